@@ -26,7 +26,7 @@ NoteNagaAudioResource* NoteNagaAudioManager::importAudio(const std::string& file
     resource->setId(nextResourceId_++);
     
     // Load the audio
-    if (!resource->load(sampleRate_)) {
+    if (!resource->load(sampleRate_, resamplerQuality_, peakCacheDirectory_)) {
         NOTE_NAGA_LOG_ERROR("Failed to load audio: " + filePath);
         return nullptr;
     }
@@ -139,3 +139,32 @@ void NoteNagaAudioManager::prepareForPlayback(int64_t tick, int ppq, int tempo)
         resource->prepareForPosition(samplePos);
     }
 }
+
+uint64_t NoteNagaAudioManager::getUnderrunCount() const
+{
+    uint64_t total = 0;
+    for (const auto& resource : resources_) {
+        total += resource->getUnderrunCount();
+    }
+    return total;
+}
+
+void NoteNagaAudioManager::resetUnderrunStats()
+{
+    for (auto& resource : resources_) {
+        resource->resetUnderrunStats();
+    }
+}
+
+bool NoteNagaAudioManager::savePeakCaches() const
+{
+    if (peakCacheDirectory_.empty()) return false;
+    
+    bool ok = true;
+    for (const auto& resource : resources_) {
+        if (resource->isLoaded()) {
+            ok = resource->savePeakCache(peakCacheDirectory_) && ok;
+        }
+    }
+    return ok;
+}
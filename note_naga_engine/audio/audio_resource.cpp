@@ -1,4 +1,5 @@
 #include "note_naga_engine/audio/audio_resource.h"
+#include "note_naga_engine/audio/mix_kernels.h"
 #include "note_naga_engine/logger.h"
 
 #include <fstream>
@@ -6,6 +7,7 @@
 #include <cmath>
 #include <algorithm>
 #include <filesystem>
+#include <cstdio>
 
 // WAV file header structures
 #pragma pack(push, 1)
@@ -30,6 +32,46 @@ struct WavFmtChunk {
 };
 #pragma pack(pop)
 
+namespace {
+
+// Use full cache for files < 30 seconds (at 44100 Hz stereo = ~10 MB)
+constexpr double MAX_CACHE_SECONDS = 30.0;
+
+// Minimum number of stream chunks per peak worker thread
+constexpr int64_t PEAK_WORKER_MIN_CHUNKS = 16;
+
+inline float decodeSample(const uint8_t *p, uint16_t audioFormat, uint16_t bitsPerSample)
+{
+    if (audioFormat == 1) { // PCM
+        if (bitsPerSample == 8) {
+            return (p[0] - 128) / 128.0f;
+        }
+        else if (bitsPerSample == 16) {
+            int16_t val;
+            std::memcpy(&val, p, sizeof(val));
+            return val / 32768.0f;
+        }
+        else if (bitsPerSample == 24) {
+            int32_t val = (p[0] | (p[1] << 8) | (p[2] << 16));
+            if (val & 0x800000) val |= 0xFF000000; // Sign extend
+            return val / 8388608.0f;
+        }
+        else if (bitsPerSample == 32) {
+            int32_t val;
+            std::memcpy(&val, p, sizeof(val));
+            return val / 2147483648.0f;
+        }
+    }
+    else if (audioFormat == 3 && bitsPerSample == 32) { // IEEE float
+        float val;
+        std::memcpy(&val, p, sizeof(val));
+        return val;
+    }
+    return 0.0f;
+}
+
+} // namespace
+
 NoteNagaAudioResource::NoteNagaAudioResource(const std::string &filePath)
     : filePath_(filePath)
 {
@@ -50,15 +92,23 @@ NoteNagaAudioResource::~NoteNagaAudioResource()
     }
 }
 
-bool NoteNagaAudioResource::load(int targetSampleRate)
+bool NoteNagaAudioResource::load(int targetSampleRate, NN_ResamplerQuality_t quality,
+                                 const std::string &peakCacheDirectory)
 {
     sampleRate_ = targetSampleRate;
+    resamplerQuality_ = quality;
     
-    if (!loadWavFile(targetSampleRate)) {
+    if (!loadWavFile(targetSampleRate, quality)) {
         return false;
     }
     
-    generateWaveformPeaks();
+    if (peakCacheDirectory.empty() || !loadPeakCache(peakCacheDirectory)) {
+        generateWaveformPeaks();
+        if (!peakCacheDirectory.empty()) {
+            savePeakCache(peakCacheDirectory);
+        }
+    }
+    
     loaded_ = true;
     
     NOTE_NAGA_LOG_INFO("Loaded audio resource: " + fileName_ + 
@@ -68,7 +118,7 @@ bool NoteNagaAudioResource::load(int targetSampleRate)
     return true;
 }
 
-bool NoteNagaAudioResource::loadWavFile(int targetSampleRate)
+bool NoteNagaAudioResource::loadWavFile(int targetSampleRate, NN_ResamplerQuality_t quality)
 {
     std::ifstream file(filePath_, std::ios::binary);
     if (!file.is_open()) {
@@ -78,11 +128,57 @@ bool NoteNagaAudioResource::loadWavFile(int targetSampleRate)
         return false;
     }
     
+    if (!readWavHeader(file)) {
+        return false;
+    }
+    
+    channels_ = 2; // Always output stereo
+    
+    // Length after resampling
+    if (originalSampleRate_ != targetSampleRate) {
+        NOTE_NAGA_LOG_INFO("Resampling from " + std::to_string(originalSampleRate_) + 
+                           " to " + std::to_string(targetSampleRate));
+        resampler_ = std::make_unique<NoteNagaResampler>(originalSampleRate_, targetSampleRate, quality);
+        totalSamples_ = resampler_->getOutputLength(source_.dataFrames);
+    }
+    else {
+        totalSamples_ = source_.dataFrames;
+    }
+    durationSeconds_ = static_cast<double>(totalSamples_) / sampleRate_;
+    
+    // Decide whether to use full cache or streaming
+    useFullAudioCache_ = (durationSeconds_ <= MAX_CACHE_SECONDS);
+    
+    if (useFullAudioCache_) {
+        DecodeScratch scratch;
+        fullAudioLeft_.resize(totalSamples_);
+        fullAudioRight_.resize(totalSamples_);
+        readOutputSamples(file, 0, totalSamples_, fullAudioLeft_.data(), fullAudioRight_.data(), scratch);
+    }
+    else {
+        // Large files are read from disk in chunks, only the peaks and the
+        // read-ahead ring stay in memory
+        int bufferSize = BUFFER_SECONDS * sampleRate_;
+        streamBufferLeft_.assign(bufferSize, 0.0f);
+        streamBufferRight_.assign(bufferSize, 0.0f);
+        
+        // Start streaming thread, pre-filling from the beginning of the file
+        requestedPosition_ = 0;
+        seekRequested_ = true;
+        loadThreadRunning_ = true;
+        loadThread_ = std::thread(&NoteNagaAudioResource::streamingThreadFunc, this);
+    }
+    
+    return true;
+}
+
+bool NoteNagaAudioResource::readWavHeader(std::ifstream &file)
+{
     // Read RIFF header
     WavHeader header;
     file.read(reinterpret_cast<char*>(&header), sizeof(header));
     
-    if (std::strncmp(header.riff, "RIFF", 4) != 0 ||
+    if (!file || std::strncmp(header.riff, "RIFF", 4) != 0 ||
         std::strncmp(header.wave, "WAVE", 4) != 0) {
         hasError_ = true;
         errorMessage_ = "Not a valid WAV file: " + filePath_;
@@ -90,9 +186,9 @@ bool NoteNagaAudioResource::loadWavFile(int targetSampleRate)
         return false;
     }
     
-    // Find fmt and data chunks
+    // Find fmt and data chunks (the data itself is not read here)
     WavFmtChunk fmt = {};
-    std::vector<uint8_t> rawData;
+    uint32_t dataSize = 0;
     bool foundFmt = false;
     bool foundData = false;
     
@@ -111,9 +207,12 @@ bool NoteNagaAudioResource::loadWavFile(int targetSampleRate)
             foundFmt = true;
         }
         else if (std::strncmp(chunk.id, "data", 4) == 0) {
-            rawData.resize(chunk.size);
-            file.read(reinterpret_cast<char*>(rawData.data()), chunk.size);
+            source_.dataOffset = static_cast<uint64_t>(file.tellg());
+            dataSize = chunk.size;
             foundData = true;
+            if (!foundFmt) {
+                file.seekg(chunk.size, std::ios::cur);
+            }
         }
         else {
             // Skip unknown chunks
@@ -144,164 +243,321 @@ bool NoteNagaAudioResource::loadWavFile(int targetSampleRate)
         return false;
     }
     
+    if (fmt.numChannels == 0 || fmt.sampleRate == 0) {
+        hasError_ = true;
+        errorMessage_ = "Invalid WAV format header: " + filePath_;
+        NOTE_NAGA_LOG_ERROR(errorMessage_);
+        return false;
+    }
+    
+    // Truncated files: only use the data which is actually present
+    file.clear();
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    uint64_t available = fileSize > source_.dataOffset ? fileSize - source_.dataOffset : 0;
+    
+    source_.audioFormat = fmt.audioFormat;
+    source_.numChannels = fmt.numChannels;
+    source_.bitsPerSample = fmt.bitsPerSample;
+    source_.blockAlign = (fmt.bitsPerSample / 8) * fmt.numChannels;
+    source_.dataFrames = static_cast<int64_t>(std::min<uint64_t>(dataSize, available) / source_.blockAlign);
+    
     originalSampleRate_ = fmt.sampleRate;
     originalChannels_ = fmt.numChannels;
+    originalTotalSamples_ = source_.dataFrames;
+    return true;
+}
+
+int64_t NoteNagaAudioResource::readSourceFrames(std::ifstream &file, int64_t firstFrame, int64_t numFrames,
+                                                DecodeScratch &scratch, float *outLeft, float *outRight)
+{
+    numFrames = std::min(numFrames, source_.dataFrames - firstFrame);
+    if (firstFrame < 0 || numFrames <= 0) return 0;
+    
+    scratch.raw.resize(static_cast<size_t>(numFrames * source_.blockAlign));
+    file.clear();
+    file.seekg(static_cast<std::streamoff>(source_.dataOffset + firstFrame * source_.blockAlign));
+    file.read(reinterpret_cast<char*>(scratch.raw.data()), static_cast<std::streamsize>(scratch.raw.size()));
+    int64_t framesRead = static_cast<int64_t>(file.gcount()) / source_.blockAlign;
+    
+    // Stereo float files need no conversion, only splitting
+    if (source_.audioFormat == 3 && source_.bitsPerSample == 32 && source_.numChannels == 2) {
+        nn_deinterleave(reinterpret_cast<const float*>(scratch.raw.data()), outLeft, outRight,
+                        static_cast<size_t>(framesRead));
+        return framesRead;
+    }
     
-    // Calculate number of samples
-    int bytesPerSample = fmt.bitsPerSample / 8;
-    int64_t numSamples = rawData.size() / (bytesPerSample * fmt.numChannels);
-    originalTotalSamples_ = numSamples;
+    const int bytesPerSample = source_.bitsPerSample / 8;
+    const uint8_t *frame = scratch.raw.data();
+    for (int64_t i = 0; i < framesRead; ++i, frame += source_.blockAlign) {
+        float left = decodeSample(frame, source_.audioFormat, source_.bitsPerSample);
+        // Convert mono to stereo
+        float right = source_.numChannels > 1
+            ? decodeSample(frame + bytesPerSample, source_.audioFormat, source_.bitsPerSample)
+            : left;
+        outLeft[i] = left;
+        outRight[i] = right;
+    }
+    return framesRead;
+}
+
+int64_t NoteNagaAudioResource::readOutputSamples(std::ifstream &file, int64_t startSample, int64_t numSamples,
+                                                 float *outLeft, float *outRight, DecodeScratch &scratch)
+{
+    numSamples = std::min(numSamples, totalSamples_ - startSample);
+    if (startSample < 0 || numSamples <= 0) return 0;
+    
+    if (!resampler_) {
+        int64_t got = readSourceFrames(file, startSample, numSamples, scratch, outLeft, outRight);
+        std::fill(outLeft + got, outLeft + numSamples, 0.0f);
+        std::fill(outRight + got, outRight + numSamples, 0.0f);
+        return numSamples;
+    }
     
-    // Convert raw data to float samples
-    std::vector<float> leftChannel(numSamples);
-    std::vector<float> rightChannel(numSamples);
+    // Band-limited resampling of the source frames covering this range, frames
+    // before the start or past the end of the file are zero
+    int64_t srcFirst = 0, srcCount = 0;
+    resampler_->getInputRange(startSample, numSamples, srcFirst, srcCount);
+    scratch.left.assign(static_cast<size_t>(srcCount), 0.0f);
+    scratch.right.assign(static_cast<size_t>(srcCount), 0.0f);
+    int64_t readFirst = std::max<int64_t>(0, srcFirst);
+    int64_t readEnd = std::min(srcFirst + srcCount, source_.dataFrames);
+    if (readEnd > readFirst) {
+        readSourceFrames(file, readFirst, readEnd - readFirst, scratch,
+                         scratch.left.data() + (readFirst - srcFirst),
+                         scratch.right.data() + (readFirst - srcFirst));
+    }
     
-    for (int64_t i = 0; i < numSamples; ++i) {
-        float left = 0.0f, right = 0.0f;
+    resampler_->process(scratch.left.data(), srcFirst, startSample, numSamples, outLeft);
+    resampler_->process(scratch.right.data(), srcFirst, startSample, numSamples, outRight);
+    return numSamples;
+}
+
+void NoteNagaAudioResource::generateWaveformPeaks()
+{
+    int64_t numPeaks = (totalSamples_ + samplesPerPeak_ - 1) / samplesPerPeak_;
+    peakLevels_.assign(1, std::vector<NN_WaveformPeak_t>(numPeaks));
+    std::vector<NN_WaveformPeak_t> &peaks = peakLevels_[0];
+    
+    // Split the finest level into peak-aligned ranges computed in parallel; streamed
+    // files are read by every worker through its own file handle, one chunk at a time
+    const int64_t chunkPeaks = STREAM_CHUNK_SAMPLES / samplesPerPeak_;
+    int64_t numChunks = (numPeaks + chunkPeaks - 1) / chunkPeaks;
+    int numWorkers = static_cast<int>(std::clamp<int64_t>(std::thread::hardware_concurrency(), 1, 8));
+    numWorkers = static_cast<int>(std::min<int64_t>(numWorkers, numChunks / PEAK_WORKER_MIN_CHUNKS + 1));
+    
+    auto worker = [this, &peaks, chunkPeaks, numChunks, numWorkers](int index) {
+        int64_t firstChunk = numChunks * index / numWorkers;
+        int64_t lastChunk = numChunks * (index + 1) / numWorkers;
+        int64_t firstSample = firstChunk * chunkPeaks * samplesPerPeak_;
+        int64_t endSample = std::min(totalSamples_, lastChunk * chunkPeaks * samplesPerPeak_);
         
-        for (int ch = 0; ch < fmt.numChannels; ++ch) {
-            float sample = 0.0f;
-            int64_t offset = i * fmt.numChannels * bytesPerSample + ch * bytesPerSample;
-            
-            if (fmt.audioFormat == 1) { // PCM
-                if (fmt.bitsPerSample == 8) {
-                    uint8_t val = rawData[offset];
-                    sample = (val - 128) / 128.0f;
-                }
-                else if (fmt.bitsPerSample == 16) {
-                    int16_t val = *reinterpret_cast<int16_t*>(&rawData[offset]);
-                    sample = val / 32768.0f;
-                }
-                else if (fmt.bitsPerSample == 24) {
-                    int32_t val = (rawData[offset] | (rawData[offset+1] << 8) | 
-                                   (rawData[offset+2] << 16));
-                    if (val & 0x800000) val |= 0xFF000000; // Sign extend
-                    sample = val / 8388608.0f;
-                }
-                else if (fmt.bitsPerSample == 32) {
-                    int32_t val = *reinterpret_cast<int32_t*>(&rawData[offset]);
-                    sample = val / 2147483648.0f;
-                }
-            }
-            else if (fmt.audioFormat == 3) { // IEEE float
-                if (fmt.bitsPerSample == 32) {
-                    sample = *reinterpret_cast<float*>(&rawData[offset]);
-                }
-            }
-            
-            if (ch == 0) left = sample;
-            else if (ch == 1) right = sample;
+        if (useFullAudioCache_) {
+            accumulatePeaks(peaks, firstSample, fullAudioLeft_.data() + firstSample,
+                            fullAudioRight_.data() + firstSample, endSample - firstSample);
+            return;
         }
         
-        // Convert mono to stereo
-        if (fmt.numChannels == 1) {
-            right = left;
+        std::ifstream file(filePath_, std::ios::binary);
+        if (!file.is_open()) return;
+        DecodeScratch scratch;
+        std::vector<float> left(STREAM_CHUNK_SAMPLES);
+        std::vector<float> right(STREAM_CHUNK_SAMPLES);
+        for (int64_t pos = firstSample; pos < endSample; pos += STREAM_CHUNK_SAMPLES) {
+            int64_t got = readOutputSamples(file, pos, std::min(STREAM_CHUNK_SAMPLES, endSample - pos),
+                                            left.data(), right.data(), scratch);
+            accumulatePeaks(peaks, pos, left.data(), right.data(), got);
         }
-        
-        leftChannel[i] = left;
-        rightChannel[i] = right;
-    }
-    
-    channels_ = 2; // Always output stereo
+    };
     
-    // Resample if needed
-    if (originalSampleRate_ != targetSampleRate) {
-        NOTE_NAGA_LOG_INFO("Resampling from " + std::to_string(originalSampleRate_) + 
-                           " to " + std::to_string(targetSampleRate));
-        
-        std::vector<float> resampledLeft, resampledRight;
-        resampleAudio(leftChannel, resampledLeft, originalSampleRate_, targetSampleRate);
-        resampleAudio(rightChannel, resampledRight, originalSampleRate_, targetSampleRate);
-        
-        fullAudioLeft_ = std::move(resampledLeft);
-        fullAudioRight_ = std::move(resampledRight);
+    std::vector<std::thread> threads;
+    for (int i = 1; i < numWorkers; ++i) {
+        threads.emplace_back(worker, i);
     }
-    else {
-        fullAudioLeft_ = std::move(leftChannel);
-        fullAudioRight_ = std::move(rightChannel);
+    worker(0);
+    for (auto &thread : threads) {
+        thread.join();
     }
     
-    totalSamples_ = fullAudioLeft_.size();
-    durationSeconds_ = static_cast<double>(totalSamples_) / sampleRate_;
+    buildPeakPyramid();
+}
+
+void NoteNagaAudioResource::buildPeakPyramid()
+{
+    peakLevels_.resize(1);
+    
+    // Every level merges PEAK_LEVEL_FACTOR peaks of the previous one
+    while (peakLevels_.back().size() > 1 &&
+           getSamplesPerPeak(static_cast<int>(peakLevels_.size()) - 1) * PEAK_LEVEL_FACTOR <= (int64_t(1) << 40)) {
+        const std::vector<NN_WaveformPeak_t> &fine = peakLevels_.back();
+        std::vector<NN_WaveformPeak_t> coarse((fine.size() + PEAK_LEVEL_FACTOR - 1) / PEAK_LEVEL_FACTOR);
+        for (size_t i = 0; i < fine.size(); ++i) {
+            NN_WaveformPeak_t &peak = coarse[i / PEAK_LEVEL_FACTOR];
+            peak.minLeft = std::min(peak.minLeft, fine[i].minLeft);
+            peak.maxLeft = std::max(peak.maxLeft, fine[i].maxLeft);
+            peak.minRight = std::min(peak.minRight, fine[i].minRight);
+            peak.maxRight = std::max(peak.maxRight, fine[i].maxRight);
+        }
+        peakLevels_.push_back(std::move(coarse));
+    }
+}
+
+void NoteNagaAudioResource::accumulatePeaks(std::vector<NN_WaveformPeak_t> &peaks, int64_t startSample,
+                                            const float *left, const float *right, int64_t numSamples) const
+{
+    for (int64_t i = 0; i < numSamples; ++i) {
+        NN_WaveformPeak_t &peak = peaks[(startSample + i) / samplesPerPeak_];
+        peak.minLeft = std::min(peak.minLeft, left[i]);
+        peak.maxLeft = std::max(peak.maxLeft, left[i]);
+        peak.minRight = std::min(peak.minRight, right[i]);
+        peak.maxRight = std::max(peak.maxRight, right[i]);
+    }
+}
+
+const std::vector<NN_WaveformPeak_t>& NoteNagaAudioResource::getWaveformPeaks(int level) const
+{
+    static const std::vector<NN_WaveformPeak_t> empty;
+    if (level < 0 || level >= static_cast<int>(peakLevels_.size())) return empty;
+    return peakLevels_[level];
+}
+
+int64_t NoteNagaAudioResource::getSamplesPerPeak(int level) const
+{
+    int64_t samples = samplesPerPeak_;
+    for (int i = 0; i < level; ++i) samples *= PEAK_LEVEL_FACTOR;
+    return samples;
+}
+
+int NoteNagaAudioResource::selectPeakLevel(double samplesPerPixel) const
+{
+    int level = 0;
+    while (level + 1 < static_cast<int>(peakLevels_.size()) &&
+           static_cast<double>(getSamplesPerPeak(level + 1)) <= samplesPerPixel) {
+        ++level;
+    }
+    return level;
+}
+
+/*******************************************************************************************************/
+// Peak cache (binary sidecar)
+/*******************************************************************************************************/
+
+std::string NoteNagaAudioResource::peakCacheFilePath(const std::string &cacheDirectory) const
+{
+    // FNV-1a hash of the absolute path keeps equally named files apart
+    std::error_code ec;
+    std::string absolute = std::filesystem::absolute(filePath_, ec).string();
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : absolute) {
+        hash = (hash ^ c) * 1099511628211ull;
+    }
+    char hex[17];
+    std::snprintf(hex, sizeof(hex), "%016llx", static_cast<unsigned long long>(hash));
+    return (std::filesystem::path(cacheDirectory) / (fileName_ + "." + hex + ".nnpeaks")).string();
+}
+
+bool NoteNagaAudioResource::loadPeakCache(const std::string &cacheDirectory)
+{
+    PeakCacheHeader expected;
+    if (!makePeakCacheHeader(expected)) return false;
     
-    // Decide whether to use full cache or streaming
-    // Use full cache for files < 30 seconds (at 44100 Hz stereo = ~10 MB)
-    constexpr double MAX_CACHE_SECONDS = 30.0;
-    useFullAudioCache_ = (durationSeconds_ <= MAX_CACHE_SECONDS);
+    std::ifstream in(peakCacheFilePath(cacheDirectory), std::ios::binary);
+    if (!in.is_open()) return false;
     
-    if (!useFullAudioCache_) {
-        // For large files, we keep the full audio in memory but use streaming buffer
-        // for the actual playback to reduce memory bandwidth
-        // In a production system, we'd read from disk in chunks
-        
-        int bufferSize = BUFFER_SECONDS * sampleRate_;
-        streamBufferLeft_.resize(bufferSize);
-        streamBufferRight_.resize(bufferSize);
-        
-        // Start streaming thread
-        loadThreadRunning_ = true;
-        loadThread_ = std::thread(&NoteNagaAudioResource::streamingThreadFunc, this);
+    PeakCacheHeader header;
+    in.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!in || std::memcmp(&header, &expected, sizeof(header)) != 0) {
+        NOTE_NAGA_LOG_INFO("Peak cache outdated: " + fileName_);
+        return false;
     }
     
+    // Finest level as 16-bit min/max values scaled by the stored peak amplitude
+    float scale = 0.0f;
+    in.read(reinterpret_cast<char*>(&scale), sizeof(scale));
+    int64_t numPeaks = (totalSamples_ + samplesPerPeak_ - 1) / samplesPerPeak_;
+    std::vector<int16_t> packed(static_cast<size_t>(numPeaks) * 4);
+    in.read(reinterpret_cast<char*>(packed.data()), static_cast<std::streamsize>(packed.size() * sizeof(int16_t)));
+    if (!in) return false;
+    
+    peakLevels_.assign(1, std::vector<NN_WaveformPeak_t>(numPeaks));
+    float factor = scale / 32767.0f;
+    for (int64_t p = 0; p < numPeaks; ++p) {
+        const int16_t *v = &packed[p * 4];
+        peakLevels_[0][p] = {v[0] * factor, v[1] * factor, v[2] * factor, v[3] * factor};
+    }
+    buildPeakPyramid();
     return true;
 }
 
-void NoteNagaAudioResource::resampleAudio(const std::vector<float>& input, 
-                                           std::vector<float>& output,
-                                           int inputRate, int outputRate)
+bool NoteNagaAudioResource::savePeakCache(const std::string &cacheDirectory) const
 {
-    if (inputRate == outputRate) {
-        output = input;
-        return;
+    PeakCacheHeader header;
+    if (peakLevels_.empty() || !makePeakCacheHeader(header)) return false;
+    std::string cachePath = peakCacheFilePath(cacheDirectory);
+    
+    // Up-to-date cache already exists
+    {
+        std::ifstream existing(cachePath, std::ios::binary);
+        PeakCacheHeader existingHeader;
+        if (existing.read(reinterpret_cast<char*>(&existingHeader), sizeof(existingHeader)) &&
+            std::memcmp(&existingHeader, &header, sizeof(header)) == 0) {
+            return true;
+        }
     }
     
-    double ratio = static_cast<double>(outputRate) / inputRate;
-    int64_t outputSize = static_cast<int64_t>(input.size() * ratio);
-    output.resize(outputSize);
+    std::error_code ec;
+    std::filesystem::create_directories(cacheDirectory, ec);
+    std::ofstream out(cachePath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        NOTE_NAGA_LOG_WARNING("Cannot write peak cache for: " + fileName_);
+        return false;
+    }
     
-    // Linear interpolation resampling
-    for (int64_t i = 0; i < outputSize; ++i) {
-        double srcPos = i / ratio;
-        int64_t srcIndex = static_cast<int64_t>(srcPos);
-        double frac = srcPos - srcIndex;
-        
-        if (srcIndex + 1 < static_cast<int64_t>(input.size())) {
-            output[i] = static_cast<float>(input[srcIndex] * (1.0 - frac) + 
-                                           input[srcIndex + 1] * frac);
-        }
-        else if (srcIndex < static_cast<int64_t>(input.size())) {
-            output[i] = input[srcIndex];
-        }
-        else {
-            output[i] = 0.0f;
-        }
+    const std::vector<NN_WaveformPeak_t> &peaks = peakLevels_[0];
+    float scale = 0.0f;
+    for (const NN_WaveformPeak_t &peak : peaks) {
+        scale = std::max({scale, -peak.minLeft, peak.maxLeft, -peak.minRight, peak.maxRight});
+    }
+    if (scale <= 0.0f) scale = 1.0f;
+    
+    // Round outwards so quantization does not shrink the envelope
+    std::vector<int16_t> packed(peaks.size() * 4);
+    auto quantize = [scale](float value, bool up) {
+        float q = value / scale * 32767.0f;
+        q = up ? std::ceil(q) : std::floor(q);
+        return static_cast<int16_t>(std::clamp(q, -32767.0f, 32767.0f));
+    };
+    for (size_t p = 0; p < peaks.size(); ++p) {
+        packed[p * 4 + 0] = quantize(peaks[p].minLeft, false);
+        packed[p * 4 + 1] = quantize(peaks[p].maxLeft, true);
+        packed[p * 4 + 2] = quantize(peaks[p].minRight, false);
+        packed[p * 4 + 3] = quantize(peaks[p].maxRight, true);
     }
+    
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(&scale), sizeof(scale));
+    out.write(reinterpret_cast<const char*>(packed.data()), static_cast<std::streamsize>(packed.size() * sizeof(int16_t)));
+    return out.good();
 }
 
-void NoteNagaAudioResource::generateWaveformPeaks()
+bool NoteNagaAudioResource::makePeakCacheHeader(PeakCacheHeader &header) const
 {
-    int64_t numPeaks = (totalSamples_ + samplesPerPeak_ - 1) / samplesPerPeak_;
-    waveformPeaks_.resize(numPeaks);
-    
-    for (int64_t p = 0; p < numPeaks; ++p) {
-        int64_t startSample = p * samplesPerPeak_;
-        int64_t endSample = std::min(startSample + samplesPerPeak_, totalSamples_);
-        
-        float minL = 0.0f, maxL = 0.0f;
-        float minR = 0.0f, maxR = 0.0f;
-        
-        for (int64_t s = startSample; s < endSample; ++s) {
-            float left = fullAudioLeft_[s];
-            float right = fullAudioRight_[s];
-            
-            minL = std::min(minL, left);
-            maxL = std::max(maxL, left);
-            minR = std::min(minR, right);
-            maxR = std::max(maxR, right);
-        }
-        
-        waveformPeaks_[p] = {minL, maxL, minR, maxR};
-    }
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(filePath_, ec);
+    if (ec) return false;
+    auto modified = std::filesystem::last_write_time(filePath_, ec);
+    if (ec) return false;
+    
+    header = PeakCacheHeader{};
+    std::memcpy(header.magic, "NNPK", 4);
+    header.version = PEAK_CACHE_VERSION;
+    header.fileSize = static_cast<uint64_t>(fileSize);
+    header.modifiedTime = static_cast<int64_t>(modified.time_since_epoch().count());
+    header.sampleRate = sampleRate_;
+    header.resamplerQuality = static_cast<int32_t>(resampler_ ? resamplerQuality_ : NN_ResamplerQuality_t::Linear);
+    header.totalSamples = totalSamples_;
+    header.samplesPerPeak = samplesPerPeak_;
+    return true;
 }
 
 int NoteNagaAudioResource::getSamples(int64_t startSample, int numSamples,
@@ -309,87 +565,185 @@ int NoteNagaAudioResource::getSamples(int64_t startSample, int numSamples,
 {
     if (!loaded_ || startSample < 0) return 0;
     
-    int samplesRead = 0;
+    int samplesRead = static_cast<int>(std::max<int64_t>(0, std::min<int64_t>(numSamples, totalSamples_ - startSample)));
+    if (samplesRead == 0) return 0;
     
     if (useFullAudioCache_) {
         // Direct read from full cache
-        for (int i = 0; i < numSamples; ++i) {
-            int64_t idx = startSample + i;
-            if (idx >= totalSamples_) break;
-            
-            outLeft[i] = fullAudioLeft_[idx];
-            outRight[i] = fullAudioRight_[idx];
-            samplesRead++;
-        }
+        std::memcpy(outLeft, fullAudioLeft_.data() + startSample, samplesRead * sizeof(float));
+        std::memcpy(outRight, fullAudioRight_.data() + startSample, samplesRead * sizeof(float));
+        return samplesRead;
     }
-    else {
-        // Read from streaming buffer
-        std::lock_guard<std::mutex> lock(bufferMutex_);
+    
+    // Read from the streaming ring (seqlock style: copy first, then validate that
+    // the I/O thread did not reposition or overwrite the copied window meanwhile)
+    const int64_t capacity = static_cast<int64_t>(streamBufferLeft_.size());
+    uint64_t generation = bufferGeneration_.load(std::memory_order_acquire);
+    int64_t bufferStart = bufferStartSample_.load(std::memory_order_acquire);
+    int64_t bufferEnd = bufferEndSample_.load(std::memory_order_acquire);
+    
+    int available = 0;
+    if ((generation & 1) == 0 && startSample >= bufferStart && startSample < bufferEnd) {
+        available = static_cast<int>(std::min<int64_t>(samplesRead, bufferEnd - startSample));
+        int64_t slot = startSample % capacity;
+        int first = static_cast<int>(std::min<int64_t>(available, capacity - slot));
+        std::memcpy(outLeft, streamBufferLeft_.data() + slot, first * sizeof(float));
+        std::memcpy(outRight, streamBufferRight_.data() + slot, first * sizeof(float));
+        if (first < available) {
+            std::memcpy(outLeft + first, streamBufferLeft_.data(), (available - first) * sizeof(float));
+            std::memcpy(outRight + first, streamBufferRight_.data(), (available - first) * sizeof(float));
+        }
         
-        for (int i = 0; i < numSamples; ++i) {
-            int64_t idx = startSample + i;
-            if (idx >= totalSamples_) break;
-            
-            // Check if sample is in buffer
-            if (idx >= bufferStartSample_ && idx < bufferEndSample_) {
-                int bufIdx = static_cast<int>(idx - bufferStartSample_);
-                outLeft[i] = streamBufferLeft_[bufIdx];
-                outRight[i] = streamBufferRight_[bufIdx];
-                samplesRead++;
-            }
-            else {
-                // Sample not in buffer - read from full cache as fallback
-                outLeft[i] = fullAudioLeft_[idx];
-                outRight[i] = fullAudioRight_[idx];
-                samplesRead++;
-            }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (bufferGeneration_.load(std::memory_order_relaxed) != generation ||
+            bufferStartSample_.load(std::memory_order_relaxed) > startSample) {
+            available = 0;
         }
     }
     
+    // Not buffered (yet): output silence instead of waiting for the disk
+    if (available < samplesRead) {
+        std::fill(outLeft + available, outLeft + samplesRead, 0.0f);
+        std::fill(outRight + available, outRight + samplesRead, 0.0f);
+        underrunCount_.fetch_add(1, std::memory_order_relaxed);
+        underrunSamples_.fetch_add(static_cast<uint64_t>(samplesRead - available), std::memory_order_relaxed);
+    }
+    
+    if (available == 0 && (startSample < bufferStart || startSample > bufferEnd)) {
+        // Outside of the read-ahead window: let the I/O thread jump there
+        // (no notify, the thread polls and the audio thread must not lock)
+        requestedPosition_.store(startSample, std::memory_order_relaxed);
+        seekRequested_.store(true, std::memory_order_release);
+    }
+    else {
+        readPosition_.store(startSample, std::memory_order_release);
+    }
+    
     return samplesRead;
 }
 
+void NoteNagaAudioResource::resetUnderrunStats()
+{
+    underrunCount_.store(0, std::memory_order_relaxed);
+    underrunSamples_.store(0, std::memory_order_relaxed);
+}
+
 void NoteNagaAudioResource::prepareForPosition(int64_t startSample)
 {
-    if (useFullAudioCache_) return;
+    if (useFullAudioCache_ || !loadThreadRunning_) return;
     
-    requestedPosition_ = startSample;
+    requestedPosition_.store(std::max<int64_t>(0, startSample), std::memory_order_relaxed);
+    seekRequested_.store(true, std::memory_order_release);
     loadCondition_.notify_one();
 }
 
+int64_t NoteNagaAudioResource::readSamples(int64_t startSample, int64_t numSamples,
+                                           float *outLeft, float *outRight)
+{
+    Reader reader(this);
+    return reader.read(startSample, numSamples, outLeft, outRight);
+}
+
+int64_t NoteNagaAudioResource::Reader::read(int64_t startSample, int64_t numSamples,
+                                            float *outLeft, float *outRight)
+{
+    NoteNagaAudioResource &resource = *resource_;
+    if (!resource.loaded_ || startSample < 0) return 0;
+
+    numSamples = std::max<int64_t>(0, std::min(numSamples, resource.totalSamples_ - startSample));
+    if (numSamples == 0) return 0;
+
+    if (resource.useFullAudioCache_) {
+        std::memcpy(outLeft, resource.fullAudioLeft_.data() + startSample, numSamples * sizeof(float));
+        std::memcpy(outRight, resource.fullAudioRight_.data() + startSample, numSamples * sizeof(float));
+        return numSamples;
+    }
+
+    if (!file_.is_open()) {
+        file_.open(resource.filePath_, std::ios::binary);
+        if (!file_.is_open()) {
+            NOTE_NAGA_LOG_ERROR("Cannot open audio file: " + resource.filePath_);
+            return 0;
+        }
+    }
+    return resource.readOutputSamples(file_, startSample, numSamples, outLeft, outRight, scratch_);
+}
+
 void NoteNagaAudioResource::streamingThreadFunc()
 {
+    std::ifstream file(filePath_, std::ios::binary);
+    if (!file.is_open()) {
+        NOTE_NAGA_LOG_ERROR("Streaming: cannot open file: " + filePath_);
+        return;
+    }
+    
+    DecodeScratch scratch;
+    std::vector<float> chunkLeft(STREAM_CHUNK_SAMPLES);
+    std::vector<float> chunkRight(STREAM_CHUNK_SAMPLES);
+    const int64_t capacity = static_cast<int64_t>(streamBufferLeft_.size());
+    
     while (loadThreadRunning_) {
-        std::unique_lock<std::mutex> lock(loadMutex_);
-        loadCondition_.wait_for(lock, std::chrono::milliseconds(100));
-        
-        if (!loadThreadRunning_) break;
+        if (seekRequested_.exchange(false, std::memory_order_acq_rel)) {
+            int64_t pos = std::clamp<int64_t>(requestedPosition_.load(std::memory_order_relaxed), 0, totalSamples_);
+            if (pos < bufferStartSample_.load(std::memory_order_relaxed) ||
+                pos > bufferEndSample_.load(std::memory_order_relaxed)) {
+                repositionBuffer(pos);
+            }
+            readPosition_.store(pos, std::memory_order_release);
+        }
         
-        int64_t reqPos = requestedPosition_.load();
-        int bufferSize = static_cast<int>(streamBufferLeft_.size());
+        // Keep the ring filled up to BUFFER_SECONDS ahead of the reader
+        int64_t bufferStart = bufferStartSample_.load(std::memory_order_relaxed);
+        int64_t bufferEnd = bufferEndSample_.load(std::memory_order_relaxed);
+        int64_t readPos = std::max(readPosition_.load(std::memory_order_acquire), bufferStart);
+        int64_t fillLimit = std::min(totalSamples_, readPos + capacity);
         
-        // Check if we need to update buffer
-        if (reqPos < bufferStartSample_ || reqPos >= bufferEndSample_ - bufferSize / 2) {
-            loadBufferRange(reqPos, reqPos + bufferSize);
+        if (bufferEnd < fillLimit) {
+            int64_t count = std::min(STREAM_CHUNK_SAMPLES, fillLimit - bufferEnd);
+            count = readOutputSamples(file, bufferEnd, count, chunkLeft.data(), chunkRight.data(), scratch);
+            // A pending seek makes this chunk obsolete
+            if (count > 0 && !seekRequested_.load(std::memory_order_acquire)) {
+                fillBuffer(bufferEnd, chunkLeft.data(), chunkRight.data(), count);
+            }
+            continue;
         }
+        
+        std::unique_lock<std::mutex> lock(loadMutex_);
+        loadCondition_.wait_for(lock, std::chrono::milliseconds(10), [this]() {
+            return !loadThreadRunning_ || seekRequested_.load(std::memory_order_acquire);
+        });
     }
 }
 
-void NoteNagaAudioResource::loadBufferRange(int64_t startSample, int64_t endSample)
+void NoteNagaAudioResource::repositionBuffer(int64_t startSample)
 {
-    startSample = std::max(int64_t(0), startSample);
-    endSample = std::min(endSample, totalSamples_);
-    
-    int bufferSize = static_cast<int>(streamBufferLeft_.size());
+    bufferGeneration_.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    bufferStartSample_.store(startSample, std::memory_order_relaxed);
+    bufferEndSample_.store(startSample, std::memory_order_relaxed);
+    bufferGeneration_.fetch_add(1, std::memory_order_release);
+}
+
+void NoteNagaAudioResource::fillBuffer(int64_t startSample, const float *left, const float *right,
+                                       int64_t numSamples)
+{
+    const int64_t capacity = static_cast<int64_t>(streamBufferLeft_.size());
     
-    std::lock_guard<std::mutex> lock(bufferMutex_);
+    // Drop the oldest samples from the window before their slots are overwritten
+    int64_t newStart = startSample + numSamples - capacity;
+    if (newStart > bufferStartSample_.load(std::memory_order_relaxed)) {
+        bufferStartSample_.store(newStart, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
     
-    for (int64_t i = startSample; i < endSample && (i - startSample) < bufferSize; ++i) {
-        int bufIdx = static_cast<int>(i - startSample);
-        streamBufferLeft_[bufIdx] = fullAudioLeft_[i];
-        streamBufferRight_[bufIdx] = fullAudioRight_[i];
+    int64_t slot = startSample % capacity;
+    int64_t first = std::min(numSamples, capacity - slot);
+    std::memcpy(streamBufferLeft_.data() + slot, left, first * sizeof(float));
+    std::memcpy(streamBufferRight_.data() + slot, right, first * sizeof(float));
+    if (first < numSamples) {
+        std::memcpy(streamBufferLeft_.data(), left + first, (numSamples - first) * sizeof(float));
+        std::memcpy(streamBufferRight_.data(), right + first, (numSamples - first) * sizeof(float));
     }
     
-    bufferStartSample_ = startSample;
-    bufferEndSample_ = std::min(startSample + bufferSize, totalSamples_);
+    bufferEndSample_.store(startSample + numSamples, std::memory_order_release);
 }
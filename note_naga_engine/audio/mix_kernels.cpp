@@ -0,0 +1,424 @@
+#include "note_naga_engine/audio/mix_kernels.h"
+
+#include "mix_kernels_table.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NN_MIX_SSE2 1
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON)
+#define NN_MIX_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+/*******************************************************************************************************/
+// Scalar
+/*******************************************************************************************************/
+
+inline float clamp01(float x) { return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x); }
+
+void mixAddScalar(float *dst, const float *src, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) dst[i] += src[i];
+}
+
+void applyGainScalar(float *left, float *right, size_t n, float gain_left, float gain_right, float in_start,
+                     float in_step, float out_start, float out_step)
+{
+    for (size_t i = 0; i < n; ++i) {
+        float fi = float(i);
+        float fade = clamp01(in_start + fi * in_step) * clamp01(out_start + fi * out_step);
+        left[i] *= gain_left * fade;
+        right[i] *= gain_right * fade;
+    }
+}
+
+void panCrossfeedScalar(float *left, float *right, size_t n, float pan_left, float pan_right)
+{
+    const float fold_left = 1.0f - pan_right;
+    const float fold_right = 1.0f - pan_left;
+    for (size_t i = 0; i < n; ++i) {
+        float l = left[i], r = right[i];
+        left[i] = l * pan_left + r * fold_left;
+        right[i] = r * pan_right + l * fold_right;
+    }
+}
+
+void sumSquaresPeakScalar(const float *samples, size_t n, float *sum_sq, float *peak)
+{
+    float sum = 0.0f, max = 0.0f;
+    for (size_t i = 0; i < n; ++i) {
+        sum += samples[i] * samples[i];
+        max = std::max(max, std::fabs(samples[i]));
+    }
+    *sum_sq += sum;
+    *peak = std::max(*peak, max);
+}
+
+void interleaveScalar(float *out, const float *left, const float *right, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
+
+void deinterleaveScalar(const float *in, float *left, float *right, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        left[i] = in[2 * i];
+        right[i] = in[2 * i + 1];
+    }
+}
+
+float dotProductScalar(const float *a, const float *b, size_t n)
+{
+    float sum = 0.0f;
+    for (size_t i = 0; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+
+#if !defined(NN_MIX_SSE2) && !defined(NN_MIX_NEON)
+const NN_MixKernelTable_t kScalarTable = {
+    "scalar", mixAddScalar, applyGainScalar, panCrossfeedScalar, sumSquaresPeakScalar, interleaveScalar,
+    deinterleaveScalar, dotProductScalar,
+};
+#endif
+
+#if defined(NN_MIX_SSE2)
+
+/*******************************************************************************************************/
+// SSE2
+/*******************************************************************************************************/
+
+void mixAddSSE2(float *dst, const float *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        _mm_storeu_ps(dst + i, _mm_add_ps(_mm_loadu_ps(dst + i), _mm_loadu_ps(src + i)));
+        _mm_storeu_ps(dst + i + 4, _mm_add_ps(_mm_loadu_ps(dst + i + 4), _mm_loadu_ps(src + i + 4)));
+    }
+    mixAddScalar(dst + i, src + i, n - i);
+}
+
+void applyGainSSE2(float *left, float *right, size_t n, float gain_left, float gain_right, float in_start,
+                   float in_step, float out_start, float out_step)
+{
+    const __m128 gl = _mm_set1_ps(gain_left), gr = _mm_set1_ps(gain_right);
+    const __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+    const __m128 is = _mm_set1_ps(in_start), id = _mm_set1_ps(in_step);
+    const __m128 os = _mm_set1_ps(out_start), od = _mm_set1_ps(out_step);
+    __m128 index = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+    const __m128 four = _mm_set1_ps(4.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 fi = _mm_min_ps(_mm_max_ps(_mm_add_ps(is, _mm_mul_ps(index, id)), zero), one);
+        __m128 fo = _mm_min_ps(_mm_max_ps(_mm_add_ps(os, _mm_mul_ps(index, od)), zero), one);
+        __m128 fade = _mm_mul_ps(fi, fo);
+        _mm_storeu_ps(left + i, _mm_mul_ps(_mm_loadu_ps(left + i), _mm_mul_ps(gl, fade)));
+        _mm_storeu_ps(right + i, _mm_mul_ps(_mm_loadu_ps(right + i), _mm_mul_ps(gr, fade)));
+        index = _mm_add_ps(index, four);
+    }
+    applyGainScalar(left + i, right + i, n - i, gain_left, gain_right, in_start + float(i) * in_step, in_step,
+                    out_start + float(i) * out_step, out_step);
+}
+
+void panCrossfeedSSE2(float *left, float *right, size_t n, float pan_left, float pan_right)
+{
+    const __m128 pl = _mm_set1_ps(pan_left), pr = _mm_set1_ps(pan_right);
+    const __m128 fl = _mm_set1_ps(1.0f - pan_right), fr = _mm_set1_ps(1.0f - pan_left);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i), r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(left + i, _mm_add_ps(_mm_mul_ps(l, pl), _mm_mul_ps(r, fl)));
+        _mm_storeu_ps(right + i, _mm_add_ps(_mm_mul_ps(r, pr), _mm_mul_ps(l, fr)));
+    }
+    panCrossfeedScalar(left + i, right + i, n - i, pan_left, pan_right);
+}
+
+void sumSquaresPeakSSE2(const float *samples, size_t n, float *sum_sq, float *peak)
+{
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 sum0 = _mm_setzero_ps(), sum1 = _mm_setzero_ps();
+    __m128 max0 = _mm_setzero_ps(), max1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128 a = _mm_loadu_ps(samples + i), b = _mm_loadu_ps(samples + i + 4);
+        sum0 = _mm_add_ps(sum0, _mm_mul_ps(a, a));
+        sum1 = _mm_add_ps(sum1, _mm_mul_ps(b, b));
+        max0 = _mm_max_ps(max0, _mm_and_ps(a, abs_mask));
+        max1 = _mm_max_ps(max1, _mm_and_ps(b, abs_mask));
+    }
+    __m128 sum = _mm_add_ps(sum0, sum1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    __m128 max = _mm_max_ps(max0, max1);
+    max = _mm_max_ps(max, _mm_movehl_ps(max, max));
+    max = _mm_max_ss(max, _mm_shuffle_ps(max, max, 1));
+    *sum_sq += _mm_cvtss_f32(sum);
+    *peak = std::max(*peak, _mm_cvtss_f32(max));
+    sumSquaresPeakScalar(samples + i, n - i, sum_sq, peak);
+}
+
+void interleaveSSE2(float *out, const float *left, const float *right, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 l = _mm_loadu_ps(left + i), r = _mm_loadu_ps(right + i);
+        _mm_storeu_ps(out + 2 * i, _mm_unpacklo_ps(l, r));
+        _mm_storeu_ps(out + 2 * i + 4, _mm_unpackhi_ps(l, r));
+    }
+    interleaveScalar(out + 2 * i, left + i, right + i, n - i);
+}
+
+void deinterleaveSSE2(const float *in, float *left, float *right, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128 a = _mm_loadu_ps(in + 2 * i), b = _mm_loadu_ps(in + 2 * i + 4);
+        _mm_storeu_ps(left + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(right + i, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    deinterleaveScalar(in + 2 * i, left + i, right + i, n - i);
+}
+
+float dotProductSSE2(const float *a, const float *b, size_t n)
+{
+    __m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    __m128 sum = _mm_add_ps(acc0, acc1);
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum) + dotProductScalar(a + i, b + i, n - i);
+}
+
+const NN_MixKernelTable_t kSSE2Table = {
+    "sse2", mixAddSSE2, applyGainSSE2, panCrossfeedSSE2, sumSquaresPeakSSE2, interleaveSSE2, deinterleaveSSE2,
+    dotProductSSE2,
+};
+
+bool cpuHasAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (!fma || !osxsave || (_xgetbv(0) & 0x6) != 0x6) return false; // OS saves YMM state
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+#elif defined(NN_MIX_NEON)
+
+/*******************************************************************************************************/
+// NEON
+/*******************************************************************************************************/
+
+void mixAddNEON(float *dst, const float *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        vst1q_f32(dst + i, vaddq_f32(vld1q_f32(dst + i), vld1q_f32(src + i)));
+        vst1q_f32(dst + i + 4, vaddq_f32(vld1q_f32(dst + i + 4), vld1q_f32(src + i + 4)));
+    }
+    mixAddScalar(dst + i, src + i, n - i);
+}
+
+void applyGainNEON(float *left, float *right, size_t n, float gain_left, float gain_right, float in_start,
+                   float in_step, float out_start, float out_step)
+{
+    const float32x4_t gl = vdupq_n_f32(gain_left), gr = vdupq_n_f32(gain_right);
+    const float32x4_t zero = vdupq_n_f32(0.0f), one = vdupq_n_f32(1.0f);
+    const float32x4_t is = vdupq_n_f32(in_start), id = vdupq_n_f32(in_step);
+    const float32x4_t os = vdupq_n_f32(out_start), od = vdupq_n_f32(out_step);
+    const float lanes[4] = {0.0f, 1.0f, 2.0f, 3.0f};
+    float32x4_t index = vld1q_f32(lanes);
+    const float32x4_t four = vdupq_n_f32(4.0f);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t fi = vminq_f32(vmaxq_f32(vmlaq_f32(is, index, id), zero), one);
+        float32x4_t fo = vminq_f32(vmaxq_f32(vmlaq_f32(os, index, od), zero), one);
+        float32x4_t fade = vmulq_f32(fi, fo);
+        vst1q_f32(left + i, vmulq_f32(vld1q_f32(left + i), vmulq_f32(gl, fade)));
+        vst1q_f32(right + i, vmulq_f32(vld1q_f32(right + i), vmulq_f32(gr, fade)));
+        index = vaddq_f32(index, four);
+    }
+    applyGainScalar(left + i, right + i, n - i, gain_left, gain_right, in_start + float(i) * in_step, in_step,
+                    out_start + float(i) * out_step, out_step);
+}
+
+void panCrossfeedNEON(float *left, float *right, size_t n, float pan_left, float pan_right)
+{
+    const float32x4_t pl = vdupq_n_f32(pan_left), pr = vdupq_n_f32(pan_right);
+    const float32x4_t fl = vdupq_n_f32(1.0f - pan_right), fr = vdupq_n_f32(1.0f - pan_left);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t l = vld1q_f32(left + i), r = vld1q_f32(right + i);
+        vst1q_f32(left + i, vmlaq_f32(vmulq_f32(l, pl), r, fl));
+        vst1q_f32(right + i, vmlaq_f32(vmulq_f32(r, pr), l, fr));
+    }
+    panCrossfeedScalar(left + i, right + i, n - i, pan_left, pan_right);
+}
+
+void sumSquaresPeakNEON(const float *samples, size_t n, float *sum_sq, float *peak)
+{
+    float32x4_t sum0 = vdupq_n_f32(0.0f), sum1 = vdupq_n_f32(0.0f);
+    float32x4_t max0 = vdupq_n_f32(0.0f), max1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t a = vld1q_f32(samples + i), b = vld1q_f32(samples + i + 4);
+        sum0 = vmlaq_f32(sum0, a, a);
+        sum1 = vmlaq_f32(sum1, b, b);
+        max0 = vmaxq_f32(max0, vabsq_f32(a));
+        max1 = vmaxq_f32(max1, vabsq_f32(b));
+    }
+    float32x4_t sum = vaddq_f32(sum0, sum1);
+    float32x2_t sum_half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    float32x4_t max = vmaxq_f32(max0, max1);
+    float32x2_t max_half = vmax_f32(vget_low_f32(max), vget_high_f32(max));
+    *sum_sq += vget_lane_f32(vpadd_f32(sum_half, sum_half), 0);
+    *peak = std::max(*peak, vget_lane_f32(vpmax_f32(max_half, max_half), 0));
+    sumSquaresPeakScalar(samples + i, n - i, sum_sq, peak);
+}
+
+void interleaveNEON(float *out, const float *left, const float *right, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t lr;
+        lr.val[0] = vld1q_f32(left + i);
+        lr.val[1] = vld1q_f32(right + i);
+        vst2q_f32(out + 2 * i, lr);
+    }
+    interleaveScalar(out + 2 * i, left + i, right + i, n - i);
+}
+
+void deinterleaveNEON(const float *in, float *left, float *right, size_t n)
+{
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float32x4x2_t lr = vld2q_f32(in + 2 * i);
+        vst1q_f32(left + i, lr.val[0]);
+        vst1q_f32(right + i, lr.val[1]);
+    }
+    deinterleaveScalar(in + 2 * i, left + i, right + i, n - i);
+}
+
+float dotProductNEON(const float *a, const float *b, size_t n)
+{
+    float32x4_t acc0 = vdupq_n_f32(0.0f), acc1 = vdupq_n_f32(0.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc0 = vmlaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vmlaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    float32x4_t sum = vaddq_f32(acc0, acc1);
+    float32x2_t half = vadd_f32(vget_low_f32(sum), vget_high_f32(sum));
+    return vget_lane_f32(vpadd_f32(half, half), 0) + dotProductScalar(a + i, b + i, n - i);
+}
+
+const NN_MixKernelTable_t kNEONTable = {
+    "neon", mixAddNEON, applyGainNEON, panCrossfeedNEON, sumSquaresPeakNEON, interleaveNEON, deinterleaveNEON,
+    dotProductNEON,
+};
+
+#endif
+
+/*******************************************************************************************************/
+// Dispatch
+/*******************************************************************************************************/
+
+const NN_MixKernelTable_t *selectKernels()
+{
+#if defined(NN_MIX_SSE2)
+    const NN_MixKernelTable_t *avx2 = nn_mix_kernels_avx2_table();
+    if (avx2 && cpuHasAVX2()) return avx2;
+    return &kSSE2Table;
+#elif defined(NN_MIX_NEON)
+    return &kNEONTable;
+#else
+    return &kScalarTable;
+#endif
+}
+
+const NN_MixKernelTable_t &kernels()
+{
+    static const NN_MixKernelTable_t *table = selectKernels();
+    return *table;
+}
+
+} // namespace
+
+NN_FadeRamp_t NN_FadeRamp_t::forBlock(int64_t block_start, size_t num_frames, int64_t clip_start, int64_t fade_in,
+                                      int64_t fade_out_end, int64_t fade_out)
+{
+    NN_FadeRamp_t ramp;
+    const int64_t block_end = block_start + static_cast<int64_t>(num_frames);
+    if (fade_in > 0 && block_start < clip_start + fade_in) {
+        ramp.in_start = static_cast<float>(static_cast<double>(block_start - clip_start) / static_cast<double>(fade_in));
+        ramp.in_step = static_cast<float>(1.0 / static_cast<double>(fade_in));
+    }
+    if (fade_out > 0 && block_end > fade_out_end - fade_out) {
+        ramp.out_start = static_cast<float>(static_cast<double>(fade_out_end - block_start) / static_cast<double>(fade_out));
+        ramp.out_step = static_cast<float>(-1.0 / static_cast<double>(fade_out));
+    }
+    return ramp;
+}
+
+void nn_mix_add(float *dst, const float *src, size_t num_frames) { kernels().mix_add(dst, src, num_frames); }
+
+void nn_apply_gain(float *left, float *right, size_t num_frames, float gain_left, float gain_right,
+                   const NN_FadeRamp_t &ramp)
+{
+    kernels().apply_gain(left, right, num_frames, gain_left, gain_right, ramp.in_start, ramp.in_step, ramp.out_start,
+                         ramp.out_step);
+}
+
+void nn_pan_crossfeed(float *left, float *right, size_t num_frames, float pan_left, float pan_right)
+{
+    kernels().pan_crossfeed(left, right, num_frames, pan_left, pan_right);
+}
+
+void nn_pan_gains(float pan, float &pan_left, float &pan_right)
+{
+    float angle = (pan + 1.0f) * 0.25f * 3.14159265f; // 0 to pi/2
+    pan_left = std::cos(angle);
+    pan_right = std::sin(angle);
+}
+
+void nn_sum_squares_peak(const float *samples, size_t num_frames, float &sum_sq, float &peak)
+{
+    kernels().sum_squares_peak(samples, num_frames, &sum_sq, &peak);
+}
+
+void nn_interleave(float *out, const float *left, const float *right, size_t num_frames)
+{
+    kernels().interleave(out, left, right, num_frames);
+}
+
+void nn_deinterleave(const float *in, float *left, float *right, size_t num_frames)
+{
+    kernels().deinterleave(in, left, right, num_frames);
+}
+
+float nn_dot_product(const float *a, const float *b, size_t n) { return kernels().dot_product(a, b, n); }
+
+const char *nn_mix_kernels_isa() { return kernels().isa; }
@@ -0,0 +1,170 @@
+// AVX2 + FMA mix kernels. This file is compiled with AVX2 code generation (see CMakeLists.txt) and
+// its table is used only after a CPU check in mix_kernels.cpp. It must not use inline library
+// functions (std::min, ...): their AVX2 copies could be picked by the linker for other files.
+
+#include "mix_kernels_table.h"
+
+// MSVC defines no __FMA__, /arch:AVX2 enables FMA code generation as well
+#if defined(__AVX2__) && (defined(__FMA__) || defined(_MSC_VER))
+
+#include <immintrin.h>
+
+namespace {
+
+inline float clamp01(float x) { return x < 0.0f ? 0.0f : (x > 1.0f ? 1.0f : x); }
+
+void mixAddAVX2(float *dst, const float *src, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        _mm256_storeu_ps(dst + i, _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_loadu_ps(src + i)));
+        _mm256_storeu_ps(dst + i + 8, _mm256_add_ps(_mm256_loadu_ps(dst + i + 8), _mm256_loadu_ps(src + i + 8)));
+    }
+    for (; i < n; ++i) dst[i] += src[i];
+}
+
+void applyGainAVX2(float *left, float *right, size_t n, float gain_left, float gain_right, float in_start,
+                   float in_step, float out_start, float out_step)
+{
+    const __m256 gl = _mm256_set1_ps(gain_left), gr = _mm256_set1_ps(gain_right);
+    const __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+    const __m256 is = _mm256_set1_ps(in_start), id = _mm256_set1_ps(in_step);
+    const __m256 os = _mm256_set1_ps(out_start), od = _mm256_set1_ps(out_step);
+    __m256 index = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 eight = _mm256_set1_ps(8.0f);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 fi = _mm256_min_ps(_mm256_max_ps(_mm256_fmadd_ps(index, id, is), zero), one);
+        __m256 fo = _mm256_min_ps(_mm256_max_ps(_mm256_fmadd_ps(index, od, os), zero), one);
+        __m256 fade = _mm256_mul_ps(fi, fo);
+        _mm256_storeu_ps(left + i, _mm256_mul_ps(_mm256_loadu_ps(left + i), _mm256_mul_ps(gl, fade)));
+        _mm256_storeu_ps(right + i, _mm256_mul_ps(_mm256_loadu_ps(right + i), _mm256_mul_ps(gr, fade)));
+        index = _mm256_add_ps(index, eight);
+    }
+    for (; i < n; ++i) {
+        float fi = float(i);
+        float fade = clamp01(in_start + fi * in_step) * clamp01(out_start + fi * out_step);
+        left[i] *= gain_left * fade;
+        right[i] *= gain_right * fade;
+    }
+}
+
+void panCrossfeedAVX2(float *left, float *right, size_t n, float pan_left, float pan_right)
+{
+    const __m256 pl = _mm256_set1_ps(pan_left), pr = _mm256_set1_ps(pan_right);
+    const __m256 fl = _mm256_set1_ps(1.0f - pan_right), fr = _mm256_set1_ps(1.0f - pan_left);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i), r = _mm256_loadu_ps(right + i);
+        _mm256_storeu_ps(left + i, _mm256_fmadd_ps(r, fl, _mm256_mul_ps(l, pl)));
+        _mm256_storeu_ps(right + i, _mm256_fmadd_ps(l, fr, _mm256_mul_ps(r, pr)));
+    }
+    for (; i < n; ++i) {
+        float l = left[i], r = right[i];
+        left[i] = l * pan_left + r * (1.0f - pan_right);
+        right[i] = r * pan_right + l * (1.0f - pan_left);
+    }
+}
+
+void sumSquaresPeakAVX2(const float *samples, size_t n, float *sum_sq, float *peak)
+{
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 sum0 = _mm256_setzero_ps(), sum1 = _mm256_setzero_ps();
+    __m256 max0 = _mm256_setzero_ps(), max1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m256 a = _mm256_loadu_ps(samples + i), b = _mm256_loadu_ps(samples + i + 8);
+        sum0 = _mm256_fmadd_ps(a, a, sum0);
+        sum1 = _mm256_fmadd_ps(b, b, sum1);
+        max0 = _mm256_max_ps(max0, _mm256_and_ps(a, abs_mask));
+        max1 = _mm256_max_ps(max1, _mm256_and_ps(b, abs_mask));
+    }
+    __m256 sum8 = _mm256_add_ps(sum0, sum1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    __m256 max8 = _mm256_max_ps(max0, max1);
+    __m128 max = _mm_max_ps(_mm256_castps256_ps128(max8), _mm256_extractf128_ps(max8, 1));
+    max = _mm_max_ps(max, _mm_movehl_ps(max, max));
+    max = _mm_max_ss(max, _mm_shuffle_ps(max, max, 1));
+
+    float total = _mm_cvtss_f32(sum);
+    float top = _mm_cvtss_f32(max);
+    for (; i < n; ++i) {
+        float x = samples[i];
+        total += x * x;
+        float a = x < 0.0f ? -x : x;
+        top = a > top ? a : top;
+    }
+    *sum_sq += total;
+    *peak = top > *peak ? top : *peak;
+}
+
+void interleaveAVX2(float *out, const float *left, const float *right, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 l = _mm256_loadu_ps(left + i), r = _mm256_loadu_ps(right + i);
+        __m256 lo = _mm256_unpacklo_ps(l, r); // l0 r0 l1 r1 | l4 r4 l5 r5
+        __m256 hi = _mm256_unpackhi_ps(l, r); // l2 r2 l3 r3 | l6 r6 l7 r7
+        _mm256_storeu_ps(out + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(out + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    for (; i < n; ++i) {
+        out[2 * i] = left[i];
+        out[2 * i + 1] = right[i];
+    }
+}
+
+void deinterleaveAVX2(const float *in, float *left, float *right, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256 a = _mm256_loadu_ps(in + 2 * i), b = _mm256_loadu_ps(in + 2 * i + 8);
+        __m256 first = _mm256_permute2f128_ps(a, b, 0x20);  // frames 0-1 | 4-5
+        __m256 second = _mm256_permute2f128_ps(a, b, 0x31); // frames 2-3 | 6-7
+        _mm256_storeu_ps(left + i, _mm256_shuffle_ps(first, second, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm256_storeu_ps(right + i, _mm256_shuffle_ps(first, second, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    for (; i < n; ++i) {
+        left[i] = in[2 * i];
+        right[i] = in[2 * i + 1];
+    }
+}
+
+float dotProductAVX2(const float *a, const float *b, size_t n)
+{
+    __m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i + 8 <= n) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        i += 8;
+    }
+    __m256 sum8 = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(sum8), _mm256_extractf128_ps(sum8, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+    float total = _mm_cvtss_f32(sum);
+    for (; i < n; ++i) total += a[i] * b[i];
+    return total;
+}
+
+const NN_MixKernelTable_t kAVX2Table = {
+    "avx2", mixAddAVX2, applyGainAVX2, panCrossfeedAVX2, sumSquaresPeakAVX2, interleaveAVX2, deinterleaveAVX2,
+    dotProductAVX2,
+};
+
+} // namespace
+
+const NN_MixKernelTable_t *nn_mix_kernels_avx2_table() { return &kAVX2Table; }
+
+#else
+
+const NN_MixKernelTable_t *nn_mix_kernels_avx2_table() { return nullptr; }
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef NOTE_NAGA_MIX_KERNELS_TABLE_H
+#define NOTE_NAGA_MIX_KERNELS_TABLE_H
+
+#include <cstddef>
+
+/*
+ * Internal: one implementation of the mix kernels (see note_naga_engine/audio/mix_kernels.h).
+ * Kept free of inline library code, the AVX2 table is compiled with different target flags.
+ */
+struct NN_MixKernelTable_t {
+    const char *isa;
+    void (*mix_add)(float *dst, const float *src, size_t n);
+    void (*apply_gain)(float *left, float *right, size_t n, float gain_left, float gain_right, float in_start,
+                       float in_step, float out_start, float out_step);
+    void (*pan_crossfeed)(float *left, float *right, size_t n, float pan_left, float pan_right);
+    void (*sum_squares_peak)(const float *samples, size_t n, float *sum_sq, float *peak);
+    void (*interleave)(float *out, const float *left, const float *right, size_t n);
+    void (*deinterleave)(const float *in, float *left, float *right, size_t n);
+    float (*dot_product)(const float *a, const float *b, size_t n);
+};
+
+/// AVX2 + FMA table, nullptr when the file was not built with AVX2 enabled
+const NN_MixKernelTable_t *nn_mix_kernels_avx2_table();
+
+#endif // NOTE_NAGA_MIX_KERNELS_TABLE_H
@@ -0,0 +1,179 @@
+#include "note_naga_engine/audio/real_fft.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE__) || defined(_M_X64)
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace {
+
+/// Four butterflies of one stage: a' = a + w * b, b' = a - w * b
+inline void butterfly4(float *are, float *aim, float *bre, float *bim, const float *wre, const float *wim)
+{
+#if defined(__SSE__) || defined(_M_X64)
+    __m128 ar = _mm_loadu_ps(are), ai = _mm_loadu_ps(aim);
+    __m128 br = _mm_loadu_ps(bre), bi = _mm_loadu_ps(bim);
+    __m128 wr = _mm_loadu_ps(wre), wi = _mm_loadu_ps(wim);
+    __m128 tr = _mm_sub_ps(_mm_mul_ps(br, wr), _mm_mul_ps(bi, wi));
+    __m128 ti = _mm_add_ps(_mm_mul_ps(br, wi), _mm_mul_ps(bi, wr));
+    _mm_storeu_ps(bre, _mm_sub_ps(ar, tr));
+    _mm_storeu_ps(bim, _mm_sub_ps(ai, ti));
+    _mm_storeu_ps(are, _mm_add_ps(ar, tr));
+    _mm_storeu_ps(aim, _mm_add_ps(ai, ti));
+#elif defined(__ARM_NEON)
+    float32x4_t ar = vld1q_f32(are), ai = vld1q_f32(aim);
+    float32x4_t br = vld1q_f32(bre), bi = vld1q_f32(bim);
+    float32x4_t wr = vld1q_f32(wre), wi = vld1q_f32(wim);
+    float32x4_t tr = vmlsq_f32(vmulq_f32(br, wr), bi, wi);
+    float32x4_t ti = vmlaq_f32(vmulq_f32(br, wi), bi, wr);
+    vst1q_f32(bre, vsubq_f32(ar, tr));
+    vst1q_f32(bim, vsubq_f32(ai, ti));
+    vst1q_f32(are, vaddq_f32(ar, tr));
+    vst1q_f32(aim, vaddq_f32(ai, ti));
+#else
+    for (int k = 0; k < 4; ++k) {
+        float tr = bre[k] * wre[k] - bim[k] * wim[k];
+        float ti = bre[k] * wim[k] + bim[k] * wre[k];
+        bre[k] = are[k] - tr;
+        bim[k] = aim[k] - ti;
+        are[k] += tr;
+        aim[k] += ti;
+    }
+#endif
+}
+
+} // namespace
+
+NoteNagaRealFFT::NoteNagaRealFFT(size_t size)
+{
+    size_ = 4;
+    while (size_ < size) size_ <<= 1;
+    half_ = size_ / 2;
+
+    int bits = 0;
+    while ((size_t(1) << bits) < half_) ++bits;
+    bitrev_.resize(half_);
+    for (size_t i = 0; i < half_; ++i) {
+        size_t r = 0;
+        for (int b = 0; b < bits; ++b) {
+            if (i & (size_t(1) << b)) r |= size_t(1) << (bits - 1 - b);
+        }
+        bitrev_[i] = r;
+    }
+
+    // Twiddles of the stage with butterfly span h: exp(-2 pi i j / (2h)), j < h
+    tw_re_.assign(half_, 0.0f);
+    tw_im_.assign(half_, 0.0f);
+    for (size_t h = 1; h < half_; h <<= 1) {
+        for (size_t j = 0; j < h; ++j) {
+            double angle = -M_PI * double(j) / double(h);
+            tw_re_[h + j] = float(std::cos(angle));
+            tw_im_[h + j] = float(std::sin(angle));
+        }
+    }
+
+    split_re_.resize(half_);
+    split_im_.resize(half_);
+    for (size_t k = 0; k < half_; ++k) {
+        double angle = -2.0 * M_PI * double(k) / double(size_);
+        split_re_[k] = float(std::cos(angle));
+        split_im_[k] = float(std::sin(angle));
+    }
+
+    work_re_.assign(half_, 0.0f);
+    work_im_.assign(half_, 0.0f);
+}
+
+void NoteNagaRealFFT::transform(const float *input)
+{
+    float *re = work_re_.data();
+    float *im = work_im_.data();
+
+    // Pack even/odd samples as complex values, already in bit reversed order
+    for (size_t k = 0; k < half_; ++k) {
+        re[bitrev_[k]] = input[2 * k];
+        im[bitrev_[k]] = input[2 * k + 1];
+    }
+
+    // First two stages have trivial twiddles (1 and -i)
+    for (size_t i = 0; i < half_; i += 2) {
+        float ar = re[i], ai = im[i];
+        re[i] = ar + re[i + 1];
+        im[i] = ai + im[i + 1];
+        re[i + 1] = ar - re[i + 1];
+        im[i + 1] = ai - im[i + 1];
+    }
+    if (half_ >= 4) {
+        for (size_t i = 0; i < half_; i += 4) {
+            float ar = re[i], ai = im[i];
+            re[i] = ar + re[i + 2];
+            im[i] = ai + im[i + 2];
+            re[i + 2] = ar - re[i + 2];
+            im[i + 2] = ai - im[i + 2];
+            // w = -i: w * b = (b.im, -b.re)
+            float br = re[i + 3], bi = im[i + 3];
+            float cr = re[i + 1], ci = im[i + 1];
+            re[i + 1] = cr + bi;
+            im[i + 1] = ci - br;
+            re[i + 3] = cr - bi;
+            im[i + 3] = ci + br;
+        }
+    }
+
+    // Remaining stages, four butterflies at a time
+    for (size_t h = 4; h < half_; h <<= 1) {
+        const float *wre = tw_re_.data() + h;
+        const float *wim = tw_im_.data() + h;
+        for (size_t i = 0; i < half_; i += 2 * h) {
+            for (size_t j = 0; j < h; j += 4) {
+                butterfly4(re + i + j, im + i + j, re + i + j + h, im + i + j + h, wre + j, wim + j);
+            }
+        }
+    }
+}
+
+void NoteNagaRealFFT::forward(const float *input, float *out_re, float *out_im)
+{
+    transform(input);
+    const float *re = work_re_.data();
+    const float *im = work_im_.data();
+
+    // X[k] = E[k] - i W^k D[k], E/D = (Z[k] +/- conj(Z[N/2 - k])) / 2
+    out_re[0] = re[0] + im[0];
+    out_im[0] = 0.0f;
+    out_re[half_] = re[0] - im[0];
+    out_im[half_] = 0.0f;
+    for (size_t k = 1; k < half_; ++k) {
+        float zr = re[k], zi = im[k];
+        float cr = re[half_ - k], ci = -im[half_ - k];
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        float dr = 0.5f * (zr - cr), di = 0.5f * (zi - ci);
+        float pr = split_re_[k] * dr - split_im_[k] * di;
+        float pi = split_re_[k] * di + split_im_[k] * dr;
+        out_re[k] = er + pi;
+        out_im[k] = ei - pr;
+    }
+}
+
+void NoteNagaRealFFT::magnitudes(const float *input, float *out)
+{
+    transform(input);
+    const float *re = work_re_.data();
+    const float *im = work_im_.data();
+
+    out[0] = std::fabs(re[0] + im[0]);
+    for (size_t k = 1; k < half_; ++k) {
+        float zr = re[k], zi = im[k];
+        float cr = re[half_ - k], ci = -im[half_ - k];
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        float dr = 0.5f * (zr - cr), di = 0.5f * (zi - ci);
+        float pr = split_re_[k] * dr - split_im_[k] * di;
+        float pi = split_re_[k] * di + split_im_[k] * dr;
+        float xr = er + pi, xi = ei - pr;
+        out[k] = std::sqrt(xr * xr + xi * xi);
+    }
+}
@@ -0,0 +1,186 @@
+#include "note_naga_engine/audio/resampler.h"
+
+#include "note_naga_engine/audio/mix_kernels.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+// Rows are precomputed per output phase up to this count, otherwise the filter
+// is interpolated from a table of this resolution
+constexpr int64_t MAX_EXACT_PHASES = 1024;
+constexpr int INTERPOLATED_PHASES = 512;
+
+/// Zeroth-order modified Bessel function (Kaiser window)
+double besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+    for (int k = 1; k < 64; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+/// floor(a / b) for b > 0
+inline int64_t floorDiv(int64_t a, int64_t b)
+{
+    int64_t q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+} // namespace
+
+NoteNagaResampler::NoteNagaResampler(int inputRate, int outputRate, NN_ResamplerQuality_t quality)
+    : inputRate_(std::max(1, inputRate)), outputRate_(std::max(1, outputRate)), quality_(quality)
+{
+    int64_t g = std::gcd<int64_t>(inputRate_, outputRate_);
+    up_ = outputRate_ / g;
+    down_ = inputRate_ / g;
+
+    double cutoff = 1.0;
+    double beta = 0.0;
+    switch (quality_) {
+    case NN_ResamplerQuality_t::Linear:
+        halfTaps_ = 1;
+        break;
+    case NN_ResamplerQuality_t::Fast:
+        halfTaps_ = 8;
+        cutoff = 0.85;
+        beta = 6.0;
+        break;
+    case NN_ResamplerQuality_t::Standard:
+        halfTaps_ = 24;
+        cutoff = 0.92;
+        beta = 8.0;
+        break;
+    case NN_ResamplerQuality_t::High:
+        halfTaps_ = 48;
+        cutoff = 0.95;
+        beta = 10.0;
+        break;
+    }
+    taps_ = halfTaps_ * 2;
+
+    // Anti-aliasing: cutoff at the lower of the two Nyquist frequencies
+    if (outputRate_ < inputRate_) {
+        cutoff *= static_cast<double>(outputRate_) / inputRate_;
+    }
+
+    exactPhases_ = (up_ <= MAX_EXACT_PHASES);
+    phases_ = exactPhases_ ? static_cast<int>(up_) : INTERPOLATED_PHASES;
+    buildTable(cutoff, beta);
+}
+
+void NoteNagaResampler::buildTable(double cutoff, double beta)
+{
+    // Linear interpolation only needs 2 taps, pad rows to a multiple of 8 for the SIMD dot product
+    const int rowTaps = taps_;
+    taps_ = (rowTaps + 7) / 8 * 8;
+    coeffs_.assign(static_cast<size_t>(phases_ + 1) * taps_, 0.0f);
+
+    const double pi = 3.14159265358979323846;
+    const double i0Beta = besselI0(beta);
+
+    for (int p = 0; p <= phases_; ++p) {
+        double frac = static_cast<double>(p) / phases_;
+        float *row = coeffs_.data() + static_cast<size_t>(p) * taps_;
+
+        // Tap k multiplies input frame (center - halfTaps_ + 1 + k)
+        double sum = 0.0;
+        for (int k = 0; k < rowTaps; ++k) {
+            double t = (k - halfTaps_ + 1) - frac;
+            double h;
+            if (quality_ == NN_ResamplerQuality_t::Linear) {
+                h = std::max(0.0, 1.0 - std::fabs(t));
+            }
+            else {
+                double x = t / halfTaps_;
+                if (std::fabs(x) > 1.0) {
+                    h = 0.0;
+                }
+                else {
+                    double sinc = (t == 0.0) ? 1.0 : std::sin(pi * cutoff * t) / (pi * cutoff * t);
+                    h = cutoff * sinc * besselI0(beta * std::sqrt(1.0 - x * x)) / i0Beta;
+                }
+            }
+            row[k] = static_cast<float>(h);
+            sum += h;
+        }
+
+        // Unity DC gain for every phase
+        if (sum != 0.0) {
+            for (int k = 0; k < rowTaps; ++k) {
+                row[k] = static_cast<float>(row[k] / sum);
+            }
+        }
+    }
+}
+
+int64_t NoteNagaResampler::getOutputLength(int64_t inputFrames) const
+{
+    return inputFrames > 0 ? (inputFrames * up_) / down_ : 0;
+}
+
+void NoteNagaResampler::getInputRange(int64_t outputStart, int64_t outputCount,
+                                      int64_t &inputFirst, int64_t &inputCount) const
+{
+    if (outputCount <= 0) {
+        inputFirst = floorDiv(outputStart * down_, up_);
+        inputCount = 0;
+        return;
+    }
+    int64_t firstCenter = floorDiv(outputStart * down_, up_);
+    int64_t lastCenter = floorDiv((outputStart + outputCount - 1) * down_, up_);
+    inputFirst = firstCenter - halfTaps_ + 1;
+    inputCount = (lastCenter - firstCenter) + taps_;
+}
+
+void NoteNagaResampler::process(const float *input, int64_t inputFirst,
+                                int64_t outputStart, int64_t outputCount, float *output) const
+{
+    if (outputCount <= 0) return;
+
+    // Position of the first output sample in input frames: center + phase / up_
+    int64_t pos = outputStart * down_;
+    int64_t center = floorDiv(pos, up_);
+    int64_t phase = pos - center * up_;
+    const int64_t centerStep = down_ / up_;
+    const int64_t phaseStep = down_ % up_;
+    const float *window = input + (center - halfTaps_ + 1 - inputFirst);
+
+    if (exactPhases_) {
+        for (int64_t i = 0; i < outputCount; ++i) {
+            output[i] = nn_dot_product(window, coeffs_.data() + phase * taps_, taps_);
+            window += centerStep;
+            phase += phaseStep;
+            if (phase >= up_) {
+                phase -= up_;
+                ++window;
+            }
+        }
+        return;
+    }
+
+    // Irreducible ratio with too many phases: blend the two nearest table rows
+    const double phaseScale = static_cast<double>(phases_) / up_;
+    for (int64_t i = 0; i < outputCount; ++i) {
+        double rowPos = phase * phaseScale;
+        int row = static_cast<int>(rowPos);
+        float blend = static_cast<float>(rowPos - row);
+        float a = nn_dot_product(window, coeffs_.data() + static_cast<size_t>(row) * taps_, taps_);
+        float b = nn_dot_product(window, coeffs_.data() + static_cast<size_t>(row + 1) * taps_, taps_);
+        output[i] = a + (b - a) * blend;
+        window += centerStep;
+        phase += phaseStep;
+        if (phase >= up_) {
+            phase -= up_;
+            ++window;
+        }
+    }
+}
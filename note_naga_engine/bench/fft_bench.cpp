@@ -0,0 +1,107 @@
+/*
+ * Magnitude spectrum of one analyzer frame: the complex nn_fft() path the spectrum analyzer used
+ * before (real samples packed into a fresh complex vector, N-point transform) versus the planned
+ * real-input FFT (note_naga_engine/audio/real_fft.h, N/2-point transform and split, no
+ * allocation).
+ *
+ * Both paths get the same windowed frame. The error column compares each result with a
+ * double precision DFT of that frame, relative to the largest bin. Built only with
+ * -DNOTE_NAGA_BUILD_BENCHMARKS=ON, run without arguments.
+ */
+
+#include <note_naga_engine/audio/real_fft.h>
+#include <note_naga_engine/core/types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr size_t kTotalSamples = size_t(1) << 24; ///< Samples per measurement (iterations = this / N)
+
+/// Hann windowed mix of three sines with some noise, like a frame of music
+std::vector<float> makeFrame(size_t n) {
+    std::vector<float> frame(n);
+    uint32_t seed = 12345;
+    for (size_t i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        const double noise = (double(seed >> 8) / double(1u << 24) - 0.5) * 0.01;
+        const double t = double(i);
+        const double x = 0.5 * std::sin(0.031 * t) + 0.25 * std::sin(0.173 * t) + 0.1 * std::sin(1.91 * t) + noise;
+        const double window = 0.5 * (1.0 - std::cos(2.0 * M_PI * t / double(n - 1)));
+        frame[i] = float(x * window);
+    }
+    return frame;
+}
+
+/// The analyzer's previous path: pack, complex FFT, magnitudes
+void magnitudesComplex(const std::vector<float> &frame, std::vector<float> &out) {
+    std::vector<std::complex<float>> fft_in(frame.size());
+    for (size_t i = 0; i < frame.size(); ++i) fft_in[i] = std::complex<float>(frame[i], 0.0f);
+    nn_fft(fft_in);
+    for (size_t k = 0; k < frame.size() / 2; ++k) out[k] = std::abs(fft_in[k]);
+}
+
+std::vector<double> magnitudesReference(const std::vector<float> &frame) {
+    const size_t n = frame.size();
+    std::vector<double> out(n / 2);
+    for (size_t k = 0; k < n / 2; ++k) {
+        std::complex<double> sum = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const double angle = -2.0 * M_PI * double((k * i) % n) / double(n);
+            sum += double(frame[i]) * std::complex<double>(std::cos(angle), std::sin(angle));
+        }
+        out[k] = std::abs(sum);
+    }
+    return out;
+}
+
+double maxError(const std::vector<float> &result, const std::vector<double> &reference) {
+    const double scale = *std::max_element(reference.begin(), reference.end());
+    double error = 0.0;
+    for (size_t k = 0; k < reference.size(); ++k) error = std::max(error, std::fabs(result[k] - reference[k]));
+    return error / scale;
+}
+
+/**
+ * @brief Average microseconds per frame.
+ */
+template <typename Fn> double measure(size_t n, Fn &&fn) {
+    const int iterations = static_cast<int>(std::max<size_t>(1, kTotalSamples / n));
+    fn(); // warm up
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) fn();
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+}
+
+} // namespace
+
+int main() {
+    std::printf("Magnitude spectrum of one frame, nn_fft (complex) vs NoteNagaRealFFT\n");
+    for (size_t n : {size_t(1024), size_t(2048), size_t(4096), size_t(8192)}) {
+        const std::vector<float> frame = makeFrame(n);
+        std::vector<float> complex_mag(n / 2), real_mag(n / 2);
+        NoteNagaRealFFT fft(n);
+        volatile float sink = 0.0f;
+
+        const double complex_us = measure(n, [&]() {
+            magnitudesComplex(frame, complex_mag);
+            sink = sink + complex_mag[n / 4];
+        });
+        const double real_us = measure(n, [&]() {
+            fft.magnitudes(frame.data(), real_mag.data());
+            sink = sink + real_mag[n / 4];
+        });
+
+        const std::vector<double> reference = magnitudesReference(frame);
+        std::printf("N=%5zu: nn_fft %8.2f us (error %.1e), real FFT %8.2f us (error %.1e), %.1fx\n", n, complex_us,
+                    maxError(complex_mag, reference), real_us, maxError(real_mag, reference), complex_us / real_us);
+    }
+    return 0;
+}
@@ -0,0 +1,131 @@
+/*
+ * Per-block cost of the arrangement mix path: the previous per-sample scalar loop versus the
+ * vectorized mix kernels (note_naga_engine/audio/mix_kernels.h).
+ *
+ * Every track of a block gets a fade envelope, volume, pan crossfeed and metering and is mixed
+ * into the master bus, which is interleaved at the end. Built only with
+ * -DNOTE_NAGA_BUILD_BENCHMARKS=ON, run without arguments.
+ */
+
+#include <note_naga_engine/audio/mix_kernels.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr size_t kBlockFrames = 512;
+constexpr int kTotalTrackBlocks = 200000; ///< Track blocks per measurement (iterations = this / tracks)
+
+// Clip placement relative to the block: inside the fade in and the fade out at once
+constexpr int64_t kBlockStart = 1000;
+constexpr int64_t kClipStart = 900;
+constexpr int64_t kFadeIn = 400;
+constexpr int64_t kClipEnd = 1400;
+constexpr int64_t kFadeOut = 300;
+
+constexpr float kVolume = 0.8f;
+constexpr float kPanLeft = 0.9f;
+constexpr float kPanRight = 0.4f;
+
+struct Meter {
+    float sum_sq_left = 0.0f;
+    float sum_sq_right = 0.0f;
+    float peak_left = 0.0f;
+    float peak_right = 0.0f;
+};
+
+/// The per-sample loop the engine used before the kernels
+void processTrackScalar(float *left, float *right, size_t n, Meter &meter) {
+    for (size_t i = 0; i < n; ++i) {
+        const int64_t pos = kBlockStart + static_cast<int64_t>(i);
+        float gain = 1.0f;
+        if (pos < kClipStart + kFadeIn) {
+            gain = std::clamp(float(pos - kClipStart) / float(kFadeIn), 0.0f, 1.0f);
+        }
+        if (pos >= kClipEnd - kFadeOut) {
+            gain *= std::clamp(float(kClipEnd - pos) / float(kFadeOut), 0.0f, 1.0f);
+        }
+        const float l = left[i] * kVolume * gain;
+        const float r = right[i] * kVolume * gain;
+        left[i] = l * kPanLeft + r * (1.0f - kPanRight);
+        right[i] = r * kPanRight + l * (1.0f - kPanLeft);
+        meter.sum_sq_left += left[i] * left[i];
+        meter.sum_sq_right += right[i] * right[i];
+        meter.peak_left = std::max(meter.peak_left, std::fabs(left[i]));
+        meter.peak_right = std::max(meter.peak_right, std::fabs(right[i]));
+    }
+}
+
+void processTrackKernels(float *left, float *right, size_t n, Meter &meter) {
+    const NN_FadeRamp_t ramp = NN_FadeRamp_t::forBlock(kBlockStart, n, kClipStart, kFadeIn, kClipEnd, kFadeOut);
+    nn_apply_gain(left, right, n, kVolume, kVolume, ramp);
+    nn_pan_crossfeed(left, right, n, kPanLeft, kPanRight);
+    nn_sum_squares_peak(left, n, meter.sum_sq_left, meter.peak_left);
+    nn_sum_squares_peak(right, n, meter.sum_sq_right, meter.peak_right);
+}
+
+/**
+ * @brief Average microseconds per block for a number of tracks.
+ */
+double measure(int tracks, bool use_kernels) {
+    const size_t n = kBlockFrames;
+    std::vector<float> source(n);
+    for (size_t i = 0; i < n; ++i) source[i] = std::sin(float(i) * 0.01f);
+
+    std::vector<float> left(n), right(n), master_left(n), master_right(n), out(2 * n);
+    const int iterations = kTotalTrackBlocks / tracks;
+    volatile float sink = 0.0f;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    for (int it = 0; it < iterations; ++it) {
+        std::fill(master_left.begin(), master_left.end(), 0.0f);
+        std::fill(master_right.begin(), master_right.end(), 0.0f);
+        for (int t = 0; t < tracks; ++t) {
+            // Fresh track audio, as rendered by the synth
+            std::copy(source.begin(), source.end(), left.begin());
+            std::copy(source.begin(), source.end(), right.begin());
+            Meter meter;
+            if (use_kernels) {
+                processTrackKernels(left.data(), right.data(), n, meter);
+                nn_mix_add(master_left.data(), left.data(), n);
+                nn_mix_add(master_right.data(), right.data(), n);
+            } else {
+                processTrackScalar(left.data(), right.data(), n, meter);
+                for (size_t i = 0; i < n; ++i) {
+                    master_left[i] += left[i];
+                    master_right[i] += right[i];
+                }
+            }
+            sink = sink + meter.sum_sq_left + meter.peak_right;
+        }
+        if (use_kernels) {
+            nn_interleave(out.data(), master_left.data(), master_right.data(), n);
+        } else {
+            for (size_t i = 0; i < n; ++i) {
+                out[2 * i] = master_left[i];
+                out[2 * i + 1] = master_right[i];
+            }
+        }
+        sink = sink + out[n];
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(t1 - t0).count() / iterations;
+}
+
+} // namespace
+
+int main() {
+    std::printf("Mix path, %zu-frame block, kernels: %s\n", kBlockFrames, nn_mix_kernels_isa());
+    for (int tracks : {1, 16, 64}) {
+        measure(tracks, false); // warm up
+        const double scalar_us = measure(tracks, false);
+        const double kernel_us = measure(tracks, true);
+        std::printf("%3d tracks: scalar %8.2f us/block, kernels %8.2f us/block (%.1fx)\n", tracks, scalar_us,
+                    kernel_us, scalar_us / kernel_us);
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Quality and speed of the polyphase sample rate converter (note_naga_engine/audio/resampler.h).
+ *
+ * A 1 kHz sine is converted between common rates at every quality level. THD+N is the power of
+ * everything but the fitted 1 kHz component relative to that component, measured away from the
+ * signal edges. Throughput converts a long signal in 4096-sample chunks, like the import and the
+ * disk streaming do. The filter taps run on the dot product kernel picked at runtime (see
+ * nn_mix_kernels_isa()). Built only with -DNOTE_NAGA_BUILD_BENCHMARKS=ON, run without arguments.
+ */
+
+#include <note_naga_engine/audio/mix_kernels.h>
+#include <note_naga_engine/audio/resampler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr double kToneHz = 1000.0;
+constexpr double kAmplitude = 0.5;
+constexpr int64_t kQualityFrames = 1 << 16;    ///< Input length of the THD+N measurement
+constexpr int64_t kThroughputFrames = 1 << 21; ///< Input length of the throughput measurement
+constexpr int64_t kChunk = 4096;               ///< Output samples per process() call
+
+struct Conversion {
+    int input_rate;
+    int output_rate;
+};
+
+struct Quality {
+    NN_ResamplerQuality_t quality;
+    const char *name;
+};
+
+const Conversion kConversions[] = {{44100, 48000}, {48000, 44100}, {96000, 44100}, {22050, 48000}};
+const Quality kQualities[] = {{NN_ResamplerQuality_t::Linear, "linear"},
+                              {NN_ResamplerQuality_t::Fast, "fast"},
+                              {NN_ResamplerQuality_t::Standard, "standard"},
+                              {NN_ResamplerQuality_t::High, "high"}};
+
+std::vector<float> sine(int rate, int64_t frames) {
+    std::vector<float> out(static_cast<size_t>(frames));
+    for (int64_t i = 0; i < frames; ++i) {
+        out[i] = float(kAmplitude * std::sin(2.0 * M_PI * kToneHz * double(i) / rate));
+    }
+    return out;
+}
+
+/**
+ * @brief Convert a whole signal chunk by chunk, frames outside of it are zero.
+ */
+std::vector<float> convert(const NoteNagaResampler &resampler, const std::vector<float> &input) {
+    const int64_t input_frames = static_cast<int64_t>(input.size());
+    const int64_t output_frames = resampler.getOutputLength(input_frames);
+    std::vector<float> output(static_cast<size_t>(output_frames));
+    std::vector<float> window;
+    for (int64_t start = 0; start < output_frames; start += kChunk) {
+        const int64_t count = std::min(kChunk, output_frames - start);
+        int64_t first = 0, needed = 0;
+        resampler.getInputRange(start, count, first, needed);
+        window.assign(static_cast<size_t>(needed), 0.0f);
+        const int64_t from = std::max<int64_t>(first, 0);
+        const int64_t to = std::min(first + needed, input_frames);
+        if (to > from) std::copy(input.begin() + from, input.begin() + to, window.begin() + (from - first));
+        resampler.process(window.data(), first, start, count, output.data() + start);
+    }
+    return output;
+}
+
+/**
+ * @brief THD+N in dB: least squares fit of the tone, the residual is distortion and noise.
+ */
+double thdN(const std::vector<float> &signal, int rate) {
+    // Skip the filter run-in at both ends
+    const size_t margin = signal.size() / 8;
+    const size_t begin = margin;
+    const size_t end = signal.size() - margin;
+
+    double ss = 0.0, cc = 0.0, sc = 0.0, ys = 0.0, yc = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        const double phase = 2.0 * M_PI * kToneHz * double(i) / rate;
+        const double s = std::sin(phase), c = std::cos(phase);
+        ss += s * s;
+        cc += c * c;
+        sc += s * c;
+        ys += signal[i] * s;
+        yc += signal[i] * c;
+    }
+    const double det = ss * cc - sc * sc;
+    const double a = (ys * cc - yc * sc) / det;
+    const double b = (yc * ss - ys * sc) / det;
+
+    double tone = 0.0, residual = 0.0;
+    for (size_t i = begin; i < end; ++i) {
+        const double phase = 2.0 * M_PI * kToneHz * double(i) / rate;
+        const double fit = a * std::sin(phase) + b * std::cos(phase);
+        tone += fit * fit;
+        residual += (signal[i] - fit) * (signal[i] - fit);
+    }
+    return 10.0 * std::log10(std::max(residual, 1e-30) / tone);
+}
+
+/**
+ * @brief Output samples per second (millions) of a chunked conversion.
+ */
+double throughput(const NoteNagaResampler &resampler, const std::vector<float> &input) {
+    convert(resampler, input); // warm up
+    const auto t0 = std::chrono::steady_clock::now();
+    const std::vector<float> output = convert(resampler, input);
+    const auto t1 = std::chrono::steady_clock::now();
+    volatile float sink = output[output.size() / 2];
+    (void)sink;
+    return double(output.size()) / std::chrono::duration<double>(t1 - t0).count() / 1e6;
+}
+
+} // namespace
+
+int main() {
+    std::printf("Resampler, %.0f Hz sine at %.1f, dot product kernel: %s\n", kToneHz, kAmplitude,
+                nn_mix_kernels_isa());
+    for (const Conversion &conv : kConversions) {
+        const std::vector<float> short_input = sine(conv.input_rate, kQualityFrames);
+        const std::vector<float> long_input = sine(conv.input_rate, kThroughputFrames);
+        std::printf("%6d -> %6d Hz\n", conv.input_rate, conv.output_rate);
+        for (const Quality &q : kQualities) {
+            NoteNagaResampler resampler(conv.input_rate, conv.output_rate, q.quality);
+            const double distortion = thdN(convert(resampler, short_input), conv.output_rate);
+            const double speed = throughput(resampler, long_input);
+            std::printf("  %-8s %3d taps: THD+N %7.1f dB, %8.1f Msamples/s\n", q.name, resampler.getTaps(),
+                        distortion, speed);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#include <note_naga_engine/core/arrangement_render_plan.h>
+
+#include <note_naga_engine/core/runtime_data.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+const NoteNagaArrangementRenderPlan::Segment *NoteNagaArrangementRenderPlan::SynthEntry::segmentAt(int tick) {
+    if (segments.empty()) return nullptr;
+    size_t n = segments.size();
+    if (cursor >= n) cursor = 0;
+
+    // Fast path: same segment or the next one (regular playback)
+    if (tick < segments[cursor].start_tick ||
+        (cursor + 1 < n && tick >= segments[cursor + 1].start_tick)) {
+        if (cursor + 1 < n && tick >= segments[cursor + 1].start_tick &&
+            (cursor + 2 >= n || tick < segments[cursor + 2].start_tick)) {
+            ++cursor;
+        } else {
+            // Seek: last segment starting at or before tick
+            auto it = std::upper_bound(segments.begin(), segments.end(), tick,
+                                       [](int t, const Segment &s) { return t < s.start_tick; });
+            if (it == segments.begin()) {
+                cursor = 0;
+                return nullptr;
+            }
+            cursor = size_t(std::distance(segments.begin(), it)) - 1;
+        }
+    }
+
+    const Segment &seg = segments[cursor];
+    return (tick >= seg.start_tick && tick < seg.end_tick) ? &seg : nullptr;
+}
+
+void NoteNagaArrangementRenderPlan::resetFadeState() {
+    for (auto &entry : synths_) {
+        entry.fade_out_end_sample.store(0, std::memory_order_relaxed);
+        entry.fade_out_samples.store(0, std::memory_order_relaxed);
+    }
+}
+
+NoteNagaArrangementRenderPlan *NoteNagaArrangementRenderPlan::build(NoteNagaRuntimeData *runtime_data,
+                                                                    const NoteNagaArrangementRenderPlan *previous) {
+    NoteNagaArrangementRenderPlan *plan = new NoteNagaArrangementRenderPlan();
+    if (!runtime_data) return plan;
+
+    // Collect all synths of all sequences (they may still be releasing notes even
+    // when no clip is active), in project order
+    std::vector<INoteNagaSoftSynth *> synths;
+    std::unordered_map<INoteNagaSoftSynth *, size_t> synthIndex;
+    for (NoteNagaMidiSeq *seq : runtime_data->getSequences()) {
+        if (!seq) continue;
+        for (NoteNagaTrack *midiTrack : seq->getTracks()) {
+            if (!midiTrack || midiTrack->isTempoTrack()) continue;
+            INoteNagaSoftSynth *softSynth = midiTrack->getSoftSynth();
+            if (softSynth && synthIndex.emplace(softSynth, synths.size()).second) {
+                synths.push_back(softSynth);
+            }
+        }
+    }
+
+    // Candidate ownership intervals per synth. Later candidates win on overlap
+    // (same priority as the former per-block clip scan).
+    struct Candidate {
+        Segment seg;
+        size_t priority;
+    };
+    std::vector<std::vector<Candidate>> candidates(synths.size());
+    size_t priority = 0;
+
+    NoteNagaArrangement *arrangement = runtime_data->getArrangement();
+    if (arrangement) {
+        for (NoteNagaArrangementTrack *arrTrack : arrangement->getTracks()) {
+            if (!arrTrack) continue;
+            int arrTrackIndex = int(plan->arr_tracks_.size());
+            plan->arr_tracks_.push_back(arrTrack);
+
+            for (const NN_MidiClip_t &clip : arrTrack->getClips()) {
+                if (clip.muted || clip.durationTicks <= 0) continue;
+                NoteNagaMidiSeq *seq = runtime_data->getSequenceById(clip.sequenceId);
+                if (!seq) continue;
+
+                Segment seg;
+                seg.start_tick = clip.startTick;
+                seg.end_tick = clip.getEndTick();
+                seg.arr_track_index = arrTrackIndex;
+                seg.clip_start_tick = clip.startTick;
+                seg.clip_end_tick = clip.getEndTick();
+                seg.fade_in_ticks = clip.fadeInTicks;
+                seg.fade_out_ticks = clip.fadeOutTicks;
+
+                for (NoteNagaTrack *midiTrack : seq->getTracks()) {
+                    if (!midiTrack || midiTrack->isTempoTrack()) continue;
+                    auto it = synthIndex.find(midiTrack->getSoftSynth());
+                    if (it == synthIndex.end()) continue;
+                    candidates[it->second].push_back({seg, priority++});
+                }
+            }
+        }
+    }
+
+    // Flatten candidates into non-overlapping segments (highest priority wins)
+    plan->synths_ = std::vector<SynthEntry>(synths.size());
+    for (size_t s = 0; s < synths.size(); ++s) {
+        SynthEntry &entry = plan->synths_[s];
+        entry.synth = synths[s];
+
+        const auto &cands = candidates[s];
+        if (cands.empty()) continue;
+
+        std::vector<int> bounds;
+        bounds.reserve(cands.size() * 2);
+        for (const auto &c : cands) {
+            bounds.push_back(c.seg.start_tick);
+            bounds.push_back(c.seg.end_tick);
+        }
+        std::sort(bounds.begin(), bounds.end());
+        bounds.erase(std::unique(bounds.begin(), bounds.end()), bounds.end());
+
+        const Candidate *prevWinner = nullptr;
+        for (size_t b = 0; b + 1 < bounds.size(); ++b) {
+            int from = bounds[b];
+            int to = bounds[b + 1];
+            const Candidate *winner = nullptr;
+            for (const auto &c : cands) {
+                if (from >= c.seg.start_tick && from < c.seg.end_tick &&
+                    (!winner || c.priority > winner->priority)) {
+                    winner = &c;
+                }
+            }
+            if (!winner) {
+                prevWinner = nullptr;
+                continue;
+            }
+            if (winner == prevWinner && !entry.segments.empty() && entry.segments.back().end_tick == from) {
+                entry.segments.back().end_tick = to;
+            } else {
+                Segment seg = winner->seg;
+                seg.start_tick = from;
+                seg.end_tick = to;
+                entry.segments.push_back(seg);
+            }
+            prevWinner = winner;
+        }
+    }
+
+    // Carry over fade-out state of synths which are still releasing
+    if (previous) {
+        std::unordered_map<INoteNagaSoftSynth *, const SynthEntry *> previousEntries;
+        for (const auto &old : previous->synths_) previousEntries[old.synth] = &old;
+        for (auto &entry : plan->synths_) {
+            auto it = previousEntries.find(entry.synth);
+            if (it == previousEntries.end()) continue;
+            entry.fade_out_end_sample.store(it->second->fade_out_end_sample.load(std::memory_order_relaxed),
+                                            std::memory_order_relaxed);
+            entry.fade_out_samples.store(it->second->fade_out_samples.load(std::memory_order_relaxed),
+                                         std::memory_order_relaxed);
+        }
+    }
+
+    plan->track_levels.assign(plan->arr_tracks_.size(), NN_BlockLevels_t{});
+    return plan;
+}
@@ -0,0 +1,261 @@
+#include <note_naga_engine/core/arrangement_scheduler.h>
+
+#include <note_naga_engine/core/runtime_data.h>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace {
+
+/// First tick >= lo of the series base + pos + k * length (k >= 0), assumes lo >= base
+inline int firstOccurrence(int base, int pos, int length, int lo) {
+    int d = lo - base - pos;
+    int k = (d > 0) ? (d + length - 1) / length : 0;
+    return base + pos + k * length;
+}
+
+/// Order key of a note event inside one clip (StopSequence uses 0 and goes first)
+inline uint64_t noteOrderKey(size_t track_index, size_t note_index, bool note_off) {
+    return ((uint64_t(track_index) + 1) << 32) | (uint64_t(note_index) * 2 + (note_off ? 1 : 0));
+}
+
+} // namespace
+
+NoteNagaArrangementScheduler::NoteNagaArrangementScheduler(NoteNagaRuntimeData *runtime_data)
+    : runtime_data_(runtime_data) {}
+
+void NoteNagaArrangementScheduler::invalidateAll() { invalidate_all_.store(true, std::memory_order_release); }
+
+void NoteNagaArrangementScheduler::invalidateSequence(int sequence_id) {
+    std::lock_guard<std::mutex> lock(pending_mutex_);
+    pending_sequences_.push_back(sequence_id);
+}
+
+bool NoteNagaArrangementScheduler::update(bool deep_check) {
+    bool invalidateAll = invalidate_all_.exchange(false, std::memory_order_acq_rel);
+    std::vector<int> invalidated;
+    {
+        std::lock_guard<std::mutex> lock(pending_mutex_);
+        invalidated.swap(pending_sequences_);
+    }
+
+    bool changed = false;
+
+    // Clip layout changed: rebuild the block list, keeping blocks of unchanged clips
+    if (invalidateAll || !layoutMatches()) {
+        std::unordered_map<int, ClipBlock *> previous;
+        if (!invalidateAll) {
+            for (ClipBlock &block : blocks_) previous[block.clip_id] = &block;
+        }
+
+        std::vector<NoteNagaArrangementTrack *> arrTracks;
+        std::vector<ClipBlock> blocks;
+        NoteNagaArrangement *arrangement = runtime_data_ ? runtime_data_->getArrangement() : nullptr;
+        if (arrangement) {
+            for (NoteNagaArrangementTrack *arrTrack : arrangement->getTracks()) {
+                int arrTrackIndex = int(arrTracks.size());
+                arrTracks.push_back(arrTrack);
+                if (!arrTrack) continue;
+
+                for (const NN_MidiClip_t &clip : arrTrack->getClips()) {
+                    auto it = previous.find(clip.id);
+                    if (it != previous.end() && it->second->arr_track == arrTrack &&
+                        it->second->sequence_id == clip.sequenceId && it->second->start_tick == clip.startTick &&
+                        it->second->duration_ticks == clip.durationTicks &&
+                        it->second->offset_ticks == clip.offsetTicks && it->second->muted == clip.muted) {
+                        blocks.push_back(std::move(*it->second));
+                        blocks.back().arr_track_index = arrTrackIndex;
+                        for (NN_ArrangementEvent_t &ev : blocks.back().events) ev.arr_track_index = arrTrackIndex;
+                        previous.erase(it);
+                        continue;
+                    }
+
+                    ClipBlock block;
+                    block.arr_track = arrTrack;
+                    block.arr_track_index = arrTrackIndex;
+                    block.clip_id = clip.id;
+                    block.sequence_id = clip.sequenceId;
+                    block.start_tick = clip.startTick;
+                    block.duration_ticks = clip.durationTicks;
+                    block.offset_ticks = clip.offsetTicks;
+                    block.muted = clip.muted;
+                    block.sequence_length = -1; // Not compiled yet
+                    blocks.push_back(std::move(block));
+                }
+            }
+        }
+        arr_tracks_ = std::move(arrTracks);
+        blocks_ = std::move(blocks);
+        changed = true;
+    }
+
+    // Recompile clips whose sequence or notes changed
+    for (ClipBlock &block : blocks_) {
+        if (!blockIsCurrent(block, deep_check, invalidated)) {
+            compileBlock(block);
+            changed = true;
+        }
+    }
+
+    if (changed) {
+        mergeBlocks();
+        cursor_valid_ = false;
+    }
+    return changed;
+}
+
+void NoteNagaArrangementScheduler::seek(int tick) {
+    auto it = std::lower_bound(events_.begin(), events_.end(), tick,
+                               [](const NN_ArrangementEvent_t &ev, int t) { return ev.tick < t; });
+    cursor_ = size_t(std::distance(events_.begin(), it));
+    cursor_tick_ = tick - 1;
+    cursor_valid_ = true;
+}
+
+bool NoteNagaArrangementScheduler::layoutMatches() const {
+    NoteNagaArrangement *arrangement = runtime_data_ ? runtime_data_->getArrangement() : nullptr;
+    if (!arrangement) return arr_tracks_.empty() && blocks_.empty();
+    if (arrangement->getTracks() != arr_tracks_) return false;
+
+    size_t b = 0;
+    for (NoteNagaArrangementTrack *arrTrack : arr_tracks_) {
+        if (!arrTrack) continue;
+        for (const NN_MidiClip_t &clip : arrTrack->getClips()) {
+            if (b >= blocks_.size()) return false;
+            const ClipBlock &block = blocks_[b++];
+            if (block.arr_track != arrTrack || block.clip_id != clip.id || block.sequence_id != clip.sequenceId ||
+                block.start_tick != clip.startTick || block.duration_ticks != clip.durationTicks ||
+                block.offset_ticks != clip.offsetTicks || block.muted != clip.muted) {
+                return false;
+            }
+        }
+    }
+    return b == blocks_.size();
+}
+
+bool NoteNagaArrangementScheduler::blockIsCurrent(const ClipBlock &block, bool deep_check,
+                                                  const std::vector<int> &invalidated) const {
+    if (block.sequence_length < 0) return false;
+    NoteNagaMidiSeq *seq = runtime_data_->getSequenceById(block.sequence_id);
+    if (seq != block.sequence) return false;
+    if (!seq) return true;
+    if (seq->getMaxTick() != block.sequence_length) return false;
+    if (std::find(invalidated.begin(), invalidated.end(), block.sequence_id) != invalidated.end()) return false;
+
+    for (size_t i = 0; i < block.tracks.size(); ++i) {
+        if (block.tracks[i]->getNotesRevision() != block.notes_revisions[i]) return false;
+    }
+
+    if (deep_check) {
+        size_t i = 0;
+        for (NoteNagaTrack *track : seq->getTracks()) {
+            if (!track || track->isTempoTrack()) continue;
+            if (i >= block.tracks.size() || block.tracks[i] != track) return false;
+            ++i;
+        }
+        if (i != block.tracks.size()) return false;
+    }
+    return true;
+}
+
+void NoteNagaArrangementScheduler::compileBlock(ClipBlock &block) {
+    block.events.clear();
+    block.tracks.clear();
+    block.notes_revisions.clear();
+
+    NoteNagaMidiSeq *seq = runtime_data_->getSequenceById(block.sequence_id);
+    block.sequence = seq;
+    block.sequence_length = seq ? seq->getMaxTick() : 0;
+    if (!seq) return;
+
+    std::vector<NoteNagaTrack *> seqTracks = seq->getTracks();
+    for (NoteNagaTrack *track : seqTracks) {
+        if (!track || track->isTempoTrack()) continue;
+        block.tracks.push_back(track);
+        block.notes_revisions.push_back(track->getNotesRevision());
+    }
+
+    int length = block.sequence_length;
+    if (block.muted || length <= 0 || block.duration_ticks <= 0) return;
+
+    // Arrangement tick of sequence tick 0 in the first repeat; the clip plays
+    // sequence tick ((t - clipStart + offset) % length) at arrangement tick t
+    int clipStart = block.start_tick;
+    int clipEnd = block.start_tick + block.duration_ticks;
+    int base = clipStart - block.offset_ticks;
+    int lo = std::max(clipStart, base);
+
+    NN_ArrangementEvent_t ev;
+    ev.arr_track_index = block.arr_track_index;
+    ev.sequence = seq;
+
+    // Loop boundaries (sequence wrapped back to tick 0)
+    if (length > 1) {
+        ev.type = NN_ArrangementEventType_t::StopSequence;
+        ev.midi_track = nullptr;
+        ev.order = 0;
+        for (int t = firstOccurrence(base, length, length, lo); t < clipEnd; t += length) {
+            ev.tick = t;
+            block.events.push_back(ev);
+        }
+    }
+
+    for (size_t trackIndex = 0; trackIndex < seqTracks.size(); ++trackIndex) {
+        NoteNagaTrack *track = seqTracks[trackIndex];
+        if (!track || track->isTempoTrack()) continue;
+        ev.midi_track = track;
+
+        std::shared_ptr<const NN_NoteColumns_t> columns = track->getNoteColumns();
+        for (size_t noteIndex = 0; noteIndex < columns->size(); ++noteIndex) {
+            int noteStart = columns->start[noteIndex];
+            int noteEnd = noteStart + columns->length[noteIndex];
+            ev.note = columns->toNote(noteIndex, track);
+
+            if (noteStart >= 0 && noteStart < length) {
+                ev.type = NN_ArrangementEventType_t::NoteOn;
+                ev.order = noteOrderKey(trackIndex, noteIndex, false);
+                for (int t = firstOccurrence(base, noteStart, length, lo); t < clipEnd; t += length) {
+                    ev.tick = t;
+                    block.events.push_back(ev);
+                }
+            }
+
+            ev.type = NN_ArrangementEventType_t::NoteOff;
+            ev.order = noteOrderKey(trackIndex, noteIndex, true);
+            if (noteEnd >= 0 && noteEnd < length) {
+                for (int t = firstOccurrence(base, noteEnd, length, lo); t < clipEnd; t += length) {
+                    ev.tick = t;
+                    block.events.push_back(ev);
+                }
+            } else if (noteEnd == length) {
+                // Note ending exactly at the sequence end is released on the last tick of the clip
+                // (earlier repeats are released by the loop boundary)
+                int last = clipEnd - 1;
+                if (last >= lo && (last - base) % length == length - 1) {
+                    ev.tick = last;
+                    block.events.push_back(ev);
+                }
+            }
+        }
+    }
+
+    std::sort(block.events.begin(), block.events.end(), [](const NN_ArrangementEvent_t &a, const NN_ArrangementEvent_t &b) {
+        return a.tick != b.tick ? a.tick < b.tick : a.order < b.order;
+    });
+}
+
+void NoteNagaArrangementScheduler::mergeBlocks() {
+    size_t total = 0;
+    for (const ClipBlock &block : blocks_) total += block.events.size();
+
+    events_.clear();
+    events_.reserve(total);
+    for (const ClipBlock &block : blocks_) {
+        events_.insert(events_.end(), block.events.begin(), block.events.end());
+    }
+
+    // Blocks are in arrangement order and sorted internally, a stable sort by tick
+    // keeps (track, clip, event) order for events at the same tick
+    std::stable_sort(events_.begin(), events_.end(),
+                     [](const NN_ArrangementEvent_t &a, const NN_ArrangementEvent_t &b) { return a.tick < b.tick; });
+}
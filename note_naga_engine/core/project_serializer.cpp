@@ -183,6 +183,8 @@ bool NoteNagaProjectSerializer::saveProject(const std::string &filePath, const N
     
     // Write Audio Resources (v9+)
     if (runtime) {
+        runtime->getAudioManager().setPeakCacheDirectory(peakCacheDirectoryFor(filePath));
+        runtime->getAudioManager().savePeakCaches();
         serializeAudioResources(file, runtime);
     } else {
         writeInt32(file, 0);  // No audio resources
@@ -295,6 +297,7 @@ bool NoteNagaProjectSerializer::loadProject(const std::string &filePath, NoteNag
     
     // Read Audio Resources (v9+)
     if (m_loadingVersion >= 9 && runtime) {
+        runtime->getAudioManager().setPeakCacheDirectory(peakCacheDirectoryFor(filePath));
         if (!deserializeAudioResources(file, runtime)) {
             NOTE_NAGA_LOG_WARNING("Failed to load audio resources, continuing without audio");
         }
@@ -542,7 +545,7 @@ void NoteNagaProjectSerializer::serializeTrack(std::ofstream &out, NoteNagaTrack
         }
     }
     
-    const std::vector<NN_Note_t> &notes = track->getNotes();
+    std::span<const NN_Note_t> notes = track->getNotesView();
     writeInt32(out, static_cast<int32_t>(notes.size()));
     for (const NN_Note_t &note : notes) {
         writeUInt64(out, note.id);
@@ -928,6 +931,12 @@ bool NoteNagaProjectSerializer::deserializeMidiClip(std::ifstream &in, NN_MidiCl
 // Audio Resources Serialization (v9+)
 /*******************************************************************************************************/
 
+std::string NoteNagaProjectSerializer::peakCacheDirectoryFor(const std::string &projectFilePath)
+{
+    // Sidecar directory next to the project file: "<project>.peaks"
+    return projectFilePath + ".peaks";
+}
+
 void NoteNagaProjectSerializer::serializeAudioResources(std::ofstream &out, NoteNagaRuntimeData *runtime)
 {
     if (!runtime) {
@@ -0,0 +1,89 @@
+#include <note_naga_engine/core/render_thread_pool.h>
+
+#include <note_naga_engine/logger.h>
+
+#include <algorithm>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#define NN_CPU_RELAX() _mm_pause()
+#else
+#define NN_CPU_RELAX() std::this_thread::yield()
+#endif
+
+NoteNagaRenderThreadPool::NoteNagaRenderThreadPool(int num_threads) {
+    if (num_threads <= 0) num_threads = defaultThreadCount();
+    // The calling thread is always worker 0
+    for (int i = 1; i < num_threads; ++i) {
+        workers_.emplace_back(&NoteNagaRenderThreadPool::workerLoop, this);
+    }
+    NOTE_NAGA_LOG_INFO("Render thread pool started with " + std::to_string(num_threads) + " thread(s)");
+}
+
+NoteNagaRenderThreadPool::~NoteNagaRenderThreadPool() {
+    stop_.store(true, std::memory_order_release);
+    generation_.fetch_add(1, std::memory_order_release);
+    generation_.notify_all();
+    for (auto &worker : workers_) {
+        if (worker.joinable()) worker.join();
+    }
+}
+
+int NoteNagaRenderThreadPool::defaultThreadCount() {
+    unsigned int hw = std::thread::hardware_concurrency();
+    if (hw <= 2) return 1;
+    // Leave cores for the GUI, playback and I/O threads
+    return std::clamp(int(hw) - 2, 1, 8);
+}
+
+void NoteNagaRenderThreadPool::runBatch(size_t job_count, void *ctx, JobTrampoline trampoline) {
+    trampoline_ = trampoline;
+    ctx_ = ctx;
+    job_count_ = job_count;
+    next_job_.store(0, std::memory_order_relaxed);
+    pending_jobs_.store(job_count, std::memory_order_relaxed);
+
+    // Open the batch and wake workers
+    uint64_t gen = generation_.load(std::memory_order_relaxed) + 1;
+    open_batch_.store(gen, std::memory_order_seq_cst);
+    generation_.store(gen, std::memory_order_release);
+    generation_.notify_all();
+
+    // Caller participates
+    drainJobs();
+    while (pending_jobs_.load(std::memory_order_acquire) != 0) {
+        NN_CPU_RELAX();
+    }
+
+    // Close the batch: no worker may touch the batch description after this returns
+    open_batch_.store(0, std::memory_order_seq_cst);
+    while (active_workers_.load(std::memory_order_seq_cst) != 0) {
+        NN_CPU_RELAX();
+    }
+}
+
+void NoteNagaRenderThreadPool::drainJobs() {
+    for (;;) {
+        size_t job = next_job_.fetch_add(1, std::memory_order_relaxed);
+        if (job >= job_count_) break;
+        trampoline_(ctx_, job);
+        pending_jobs_.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void NoteNagaRenderThreadPool::workerLoop() {
+    uint64_t seen = 0;
+    for (;;) {
+        generation_.wait(seen, std::memory_order_acquire);
+        if (stop_.load(std::memory_order_acquire)) return;
+        uint64_t gen = generation_.load(std::memory_order_acquire);
+        seen = gen;
+
+        // Join the batch only if it is still open (pairs with the close in runBatch)
+        active_workers_.fetch_add(1, std::memory_order_seq_cst);
+        if (open_batch_.load(std::memory_order_seq_cst) == gen) {
+            drainJobs();
+        }
+        active_workers_.fetch_sub(1, std::memory_order_seq_cst);
+    }
+}
@@ -52,13 +52,19 @@ bool NoteNagaRuntimeData::loadProject(const std::string &project_path) {
     if (!sequences.empty()) {
         NOTE_NAGA_LOG_INFO("Cleaning existing project data before loading new project");
     }
-    for (NoteNagaMidiSeq *seq : sequences) {
-        if (seq) delete seq;
-    }
+    // Sequences are deleted after the change is announced (the DSP engine drops
+    // their synths from the render plan first)
+    std::vector<NoteNagaMidiSeq *> oldSequences;
+    oldSequences.swap(this->sequences);
     this->current_tick = 0;
     this->max_tick = 0;
-    this->sequences.clear();
     this->active_sequence = nullptr;
+    if (!oldSequences.empty()) {
+        NN_QT_EMIT(sequenceListChanged());
+    }
+    for (NoteNagaMidiSeq *seq : oldSequences) {
+        if (seq) delete seq;
+    }
 
     NoteNagaMidiSeq *sequence = new NoteNagaMidiSeq();
     sequence->loadFromMidi(project_path);
@@ -81,6 +87,7 @@ void NoteNagaRuntimeData::addSequence(NoteNagaMidiSeq *sequence) {
                 &NoteNagaRuntimeData::trackMetaChanged);
         // Only emit activeSequenceTrackListChanged if this is the active sequence
         connect(sequence, &NoteNagaMidiSeq::trackListChanged, this, [this, sequence](){
+            this->sequenceTrackListChanged(sequence);
             if (this->active_sequence == sequence) {
                 this->activeSequenceTrackListChanged(sequence);
             }
@@ -153,6 +160,27 @@ int NoteNagaRuntimeData::getTempo() const {
     return tempo;
 }
 
+std::shared_ptr<const NoteNagaTempoMap> NoteNagaRuntimeData::getTempoMap() const {
+    NoteNagaMidiSeq *active_sequence = getActiveSequence();
+    if (active_sequence) { return active_sequence->getTempoMap(); }
+    return getFixedTempoMap(tempo);
+}
+
+std::shared_ptr<const NoteNagaTempoMap> NoteNagaRuntimeData::getArrangementTempoMap() const {
+    NoteNagaTrack *tempoTrack = arrangement_ ? arrangement_->getTempoTrack() : nullptr;
+    if (tempoTrack && tempoTrack->isTempoTrackActive()) { return tempoTrack->getTempoMap(); }
+    return getFixedTempoMap(getTempo());
+}
+
+std::shared_ptr<const NoteNagaTempoMap> NoteNagaRuntimeData::getFixedTempoMap(int tempo) const {
+    std::lock_guard<std::mutex> lock(tempo_map_mutex_);
+    const double bpm = 60'000'000.0 / std::max(1, tempo);
+    if (!fixed_tempo_map_ || fixed_tempo_map_->getBPMAtTick(0) != bpm) {
+        fixed_tempo_map_ = std::make_shared<const NoteNagaTempoMap>(bpm);
+    }
+    return fixed_tempo_map_;
+}
+
 void NoteNagaRuntimeData::setCurrentTick(int tick) {
     if (this->current_tick == tick) return;
     this->current_tick = tick;
@@ -0,0 +1,158 @@
+#include <note_naga_engine/core/tempo_map.h>
+
+#include <note_naga_engine/core/types.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr double kMinBPM = 1.0;
+constexpr double kRampEpsilon = 1e-9;
+
+} // namespace
+
+/*******************************************************************************************************/
+// Construction
+/*******************************************************************************************************/
+
+NoteNagaTempoMap::NoteNagaTempoMap(double bpm) {
+    Segment segment;
+    segment.bpm = std::max(kMinBPM, bpm);
+    segment.end_bpm = segment.bpm;
+    segments_.push_back(segment);
+}
+
+NoteNagaTempoMap::NoteNagaTempoMap(const std::vector<NN_TempoEvent_t> &events) { rebuild(events); }
+
+NoteNagaTempoMap NoteNagaTempoMap::fromMicroseconds(int tempo) {
+    return NoteNagaTempoMap(60'000'000.0 / std::max(1, tempo));
+}
+
+void NoteNagaTempoMap::rebuild(const std::vector<NN_TempoEvent_t> &events) {
+    segments_.clear();
+    if (events.empty()) {
+        *this = NoteNagaTempoMap();
+        return;
+    }
+    if (events.front().tick > 0) {
+        // Before the first event the first tempo applies
+        Segment lead;
+        lead.bpm = std::max(kMinBPM, events.front().bpm);
+        lead.end_bpm = lead.bpm;
+        segments_.push_back(lead);
+        appendSegments(events, 0, span(lead, events.front().tick));
+    } else {
+        appendSegments(events, 0, 0.0);
+    }
+}
+
+void NoteNagaTempoMap::update(const std::vector<NN_TempoEvent_t> &events, int changed_tick) {
+    // The segment before the change keeps its start but its ramp may end at the changed
+    // event, so it is recomputed too; everything before it is still valid.
+    auto it = std::lower_bound(segments_.begin(), segments_.end(), changed_tick,
+                               [](const Segment &segment, int tick) { return segment.tick < tick; });
+    size_t keep = static_cast<size_t>(it - segments_.begin());
+    if (keep < 2 || events.empty()) {
+        rebuild(events);
+        return;
+    }
+    --keep;
+
+    const Segment restart = segments_[keep];
+    auto first = std::lower_bound(events.begin(), events.end(), restart.tick,
+                                  [](const NN_TempoEvent_t &event, int tick) { return event.tick < tick; });
+    if (first == events.end() || first->tick != restart.tick) {
+        rebuild(events);
+        return;
+    }
+    segments_.resize(keep);
+    appendSegments(events, static_cast<size_t>(first - events.begin()), restart.time);
+}
+
+void NoteNagaTempoMap::appendSegments(const std::vector<NN_TempoEvent_t> &events, size_t first_event,
+                                      double time) {
+    segments_.reserve(segments_.size() + events.size() - first_event);
+    for (size_t i = first_event; i < events.size(); ++i) {
+        const NN_TempoEvent_t &event = events[i];
+        const NN_TempoEvent_t *next = (i + 1 < events.size()) ? &events[i + 1] : nullptr;
+        Segment segment;
+        segment.tick = event.tick;
+        segment.bpm = std::max(kMinBPM, event.bpm);
+        segment.end_bpm = segment.bpm;
+        segment.time = time;
+        if (next && event.interpolation == TempoInterpolation::Linear && next->tick > event.tick) {
+            segment.end_bpm = std::max(kMinBPM, next->bpm);
+            segment.length = next->tick - event.tick;
+        }
+        segments_.push_back(segment);
+        if (next) time += span(segment, next->tick - event.tick);
+    }
+}
+
+/*******************************************************************************************************/
+// Queries
+/*******************************************************************************************************/
+
+const NoteNagaTempoMap::Segment &NoteNagaTempoMap::segmentAtTick(double tick) const {
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), tick,
+                               [](double t, const Segment &segment) { return t < segment.tick; });
+    return (it == segments_.begin()) ? segments_.front() : *std::prev(it);
+}
+
+const NoteNagaTempoMap::Segment &NoteNagaTempoMap::segmentAtTime(double time) const {
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), time,
+                               [](double t, const Segment &segment) { return t < segment.time; });
+    return (it == segments_.begin()) ? segments_.front() : *std::prev(it);
+}
+
+double NoteNagaTempoMap::getBPMAtTick(double tick) const {
+    const Segment &segment = segmentAtTick(tick);
+    if (segment.length <= 0 || tick <= segment.tick) return segment.bpm;
+    double t = std::min(1.0, (tick - segment.tick) / segment.length);
+    return segment.bpm + t * (segment.end_bpm - segment.bpm);
+}
+
+int NoteNagaTempoMap::getTempoAtTick(int tick) const {
+    return static_cast<int>(60'000'000.0 / getBPMAtTick(tick));
+}
+
+double NoteNagaTempoMap::ticksToSeconds(double tick, int ppq) const {
+    const Segment &segment = segmentAtTick(tick);
+    return (segment.time + span(segment, tick - segment.tick)) / std::max(1, ppq);
+}
+
+double NoteNagaTempoMap::secondsToTicks(double seconds, int ppq) const {
+    const double time = seconds * std::max(1, ppq);
+    const Segment &segment = segmentAtTime(time);
+    return segment.tick + inverseSpan(segment, time - segment.time);
+}
+
+int64_t NoteNagaTempoMap::ticksToSamples(double tick, int ppq, int sample_rate) const {
+    return static_cast<int64_t>(std::llround(ticksToSeconds(tick, ppq) * sample_rate));
+}
+
+double NoteNagaTempoMap::samplesToTicks(int64_t sample, int ppq, int sample_rate) const {
+    if (sample_rate <= 0) return 0.0;
+    return secondsToTicks(static_cast<double>(sample) / sample_rate, ppq);
+}
+
+double NoteNagaTempoMap::span(const Segment &segment, double ticks) {
+    double delta = segment.end_bpm - segment.bpm;
+    if (segment.length <= 0 || ticks <= 0.0 || std::fabs(delta) < kRampEpsilon) {
+        // Also covers ticks before the first segment (first tempo extrapolated)
+        return ticks * 60.0 / segment.bpm;
+    }
+    // Integral of 60 / bpm(t) with bpm(t) linear over the ramp
+    double bpm = segment.bpm + delta * ticks / segment.length;
+    return 60.0 * segment.length / delta * std::log(bpm / segment.bpm);
+}
+
+double NoteNagaTempoMap::inverseSpan(const Segment &segment, double time) {
+    double delta = segment.end_bpm - segment.bpm;
+    if (segment.length <= 0 || time <= 0.0 || std::fabs(delta) < kRampEpsilon) {
+        return time * segment.bpm / 60.0;
+    }
+    double bpm = segment.bpm * std::exp(time * delta / (60.0 * segment.length));
+    return (bpm - segment.bpm) * segment.length / delta;
+}
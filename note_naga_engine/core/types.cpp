@@ -5,6 +5,9 @@
 #include <algorithm>
 #include <atomic>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <climits>
 #include <cmath>
 
 #include <note_naga_engine/logger.h>
@@ -64,6 +67,120 @@ double note_time_ms(const NN_Note_t &note, int ppq, int tempo) {
   return total_us / 1000.0;
 }
 
+size_t NN_NoteColumns_t::lowerBound(int tick) const {
+    return static_cast<size_t>(std::lower_bound(start.begin(), start.end(), tick) - start.begin());
+}
+
+size_t NN_NoteColumns_t::upperBound(int tick) const {
+    return static_cast<size_t>(std::upper_bound(start.begin(), start.end(), tick) - start.begin());
+}
+
+int64_t NN_NoteColumns_t::findRow(unsigned long note_id) const {
+    auto it = std::lower_bound(id_index.begin(), id_index.end(), note_id,
+                               [](const std::pair<unsigned long, uint32_t> &e, unsigned long v) {
+                                   return e.first < v;
+                               });
+    if (it == id_index.end() || it->first != note_id) return -1;
+    return static_cast<int64_t>(it->second);
+}
+
+size_t NN_NoteColumns_t::findOverlapping(int from, int to, std::vector<uint32_t> &rows) const {
+    // Only rows starting before 'to' can overlap; among them descend into the
+    // subtrees whose largest end tick is past 'from'
+    const size_t limit = lowerBound(to);
+    if (limit == 0 || from >= to) return 0;
+    const size_t leaves = end_tree.size() / 2;
+    const size_t found = rows.size();
+
+    struct Range { size_t node, lo, hi; };
+    Range stack[64];
+    int top = 0;
+    stack[top++] = {1, 0, leaves};
+    while (top > 0) {
+        const Range r = stack[--top];
+        if (r.lo >= limit || end_tree[r.node] <= from) continue;
+        if (r.hi - r.lo == 1) {
+            rows.push_back(static_cast<uint32_t>(r.lo));
+            continue;
+        }
+        // Right child first so rows come out in ascending order
+        const size_t mid = (r.lo + r.hi) / 2;
+        stack[top++] = {2 * r.node + 1, mid, r.hi};
+        stack[top++] = {2 * r.node, r.lo, mid};
+    }
+    return rows.size() - found;
+}
+
+NN_Note_t NN_NoteColumns_t::toNote(size_t row, NoteNagaTrack *parent) const {
+    NN_Note_t note(pitch[row], parent, start[row], length[row]);
+    note.id = id[row];
+    if (velocity[row] > 0) note.velocity = velocity[row];
+    if (pan[row] != PAN_UNSET) note.pan = pan[row];
+    return note;
+}
+
+NN_NoteChangeSet_t NN_NoteChangeSet_t::inverted() const {
+    NN_NoteChangeSet_t inv;
+    inv.added = this->removed;
+    inv.removed = this->added;
+    inv.updated = this->previous;
+    inv.previous = this->updated;
+    return inv;
+}
+
+/// Compare all note fields except the parent pointer
+static bool nn_same_note(const NN_Note_t &a, const NN_Note_t &b) {
+    return a.id == b.id && a.note == b.note && a.start == b.start && a.length == b.length &&
+           a.velocity == b.velocity && a.pan == b.pan;
+}
+
+/// Sort incoming notes by start and merge them into a start-ordered note list
+/// (existing notes stay first on equal start). Falls back to a full stable sort
+/// if the list was not ordered (e.g. after setNotes() with unsorted input).
+static void nn_merge_notes(std::vector<NN_Note_t> &notes, std::vector<NN_Note_t> &incoming) {
+    auto byStart = [](const NN_Note_t &a, const NN_Note_t &b) {
+        return a.start.value_or(0) < b.start.value_or(0);
+    };
+    std::stable_sort(incoming.begin(), incoming.end(), byStart);
+    const bool ordered = std::is_sorted(notes.begin(), notes.end(), byStart);
+    const size_t middle = notes.size();
+    notes.insert(notes.end(), std::make_move_iterator(incoming.begin()),
+                 std::make_move_iterator(incoming.end()));
+    if (ordered) {
+        std::inplace_merge(notes.begin(), notes.begin() + middle, notes.end(), byStart);
+    } else {
+        std::stable_sort(notes.begin(), notes.end(), byStart);
+    }
+}
+
+/// Append a playable note (start and length set) as the last row of a snapshot
+static void nn_append_column_row(NN_NoteColumns_t &columns, const NN_Note_t &n, uint32_t source) {
+    columns.start.push_back(*n.start);
+    columns.length.push_back(*n.length);
+    columns.pitch.push_back(static_cast<uint8_t>(std::clamp(n.note, 0, 127)));
+    columns.velocity.push_back(static_cast<uint8_t>(std::clamp(n.velocity.value_or(0), 0, 127)));
+    columns.pan.push_back(n.pan.has_value() ? static_cast<uint8_t>(std::clamp(*n.pan, 0, 127))
+                                            : NN_NoteColumns_t::PAN_UNSET);
+    columns.id.push_back(n.id);
+    columns.source.push_back(source);
+    columns.max_length = std::max(columns.max_length, *n.length);
+    columns.end_tick = std::max(columns.end_tick, *n.start + *n.length);
+}
+
+/// Interval index over the start-sorted rows (unused leaves never match)
+static void nn_build_end_tree(NN_NoteColumns_t &columns) {
+    const size_t count = columns.size();
+    size_t leaves = 1;
+    while (leaves < count) leaves *= 2;
+    columns.end_tree.assign(2 * leaves, INT_MIN);
+    for (size_t row = 0; row < count; ++row) {
+        columns.end_tree[leaves + row] = columns.start[row] + columns.length[row];
+    }
+    for (size_t node = leaves - 1; node > 0; --node) {
+        columns.end_tree[node] = std::max(columns.end_tree[2 * node], columns.end_tree[2 * node + 1]);
+    }
+}
+
 /*******************************************************************************************************/
 // Note Naga Track
 /*******************************************************************************************************/
@@ -125,23 +242,8 @@ void NoteNagaTrack::addNote(const NN_Note_t &note) {
     // Vložíme notu na správnou pozici podle start času (binary search)
     // aby noty byly vždy seřazené pro playback worker
     int noteStart = note.start.value_or(0);
-    auto it = std::lower_bound(
-        this->midi_notes.begin(), this->midi_notes.end(), noteStart,
-        [](const NN_Note_t &n, int start) {
-            return n.start.value_or(0) < start;
-        }
-    );
-    this->midi_notes.insert(it, note);
-    NN_QT_EMIT(metadataChanged(this, "notes"));
-}
-
-void NoteNagaTrack::addNotesBulk(const std::vector<NN_Note_t> &notes) {
-    // Reserve space for efficiency
-    this->midi_notes.reserve(this->midi_notes.size() + notes.size());
-    
-    // Add all notes
-    for (const auto &note : notes) {
-        int noteStart = note.start.value_or(0);
+    {
+        std::lock_guard<std::mutex> lock(this->notes_mutex_);
         auto it = std::lower_bound(
             this->midi_notes.begin(), this->midi_notes.end(), noteStart,
             [](const NN_Note_t &n, int start) {
@@ -149,21 +251,197 @@ void NoteNagaTrack::addNotesBulk(const std::vector<NN_Note_t> &notes) {
             }
         );
         this->midi_notes.insert(it, note);
+        this->notes_revision_.fetch_add(1, std::memory_order_release);
+        NN_NoteChangeSet_t applied;
+        applied.added.push_back(note);
+        patchNoteColumns(applied);
     }
-    
+    NN_QT_EMIT(metadataChanged(this, "notes"));
+}
+
+void NoteNagaTrack::addNotesBulk(const std::vector<NN_Note_t> &notes) {
+    // One sort of the new notes and a single merge instead of an insert per note
+    std::vector<NN_Note_t> incoming = notes;
+    {
+        std::lock_guard<std::mutex> lock(this->notes_mutex_);
+        nn_merge_notes(this->midi_notes, incoming);
+        this->notes_revision_.fetch_add(1, std::memory_order_release);
+    }
+
     // Emit signal only once at the end
     NN_QT_EMIT(metadataChanged(this, "notes"));
 }
 
 void NoteNagaTrack::removeNote(const NN_Note_t &note) {
-    auto it = std::find_if(midi_notes.begin(), midi_notes.end(),
-                           [&note](const NN_Note_t &n) { return n.id == note.id; });
-    if (it != midi_notes.end()) {
-        midi_notes.erase(it);
+    {
+        std::lock_guard<std::mutex> lock(this->notes_mutex_);
+        auto it = std::find_if(midi_notes.begin(), midi_notes.end(),
+                               [&note](const NN_Note_t &n) { return n.id == note.id; });
+        NN_NoteChangeSet_t applied;
+        if (it != midi_notes.end()) {
+            applied.removed.push_back(*it);
+            midi_notes.erase(it);
+        }
+        this->notes_revision_.fetch_add(1, std::memory_order_release);
+        patchNoteColumns(applied);
     }
     NN_QT_EMIT(metadataChanged(this, "notes"));
 }
 
+NN_NoteChangeSet_t NoteNagaTrack::applyNoteChanges(const NN_NoteChangeSet_t &changes) {
+    NN_NoteChangeSet_t applied;
+    if (changes.empty()) return applied;
+
+    std::unordered_set<unsigned long> removals;
+    for (const NN_Note_t &note : changes.removed) removals.insert(note.id);
+    std::unordered_map<unsigned long, const NN_Note_t *> updates;
+    for (const NN_Note_t &note : changes.updated) updates[note.id] = &note;
+
+    // Single compacting pass: drop removed notes, update the rest in place and pull
+    // out notes whose start moved (they are merged back in order below)
+    std::unique_lock<std::mutex> lock(this->notes_mutex_);
+    std::vector<NN_Note_t> moved;
+    size_t kept = 0;
+    for (size_t i = 0; i < this->midi_notes.size(); ++i) {
+        NN_Note_t &note = this->midi_notes[i];
+        if (!removals.empty() && removals.count(note.id)) {
+            applied.removed.push_back(std::move(note));
+            continue;
+        }
+        auto it = updates.find(note.id);
+        if (it != updates.end() && !nn_same_note(note, *it->second)) {
+            const NN_Note_t &value = *it->second;
+            applied.previous.push_back(note);
+            applied.updated.push_back(value);
+            if (value.start != note.start) {
+                moved.push_back(value);
+                continue;
+            }
+            note = value;
+        }
+        if (kept != i) this->midi_notes[kept] = std::move(note);
+        ++kept;
+    }
+    this->midi_notes.erase(this->midi_notes.begin() + kept, this->midi_notes.end());
+
+    for (const NN_Note_t &note : changes.added) {
+        moved.push_back(note);
+        applied.added.push_back(note);
+    }
+    if (!moved.empty()) nn_merge_notes(this->midi_notes, moved);
+
+    if (!applied.empty()) {
+        this->notes_revision_.fetch_add(1, std::memory_order_release);
+        patchNoteColumns(applied);
+        lock.unlock();
+        NN_QT_EMIT(metadataChanged(this, "notes"));
+    }
+    return applied;
+}
+
+std::shared_ptr<const NN_NoteColumns_t> NoteNagaTrack::getNoteColumns() const {
+    // Note edits hold the same mutex, so the list cannot change while it is read here
+    std::lock_guard<std::mutex> lock(this->notes_mutex_);
+    const uint64_t revision = this->notes_revision_.load(std::memory_order_acquire);
+    if (this->note_columns_ && this->note_columns_->revision == revision) {
+        return this->note_columns_;
+    }
+
+    // Playable notes ordered by start tick, ties keep the list order
+    std::vector<uint32_t> order;
+    order.reserve(this->midi_notes.size());
+    for (size_t i = 0; i < this->midi_notes.size(); ++i) {
+        const NN_Note_t &n = this->midi_notes[i];
+        if (n.start.has_value() && n.length.has_value()) order.push_back(static_cast<uint32_t>(i));
+    }
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return *this->midi_notes[a].start < *this->midi_notes[b].start;
+    });
+
+    auto columns = std::make_shared<NN_NoteColumns_t>();
+    columns->revision = revision;
+    const size_t count = order.size();
+    columns->start.reserve(count);
+    columns->length.reserve(count);
+    columns->pitch.reserve(count);
+    columns->velocity.reserve(count);
+    columns->pan.reserve(count);
+    columns->id.reserve(count);
+    columns->source.reserve(count);
+    columns->id_index.resize(count);
+    for (size_t row = 0; row < count; ++row) {
+        const NN_Note_t &n = this->midi_notes[order[row]];
+        nn_append_column_row(*columns, n, order[row]);
+        columns->id_index[row] = {n.id, static_cast<uint32_t>(row)};
+    }
+    std::sort(columns->id_index.begin(), columns->id_index.end());
+    nn_build_end_tree(*columns);
+
+    this->note_columns_ = columns;
+    return this->note_columns_;
+}
+
+void NoteNagaTrack::patchNoteColumns(const NN_NoteChangeSet_t &applied) {
+    const uint64_t revision = this->notes_revision_.load(std::memory_order_relaxed);
+    const std::shared_ptr<const NN_NoteColumns_t> old = this->note_columns_;
+    if (!old || old->revision + 1 != revision) return;
+    auto byStart = [](const NN_Note_t &a, const NN_Note_t &b) {
+        return a.start.value_or(0) < b.start.value_or(0);
+    };
+    if (!std::is_sorted(this->midi_notes.begin(), this->midi_notes.end(), byStart)) return;
+
+    std::unordered_set<unsigned long> touched;
+    for (const NN_Note_t &note : applied.removed) touched.insert(note.id);
+    for (const NN_Note_t &note : applied.updated) touched.insert(note.id);
+    for (const NN_Note_t &note : applied.added) touched.insert(note.id);
+
+    // The ordered list gives the rows directly. Untouched notes keep their relative order,
+    // so they pair up with the untouched old rows in sequence (old row -> new row)
+    auto columns = std::make_shared<NN_NoteColumns_t>();
+    columns->revision = revision;
+    const size_t capacity = old->size() + applied.added.size();
+    columns->start.reserve(capacity);
+    columns->length.reserve(capacity);
+    columns->pitch.reserve(capacity);
+    columns->velocity.reserve(capacity);
+    columns->pan.reserve(capacity);
+    columns->id.reserve(capacity);
+    columns->source.reserve(capacity);
+    std::vector<uint32_t> new_row(old->size(), UINT32_MAX);
+    std::vector<std::pair<unsigned long, uint32_t>> fresh;
+    size_t old_row = 0;
+    for (size_t i = 0; i < this->midi_notes.size(); ++i) {
+        const NN_Note_t &n = this->midi_notes[i];
+        if (!n.start.has_value() || !n.length.has_value()) continue;
+        const uint32_t row = static_cast<uint32_t>(columns->size());
+        nn_append_column_row(*columns, n, static_cast<uint32_t>(i));
+        if (touched.count(n.id)) {
+            fresh.push_back({n.id, row});
+            continue;
+        }
+        while (old_row < old->size() && touched.count(old->id[old_row])) ++old_row;
+        // The old snapshot does not match the list (e.g. built from an unordered list)
+        if (old_row >= old->size() || old->id[old_row] != n.id) return;
+        new_row[old_row++] = row;
+    }
+
+    // Merge the remapped old index entries with the touched notes
+    std::sort(fresh.begin(), fresh.end());
+    columns->id_index.reserve(columns->size());
+    auto next = fresh.begin();
+    for (const auto &entry : old->id_index) {
+        if (new_row[entry.second] == UINT32_MAX) continue;
+        const std::pair<unsigned long, uint32_t> moved{entry.first, new_row[entry.second]};
+        while (next != fresh.end() && *next < moved) columns->id_index.push_back(*next++);
+        columns->id_index.push_back(moved);
+    }
+    columns->id_index.insert(columns->id_index.end(), next, fresh.end());
+    if (columns->id_index.size() != columns->size()) return;
+
+    nn_build_end_tree(*columns);
+    this->note_columns_ = columns;
+}
+
 void NoteNagaTrack::setInstrument(std::optional<int> instrument) {
   if (this->instrument == instrument)
     return;
@@ -253,14 +531,14 @@ float NoteNagaTrack::getAudioVolumeLinear() const {
 void NoteNagaTrack::setSynth(NoteNagaSynthesizer* synth) {
   if (synth_ == synth)
     return;
-  // Delete old synth if we own it
-  if (synth_ != nullptr) {
-    delete synth_;
-  }
+  // The old synth (owned by the track) is deleted after the change is announced,
+  // the DSP engine drops it from the render plan and waits for the render in flight
+  NoteNagaSynthesizer *old_synth = synth_;
   synth_ = synth;
   NOTE_NAGA_LOG_INFO("Track ID: " + std::to_string(track_id) + 
                      " synth set to: " + (synth ? synth->getName() : "nullptr"));
   NN_QT_EMIT(metadataChanged(this, "synth"));
+  delete old_synth;
 }
 
 bool NoteNagaTrack::initDefaultSynth() {
@@ -392,6 +670,7 @@ void NoteNagaTrack::setTempoTrack(bool is_tempo) {
   if (is_tempo && tempo_events.empty()) {
     // Initialize with default tempo at tick 0
     tempo_events.push_back(NN_TempoEvent_t(0, 120.0, TempoInterpolation::Step));
+    updateTempoMap();
   }
   NOTE_NAGA_LOG_INFO("Track ID: " + std::to_string(track_id) + 
                      " is_tempo_track set to: " + (is_tempo ? "true" : "false"));
@@ -402,6 +681,7 @@ void NoteNagaTrack::setTempoEvents(const std::vector<NN_TempoEvent_t>& events) {
   tempo_events = events;
   // Sort by tick
   std::sort(tempo_events.begin(), tempo_events.end());
+  updateTempoMap();
   NN_QT_EMIT(tempoEventsChanged(this));
 }
 
@@ -415,6 +695,7 @@ void NoteNagaTrack::addTempoEvent(const NN_TempoEvent_t& event) {
   // Insert and sort
   tempo_events.push_back(event);
   std::sort(tempo_events.begin(), tempo_events.end());
+  updateTempoMap(event.tick);
   
   NOTE_NAGA_LOG_INFO("Track ID: " + std::to_string(track_id) + 
                      " tempo event added at tick: " + std::to_string(event.tick) +
@@ -433,6 +714,7 @@ bool NoteNagaTrack::removeTempoEventAtTick(int tick) {
                          [tick](const NN_TempoEvent_t& e) { return e.tick == tick; });
   if (it != tempo_events.end()) {
     tempo_events.erase(it);
+    updateTempoMap(tick);
     NOTE_NAGA_LOG_INFO("Track ID: " + std::to_string(track_id) + 
                        " tempo event removed at tick: " + std::to_string(tick));
     NN_QT_EMIT(tempoEventsChanged(this));
@@ -442,52 +724,33 @@ bool NoteNagaTrack::removeTempoEventAtTick(int tick) {
 }
 
 double NoteNagaTrack::getTempoAtTick(int tick) const {
-  if (tempo_events.empty()) {
-    return 120.0;  // Default tempo
-  }
-  
-  // Find the tempo event at or before this tick
-  const NN_TempoEvent_t* prevEvent = nullptr;
-  const NN_TempoEvent_t* nextEvent = nullptr;
-  
-  for (size_t i = 0; i < tempo_events.size(); ++i) {
-    if (tempo_events[i].tick <= tick) {
-      prevEvent = &tempo_events[i];
-      if (i + 1 < tempo_events.size()) {
-        nextEvent = &tempo_events[i + 1];
-      } else {
-        nextEvent = nullptr;
-      }
-    } else {
-      if (!prevEvent) {
-        // tick is before first event - use that next event info
-        nextEvent = &tempo_events[i];
-      }
-      break;
-    }
-  }
-  
-  if (!prevEvent) {
-    // Before first tempo event, use first event's tempo
-    return tempo_events[0].bpm;
+  return getTempoMap()->getBPMAtTick(tick);
+}
+
+std::shared_ptr<const NoteNagaTempoMap> NoteNagaTrack::getTempoMap() const {
+  std::lock_guard<std::mutex> lock(tempo_map_mutex_);
+  if (!tempo_map_) {
+    tempo_map_ = std::make_shared<const NoteNagaTempoMap>(tempo_events);
   }
-  
-  // Check interpolation mode
-  if (prevEvent->interpolation == TempoInterpolation::Linear && nextEvent && nextEvent->tick > prevEvent->tick) {
-    // Linear interpolation between prevEvent and nextEvent
-    int tickRange = nextEvent->tick - prevEvent->tick;
-    double t = static_cast<double>(tick - prevEvent->tick) / tickRange;
-    t = std::clamp(t, 0.0, 1.0);
-    return prevEvent->bpm + t * (nextEvent->bpm - prevEvent->bpm);
+  return tempo_map_;
+}
+
+void NoteNagaTrack::updateTempoMap(std::optional<int> changed_tick) {
+  std::lock_guard<std::mutex> lock(tempo_map_mutex_);
+  if (!tempo_map_ || !changed_tick.has_value()) {
+    tempo_map_ = std::make_shared<const NoteNagaTempoMap>(tempo_events);
+    return;
   }
-  
-  // Step interpolation or no next event
-  return prevEvent->bpm;
+  // Readers may still hold the old snapshot, update a copy
+  auto map = std::make_shared<NoteNagaTempoMap>(*tempo_map_);
+  map->update(tempo_events, changed_tick.value());
+  tempo_map_ = std::move(map);
 }
 
 void NoteNagaTrack::resetTempoEvents(double bpm) {
   tempo_events.clear();
   tempo_events.push_back(NN_TempoEvent_t(0, bpm, TempoInterpolation::Step));
+  updateTempoMap();
   NOTE_NAGA_LOG_INFO("Track ID: " + std::to_string(track_id) + 
                      " tempo events reset to: " + std::to_string(bpm) + " BPM");
   NN_QT_EMIT(tempoEventsChanged(this));
@@ -526,12 +789,10 @@ void NoteNagaMidiSeq::clear() {
   NOTE_NAGA_LOG_INFO("Clearing MIDI sequence with ID: " +
                      std::to_string(sequence_id));
 
-  // Dealokace všech tracků
-  for (NoteNagaTrack *track : this->tracks) {
-    if (track)
-      delete track;
-  }
-  this->tracks.clear();
+  // Detach the tracks, they are deleted after the change is announced
+  // (the DSP engine drops them from the render plan first)
+  std::vector<NoteNagaTrack *> old_tracks;
+  old_tracks.swap(this->tracks);
 
   // Dealokace midi_file
   if (midi_file) {
@@ -546,6 +807,12 @@ void NoteNagaMidiSeq::clear() {
   this->solo_track = nullptr;
 
   NN_QT_EMIT(trackListChanged());
+
+  // Dealokace všech tracků
+  for (NoteNagaTrack *track : old_tracks) {
+    if (track)
+      delete track;
+  }
 }
 
 void NoteNagaMidiSeq::setId(int new_id) {
@@ -760,111 +1027,26 @@ double NoteNagaMidiSeq::getEffectiveBPMAtTick(int tick) const {
 }
 
 double NoteNagaMidiSeq::ticksToSeconds(int tick) const {
-  NoteNagaTrack* tempoTrack = getTempoTrack();
-  
-  if (!tempoTrack || !tempoTrack->isTempoTrackActive() || tempoTrack->getTempoEvents().empty()) {
-    // Use fixed tempo
-    double us_per_tick = static_cast<double>(tempo) / ppq;
-    return tick * us_per_tick / 1'000'000.0;
-  }
-  
-  // Integrate over tempo changes
-  const auto& events = tempoTrack->getTempoEvents();
-  double totalSeconds = 0.0;
-  int currentTick = 0;
-  
-  for (size_t i = 0; i < events.size(); ++i) {
-    const auto& event = events[i];
-    int nextEventTick = (i + 1 < events.size()) ? events[i + 1].tick : tick + 1;
-    
-    if (event.tick >= tick) break;
-    
-    int startTick = std::max(currentTick, event.tick);
-    int endTick = std::min(tick, nextEventTick);
-    
-    if (startTick < endTick) {
-      if (event.interpolation == TempoInterpolation::Linear && i + 1 < events.size() && events[i + 1].tick <= tick) {
-        // Linear interpolation - need to integrate
-        double startBpm = event.bpm;
-        double endBpm = events[i + 1].bpm;
-        int segmentTicks = events[i + 1].tick - event.tick;
-        
-        // For linear tempo change, use average tempo
-        int ticksInSegment = endTick - startTick;
-        double t1 = static_cast<double>(startTick - event.tick) / segmentTicks;
-        double t2 = static_cast<double>(endTick - event.tick) / segmentTicks;
-        double avgBpm = (startBpm + t1 * (endBpm - startBpm) + startBpm + t2 * (endBpm - startBpm)) / 2.0;
-        double us_per_beat = 60'000'000.0 / avgBpm;
-        double us_per_tick_avg = us_per_beat / ppq;
-        totalSeconds += ticksInSegment * us_per_tick_avg / 1'000'000.0;
-      } else {
-        // Step interpolation
-        double us_per_beat = 60'000'000.0 / event.bpm;
-        double us_per_tick_step = us_per_beat / ppq;
-        totalSeconds += (endTick - startTick) * us_per_tick_step / 1'000'000.0;
-      }
-    }
-    currentTick = endTick;
-  }
-  
-  // Handle remaining ticks after last event
-  if (currentTick < tick && !events.empty()) {
-    double lastBpm = events.back().bpm;
-    double us_per_beat = 60'000'000.0 / lastBpm;
-    double us_per_tick_last = us_per_beat / ppq;
-    totalSeconds += (tick - currentTick) * us_per_tick_last / 1'000'000.0;
-  }
-  
-  return totalSeconds;
+  return getTempoMap()->ticksToSeconds(tick, ppq);
 }
 
 int NoteNagaMidiSeq::secondsToTicks(double seconds) const {
+  return static_cast<int>(getTempoMap()->secondsToTicks(seconds, ppq));
+}
+
+std::shared_ptr<const NoteNagaTempoMap> NoteNagaMidiSeq::getTempoMap() const {
   NoteNagaTrack* tempoTrack = getTempoTrack();
-  
-  if (!tempoTrack || !tempoTrack->isTempoTrackActive() || tempoTrack->getTempoEvents().empty()) {
-    // Use fixed tempo
-    double us_per_tick = static_cast<double>(tempo) / ppq;
-    return static_cast<int>(seconds * 1'000'000.0 / us_per_tick);
+  if (tempoTrack && tempoTrack->isTempoTrackActive() && !tempoTrack->getTempoEvents().empty()) {
+    return tempoTrack->getTempoMap();
   }
-  
-  // Binary search approach - find tick that gives us the target seconds
-  // This is an approximation for efficiency
-  const auto& events = tempoTrack->getTempoEvents();
-  double totalSeconds = 0.0;
-  int currentTick = 0;
-  
-  for (size_t i = 0; i < events.size(); ++i) {
-    const auto& event = events[i];
-    int nextEventTick = (i + 1 < events.size()) ? events[i + 1].tick : max_tick;
-    
-    double us_per_beat = 60'000'000.0 / event.bpm;
-    double us_per_tick_step = us_per_beat / ppq;
-    double segmentMaxSeconds = (nextEventTick - event.tick) * us_per_tick_step / 1'000'000.0;
-    
-    if (totalSeconds + segmentMaxSeconds >= seconds) {
-      // Target is in this segment
-      double remainingSeconds = seconds - totalSeconds;
-      int ticksInSegment = static_cast<int>(remainingSeconds * 1'000'000.0 / us_per_tick_step);
-      return event.tick + ticksInSegment;
-    }
-    
-    totalSeconds += segmentMaxSeconds;
-    currentTick = nextEventTick;
-  }
-  
-  // Past last event
-  if (!events.empty()) {
-    double lastBpm = events.back().bpm;
-    double us_per_beat = 60'000'000.0 / lastBpm;
-    double us_per_tick_last = us_per_beat / ppq;
-    double remainingSeconds = seconds - totalSeconds;
-    int additionalTicks = static_cast<int>(remainingSeconds * 1'000'000.0 / us_per_tick_last);
-    return currentTick + additionalTicks;
+
+  // Fixed tempo, the constant map is rebuilt when the tempo differs
+  std::lock_guard<std::mutex> lock(tempo_map_mutex_);
+  const double bpm = 60'000'000.0 / std::max(1, tempo);
+  if (!fixed_tempo_map_ || fixed_tempo_map_->getBPMAtTick(0) != bpm) {
+    fixed_tempo_map_ = std::make_shared<const NoteNagaTempoMap>(bpm);
   }
-  
-  // Fallback to fixed tempo
-  double us_per_tick = static_cast<double>(tempo) / ppq;
-  return static_cast<int>(seconds * 1'000'000.0 / us_per_tick);
+  return fixed_tempo_map_;
 }
 
 NoteNagaTrack *NoteNagaMidiSeq::getTrackById(int track_id) {
@@ -878,7 +1060,7 @@ NoteNagaTrack *NoteNagaMidiSeq::getTrackById(int track_id) {
 int NoteNagaMidiSeq::computeMaxTick() {
   this->max_tick = 0;
   for (const auto &track : this->tracks) {
-    for (const auto &note : track->getNotes()) {
+    for (const auto &note : track->getNotesView()) {
       if (note.start.has_value() && note.length.has_value())
         this->max_tick =
             std::max(this->max_tick, note.start.value() + note.length.value());
@@ -918,9 +1100,13 @@ bool NoteNagaMidiSeq::removeTrack(int track_index) {
   if (track_index < 0 || track_index >= this->tracks.size())
     return false;
 
-  delete this->tracks[track_index];
+  // Deleted after the change is announced (the DSP engine drops it from the render plan first)
+  NoteNagaTrack *track = this->tracks[track_index];
   this->tracks.erase(this->tracks.begin() + track_index);
+  if (this->active_track == track)
+    this->active_track = nullptr;
   NN_QT_EMIT(trackListChanged());
+  delete track;
   return true;
 }
 
@@ -1357,7 +1543,7 @@ bool NoteNagaMidiSeq::exportToMidi(const std::string &midi_file_path,
     };
     std::vector<NoteEvent> noteEvents;
 
-    for (const NN_Note_t &note : track->getNotes()) {
+    for (const NN_Note_t &note : track->getNotesView()) {
       int start = note.start.value_or(0);
       int length = note.length.value_or(ppq);
       uint8_t velocity = static_cast<uint8_t>(note.velocity.value_or(100) & 0x7F);
@@ -1727,6 +1913,17 @@ bool NoteNagaArrangementTrack::resizeClip(int clipId, int newDuration) {
     return false;
 }
 
+bool NoteNagaArrangementTrack::setClipFades(int clipId, int fadeInTicks, int fadeOutTicks) {
+    auto *clip = getClipById(clipId);
+    if (clip) {
+        clip->fadeInTicks = std::max(0, fadeInTicks);
+        clip->fadeOutTicks = std::max(0, fadeOutTicks);
+        NN_QT_EMIT(clipsChanged());
+        return true;
+    }
+    return false;
+}
+
 int NoteNagaArrangementTrack::getRemappedChannel(int originalChannel, bool isDrumTrack) const {
     // Drum channel (9) is never remapped
     if (isDrumTrack || originalChannel == MIDI_DRUM_CHANNEL) {
@@ -1878,14 +2075,17 @@ NoteNagaArrangement::~NoteNagaArrangement() {
 }
 
 void NoteNagaArrangement::clear() {
-    for (auto *track : tracks_) {
-        delete track;
-    }
-    tracks_.clear();
+    // Tracks are deleted after the change is announced, the DSP engine drops them
+    // from the render plan and waits for the render in flight
+    std::vector<NoteNagaArrangementTrack*> oldTracks;
+    oldTracks.swap(tracks_);
     maxTick_ = 0;
     // Note: tempo track is NOT cleared here, only in destructor or removeTempoTrack()
     NN_QT_EMIT(tracksChanged());
     NN_QT_EMIT(maxTickChanged(0));
+    for (auto *track : oldTracks) {
+        delete track;
+    }
 }
 
 NoteNagaArrangementTrack* NoteNagaArrangement::addTrack(const std::string &name) {
@@ -1939,10 +2139,12 @@ bool NoteNagaArrangement::removeTrack(int trackId) {
     auto it = std::find_if(tracks_.begin(), tracks_.end(),
                            [trackId](NoteNagaArrangementTrack *t) { return t->getId() == trackId; });
     if (it != tracks_.end()) {
-        delete *it;
+        // Deleted after the change is announced (the DSP engine drops it from the render plan first)
+        NoteNagaArrangementTrack *track = *it;
         tracks_.erase(it);
         updateMaxTick();
         NN_QT_EMIT(tracksChanged());
+        delete track;
         return true;
     }
     return false;
@@ -1952,10 +2154,11 @@ bool NoteNagaArrangement::removeTrackByIndex(int index) {
     if (index < 0 || index >= static_cast<int>(tracks_.size())) {
         return false;
     }
-    delete tracks_[index];
+    NoteNagaArrangementTrack *track = tracks_[index];
     tracks_.erase(tracks_.begin() + index);
     updateMaxTick();
     NN_QT_EMIT(tracksChanged());
+    delete track;
     return true;
 }
 
@@ -2058,6 +2261,10 @@ NoteNagaTrack* NoteNagaArrangement::createTempoTrack(double defaultBpm) {
 #ifndef QT_DEACTIVATED
     connect(tempoTrack_, &NoteNagaTrack::tempoEventsChanged, this,
             [this](NoteNagaTrack*) { NN_QT_EMIT(tempoTrackChanged()); });
+    connect(tempoTrack_, &NoteNagaTrack::metadataChanged, this,
+            [this](NoteNagaTrack*, const std::string &param) {
+                if (param == "tempo_track_active") NN_QT_EMIT(tempoTrackChanged());
+            });
 #endif
     
     NOTE_NAGA_LOG_INFO("Created arrangement tempo track with default BPM: " + std::to_string(defaultBpm));
@@ -5,10 +5,20 @@
 DSPBlockChorus::DSPBlockChorus(float speed, float depth, float mix)
     : speed_(speed), depth_(depth), mix_(mix)
 {
+    resizeDelayBuffers();
+}
+
+void DSPBlockChorus::setSampleRate(float sampleRate) {
+    NoteNagaDSPBlockBase::setSampleRate(sampleRate);
+    resizeDelayBuffers();
+}
+
+void DSPBlockChorus::resizeDelayBuffers() {
     // Max delay for chorus typicky 25 ms
     maxDelaySamples_ = static_cast<size_t>(sampleRate_ * 0.025f); // 25 ms max
-    delayBufferL_.resize(maxDelaySamples_, 0.0f);
-    delayBufferR_.resize(maxDelaySamples_, 0.0f);
+    delayBufferL_.assign(maxDelaySamples_, 0.0f);
+    delayBufferR_.assign(maxDelaySamples_, 0.0f);
+    delayIdx_ = 0;
 }
 
 void DSPBlockChorus::prepareDelayBuffer(size_t numFrames) {
@@ -2,11 +2,19 @@
 
 #include <cmath>
 
+void DSPBlockCompressor::recalcCoefficients() {
+    attack_coeff_ = expf(-1.0f / (attack_ms_ * 0.001f * sampleRate_));
+    release_coeff_ = expf(-1.0f / (release_ms_ * 0.001f * sampleRate_));
+    makeupRamp_.setTarget(dB_to_linear(makeup_db_));
+    // Set after the targets: the first update after construction jumps to the initial values
+    makeupRamp_.setRampLength(smoothingFrames());
+}
+
 void DSPBlockCompressor::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float makeup = dB_to_linear(makeup_db_);
-    float attack_coeff = expf(-1.0f / (attack_ms_ * 0.001f * 44100.0f));
-    float release_coeff = expf(-1.0f / (release_ms_ * 0.001f * 44100.0f));
+    updateCoefficients();
+    const float attack_coeff = attack_coeff_;
+    const float release_coeff = release_coeff_;
 
     for (size_t i = 0; i < numFrames; ++i) {
         float rms = sqrtf(0.5f * (left[i]*left[i] + right[i]*right[i]) + 1e-12f);
@@ -25,6 +33,7 @@ void DSPBlockCompressor::process(float* left, float* right, size_t numFrames) {
         else
             gainSmooth_ = gainSmooth_ * release_coeff + gain * (1.0f - release_coeff);
 
+        float makeup = makeupRamp_.getNext();
         left[i] *= gainSmooth_ * makeup;
         right[i] *= gainSmooth_ * makeup;
     }
@@ -57,4 +66,5 @@ void DSPBlockCompressor::setParamValue(size_t idx, float value) {
         case 3: release_ms_ = value; break;
         case 4: makeup_db_ = value; break;
     }
+    invalidateCoefficients();
 }
\ No newline at end of file
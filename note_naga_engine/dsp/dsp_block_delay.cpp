@@ -5,7 +5,7 @@
 DSPBlockDelay::DSPBlockDelay(float time_ms, float feedback, float mix)
     : time_ms_(time_ms), feedback_(feedback), mix_(mix)
 {
-    setSampleRate(44100.0f); // default
+    resizeDelayBuffers();
 }
 
 void DSPBlockDelay::process(float* left, float* right, size_t numFrames) {
@@ -61,8 +61,12 @@ void DSPBlockDelay::setParamValue(size_t idx, float value) {
     }
 }
 
-void DSPBlockDelay::setSampleRate(float sr) {
-    sampleRate_ = sr;
+double DSPBlockDelay::getTailSeconds() const {
+    return feedbackTail(time_ms_ * 0.001, feedback_);
+}
+
+void DSPBlockDelay::setSampleRate(float sampleRate) {
+    NoteNagaDSPBlockBase::setSampleRate(sampleRate);
     resizeDelayBuffers();
 }
 
@@ -50,7 +50,7 @@ void DSPBlockDistortion::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
     
     // Tone control filter coefficient
-    float lpCoeff = std::exp(-2.0f * 3.14159f * (800.0f + tone_ * 15000.0f) / 44100.0f);
+    float lpCoeff = std::exp(-2.0f * 3.14159f * (800.0f + tone_ * 15000.0f) / sampleRate_);
     float hpAmount = 1.0f - tone_;
     
     for (size_t i = 0; i < numFrames; ++i) {
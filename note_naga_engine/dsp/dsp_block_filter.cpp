@@ -4,27 +4,32 @@
 #include <cmath>
 
 DSPBlockFilter::DSPBlockFilter(FilterType type, float cutoff, float resonance, float mix)
-    : type_(type), cutoff_(cutoff), resonance_(resonance), mix_(mix) {
-    setSampleRate(44100.0f);
-    calcCoeffs();
+    : type_(type), cutoff_(cutoff), resonance_(resonance), mix_(mix), cutoffSmooth_(cutoff), mixSmooth_(mix),
+      coeffType_(type) {
+    calcCoeffs(cutoff_);
 }
 
 void DSPBlockFilter::process(float *left, float *right, size_t numFrames) {
     if (!isActive()) return;
+    updateCoefficients();
+    // Cutoff changes ramp over a few blocks, the biquad is recomputed once per block
+    if (cutoffSmooth_.isSmoothing()) calcCoeffs(cutoffSmooth_.skip(numFrames));
+
     for (size_t i = 0; i < numFrames; ++i) {
+        const float mix = mixSmooth_.getNext();
         // Left
         float inL = left[i];
         float outL = a0_ * inL + a1_ * z1L_ + a2_ * z2L_ - b1_ * z1L_ - b2_ * z2L_;
         z2L_ = z1L_;
         z1L_ = outL;
-        left[i] = inL * (1.0f - mix_) + outL * mix_;
+        left[i] = inL * (1.0f - mix) + outL * mix;
 
         // Right
         float inR = right[i];
         float outR = a0_ * inR + a1_ * z1R_ + a2_ * z2R_ - b1_ * z1R_ - b2_ * z2R_;
         z2R_ = z1R_;
         z1R_ = outR;
-        right[i] = inR * (1.0f - mix_) + outR * mix_;
+        right[i] = inR * (1.0f - mix) + outR * mix;
     }
 }
 
@@ -60,37 +65,47 @@ void DSPBlockFilter::setParamValue(size_t idx, float value) {
     switch (idx) {
     case 0:
         type_ = static_cast<FilterType>(static_cast<int>(value));
-        calcCoeffs();
+        invalidateCoefficients();
         break;
     case 1:
         cutoff_ = value;
-        calcCoeffs();
+        invalidateCoefficients();
         break;
     case 2:
         resonance_ = value;
-        calcCoeffs();
+        invalidateCoefficients();
         break;
     case 3:
         mix_ = value;
+        invalidateCoefficients();
         break;
     }
 }
 
-void DSPBlockFilter::setSampleRate(float sr) {
-    sampleRate_ = sr;
-    calcCoeffs();
+void DSPBlockFilter::recalcCoefficients() {
+    cutoffSmooth_.setTarget(cutoff_);
+    mixSmooth_.setTarget(mix_);
+    // Set after the targets: the first update after construction jumps to the initial values
+    cutoffSmooth_.setRampLength(smoothingFrames());
+    mixSmooth_.setRampLength(smoothingFrames());
+    // A different filter type has an incompatible state
+    if (type_ != coeffType_) {
+        coeffType_ = type_;
+        z1L_ = z2L_ = z1R_ = z2R_ = 0.0f;
+    }
+    calcCoeffs(cutoffSmooth_.getCurrent());
 }
 
 // Biquad filter design (TPT, simple RBJ formula)
-void DSPBlockFilter::calcCoeffs() {
-    float freq = std::clamp(cutoff_, 20.0f, sampleRate_ * 0.45f);
+void DSPBlockFilter::calcCoeffs(float cutoff) {
+    float freq = std::clamp(cutoff, 20.0f, sampleRate_ * 0.45f);
     float Q = std::clamp(resonance_, 0.1f, 2.0f);
     float omega = 2.0f * M_PI * freq / sampleRate_;
     float sn = std::sin(omega);
     float cs = std::cos(omega);
     float alpha = sn / (2.0f * Q);
 
-    switch (type_) {
+    switch (coeffType_) {
     case FilterType::Lowpass: {
         float norm = 1.0f / (1.0f + alpha);
         a0_ = (1.0f - cs) * 0.5f * norm;
@@ -119,6 +134,4 @@ void DSPBlockFilter::calcCoeffs() {
         break;
     }
     }
-    // Clear state after parameter change
-    z1L_ = z2L_ = z1R_ = z2R_ = 0.0f;
 }
\ No newline at end of file
@@ -5,9 +5,23 @@
 DSPBlockFlanger::DSPBlockFlanger(float speed, float depth, float feedback, float mix)
     : speed_(speed), depth_(depth), feedback_(feedback), mix_(mix)
 {
+    resizeDelayBuffers();
+}
+
+double DSPBlockFlanger::getTailSeconds() const {
+    return feedbackTail(0.008, feedback_); // 8 ms max delay
+}
+
+void DSPBlockFlanger::setSampleRate(float sampleRate) {
+    NoteNagaDSPBlockBase::setSampleRate(sampleRate);
+    resizeDelayBuffers();
+}
+
+void DSPBlockFlanger::resizeDelayBuffers() {
     maxDelaySamples_ = static_cast<size_t>(sampleRate_ * 0.008f); // 8 ms max delay
-    delayBufferL_.resize(maxDelaySamples_, 0.0f);
-    delayBufferR_.resize(maxDelaySamples_, 0.0f);
+    delayBufferL_.assign(maxDelaySamples_, 0.0f);
+    delayBufferR_.assign(maxDelaySamples_, 0.0f);
+    delayIdx_ = 0;
 }
 
 void DSPBlockFlanger::process(float* left, float* right, size_t numFrames) {
@@ -1,10 +1,25 @@
 #include <note_naga_engine/dsp/dsp_block_gain.h>
 
+void DSPBlockGain::recalcCoefficients() {
+    gainRamp_.setTarget(powf(10.0f, gain_));
+    // Set after the targets: the first update after construction jumps to the initial values
+    gainRamp_.setRampLength(smoothingFrames());
+}
+
 void DSPBlockGain::process(float *left, float *right, size_t numFrames) {
     if (!isActive()) return;
-    if (gain_ == 0.0f) return; // No change needed
-    float appliedGain = powf(10.0f, gain_);
+    updateCoefficients();
+    if (!gainRamp_.isSmoothing()) {
+        const float appliedGain = gainRamp_.getCurrent();
+        if (appliedGain == 1.0f) return; // No change needed
+        for (size_t i = 0; i < numFrames; ++i) {
+            left[i] *= appliedGain;
+            right[i] *= appliedGain;
+        }
+        return;
+    }
     for (size_t i = 0; i < numFrames; ++i) {
+        const float appliedGain = gainRamp_.getNext();
         left[i] *= appliedGain;
         right[i] *= appliedGain;
     }
@@ -22,5 +37,8 @@ float DSPBlockGain::getParamValue(size_t idx) const {
 }
 
 void DSPBlockGain::setParamValue(size_t idx, float value) {
-    if (idx == 0) gain_ = value;
+    if (idx == 0) {
+        gain_ = value;
+        invalidateCoefficients();
+    }
 }
\ No newline at end of file
@@ -2,13 +2,23 @@
 
 #include <cmath>
 
+void DSPBlockLimiter::recalcCoefficients() {
+    release_coeff_ = expf(-1.0f / (release_ms_ * 0.001f * sampleRate_));
+    thresholdRamp_.setTarget(dB_to_linear(threshold_db_));
+    makeupRamp_.setTarget(dB_to_linear(makeup_db_));
+    // Set after the targets: the first update after construction jumps to the initial values
+    thresholdRamp_.setRampLength(smoothingFrames());
+    makeupRamp_.setRampLength(smoothingFrames());
+}
+
 void DSPBlockLimiter::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float threshold = dB_to_linear(threshold_db_);
-    float makeup = dB_to_linear(makeup_db_);
-    float release_coeff = expf(-1.0f / (release_ms_ * 0.001f * 44100.0f));
+    updateCoefficients();
+    const float release_coeff = release_coeff_;
 
     for (size_t i = 0; i < numFrames; ++i) {
+        float threshold = thresholdRamp_.getNext();
+        float makeup = makeupRamp_.getNext();
         float peak = std::max(std::fabs(left[i]), std::fabs(right[i]));
         float gain = 1.0f;
         if (peak > threshold) {
@@ -48,4 +58,5 @@ void DSPBlockLimiter::setParamValue(size_t idx, float value) {
         case 1: release_ms_ = value; break;
         case 2: makeup_db_ = value; break;
     }
+    invalidateCoefficients();
 }
\ No newline at end of file
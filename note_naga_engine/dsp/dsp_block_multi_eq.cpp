@@ -1,30 +1,40 @@
 #include <note_naga_engine/dsp/dsp_block_multi_eq.h>
 
+#include <cmath>
+
 DSPBlockMultiSimpleEQ::DSPBlockMultiSimpleEQ(const std::vector<float>& freqs, float q) {
     for (float f : freqs) {
         Band b;
         b.freq = f;
         b.gain = 0.0f;
         b.q = q;
+        b.gainSmooth.reset(b.gain);
         bands_.push_back(b);
     }
-    for (size_t i = 0; i < bands_.size(); ++i)
-        recalcCoeffs(int(i));
 }
 
-void DSPBlockMultiSimpleEQ::setSampleRate(float sr) {
-    sampleRate_ = sr;
-    for (size_t i = 0; i < bands_.size(); ++i)
-        recalcCoeffs(int(i));
+void DSPBlockMultiSimpleEQ::recalcCoefficients() {
+    // Band frequencies are fixed, the trigonometry depends only on the sample rate
+    if (trigSampleRate_ != sampleRate_) {
+        trigSampleRate_ = sampleRate_;
+        for (auto& band : bands_) {
+            float omega = 2.0f * float(M_PI) * band.freq / sampleRate_;
+            band.cs = std::cos(omega);
+            band.alpha = std::sin(omega) / (2.0f * band.q);
+        }
+    }
+    for (auto& band : bands_) {
+        band.gainSmooth.setTarget(band.gain);
+        // Set after the targets: the first update after construction jumps to the initial values
+        band.gainSmooth.setRampLength(smoothingFrames());
+        calcCoeffs(band, band.gainSmooth.getCurrent());
+    }
 }
 
-void DSPBlockMultiSimpleEQ::recalcCoeffs(int bandIdx) {
-    auto& band = bands_[bandIdx];
-    float A = std::pow(10.0f, band.gain / 40.0f);
-    float omega = 2.0f * float(M_PI) * band.freq / sampleRate_;
-    float sn = std::sin(omega);
-    float cs = std::cos(omega);
-    float alpha = sn / (2.0f * band.q);
+void DSPBlockMultiSimpleEQ::calcCoeffs(Band &band, float gain) {
+    float A = std::pow(10.0f, gain / 40.0f);
+    float cs = band.cs;
+    float alpha = band.alpha;
 
     float b0 = 1 + alpha*A;
     float b1 = -2*cs;
@@ -40,15 +50,17 @@ void DSPBlockMultiSimpleEQ::recalcCoeffs(int bandIdx) {
     band.a1 = a1 / a0;
     band.a2 = a2 / a0;
     band.a0 = 1.0f;
-
-    // clear state to avoid clicks at param change
-    band.x1l = band.x2l = band.y1l = band.y2l = 0.0f;
-    band.x1r = band.x2r = band.y1r = band.y2r = 0.0f;
 }
 
 void DSPBlockMultiSimpleEQ::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
 
+    // Coefficients are recalculated only after a gain change, then once per block while it ramps
+    updateCoefficients();
+    for (auto& band : bands_) {
+        if (band.gainSmooth.isSmoothing()) calcCoeffs(band, band.gainSmooth.skip(numFrames));
+    }
+
     for (size_t i = 0; i < numFrames; ++i) {
         float inL = left[i];
         float inR = right[i];
@@ -106,6 +118,6 @@ float DSPBlockMultiSimpleEQ::getParamValue(size_t idx) const {
 void DSPBlockMultiSimpleEQ::setParamValue(size_t idx, float value) {
     if (idx < bands_.size()) {
         bands_[idx].gain = value;
-        recalcCoeffs(int(idx));
+        invalidateCoefficients();
     }
 }
\ No newline at end of file
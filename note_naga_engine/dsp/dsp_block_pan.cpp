@@ -2,14 +2,24 @@
 
 #include <cmath>
 
+DSPBlockPan::DSPBlockPan(float pan)
+    : pan_(pan), leftGain_(std::cos(0.25f * M_PI * (pan + 1.0f))), rightGain_(std::sin(0.25f * M_PI * (pan + 1.0f))) {}
+
+void DSPBlockPan::recalcCoefficients() {
+    leftGain_.setTarget(std::cos(0.25f * M_PI * (pan_ + 1.0f)));
+    rightGain_.setTarget(std::sin(0.25f * M_PI * (pan_ + 1.0f)));
+    // Set after the targets: the first update after construction jumps to the initial values
+    leftGain_.setRampLength(smoothingFrames());
+    rightGain_.setRampLength(smoothingFrames());
+}
+
 void DSPBlockPan::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
-    float leftGain = std::cos(0.25f * M_PI * (pan_ + 1.0f));
-    float rightGain = std::sin(0.25f * M_PI * (pan_ + 1.0f));
+    updateCoefficients();
     for (size_t i = 0; i < numFrames; ++i) {
         float l = left[i], r = right[i];
-        left[i] = l * leftGain;
-        right[i] = r * rightGain;
+        left[i] = l * leftGain_.getNext();
+        right[i] = r * rightGain_.getNext();
     }
 }
 
@@ -17,4 +27,9 @@ std::vector<DSPParamDescriptor> DSPBlockPan::getParamDescriptors() {
     return { DSPParamDescriptor{ "Pan", DSPParamType::Float, DSControlType::DialCentered, -1.0f, 1.0f, 0.0f } };
 }
 float DSPBlockPan::getParamValue(size_t idx) const { return idx == 0 ? pan_ : 0.0f; }
-void DSPBlockPan::setParamValue(size_t idx, float value) { if (idx == 0) pan_ = value; }
\ No newline at end of file
+void DSPBlockPan::setParamValue(size_t idx, float value) {
+    if (idx == 0) {
+        pan_ = value;
+        invalidateCoefficients();
+    }
+}
\ No newline at end of file
@@ -3,16 +3,25 @@
 #include <algorithm>
 
 DSPBlockPitchShifter::DSPBlockPitchShifter(float semitones, float mix)
-    : semitones_(semitones), mix_(mix)
+    : semitones_(semitones), mix_(mix), mixRamp_(mix)
 {
     resizeBuffers();
 }
 
-void DSPBlockPitchShifter::setSampleRate(float sr) {
-    sampleRate_ = sr;
+void DSPBlockPitchShifter::setSampleRate(float sampleRate) {
+    NoteNagaDSPBlockBase::setSampleRate(sampleRate);
     resizeBuffers();
 }
 
+void DSPBlockPitchShifter::recalcCoefficients() {
+    ratio_ = std::pow(2.0f, semitones_ / 12.0f);
+    grainSize_ = sampleRate_ * 0.02f; // 20ms grains
+    grainPos_ = std::fmod(readPosL_, grainSize_);
+    mixRamp_.setTarget(mix_);
+    // Set after the targets: the first update after construction jumps to the initial values
+    mixRamp_.setRampLength(smoothingFrames());
+}
+
 void DSPBlockPitchShifter::resizeBuffers() {
     bufferSize_ = static_cast<size_t>(sampleRate_ * 0.2f); // 200ms buffer
     bufferL_.resize(bufferSize_, 0.0f);
@@ -20,16 +29,16 @@ void DSPBlockPitchShifter::resizeBuffers() {
     writeIdx_ = 0;
     readPosL_ = 0.0f;
     readPosR_ = 0.0f;
+    grainPos_ = 0.0f;
 }
 
 void DSPBlockPitchShifter::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
+    updateCoefficients();
     
-    // Calculate pitch ratio from semitones
-    float ratio = std::pow(2.0f, semitones_ / 12.0f);
-    
-    // Grain size for crossfade (samples)
-    const float grainSize = sampleRate_ * 0.02f; // 20ms grains
+    const float ratio = ratio_;
+    const float grainSize = grainSize_;
+    const float bufferLen = static_cast<float>(bufferSize_);
     
     for (size_t i = 0; i < numFrames; ++i) {
         // Write input to circular buffer
@@ -38,11 +47,11 @@ void DSPBlockPitchShifter::process(float* left, float* right, size_t numFrames)
         
         // Calculate read positions for two overlapping grains
         float readPos1 = readPosL_;
-        float readPos2 = std::fmod(readPosL_ + grainSize, static_cast<float>(bufferSize_));
+        float readPos2 = readPosL_ + grainSize;
+        if (readPos2 >= bufferLen) readPos2 -= bufferLen;
         
         // Crossfade position within grain
-        float grainPos = std::fmod(readPosL_, grainSize);
-        float fade1 = 0.5f - 0.5f * std::cos(3.14159f * grainPos / grainSize);
+        float fade1 = 0.5f - 0.5f * std::cos(3.14159f * grainPos_ / grainSize);
         float fade2 = 1.0f - fade1;
         
         // Read with interpolation - grain 1
@@ -65,14 +74,19 @@ void DSPBlockPitchShifter::process(float* left, float* right, size_t numFrames)
         float shiftedL = sampleL1 * fade1 + sampleL2 * fade2;
         float shiftedR = sampleR1 * fade1 + sampleR2 * fade2;
         
-        // Advance read position
+        // Advance read position, the grain position follows it without a per sample fmod
         readPosL_ += ratio;
-        if (readPosL_ >= bufferSize_) readPosL_ -= bufferSize_;
-        if (readPosL_ < 0.0f) readPosL_ += bufferSize_;
+        grainPos_ += ratio;
+        if (grainPos_ >= grainSize) grainPos_ -= grainSize;
+        if (readPosL_ >= bufferLen) {
+            readPosL_ -= bufferLen;
+            grainPos_ = std::fmod(readPosL_, grainSize);
+        }
         
         // Mix
-        left[i] = left[i] * (1.0f - mix_) + shiftedL * mix_;
-        right[i] = right[i] * (1.0f - mix_) + shiftedR * mix_;
+        const float mix = mixRamp_.getNext();
+        left[i] = left[i] * (1.0f - mix) + shiftedL * mix;
+        right[i] = right[i] * (1.0f - mix) + shiftedR * mix;
         
         writeIdx_ = (writeIdx_ + 1) % bufferSize_;
     }
@@ -98,4 +112,5 @@ void DSPBlockPitchShifter::setParamValue(size_t idx, float value) {
         case 0: semitones_ = value; break;
         case 1: mix_ = value; break;
     }
+    invalidateCoefficients();
 }
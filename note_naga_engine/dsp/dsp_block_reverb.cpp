@@ -22,7 +22,6 @@ float DSPBlockReverb::AllpassFilter::process(float inp) {
 
 DSPBlockReverb::DSPBlockReverb(float roomsize, float damping, float wet, float predelay)
     : roomsize_(roomsize), damping_(damping), wet_(wet), predelay_(predelay) {
-    setSampleRate(44100.0f);
     updateFilters();
 }
 
@@ -98,8 +97,14 @@ void DSPBlockReverb::setParamValue(size_t idx, float value) {
     }
 }
 
-void DSPBlockReverb::setSampleRate(float sr) {
-    sampleRate_ = sr;
+double DSPBlockReverb::getTailSeconds() const {
+    // The longest comb filter decays slowest, damping only shortens the tail
+    const double combPeriod = 1387.0 * roomsize_ / sampleRate_;
+    return predelay_ * 0.001 + feedbackTail(combPeriod, 0.7 + roomsize_ * 0.25);
+}
+
+void DSPBlockReverb::setSampleRate(float sampleRate) {
+    NoteNagaDSPBlockBase::setSampleRate(sampleRate);
     updateFilters();
 }
 
@@ -1,20 +1,24 @@
 #include <note_naga_engine/dsp/dsp_block_single_eq.h>
 
 DSPBlockSingleEQ::DSPBlockSingleEQ(float freq, float gain, float q)
-    : freq_(freq), gain_(gain), q_(q)
+    : freq_(freq), gain_(gain), q_(q), freqSmooth_(freq), gainSmooth_(gain)
 {
-    recalcCoeffs();
+    calcCoeffs(freq_, gain_);
 }
 
-void DSPBlockSingleEQ::setSampleRate(float sr) {
-    sampleRate_ = sr;
-    recalcCoeffs();
+void DSPBlockSingleEQ::recalcCoefficients() {
+    freqSmooth_.setTarget(freq_);
+    gainSmooth_.setTarget(gain_);
+    // Set after the targets: the first update after construction jumps to the initial values
+    freqSmooth_.setRampLength(smoothingFrames());
+    gainSmooth_.setRampLength(smoothingFrames());
+    calcCoeffs(freqSmooth_.getCurrent(), gainSmooth_.getCurrent());
 }
 
-void DSPBlockSingleEQ::recalcCoeffs() {
+void DSPBlockSingleEQ::calcCoeffs(float freq, float gain) {
     // RBJ peak EQ
-    float A = powf(10.0f, gain_ / 40.0f);
-    float omega = 2.0f * float(M_PI) * freq_ / sampleRate_;
+    float A = powf(10.0f, gain / 40.0f);
+    float omega = 2.0f * float(M_PI) * freq / sampleRate_;
     float sn = sinf(omega);
     float cs = cosf(omega);
     float alpha = sn / (2.0f * q_);
@@ -33,18 +37,15 @@ void DSPBlockSingleEQ::recalcCoeffs() {
     a1_ = a1 / a0;
     a2_ = a2 / a0;
     a0_ = 1.0f; // always 1
-
-    // clear state to avoid clicks at param change
-    x1l_ = x2l_ = y1l_ = y2l_ = 0.0f;
-    x1r_ = x2r_ = y1r_ = y2r_ = 0.0f;
 }
 
 void DSPBlockSingleEQ::process(float* left, float* right, size_t numFrames) {
     if (!isActive()) return;
 
-    // coefficients should only be recalculated when param changes
-    // -> recalcCoeffs() volat jen v setParamValue!
-    // recalcCoeffs();
+    // Coefficients are recalculated only after a parameter change, then once per block while it ramps
+    updateCoefficients();
+    if (freqSmooth_.isSmoothing() || gainSmooth_.isSmoothing())
+        calcCoeffs(freqSmooth_.skip(numFrames), gainSmooth_.skip(numFrames));
 
     for (size_t i = 0; i < numFrames; ++i) {
         // Left
@@ -86,5 +87,5 @@ void DSPBlockSingleEQ::setParamValue(size_t idx, float value) {
     if (idx == 0) freq_ = value;
     if (idx == 1) gain_ = value;
     if (idx == 2) q_ = value;
-    recalcCoeffs();
+    invalidateCoefficients();
 }
\ No newline at end of file
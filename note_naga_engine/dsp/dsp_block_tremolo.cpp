@@ -42,8 +42,4 @@ void DSPBlockTremolo::setParamValue(size_t idx, float value) {
         case 1: depth_ = value; break;
         case 2: mix_ = value; break;
     }
-}
-
-void DSPBlockTremolo::setSampleRate(float sr) {
-    sampleRate_ = sr;
 }
\ No newline at end of file
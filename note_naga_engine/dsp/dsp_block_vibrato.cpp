@@ -8,8 +8,8 @@ DSPBlockVibrato::DSPBlockVibrato(float speed, float depth, float mix)
     resizeBuffers();
 }
 
-void DSPBlockVibrato::setSampleRate(float sr) {
-    sampleRate_ = sr;
+void DSPBlockVibrato::setSampleRate(float sampleRate) {
+    NoteNagaDSPBlockBase::setSampleRate(sampleRate);
     resizeBuffers();
 }
 
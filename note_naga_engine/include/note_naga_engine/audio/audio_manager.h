@@ -47,6 +47,35 @@ public:
      */
     int getSampleRate() const { return sampleRate_; }
     
+    /**
+     * @brief Set the sample rate converter quality used for newly imported audio.
+     * @param quality Resampler quality.
+     */
+    void setResamplerQuality(NN_ResamplerQuality_t quality) { resamplerQuality_ = quality; }
+    
+    /**
+     * @brief Get the sample rate converter quality used for imported audio.
+     */
+    NN_ResamplerQuality_t getResamplerQuality() const { return resamplerQuality_; }
+    
+    /**
+     * @brief Set the directory of the waveform peak cache (usually next to the project file).
+     * Resources imported afterwards read their peaks from it when the audio file is unchanged.
+     * @param directory Cache directory, empty disables the cache.
+     */
+    void setPeakCacheDirectory(const std::string& directory) { peakCacheDirectory_ = directory; }
+    
+    /**
+     * @brief Get the directory of the waveform peak cache.
+     */
+    const std::string& getPeakCacheDirectory() const { return peakCacheDirectory_; }
+    
+    /**
+     * @brief Write waveform peaks of all resources to the peak cache directory.
+     * @return True if all caches were written.
+     */
+    bool savePeakCaches() const;
+    
     /**
      * @brief Import an audio file and add it to the resource pool.
      * @param filePath Path to the audio file.
@@ -114,6 +143,17 @@ public:
      */
     void prepareForPlayback(int64_t tick, int ppq, int tempo);
     
+    /**
+     * @brief Get the total number of streaming underruns of all resources.
+     * @return Sum of NoteNagaAudioResource::getUnderrunCount().
+     */
+    uint64_t getUnderrunCount() const;
+    
+    /**
+     * @brief Reset the underrun counters of all resources.
+     */
+    void resetUnderrunStats();
+    
     /**
      * @brief Get the next resource ID.
      */
@@ -134,6 +174,8 @@ public:
 
 private:
     int sampleRate_;
+    NN_ResamplerQuality_t resamplerQuality_ = NN_ResamplerQuality_t::Standard;
+    std::string peakCacheDirectory_;
     int nextResourceId_ = 1;
     std::vector<std::unique_ptr<NoteNagaAudioResource>> resources_;
     std::unordered_map<int, NoteNagaAudioResource*> resourceById_;
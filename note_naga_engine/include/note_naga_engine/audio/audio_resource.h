@@ -2,11 +2,14 @@
 #define NOTE_NAGA_AUDIO_RESOURCE_H
 
 #include "../note_naga_api.h"
+#include "resampler.h"
 
 #include <string>
 #include <vector>
 #include <memory>
 #include <atomic>
+#include <cstdint>
+#include <fstream>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
@@ -54,6 +57,12 @@ struct NOTE_NAGA_ENGINE_API NN_AudioClip_t {
 /**
  * @brief Represents an audio resource loaded from disk.
  * Handles streaming, caching, and waveform generation.
+ *
+ * Short files are decoded into memory at load time. Longer files are never held
+ * in memory as a whole: a background I/O thread reads the WAV data chunk in
+ * blocks, decodes and resamples them and keeps a read-ahead ring buffer of
+ * BUFFER_SECONDS filled ahead of the playback position. getSamples() reads the
+ * ring without locking, so RAM per streamed resource is bounded by the ring size.
  */
 #ifndef QT_DEACTIVATED
 class NOTE_NAGA_ENGINE_API NoteNagaAudioResource : public QObject {
@@ -87,45 +96,130 @@ public:
     const std::string& getErrorMessage() const { return errorMessage_; }
     
     /**
-     * @brief Get waveform peaks for rendering.
+     * @brief Get waveform peaks for rendering (finest level of the peak pyramid).
      * @return Vector of peak data.
      */
-    const std::vector<NN_WaveformPeak_t>& getWaveformPeaks() const { return waveformPeaks_; }
+    const std::vector<NN_WaveformPeak_t>& getWaveformPeaks() const { return getWaveformPeaks(0); }
     
     /**
-     * @brief Get number of samples per peak.
+     * @brief Get number of samples per peak (finest level of the peak pyramid).
      */
     int getSamplesPerPeak() const { return samplesPerPeak_; }
     
+    /**
+     * @brief Get number of levels of the waveform peak pyramid.
+     * Level 0 has getSamplesPerPeak() samples per peak, every next level is
+     * PEAK_LEVEL_FACTOR times coarser.
+     */
+    int getPeakLevelCount() const { return static_cast<int>(peakLevels_.size()); }
+    
+    /**
+     * @brief Get waveform peaks of one pyramid level.
+     * @param level Pyramid level (0 = finest).
+     * @return Vector of peak data (empty for an invalid level).
+     */
+    const std::vector<NN_WaveformPeak_t>& getWaveformPeaks(int level) const;
+    
+    /**
+     * @brief Get number of samples per peak of one pyramid level.
+     * @param level Pyramid level (0 = finest).
+     */
+    int64_t getSamplesPerPeak(int level) const;
+    
+    /**
+     * @brief Select the coarsest pyramid level which still has at least one peak
+     * per pixel, so drawing touches O(pixels) peaks at any zoom.
+     * @param samplesPerPixel Number of audio samples covered by one pixel column.
+     * @return Pyramid level.
+     */
+    int selectPeakLevel(double samplesPerPixel) const;
+    
+    /**
+     * @brief Write the waveform peaks to a binary sidecar file in a cache directory.
+     * @param cacheDirectory Directory of the peak cache (created if missing).
+     * @return True if successful.
+     */
+    bool savePeakCache(const std::string &cacheDirectory) const;
+    
     /**
      * @brief Load the audio file and prepare for streaming.
      * @param targetSampleRate Target sample rate for resampling.
+     * @param quality Sample rate converter quality (used when the file rate differs).
+     * @param peakCacheDirectory Directory with cached waveform peaks (empty = no cache).
+     *        Peaks are read from the cache when the file is unchanged, otherwise they are
+     *        computed and the cache is updated.
      * @return True if successful.
      */
-    bool load(int targetSampleRate);
+    bool load(int targetSampleRate,
+              NN_ResamplerQuality_t quality = NN_ResamplerQuality_t::Standard,
+              const std::string &peakCacheDirectory = std::string());
     
     /**
      * @brief Get audio samples for a given range. Handles streaming buffer.
+     *
+     * Real-time safe: never blocks and never touches the disk. For streamed files,
+     * samples which are not buffered yet are zero-filled and the I/O thread is
+     * asked to reposition the read-ahead window.
      * @param startSample Start sample index.
      * @param numSamples Number of samples to get.
      * @param outLeft Output buffer for left channel.
      * @param outRight Output buffer for right channel.
-     * @return Number of samples actually read.
+     * @return Number of samples written (clamped to the end of the resource).
      */
     int getSamples(int64_t startSample, int numSamples, 
                    float* outLeft, float* outRight);
     
     /**
      * @brief Prepare streaming buffer for upcoming playback position.
-     * Call this ahead of time to ensure data is ready.
+     * Call this ahead of time to ensure data is ready. Returns immediately,
+     * the buffer is refilled by the I/O thread.
      * @param startSample Sample position to prepare for.
      */
     void prepareForPosition(int64_t startSample);
     
+    /**
+     * @brief Read audio samples for offline processing (export).
+     * Blocking: streamed files are decoded from disk through a private file handle,
+     * the real-time read-ahead ring is neither read nor repositioned. Safe to call
+     * from any thread.
+     * @param startSample Start sample index.
+     * @param numSamples Number of samples to read.
+     * @param outLeft Output buffer for left channel.
+     * @param outRight Output buffer for right channel.
+     * @return Number of samples written (clamped to the end of the resource).
+     */
+    int64_t readSamples(int64_t startSample, int64_t numSamples, float *outLeft, float *outRight);
+    
+    /**
+     * @brief Offline reader keeping its file handle and decode buffers between reads (see below).
+     */
+    class Reader;
+    
     /**
      * @brief Set the unique ID.
      */
     void setId(int id) { id_ = id; }
+    
+    /**
+     * @brief Check if the resource is streamed from disk (not fully cached in memory).
+     */
+    bool isStreamed() const { return loaded_ && !useFullAudioCache_; }
+    
+    /**
+     * @brief Number of getSamples() calls which could not be fully served from the
+     * streaming buffer and were (partially) zero-filled.
+     */
+    uint64_t getUnderrunCount() const { return underrunCount_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Total number of zero-filled samples caused by underruns.
+     */
+    uint64_t getUnderrunSamples() const { return underrunSamples_.load(std::memory_order_relaxed); }
+    
+    /**
+     * @brief Reset the underrun counters.
+     */
+    void resetUnderrunStats();
 
 private:
     int id_ = -1;
@@ -148,37 +242,92 @@ private:
     bool hasError_ = false;
     std::string errorMessage_;
     
-    // Waveform peaks for visualization
-    std::vector<NN_WaveformPeak_t> waveformPeaks_;
+    // Waveform peak pyramid for visualization (level 0 = samplesPerPeak_)
+    static constexpr int PEAK_LEVEL_FACTOR = 4;
+    std::vector<std::vector<NN_WaveformPeak_t>> peakLevels_;
     int samplesPerPeak_ = 256;
+    NN_ResamplerQuality_t resamplerQuality_ = NN_ResamplerQuality_t::Standard;
     
-    // Streaming buffer (4 seconds of audio)
+    // Layout of the source WAV file
+    struct SourceFormat {
+        uint16_t audioFormat = 0;    ///< 1 = PCM, 3 = IEEE float
+        uint16_t numChannels = 0;
+        uint16_t bitsPerSample = 0;
+        int blockAlign = 0;          ///< Bytes per source frame
+        uint64_t dataOffset = 0;     ///< File offset of the first sample of the data chunk
+        int64_t dataFrames = 0;      ///< Number of source frames in the data chunk
+    };
+    SourceFormat source_;
+    
+    // Decode scratch buffers (one set per reading thread)
+    struct DecodeScratch {
+        std::vector<uint8_t> raw;
+        std::vector<float> left;
+        std::vector<float> right;
+    };
+    
+    // Streaming ring buffer (4 seconds of audio), sample i lives in slot i % capacity.
+    // Holds the window [bufferStartSample_, bufferEndSample_), written only by the
+    // I/O thread and read lock-free by getSamples().
     static constexpr int BUFFER_SECONDS = 4;
+    static constexpr int64_t STREAM_CHUNK_SAMPLES = 16384;
     std::vector<float> streamBufferLeft_;
     std::vector<float> streamBufferRight_;
-    int64_t bufferStartSample_ = 0;
-    int64_t bufferEndSample_ = 0;
-    std::mutex bufferMutex_;
+    std::atomic<int64_t> bufferStartSample_{0};
+    std::atomic<int64_t> bufferEndSample_{0};
+    std::atomic<uint64_t> bufferGeneration_{0}; ///< Odd while the I/O thread repositions the window
+    std::atomic<int64_t> readPosition_{0};      ///< Last position read by getSamples()
+    std::atomic<uint64_t> underrunCount_{0};
+    std::atomic<uint64_t> underrunSamples_{0};
     
     // Background loading
     std::thread loadThread_;
     std::atomic<bool> loadThreadRunning_{false};
     std::atomic<int64_t> requestedPosition_{0};
+    std::atomic<bool> seekRequested_{false};
     std::condition_variable loadCondition_;
     std::mutex loadMutex_;
     
-    // Full audio data (for small files) or file handle for streaming
+    // Sample rate converter (nullptr when the file already has the target rate)
+    std::unique_ptr<NoteNagaResampler> resampler_;
+    
+    // Full audio data (for small files only)
     std::vector<float> fullAudioLeft_;
     std::vector<float> fullAudioRight_;
     bool useFullAudioCache_ = false;
     
     // Internal methods
-    bool loadWavFile(int targetSampleRate);
+    bool loadWavFile(int targetSampleRate, NN_ResamplerQuality_t quality);
+    bool readWavHeader(std::ifstream &file);
+    int64_t readSourceFrames(std::ifstream &file, int64_t firstFrame, int64_t numFrames,
+                             DecodeScratch &scratch, float *outLeft, float *outRight);
+    int64_t readOutputSamples(std::ifstream &file, int64_t startSample, int64_t numSamples,
+                              float *outLeft, float *outRight, DecodeScratch &scratch);
     void generateWaveformPeaks();
-    void resampleAudio(const std::vector<float>& input, std::vector<float>& output,
-                       int inputRate, int outputRate);
+    void buildPeakPyramid();
+    void accumulatePeaks(std::vector<NN_WaveformPeak_t> &peaks, int64_t startSample,
+                         const float *left, const float *right, int64_t numSamples) const;
+    std::string peakCacheFilePath(const std::string &cacheDirectory) const;
+    bool loadPeakCache(const std::string &cacheDirectory);
+    
+    // Peak cache sidecar header, the cache is valid only if it matches the current
+    // file size, modification time and decoding settings
+    static constexpr uint32_t PEAK_CACHE_VERSION = 1;
+    struct PeakCacheHeader {
+        char magic[4] = {};
+        uint32_t version = 0;
+        uint64_t fileSize = 0;
+        int64_t modifiedTime = 0;
+        int32_t sampleRate = 0;
+        int32_t resamplerQuality = 0;
+        int64_t totalSamples = 0;
+        int32_t samplesPerPeak = 0;
+        int32_t reserved = 0;
+    };
+    bool makePeakCacheHeader(PeakCacheHeader &header) const;
     void streamingThreadFunc();
-    void loadBufferRange(int64_t startSample, int64_t endSample);
+    void repositionBuffer(int64_t startSample);
+    void fillBuffer(int64_t startSample, const float *left, const float *right, int64_t numSamples);
     
 #ifndef QT_DEACTIVATED
 Q_SIGNALS:
@@ -187,4 +336,30 @@ Q_SIGNALS:
 #endif
 };
 
+/**
+ * @brief Reads a resource block by block for offline processing (export).
+ * Same results as NoteNagaAudioResource::readSamples(), but the file is opened once and
+ * the decode buffers are reused, so a long render does no per-block open or allocation.
+ * A reader may move between threads but must not be used by two threads at once.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaAudioResource::Reader {
+public:
+    /**
+     * @brief Create a reader, the file is opened on the first streamed read.
+     * @param resource Loaded resource, must outlive the reader.
+     */
+    explicit Reader(NoteNagaAudioResource *resource) : resource_(resource) {}
+    
+    /**
+     * @brief Read audio samples (see NoteNagaAudioResource::readSamples()).
+     * @return Number of samples written (clamped to the end of the resource).
+     */
+    int64_t read(int64_t startSample, int64_t numSamples, float *outLeft, float *outRight);
+
+private:
+    NoteNagaAudioResource *resource_;
+    std::ifstream file_;
+    DecodeScratch scratch_;
+};
+
 #endif // NOTE_NAGA_AUDIO_RESOURCE_H
@@ -0,0 +1,117 @@
+#ifndef NOTE_NAGA_MIX_KERNELS_H
+#define NOTE_NAGA_MIX_KERNELS_H
+
+#include "../note_naga_api.h"
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Linear fade envelope of one block.
+ *
+ * gain(i) = clamp(in_start + i * in_step, 0, 1) * clamp(out_start + i * out_step, 0, 1),
+ * i.e. the fade in and fade out ramps of a clip evaluated for the frames of the block.
+ * Parts of a clip outside both fades give a gain of exactly 1.
+ */
+struct NOTE_NAGA_ENGINE_API NN_FadeRamp_t {
+    float in_start = 1.0f;  ///< Fade in gain at the first frame (before clamping)
+    float in_step = 0.0f;   ///< Fade in gain change per frame
+    float out_start = 1.0f; ///< Fade out gain at the first frame (before clamping)
+    float out_step = 0.0f;  ///< Fade out gain change per frame (negative)
+
+    /**
+     * @brief Envelope of a clip for a block.
+     * @param block_start Sample position of the first frame of the block.
+     * @param num_frames Frames in the block.
+     * @param clip_start Sample position of the clip start.
+     * @param fade_in Fade in length in samples (0 = none).
+     * @param fade_out_end Sample position where the fade out reaches silence (clip end).
+     * @param fade_out Fade out length in samples (0 = none).
+     */
+    static NN_FadeRamp_t forBlock(int64_t block_start, size_t num_frames, int64_t clip_start, int64_t fade_in,
+                                  int64_t fade_out_end, int64_t fade_out);
+
+    /**
+     * @brief True if the envelope is 1 for the whole block (nothing to apply).
+     */
+    bool isUnity() const { return in_step == 0.0f && out_step == 0.0f && in_start >= 1.0f && out_start >= 1.0f; }
+};
+
+/**
+ * @name Mix kernels
+ * Vectorized loops of the mixing hot paths. Every function exists in a scalar, an SSE2
+ * (x86-64 baseline), an AVX2 and a NEON version; the best one supported by the CPU is chosen
+ * once at runtime (the AVX2 version is built with its own compiler flags and used only when the
+ * CPU reports AVX2 and FMA). Buffers need no particular alignment and may have any length.
+ * @{
+ */
+
+/**
+ * @brief dst[i] += src[i].
+ */
+NOTE_NAGA_ENGINE_API void nn_mix_add(float *dst, const float *src, size_t num_frames);
+
+/**
+ * @brief Scale a stereo block by a constant gain per channel and a fade envelope.
+ * @param left Left channel (in place).
+ * @param right Right channel (in place).
+ * @param num_frames Frames in the block.
+ * @param gain_left Constant left gain.
+ * @param gain_right Constant right gain.
+ * @param ramp Fade envelope of the block.
+ */
+NOTE_NAGA_ENGINE_API void nn_apply_gain(float *left, float *right, size_t num_frames, float gain_left,
+                                        float gain_right, const NN_FadeRamp_t &ramp = NN_FadeRamp_t{});
+
+/**
+ * @brief Pan crossfeed of a stereo block: at center both channels stay, towards one side the
+ * other channel is folded in (left' = left * pan_left + right * (1 - pan_right), and mirrored).
+ * @param left Left channel (in place).
+ * @param right Right channel (in place).
+ * @param num_frames Frames in the block.
+ * @param pan_left Left gain of the constant power pan law.
+ * @param pan_right Right gain of the constant power pan law.
+ */
+NOTE_NAGA_ENGINE_API void nn_pan_crossfeed(float *left, float *right, size_t num_frames, float pan_left,
+                                           float pan_right);
+
+/**
+ * @brief Constant power pan gains.
+ * @param pan Pan position (-1 = left, 0 = center, 1 = right).
+ * @param pan_left Receives the left gain (cos).
+ * @param pan_right Receives the right gain (sin).
+ */
+NOTE_NAGA_ENGINE_API void nn_pan_gains(float pan, float &pan_left, float &pan_right);
+
+/**
+ * @brief Accumulate the sum of squares and the peak of a signal.
+ * @param samples Input samples.
+ * @param num_frames Number of samples.
+ * @param sum_sq Sum of squares, the block is added to it.
+ * @param peak Peak absolute value, raised to the block peak.
+ */
+NOTE_NAGA_ENGINE_API void nn_sum_squares_peak(const float *samples, size_t num_frames, float &sum_sq, float &peak);
+
+/**
+ * @brief Interleave two channels into L R L R ...
+ */
+NOTE_NAGA_ENGINE_API void nn_interleave(float *out, const float *left, const float *right, size_t num_frames);
+
+/**
+ * @brief Split L R L R ... into two channels.
+ */
+NOTE_NAGA_ENGINE_API void nn_deinterleave(const float *in, float *left, float *right, size_t num_frames);
+
+/**
+ * @brief Dot product sum(a[i] * b[i]) (resampler filter taps).
+ */
+NOTE_NAGA_ENGINE_API float nn_dot_product(const float *a, const float *b, size_t n);
+
+/**
+ * @brief Name of the instruction set the kernels use ("avx2", "sse2", "neon" or "scalar").
+ */
+NOTE_NAGA_ENGINE_API const char *nn_mix_kernels_isa();
+
+/** @} */
+
+#endif // NOTE_NAGA_MIX_KERNELS_H
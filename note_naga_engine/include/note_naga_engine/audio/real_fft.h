@@ -0,0 +1,68 @@
+#ifndef NOTE_NAGA_REAL_FFT_H
+#define NOTE_NAGA_REAL_FFT_H
+
+#include "../note_naga_api.h"
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief Planned FFT of real input (power of two sizes).
+ *
+ * A real signal of N samples is packed into N/2 complex values (even samples real, odd
+ * samples imaginary), transformed by an iterative radix-2 complex FFT of size N/2 and
+ * split into the N/2 + 1 bins of the real spectrum. Bit reversal indices, the twiddles of
+ * every stage and the split twiddles are computed once by the constructor, data is kept in
+ * split real/imaginary arrays so the butterflies run 4 at a time with SSE or NEON.
+ *
+ * forward() and magnitudes() do not allocate. They use the plan's work buffers, so one
+ * instance must not be used by several threads at once (create one per thread).
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaRealFFT {
+public:
+    /**
+     * @brief Create the plan.
+     * @param size Transform size, a power of two of at least 4 (other values are rounded up).
+     */
+    explicit NoteNagaRealFFT(size_t size);
+
+    /**
+     * @brief Transform size N.
+     */
+    size_t getSize() const { return size_; }
+
+    /**
+     * @brief Number of spectrum bins, N / 2 + 1 (DC to Nyquist).
+     */
+    size_t getBinCount() const { return half_ + 1; }
+
+    /**
+     * @brief Forward transform (unnormalized, same scale as nn_fft()).
+     * @param input N real samples.
+     * @param out_re Real parts of getBinCount() bins.
+     * @param out_im Imaginary parts of getBinCount() bins.
+     */
+    void forward(const float *input, float *out_re, float *out_im);
+
+    /**
+     * @brief Magnitudes of the first N / 2 bins (DC up to, not including, Nyquist).
+     * @param input N real samples.
+     * @param out N / 2 magnitudes.
+     */
+    void magnitudes(const float *input, float *out);
+
+private:
+    size_t size_;                ///< N
+    size_t half_;                ///< N / 2, size of the complex transform
+    std::vector<size_t> bitrev_; ///< Bit reversed index of each complex input
+    std::vector<float> tw_re_;   ///< Stage twiddles, stage with half size h at [h, 2h)
+    std::vector<float> tw_im_;
+    std::vector<float> split_re_; ///< exp(-2 pi i k / N) for the real split
+    std::vector<float> split_im_;
+    std::vector<float> work_re_; ///< Complex transform work buffer
+    std::vector<float> work_im_;
+
+    void transform(const float *input);
+};
+
+#endif // NOTE_NAGA_REAL_FFT_H
@@ -0,0 +1,102 @@
+#ifndef NOTE_NAGA_RESAMPLER_H
+#define NOTE_NAGA_RESAMPLER_H
+
+#include "../note_naga_api.h"
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Quality level of the sample rate converter.
+ */
+enum class NN_ResamplerQuality_t {
+    Linear,   ///< 2-tap linear interpolation (no anti-aliasing, cheapest)
+    Fast,     ///< 16-tap windowed sinc
+    Standard, ///< 48-tap windowed sinc
+    High      ///< 96-tap windowed sinc
+};
+
+/**
+ * @brief Band-limited polyphase sample rate converter (Kaiser windowed sinc).
+ *
+ * The conversion ratio is reduced to L/M (output/input rate). When L is small
+ * enough every output phase has its own precomputed filter row, otherwise the
+ * filter is evaluated from a finer table by interpolating between adjacent rows.
+ * When downsampling the cutoff follows the output Nyquist frequency.
+ *
+ * The converter is stateless and addressed by absolute positions: output sample n
+ * is computed from input frames around n * M / L. Any range of output samples can
+ * be produced from the matching input window (getInputRange()), so long inputs can
+ * be converted chunk by chunk (import, disk streaming) and random access (seeking)
+ * needs no priming. process() is const and does not allocate, so one instance may
+ * be shared by several threads.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaResampler {
+public:
+    /**
+     * @brief Constructor.
+     * @param inputRate Input sample rate in Hz.
+     * @param outputRate Output sample rate in Hz.
+     * @param quality Filter quality.
+     */
+    NoteNagaResampler(int inputRate, int outputRate,
+                      NN_ResamplerQuality_t quality = NN_ResamplerQuality_t::Standard);
+
+    int getInputRate() const { return inputRate_; }
+    int getOutputRate() const { return outputRate_; }
+    NN_ResamplerQuality_t getQuality() const { return quality_; }
+
+    /**
+     * @brief Number of filter taps per output sample (padded to a multiple of 8).
+     */
+    int getTaps() const { return taps_; }
+
+    /**
+     * @brief Number of output samples produced from an input of the given length.
+     * @param inputFrames Input length in frames.
+     * @return floor(inputFrames * outputRate / inputRate).
+     */
+    int64_t getOutputLength(int64_t inputFrames) const;
+
+    /**
+     * @brief Input frames needed to compute an output range.
+     * @param outputStart First output sample.
+     * @param outputCount Number of output samples.
+     * @param inputFirst Receives the first needed input frame (may be negative).
+     * @param inputCount Receives the number of needed input frames.
+     */
+    void getInputRange(int64_t outputStart, int64_t outputCount,
+                       int64_t &inputFirst, int64_t &inputCount) const;
+
+    /**
+     * @brief Convert a range of output samples of one channel.
+     * @param input Input frames, input[0] is frame inputFirst. Must cover the range
+     *        returned by getInputRange() (frames outside of the signal must be zero).
+     * @param inputFirst Absolute index of input[0].
+     * @param outputStart First output sample to compute.
+     * @param outputCount Number of output samples.
+     * @param output Output buffer (outputCount samples).
+     */
+    void process(const float *input, int64_t inputFirst,
+                 int64_t outputStart, int64_t outputCount, float *output) const;
+
+private:
+    int inputRate_;
+    int outputRate_;
+    NN_ResamplerQuality_t quality_;
+
+    int64_t up_ = 1;      ///< L (reduced output rate)
+    int64_t down_ = 1;    ///< M (reduced input rate)
+    int halfTaps_ = 1;    ///< Taps on each side of the filter center
+    int taps_ = 2;        ///< Taps per row (2 * halfTaps_)
+    int phases_ = 1;      ///< Number of table rows (excluding the guard row)
+    bool exactPhases_ = true; ///< One row per output phase (phases_ == up_)
+
+    /// Filter rows, (phases_ + 1) * taps_ coefficients, row p is the filter for the
+    /// fractional input position p / phases_
+    std::vector<float> coeffs_;
+
+    void buildTable(double cutoff, double beta);
+};
+
+#endif // NOTE_NAGA_RESAMPLER_H
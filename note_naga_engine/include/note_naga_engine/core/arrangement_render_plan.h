@@ -0,0 +1,99 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+#include <note_naga_engine/core/types.h>
+#include <note_naga_engine/module/analysis_bus.h>
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+class NoteNagaRuntimeData;
+
+/**
+ * @brief Precomputed routing table for arrangement rendering.
+ *
+ * For every synthesizer used by the arrangement the plan stores a flat, sorted list of
+ * timeline segments. Each segment says which arrangement track owns the synth in that
+ * time range and which clip (fade envelope) is active. The DSP engine walks these
+ * segments with a per-synth cursor, so crossing a clip boundary is a cursor step and the
+ * audio callback needs no maps, sets or getClipsAtTick() allocations.
+ *
+ * The plan is built on a non-audio thread (on clipsChanged/tracksChanged, sequence list
+ * or synth changes) and published by NoteNagaDSPEngine like the DSP render graph.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaArrangementRenderPlan {
+public:
+    /// Time range with a constant owner (arrangement track + clip) for one synth
+    struct Segment {
+        int start_tick = 0;       ///< Segment start (inclusive)
+        int end_tick = 0;         ///< Segment end (exclusive)
+        int arr_track_index = -1; ///< Index into getArrangementTracks()
+        int clip_start_tick = 0;  ///< Start tick of the owning clip
+        int clip_end_tick = 0;    ///< End tick of the owning clip
+        int fade_in_ticks = 0;    ///< Fade in of the owning clip
+        int fade_out_ticks = 0;   ///< Fade out of the owning clip
+    };
+
+    /// Render entry of one synthesizer
+    struct SynthEntry {
+        INoteNagaSoftSynth *synth = nullptr;
+        std::vector<Segment> segments; ///< Sorted, non-overlapping
+        size_t cursor = 0;             ///< Last found segment (audio thread only)
+
+        /// Fade out continued after the clip ended (written by the audio thread,
+        /// carried over to the next plan when it is rebuilt)
+        std::atomic<int64_t> fade_out_end_sample{0};
+        std::atomic<int64_t> fade_out_samples{0};
+
+        /**
+         * @brief Find the segment containing a tick. Amortized O(1) for monotonic playback,
+         * O(log n) after a seek. Audio thread only (moves the cursor).
+         * @param tick Arrangement tick.
+         * @return Active segment or nullptr if no clip owns the synth at this tick.
+         */
+        const Segment *segmentAt(int tick);
+    };
+
+    /**
+     * @brief Build a render plan from the current runtime data.
+     * @param runtime_data Project runtime data.
+     * @param previous Currently published plan (fade state is carried over), may be nullptr.
+     * @return Newly allocated plan (never nullptr).
+     */
+    static NoteNagaArrangementRenderPlan *build(NoteNagaRuntimeData *runtime_data,
+                                                const NoteNagaArrangementRenderPlan *previous);
+
+    /**
+     * @brief Arrangement tracks referenced by segments (index = Segment::arr_track_index).
+     * @return Vector of arrangement tracks.
+     */
+    const std::vector<NoteNagaArrangementTrack *> &getArrangementTracks() const { return arr_tracks_; }
+
+    /**
+     * @brief Number of synthesizers in the plan.
+     * @return Synth count.
+     */
+    size_t getSynthCount() const { return synths_.size(); }
+
+    /**
+     * @brief Get a synth entry.
+     * @param index Entry index (deterministic rendering order).
+     * @return Reference to the entry.
+     */
+    SynthEntry &getSynth(size_t index) { return synths_[index]; }
+
+    /**
+     * @brief Clear the carried fade-out state of all synths (playback restart).
+     */
+    void resetFadeState();
+
+    /// Per arrangement track level summaries of the current block, sized at build time (audio thread only)
+    std::vector<NN_BlockLevels_t> track_levels;
+
+private:
+    NoteNagaArrangementRenderPlan() = default;
+
+    std::vector<NoteNagaArrangementTrack *> arr_tracks_;
+    std::vector<SynthEntry> synths_;
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+#include <note_naga_engine/core/types.h>
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class NoteNagaRuntimeData;
+
+/**
+ * @brief Type of a precompiled arrangement event.
+ */
+enum class NN_ArrangementEventType_t : uint8_t {
+    StopSequence, ///< Clip looped back to the sequence start, stop all notes of the sequence
+    NoteOn,       ///< Start a note
+    NoteOff       ///< Stop a note
+};
+
+/**
+ * @brief One event of the flattened arrangement timeline.
+ */
+struct NOTE_NAGA_ENGINE_API NN_ArrangementEvent_t {
+    int tick = 0;                        ///< Absolute arrangement tick
+    NN_ArrangementEventType_t type = NN_ArrangementEventType_t::NoteOn;
+    int arr_track_index = -1;            ///< Index into getArrangementTracks()
+    NoteNagaMidiSeq *sequence = nullptr; ///< Sequence referenced by the clip
+    NoteNagaTrack *midi_track = nullptr; ///< MIDI track of the note (nullptr for StopSequence)
+    NN_Note_t note;                      ///< Note to play or stop
+    uint64_t order = 0;                  ///< Order of events of one clip at the same tick
+};
+
+/**
+ * @brief Precompiled event timeline for arrangement playback.
+ *
+ * Notes of all MIDI clips (including loop repeats of the referenced sequence and the clip
+ * offset) are flattened into one list of note on/off events sorted by absolute tick. The
+ * playback thread seeks into it with a binary search and then walks it with a moving cursor,
+ * so the cost of one playback iteration depends only on the number of events that are due.
+ *
+ * Events are compiled per clip. update() compares the clip layout, sequence lengths and note
+ * revisions against the cached blocks and recompiles only the clips which changed. Changes
+ * which cannot be detected by polling (MIDI track list of a sequence, tempo track flag) are
+ * reported with invalidateSequence() / invalidateAll().
+ *
+ * All methods except invalidateSequence() and invalidateAll() must be called from the
+ * playback thread.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaArrangementScheduler {
+public:
+    /**
+     * @brief Construct the scheduler.
+     * @param runtime_data Project runtime data (not owned).
+     */
+    explicit NoteNagaArrangementScheduler(NoteNagaRuntimeData *runtime_data);
+
+    /**
+     * @brief Mark the whole timeline for recompilation (thread-safe).
+     */
+    void invalidateAll();
+
+    /**
+     * @brief Mark all clips referencing a sequence for recompilation (thread-safe).
+     * @param sequence_id ID of the changed sequence.
+     */
+    void invalidateSequence(int sequence_id);
+
+    /**
+     * @brief Synchronize the timeline with the project, recompiling changed clips.
+     * @param deep_check Also compare MIDI track lists of all sequences (used when playback starts).
+     * @return True if the timeline changed.
+     */
+    bool update(bool deep_check = false);
+
+    /**
+     * @brief Move the cursor to the first event at or after a tick. O(log n).
+     * @param tick Arrangement tick.
+     */
+    void seek(int tick);
+
+    /**
+     * @brief Invoke fn(const NN_ArrangementEvent_t &) for all events in (from_tick, to_tick],
+     * in playback order. Continuous playback just advances the cursor, otherwise it seeks.
+     * @param from_tick Last processed tick (exclusive).
+     * @param to_tick Current tick (inclusive).
+     * @param fn Event callback.
+     */
+    template <typename Fn> void dispatch(int from_tick, int to_tick, Fn &&fn) {
+        if (to_tick <= from_tick) return;
+        if (!cursor_valid_ || cursor_tick_ != from_tick) seek(from_tick + 1);
+        size_t n = events_.size();
+        while (cursor_ < n && events_[cursor_].tick <= to_tick) {
+            fn(events_[cursor_]);
+            ++cursor_;
+        }
+        cursor_tick_ = to_tick;
+    }
+
+    /**
+     * @brief Arrangement tracks referenced by events (index = NN_ArrangementEvent_t::arr_track_index).
+     * @return Vector of arrangement tracks.
+     */
+    const std::vector<NoteNagaArrangementTrack *> &getArrangementTracks() const { return arr_tracks_; }
+
+    /**
+     * @brief Number of compiled events.
+     * @return Event count.
+     */
+    size_t getEventCount() const { return events_.size(); }
+
+private:
+    /// Compiled events of one MIDI clip
+    struct ClipBlock {
+        NoteNagaArrangementTrack *arr_track = nullptr;
+        int arr_track_index = -1;
+        int clip_id = -1;
+        int sequence_id = -1;
+        int start_tick = 0;
+        int duration_ticks = 0;
+        int offset_ticks = 0;
+        bool muted = false;
+        NoteNagaMidiSeq *sequence = nullptr;
+        int sequence_length = 0;
+        std::vector<NoteNagaTrack *> tracks;     ///< MIDI tracks the block was compiled from
+        std::vector<uint64_t> notes_revisions;   ///< Notes revision of each track at compile time
+        std::vector<NN_ArrangementEvent_t> events; ///< Sorted by (tick, order)
+    };
+
+    NoteNagaRuntimeData *runtime_data_;
+
+    std::vector<NoteNagaArrangementTrack *> arr_tracks_;
+    std::vector<ClipBlock> blocks_;
+    std::vector<NN_ArrangementEvent_t> events_; ///< Merged timeline of all blocks
+
+    size_t cursor_ = 0;        ///< Next event to dispatch
+    int cursor_tick_ = 0;      ///< Last tick dispatched up to
+    bool cursor_valid_ = false;
+
+    std::atomic<bool> invalidate_all_{true};
+    std::mutex pending_mutex_;
+    std::vector<int> pending_sequences_; ///< Invalidated sequence IDs (guarded by pending_mutex_)
+
+    bool layoutMatches() const;
+    bool blockIsCurrent(const ClipBlock &block, bool deep_check,
+                        const std::vector<int> &invalidated) const;
+    void compileBlock(ClipBlock &block);
+    void mergeBlocks();
+};
@@ -6,10 +6,9 @@
 
 #include <atomic>
 #include <cassert>
-#include <condition_variable>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
-#include <mutex>
 #include <optional>
 #include <thread>
 
@@ -23,7 +22,8 @@ typedef NOTE_NAGA_ENGINE_API struct NN_AsyncTriggerMessage_t {
 
 /**
  * @brief Abstract class for Note Naga components utilizing a lock-free MPMC queue.
- *        Supports safe thread lifetime management.
+ *        Supports safe thread lifetime management. The worker sleeps on an atomic wake
+ *        counter, so producers never take a lock and may push from the audio thread.
  * @tparam T Type of data in the queue.
  * @tparam QueueSize Capacity of the queue (must be a power of 2).
  *
@@ -69,13 +69,11 @@ public:
 
     /**
      * @brief Enqueues data into the queue (thread-safe, supports multiple producers).
+     *        Lock-free, the worker is woken through the atomic wake counter.
      */
     bool pushToQueue(const T &value) {
         bool ok = m_queue->enqueue(value);
-        if (ok) {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_cv.notify_one();
-        }
+        if (ok) wakeWorker();
         return ok;
     }
 
@@ -96,8 +94,7 @@ public:
     void enterManualMode() {
         m_manualMode.store(true, std::memory_order_release);
         // Probudíme vlákno, aby si všimlo změny režimu a šlo spát
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_cv.notify_one();
+        wakeWorker();
     }
 
     /**
@@ -106,8 +103,7 @@ public:
     void exitManualMode() {
         m_manualMode.store(false, std::memory_order_release);
         // Probudíme vlákno, aby mohlo začít znovu pracovat
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_cv.notify_one();
+        wakeWorker();
     }
 
     /**
@@ -115,10 +111,7 @@ public:
      */
     void killThread() {
         m_stopThread.store(true, std::memory_order_release);
-        {
-            std::lock_guard<std::mutex> lock(m_mutex);
-            m_cv.notify_one();
-        }
+        wakeWorker();
         if (m_thread.joinable()) m_thread.join();
         NOTE_NAGA_LOG_INFO("Engine Component thread killed");
     }
@@ -130,12 +123,24 @@ protected:
     virtual void onItem(const T &value) = 0;
 
 private:
+    /**
+     * @brief Bumps the wake counter and wakes the worker if it sleeps on it. Does not lock,
+     *        notify only enters the kernel when the worker is actually waiting.
+     */
+    void wakeWorker() {
+        m_wakeCounter.fetch_add(1, std::memory_order_release);
+        m_wakeCounter.notify_one();
+    }
+
     void threadFunc() {
         while (!m_stopThread.load(std::memory_order_acquire)) {
+            // The counter is read before the conditions are checked, any wake up after this
+            // point changes it and the wait below returns immediately
+            const uint32_t wake = m_wakeCounter.load(std::memory_order_acquire);
+
             // Pokud jsme v manuálním režimu, vlákno jen čeká a nic nedělá.
             if (m_manualMode.load(std::memory_order_acquire)) {
-                std::unique_lock<std::mutex> lock(m_mutex);
-                m_cv.wait(lock); // Čeká na probuzení (např. při vypnutí manuálního režimu)
+                m_wakeCounter.wait(wake, std::memory_order_acquire); // Čeká na probuzení (např. při vypnutí manuálního režimu)
                 continue; // Znovu zkontroluje podmínky smyčky
             }
 
@@ -145,10 +150,8 @@ private:
                 continue;
             }
 
-            std::unique_lock<std::mutex> lock(m_mutex);
-            m_cv.wait(lock, [this]() {
-                return m_stopThread.load(std::memory_order_acquire) || !m_queue->empty() || m_manualMode.load(std::memory_order_acquire);
-            });
+            if (m_stopThread.load(std::memory_order_acquire) || !m_queue->empty()) continue;
+            m_wakeCounter.wait(wake, std::memory_order_acquire);
         }
     }
 
@@ -157,6 +160,5 @@ private:
     std::atomic<bool> m_manualMode;
     std::thread m_thread;
     std::atomic<bool> m_stopThread;
-    std::mutex m_mutex;
-    std::condition_variable m_cv;
+    std::atomic<uint32_t> m_wakeCounter{0};
 };
\ No newline at end of file
@@ -2,6 +2,9 @@
 
 #include <note_naga_engine/note_naga_api.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <string>
 #include <vector>
 
@@ -36,6 +39,77 @@ struct NOTE_NAGA_ENGINE_API DSPParamDescriptor {
     std::vector<std::string> options;
 };
 
+/**
+ * @brief Linear ramp of a block parameter, advanced by the audio thread.
+ * Parameter values set from the UI jump; a block follows them with this ramp so
+ * that a change does not zipper. Control rate blocks advance it once per block,
+ * audio rate blocks once per sample.
+ */
+class NOTE_NAGA_ENGINE_API DSPSmoothedValue {
+public:
+    explicit DSPSmoothedValue(float value = 0.0f) : current_(value), target_(value) {}
+
+    /**
+     * @brief Jump to a value without ramping.
+     */
+    void reset(float value) {
+        current_ = target_ = value;
+        remaining_ = 0;
+    }
+
+    /**
+     * @brief Set the ramp length in frames (0 = no smoothing).
+     */
+    void setRampLength(size_t frames) { ramp_frames_ = frames; }
+
+    /**
+     * @brief Set the value to ramp to. Restarts the ramp only if the target changed.
+     */
+    void setTarget(float target) {
+        if (target == target_) return;
+        target_ = target;
+        if (ramp_frames_ == 0) {
+            reset(target);
+            return;
+        }
+        remaining_ = ramp_frames_;
+        step_ = (target_ - current_) / float(remaining_);
+    }
+
+    /**
+     * @brief Advance one frame and return the value for it.
+     */
+    float getNext() {
+        if (remaining_ == 0) return current_;
+        current_ = --remaining_ == 0 ? target_ : current_ + step_;
+        return current_;
+    }
+
+    /**
+     * @brief Advance a whole block and return the value at its end.
+     */
+    float skip(size_t numFrames) {
+        if (numFrames >= remaining_) {
+            reset(target_);
+        } else {
+            remaining_ -= numFrames;
+            current_ += step_ * float(numFrames);
+        }
+        return current_;
+    }
+
+    float getCurrent() const { return current_; }
+    float getTarget() const { return target_; }
+    bool isSmoothing() const { return remaining_ > 0; }
+
+private:
+    float current_;
+    float target_;
+    float step_ = 0.0f;
+    size_t remaining_ = 0;
+    size_t ramp_frames_ = 0;
+};
+
 /**
  * @brief Base class for DSP blocks in the Note Naga engine.
  * This class defines the interface for processing audio data,
@@ -87,6 +161,70 @@ public:
      */
     virtual void resetState() {}
 
+    /**
+     * @brief Time in seconds the block keeps producing output after its input went silent
+     * (reverb and echo decay, delay line length, envelope release).
+     * The DSP engine stops processing a chain whose input has been silent for longer than
+     * the sum of its tails. Blocks without internal memory keep the default.
+     */
+    virtual double getTailSeconds() const { return 0.0; }
+
+    /**
+     * @brief Set the sample rate the block runs at.
+     * The DSP engine calls this before the block is used and from the audio thread when
+     * its rate changes. Blocks with sample rate sized buffers override it (and call the base).
+     */
+    virtual void setSampleRate(float sampleRate) {
+        sampleRate_ = sampleRate;
+        invalidateCoefficients();
+    }
+
+    /**
+     * @brief Get the sample rate the block runs at.
+     */
+    float getSampleRate() const { return sampleRate_; }
+
+protected:
+    /// Length of parameter ramps (DSPSmoothedValue) in seconds
+    static constexpr float kSmoothingTime = 0.02f;
+
+    /**
+     * @brief Recompute cached coefficients from the parameters and the sample rate.
+     * Runs on the audio thread from updateCoefficients(), only after something changed.
+     */
+    virtual void recalcCoefficients() {}
+
+    /**
+     * @brief Mark cached coefficients stale (setParamValue(), setSampleRate()).
+     */
+    void invalidateCoefficients() { coeffsDirty_.store(true, std::memory_order_release); }
+
+    /**
+     * @brief Recompute cached coefficients if they are stale. Call at the start of process().
+     */
+    void updateCoefficients() {
+        if (coeffsDirty_.exchange(false, std::memory_order_acq_rel)) recalcCoefficients();
+    }
+
+    /**
+     * @brief Tail of a feedback loop: time until its repeats fall below -60 dB.
+     * @param period Loop length in seconds.
+     * @param feedback Gain of one round trip.
+     */
+    static double feedbackTail(double period, double feedback) {
+        feedback = std::min(std::fabs(feedback), 0.999);
+        if (feedback < 0.001) return period;
+        return period * (1.0 + std::log(0.001) / std::log(feedback));
+    }
+
+    /**
+     * @brief Ramp length in frames for the current sample rate.
+     */
+    size_t smoothingFrames() const { return static_cast<size_t>(sampleRate_ * kSmoothingTime); }
+
+    float sampleRate_ = 44100.0f; ///< Sample rate in Hz
+
 private:
     bool active_ = true;
+    std::atomic<bool> coeffsDirty_{true}; ///< Coefficients must be recomputed before the next block
 };
\ No newline at end of file
@@ -41,6 +41,40 @@ public:
         return true;
     }
 
+    /**
+     * @brief Enqueue without overwriting (producer only).
+     * @return False if the queue is full, the value is dropped.
+     */
+    bool tryEnqueue(const T &value) {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t t = tail.load(std::memory_order_acquire);
+
+        if (((h + 1) & MASK) == (t & MASK)) {
+            return false;
+        }
+        buffer[h & MASK] = value;
+        head.store((h + 1) & MASK, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Oldest element without removing it (consumer only, use with tryEnqueue()).
+     * @return Pointer to the element, nullptr if the queue is empty.
+     */
+    const T *peek() const {
+        size_t t = tail.load(std::memory_order_relaxed);
+        size_t h = head.load(std::memory_order_acquire);
+        return ((t & MASK) == (h & MASK)) ? nullptr : &buffer[t & MASK];
+    }
+
+    /**
+     * @brief Remove the element returned by peek() (consumer only).
+     */
+    void pop() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        tail.store((t + 1) & MASK, std::memory_order_release);
+    }
+
     std::optional<T> dequeue() {
         size_t t = tail.load(std::memory_order_relaxed);
         size_t h = head.load(std::memory_order_acquire);
@@ -1,22 +1,84 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
-#include <note_naga_engine/core/async_queue_component.h>
+#include <cstdint>
 #include <note_naga_engine/core/types.h>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 /*******************************************************************************************************/
-// Synthesizer Queue Message
+// Active Note Table
 /*******************************************************************************************************/
 
 /**
- * @brief Represents a message for the Note Naga Synthesizer queue.
+ * Sounding notes of one synthesizer, one slot per (channel, pitch). Preallocated and lock-free:
+ * the render thread (scheduled events), the playback worker and the GUI preview start and stop
+ * notes at the same time without allocating or waiting. A slot keeps the last note started on
+ * its key, starting the key again takes the slot over (MIDI cannot tell the voices apart either).
  */
-struct NOTE_NAGA_ENGINE_API NN_SynthMessage_t {
-  NN_Note_t note; /// <MIDI note to play or stop>
-  int channel;    ///< MIDI channel to use
-  bool play;      /// <True to play note, false to stop>
-  float pan;      /// <Stereo pan value (-1.0 left, 1.0 right)>
+class NOTE_NAGA_ENGINE_API NoteNagaActiveNotes {
+public:
+  static constexpr int kChannels = 16;
+  static constexpr int kPitches = 128;
+
+  /**
+   * @brief Mark a note as sounding.
+   * @param note The note (its ID, pitch and parent track are stored).
+   * @param channel MIDI channel the note is started on.
+   * @return False if the note is already sounding or out of range (send no note on).
+   */
+  bool noteOn(const NN_Note_t &note, int channel) {
+    if (channel < 0 || channel >= kChannels || note.note < 0 || note.note >= kPitches) return false;
+    Slot &slot = slots_[index(channel, note.note)];
+    slot.track.store(note.parent, std::memory_order_relaxed);
+    return slot.key.exchange(key(note), std::memory_order_acq_rel) != key(note);
+  }
+
+  /**
+   * @brief Mark a note as released.
+   * @param note The note.
+   * @return Channel the note was started on, -1 if it is not sounding.
+   */
+  int noteOff(const NN_Note_t &note) {
+    if (note.note < 0 || note.note >= kPitches) return -1;
+    for (int channel = 0; channel < kChannels; ++channel) {
+      uint64_t expected = key(note);
+      if (slots_[index(channel, note.note)].key.compare_exchange_strong(expected, 0, std::memory_order_acq_rel)) {
+        return channel;
+      }
+    }
+    return -1;
+  }
+
+  /**
+   * @brief Release the sounding notes of a track, or all of them.
+   * @param track Track filter, nullptr releases every note.
+   * @param note_off Called with (channel, pitch) of each released note.
+   */
+  template <typename Fn> void releaseAll(const NoteNagaTrack *track, Fn &&note_off) {
+    for (int i = 0; i < kChannels * kPitches; ++i) {
+      Slot &slot = slots_[i];
+      uint64_t current = slot.key.load(std::memory_order_acquire);
+      if (current == 0) continue;
+      if (track && slot.track.load(std::memory_order_relaxed) != track) continue;
+      if (slot.key.compare_exchange_strong(current, 0, std::memory_order_acq_rel)) {
+        note_off(i / kPitches, i % kPitches);
+      }
+    }
+  }
+
+private:
+  struct Slot {
+    std::atomic<uint64_t> key{0};                      ///< Note ID + 1, 0 = free
+    std::atomic<const NoteNagaTrack *> track{nullptr}; ///< Track which started the note
+  };
+
+  static int index(int channel, int pitch) { return channel * kPitches + pitch; }
+  static uint64_t key(const NN_Note_t &note) { return static_cast<uint64_t>(note.id) + 1; }
+
+  Slot slots_[kChannels * kPitches];
 };
 
 /*******************************************************************************************************/
@@ -26,15 +88,18 @@ struct NOTE_NAGA_ENGINE_API NN_SynthMessage_t {
 /**
  * Abstract base class for Note Naga Synthesizers.
  * This class defines the interface for synthesizers that can play MIDI notes.
+ * Synthesizers own no thread: timed note events are delivered by the DSP engine on the
+ * render thread at the start of each audio block (see NoteNagaDSPEngine::scheduleMidiEvent()),
+ * live notes are played by direct calls. The note methods are therefore called from the
+ * render thread, the playback worker and the GUI at the same time; note state lives in the
+ * lock-free active_notes_ table and per-channel atomics, so soft synths never lock or allocate
+ * in them.
  */
 #ifndef QT_DEACTIVATED
-class NOTE_NAGA_ENGINE_API NoteNagaSynthesizer
-    : public QObject,
-      public AsyncQueueComponent<NN_SynthMessage_t, 1024> {
+class NOTE_NAGA_ENGINE_API NoteNagaSynthesizer : public QObject {
   Q_OBJECT
 #else
-class NOTE_NAGA_ENGINE_API NoteNagaSynthesizer
-    : public AsyncQueueComponent<NN_SynthMessage_t, 1024> {
+class NOTE_NAGA_ENGINE_API NoteNagaSynthesizer {
 #endif
 public:
 #ifndef QT_DEACTIVATED
@@ -44,6 +109,10 @@ public:
 #endif
   virtual ~NoteNagaSynthesizer() = default;
 
+  // Not copyable
+  NoteNagaSynthesizer(const NoteNagaSynthesizer &) = delete;
+  NoteNagaSynthesizer &operator=(const NoteNagaSynthesizer &) = delete;
+
   /**
    * @brief Set the name of the synthesizer.
    * @param name Name of the synthesizer.
@@ -114,31 +183,14 @@ public:
 protected:
   std::string name; ///< Name of the synthesizer
 
-  // playing notes map: track -> note ID -> playing note
-  struct PlayedNote_t {
-    NN_Note_t note;
-    int channel;
-  };
-  typedef std::unordered_map<long, PlayedNote_t> TrackNotesMap;
-  std::unordered_map<NoteNagaTrack *, TrackNotesMap> playing_notes_;
+  // sounding notes (lock-free, shared by all threads that play notes)
+  NoteNagaActiveNotes active_notes_;
 
-  // current channel programs
-  std::unordered_map<int, int> channel_programs_;
+  // current channel programs (-1 = not set)
+  std::atomic<int> channel_programs_[NoteNagaActiveNotes::kChannels];
 
   // curent channel pan values
-  std::unordered_map<int, float> channel_pan_;
-
-  /**
-   * @brief Called when a new item is dequeued from the component's queue.
-   * This method processes the MIDI note play/stop messages.
-   * @param value The message to process.
-   */
-  void onItem(const NN_SynthMessage_t &value) override {
-    if (value.play)
-      playNote(value.note, value.channel, value.pan);
-    else
-      stopNote(value.note);
-  }
+  std::atomic<float> channel_pan_[NoteNagaActiveNotes::kChannels];
 
 #ifndef QT_DEACTIVATED
 Q_SIGNALS:
@@ -156,4 +208,18 @@ Q_SIGNALS:
 class NOTE_NAGA_ENGINE_API INoteNagaSoftSynth {
 public:
   virtual void renderAudio(float *left, float *right, size_t num_frames) = 0;
+
+  /**
+   * @brief Check whether the synth has sounding voices (releases included).
+   * Called from the render thread. Once a synth without voices has gone silent
+   * for longer than its tail, the DSP engine stops calling renderAudio() until
+   * it gets new events. Synths that cannot tell keep the default.
+   */
+  virtual bool hasActiveVoices() const { return true; }
+
+  /**
+   * @brief Time in seconds the output keeps sounding after the last voice ended
+   * (internal effects such as reverb).
+   */
+  virtual double getTailSeconds() const { return 0.0; }
 };
\ No newline at end of file
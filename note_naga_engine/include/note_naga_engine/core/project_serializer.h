@@ -74,6 +74,13 @@ public:
      */
     std::string lastError() const { return m_lastError; }
     
+    /**
+     * @brief Get the waveform peak cache directory belonging to a project file.
+     * @param projectFilePath Path to the project file.
+     * @return Path of the sidecar cache directory.
+     */
+    static std::string peakCacheDirectoryFor(const std::string &projectFilePath);
+    
 private:
     NoteNagaEngine *m_engine;
     std::string m_lastError;
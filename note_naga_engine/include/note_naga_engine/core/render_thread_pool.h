@@ -0,0 +1,84 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Small real-time worker pool used by the DSP engine to render independent
+ * synthesizers in parallel. Jobs of one batch are claimed from a shared atomic
+ * counter (idle workers pick up whatever is left, so a slow synth does not stall
+ * the others) and the calling (audio) thread participates as worker 0.
+ *
+ * run() does not allocate and does not take locks. Results are written by the jobs
+ * into caller-owned per-job slots, so the caller can sum them in a deterministic order.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaRenderThreadPool {
+public:
+    /**
+     * @brief Construct the pool.
+     * @param num_threads Total number of rendering threads including the caller.
+     *        0 = automatic (based on hardware concurrency), 1 = single-threaded (no workers).
+     */
+    explicit NoteNagaRenderThreadPool(int num_threads = 0);
+    ~NoteNagaRenderThreadPool();
+
+    NoteNagaRenderThreadPool(const NoteNagaRenderThreadPool &) = delete;
+    NoteNagaRenderThreadPool &operator=(const NoteNagaRenderThreadPool &) = delete;
+
+    /**
+     * @brief Get total number of rendering threads (workers + calling thread).
+     * @return Thread count, 1 means single-threaded rendering.
+     */
+    int getThreadCount() const { return int(workers_.size()) + 1; }
+
+    /**
+     * @brief Resolve the automatic thread count for this machine.
+     * @return Recommended number of rendering threads.
+     */
+    static int defaultThreadCount();
+
+    /**
+     * @brief Execute job_count jobs and wait until all of them are finished.
+     * Falls back to a plain serial loop when the pool has no workers or there is only one job.
+     *
+     * @param job_count Number of jobs in the batch.
+     * @param fn Callable invoked as fn(size_t job_index). Must be safe to call concurrently
+     *        for different job indices.
+     */
+    template <typename Fn> void run(size_t job_count, Fn &&fn) {
+        using FnType = std::remove_reference_t<Fn>;
+        if (workers_.empty() || job_count < 2) {
+            for (size_t i = 0; i < job_count; ++i) fn(i);
+            return;
+        }
+        runBatch(job_count, const_cast<void *>(static_cast<const void *>(&fn)),
+                 [](void *ctx, size_t job) { (*static_cast<FnType *>(ctx))(job); });
+    }
+
+private:
+    using JobTrampoline = void (*)(void *ctx, size_t job);
+
+    std::vector<std::thread> workers_;
+
+    // Batch description, written by the caller before the batch is opened
+    JobTrampoline trampoline_ = nullptr;
+    void *ctx_ = nullptr;
+    size_t job_count_ = 0;
+
+    std::atomic<size_t> next_job_{0};      ///< Next unclaimed job index
+    std::atomic<size_t> pending_jobs_{0};  ///< Jobs not finished yet
+    std::atomic<uint64_t> generation_{0};  ///< Bumped for every batch, workers wait on it
+    std::atomic<uint64_t> open_batch_{0};  ///< Generation of the batch workers may join (0 = closed)
+    std::atomic<int> active_workers_{0};   ///< Workers currently inside a batch
+    std::atomic<bool> stop_{false};
+
+    void runBatch(size_t job_count, void *ctx, JobTrampoline trampoline);
+    void drainJobs();
+    void workerLoop();
+};
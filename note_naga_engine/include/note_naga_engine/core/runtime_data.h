@@ -9,6 +9,8 @@
 #endif
 
 #include <atomic>
+#include <memory>
+#include <mutex>
 #include <vector>
 
 /*******************************************************************************************************/
@@ -74,6 +76,20 @@ public:
      */
     int getProjectTempo() const { return tempo; }
 
+    /**
+     * @brief Returns the tempo map of the active sequence (constant project tempo if there
+     * is no active sequence). Used for sequence playback and the metronome.
+     * @return Shared tempo map.
+     */
+    std::shared_ptr<const NoteNagaTempoMap> getTempoMap() const;
+
+    /**
+     * @brief Returns the tempo map of the arrangement timeline: the arrangement tempo track
+     * when it is active, otherwise a constant map of getTempo().
+     * @return Shared tempo map.
+     */
+    std::shared_ptr<const NoteNagaTempoMap> getArrangementTempoMap() const;
+
     /**
      * @brief Returns the current tick of the project.
      * @return Current tick.
@@ -181,6 +197,10 @@ protected:
     std::atomic<int> current_tick; ///< Current position in ticks (for sequence mode)
     std::atomic<int> current_arrangement_tick_; ///< Current position in arrangement mode
     int max_tick;                  ///< Maximum tick in the project
+    mutable std::mutex tempo_map_mutex_; ///< Guards fixed_tempo_map_
+    mutable std::shared_ptr<const NoteNagaTempoMap> fixed_tempo_map_; ///< Constant map for the fallbacks
+
+    std::shared_ptr<const NoteNagaTempoMap> getFixedTempoMap(int tempo) const;
 
     // SIGNALS
     // ////////////////////////////////////////////////////////////////////////////////
@@ -235,6 +255,13 @@ Q_SIGNALS:
      */
     void activeSequenceTrackListChanged(NoteNagaMidiSeq *seq);
 
+    /**
+     * @brief Signal emitted when the track list of any sequence changes. Removed tracks
+     * are deleted after the signal returns.
+     * @param seq Pointer to the sequence.
+     */
+    void sequenceTrackListChanged(NoteNagaMidiSeq *seq);
+
     /**
      * @brief Signal emitted when the arrangement tick changes.
      * @param tick The current arrangement tick.
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Sequence lock publishing a small trivially copyable value.
+ *        One writer, any number of readers; neither side ever blocks on a mutex.
+ *
+ * The writer makes the sequence odd, copies the value and makes the sequence even again.
+ * A reader copies the value and retries if the sequence was odd or changed meanwhile, so
+ * it always gets a value written by exactly one store(). The value is kept in relaxed
+ * atomic words, which keeps concurrent copies well defined.
+ * @tparam T Trivially copyable value type (meant for a few dozen bytes).
+ */
+template <typename T> class NOTE_NAGA_ENGINE_API NoteNagaSeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "NoteNagaSeqLock requires a trivially copyable type");
+
+    static constexpr size_t kWords = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    std::atomic<uint32_t> sequence_{0};
+    std::atomic<uint64_t> words_[kWords] = {};
+
+public:
+    NoteNagaSeqLock() = default;
+    explicit NoteNagaSeqLock(const T &value) { store(value); }
+
+    // Not copyable/movable
+    NoteNagaSeqLock(const NoteNagaSeqLock &) = delete;
+    NoteNagaSeqLock &operator=(const NoteNagaSeqLock &) = delete;
+
+    /**
+     * @brief Publish a new value (single writer only).
+     */
+    void store(const T &value) {
+        uint64_t buffer[kWords] = {};
+        std::memcpy(buffer, &value, sizeof(T));
+
+        const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buffer[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read the last published value (any thread, wait-free unless a store overlaps).
+     */
+    T load() const {
+        uint64_t buffer[kWords];
+        for (;;) {
+            const uint32_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1u) {
+                std::this_thread::yield();
+                continue;
+            }
+            for (size_t i = 0; i < kWords; ++i) {
+                buffer[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) break;
+        }
+        T value;
+        std::memcpy(&value, buffer, sizeof(T));
+        return value;
+    }
+};
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct NN_TempoEvent_t;
+
+/**
+ * @brief Tick <-> time conversion over a tempo curve.
+ *
+ * The tempo events are turned into segments (one per event) holding the time at which the
+ * segment starts, so a conversion is a binary search for the segment plus a closed form
+ * inside it. Linear ramps are integrated exactly (the tempo changes linearly with the tick,
+ * the elapsed time is logarithmic), instead of being approximated by an average tempo.
+ *
+ * The map does not depend on the PPQ: segment times are stored in "seconds at 1 PPQ" and the
+ * conversion functions take the PPQ of the caller. Before the first event the first tempo
+ * applies, after the last event its tempo holds forever.
+ *
+ * A built map is immutable in practice and is shared as std::shared_ptr<const NoteNagaTempoMap>
+ * (see NoteNagaTrack::getTempoMap()), so readers on other threads keep a consistent snapshot.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaTempoMap {
+public:
+    /**
+     * @brief Construct a map with a constant tempo.
+     * @param bpm Tempo in BPM.
+     */
+    explicit NoteNagaTempoMap(double bpm = 120.0);
+
+    /**
+     * @brief Construct a map from tempo events.
+     * @param events Tempo events sorted by tick (a constant 120 BPM if empty).
+     */
+    explicit NoteNagaTempoMap(const std::vector<NN_TempoEvent_t> &events);
+
+    /**
+     * @brief Construct a map with a constant tempo given in microseconds per quarter note.
+     * @param tempo Tempo in microseconds per quarter note.
+     */
+    static NoteNagaTempoMap fromMicroseconds(int tempo);
+
+    /**
+     * @brief Rebuild the map from tempo events.
+     * @param events Tempo events sorted by tick.
+     */
+    void rebuild(const std::vector<NN_TempoEvent_t> &events);
+
+    /**
+     * @brief Rebuild only the part of the map affected by an edit. Segments which end
+     * before the changed tick are kept, the rest is recomputed.
+     * @param events Tempo events sorted by tick (after the edit).
+     * @param changed_tick Lowest tick of an added, removed or modified event.
+     */
+    void update(const std::vector<NN_TempoEvent_t> &events, int changed_tick);
+
+    /**
+     * @brief Check whether the tempo never changes.
+     * @return True for a single constant tempo.
+     */
+    bool isConstant() const { return segments_.size() == 1 && segments_.front().length == 0; }
+
+    /**
+     * @brief Number of tempo segments.
+     */
+    size_t getSegmentCount() const { return segments_.size(); }
+
+    /**
+     * @brief Tempo at a tick (interpolated inside linear ramps).
+     * @param tick Tick position.
+     * @return Tempo in BPM.
+     */
+    double getBPMAtTick(double tick) const;
+
+    /**
+     * @brief Tempo at a tick in microseconds per quarter note.
+     * @param tick Tick position.
+     * @return Tempo in microseconds per quarter note.
+     */
+    int getTempoAtTick(int tick) const;
+
+    /**
+     * @brief Time of a tick.
+     * @param tick Tick position (may be fractional or negative).
+     * @param ppq Pulses per quarter note.
+     * @return Seconds from tick 0.
+     */
+    double ticksToSeconds(double tick, int ppq) const;
+
+    /**
+     * @brief Tick at a time (inverse of ticksToSeconds()).
+     * @param seconds Seconds from tick 0.
+     * @param ppq Pulses per quarter note.
+     * @return Fractional tick position.
+     */
+    double secondsToTicks(double seconds, int ppq) const;
+
+    /**
+     * @brief Sample position of a tick.
+     * @param tick Tick position.
+     * @param ppq Pulses per quarter note.
+     * @param sample_rate Sample rate in Hz.
+     * @return Sample position (rounded to the nearest sample).
+     */
+    int64_t ticksToSamples(double tick, int ppq, int sample_rate) const;
+
+    /**
+     * @brief Tick at a sample position.
+     * @param sample Sample position.
+     * @param ppq Pulses per quarter note.
+     * @param sample_rate Sample rate in Hz.
+     * @return Fractional tick position.
+     */
+    double samplesToTicks(int64_t sample, int ppq, int sample_rate) const;
+
+private:
+    struct Segment {
+        int tick = 0;           ///< Segment start
+        double bpm = 120.0;     ///< Tempo at the segment start
+        double end_bpm = 120.0; ///< Tempo at the end of a linear ramp (== bpm for steps)
+        int length = 0;         ///< Ramp length in ticks (0 = constant tempo)
+        double time = 0.0;      ///< Segment start in seconds at 1 PPQ
+    };
+
+    std::vector<Segment> segments_; ///< Sorted by tick, never empty, first segment starts at tick 0
+
+    void appendSegments(const std::vector<NN_TempoEvent_t> &events, size_t first_event, double time);
+    const Segment &segmentAtTick(double tick) const;
+    const Segment &segmentAtTime(double time) const;
+
+    /// Time (at 1 PPQ) from the segment start to ticks later
+    static double span(const Segment &segment, double ticks);
+    /// Ticks from the segment start after a time (at 1 PPQ), inverse of span()
+    static double inverseSpan(const Segment &segment, double time);
+};
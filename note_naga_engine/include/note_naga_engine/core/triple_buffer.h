@@ -0,0 +1,64 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Triple buffer handing whole values from one writer thread to one reader thread.
+ *
+ * The writer fills its private back buffer and publish() swaps it with the shared middle
+ * buffer; the reader swaps the middle buffer with its front buffer when a new value was
+ * published. Both sides only exchange an atomic index, never wait for each other, and
+ * buffers are reused, so values holding vectors stop allocating once they reach their size.
+ *
+ * Not thread-safe for multiple writers or multiple readers.
+ * @tparam T Value type (default constructible).
+ */
+template <typename T> class NOTE_NAGA_ENGINE_API NoteNagaTripleBuffer {
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4; ///< Middle buffer holds a value the reader did not take yet
+
+    T buffers_[3];
+    std::atomic<uint8_t> middle_{1};
+    uint8_t back_ = 0;  // writer only
+    uint8_t front_ = 2; // reader only
+
+public:
+    NoteNagaTripleBuffer() = default;
+
+    // Not copyable/movable
+    NoteNagaTripleBuffer(const NoteNagaTripleBuffer &) = delete;
+    NoteNagaTripleBuffer &operator=(const NoteNagaTripleBuffer &) = delete;
+
+    /**
+     * @brief Buffer to fill with the next value (writer only). Holds the value published
+     * two or three publish() calls ago, not the last one.
+     */
+    T &writeBuffer() { return buffers_[back_]; }
+
+    /**
+     * @brief Publish the write buffer (writer only).
+     */
+    void publish() {
+        uint8_t previous = middle_.exchange(back_ | kFresh, std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+    }
+
+    /**
+     * @brief Take the newest published value if there is one (reader only).
+     * @return True if the front buffer changed.
+     */
+    bool update() {
+        if (!(middle_.load(std::memory_order_relaxed) & kFresh)) return false;
+        uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        return true;
+    }
+
+    /**
+     * @brief Value taken by the last update() (reader only).
+     */
+    const T &readBuffer() const { return buffers_[front_]; }
+};
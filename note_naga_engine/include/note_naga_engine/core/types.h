@@ -3,16 +3,21 @@
 #include <note_naga_engine/io/midi_file.h>
 #include <note_naga_engine/note_naga_api.h>
 #include <note_naga_engine/audio/audio_resource.h>
+#include <note_naga_engine/core/tempo_map.h>
 
 #ifndef QT_DEACTIVATED
 #include <QColor>
 #include <QObject>
 #endif
 
+#include <atomic>
 #include <complex>
 #include <cstdint>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <set>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -214,6 +219,128 @@ struct NOTE_NAGA_ENGINE_API NN_Note_t {
  */
 NOTE_NAGA_ENGINE_API double note_time_ms(const NN_Note_t &note, int ppq, int tempo);
 
+/**
+ * @brief Packed, read-only structure-of-arrays snapshot of the notes of one track.
+ *
+ * Rows are sorted by start tick (ties keep the order of the track's note list) and
+ * every column has one entry per row, so hot paths (playback, rendering, overview
+ * widgets) can scan plain arrays without copying NN_Note_t or testing optionals.
+ * Notes without start or length are not playable and are left out. Unset velocity
+ * is stored as 0 and unset pan as NN_NoteColumns_t::PAN_UNSET.
+ *
+ * A snapshot is immutable once built: NoteNagaTrack::getNoteColumns() hands out a
+ * shared pointer that stays valid across later edits of the track.
+ */
+struct NOTE_NAGA_ENGINE_API NN_NoteColumns_t {
+    static constexpr uint8_t PAN_UNSET = 0xFF; ///< Pan column value of notes without pan
+
+    uint64_t revision = 0;          ///< Track notes revision the snapshot was built from
+    int max_length = 0;             ///< Longest note (bounds searches for notes ending in a range)
+    int end_tick = 0;               ///< Largest start + length of all rows
+
+    std::vector<int> start;         ///< Start tick (sorted ascending)
+    std::vector<int> length;        ///< Length in ticks
+    std::vector<uint8_t> pitch;     ///< MIDI note number
+    std::vector<uint8_t> velocity;  ///< Velocity (0 = unset)
+    std::vector<uint8_t> pan;       ///< Pan 0-127 (PAN_UNSET = unset)
+    std::vector<unsigned long> id;  ///< Stable note ID
+    std::vector<uint32_t> source;   ///< Index of the note in NoteNagaTrack::getNotesView()
+
+    /// Note IDs sorted ascending with their row, for findRow()
+    std::vector<std::pair<unsigned long, uint32_t>> id_index;
+
+    /// Interval index: implicit binary tree over the rows, each node holds the largest
+    /// end tick of its rows (leaves at end_tree.size() / 2 + row), for findOverlapping()
+    std::vector<int> end_tree;
+
+    /**
+     * @brief Number of rows.
+     */
+    size_t size() const { return start.size(); }
+
+    /**
+     * @brief Check whether the snapshot has no rows.
+     */
+    bool empty() const { return start.empty(); }
+
+    /**
+     * @brief First row whose start tick is not less than tick.
+     * @param tick Tick.
+     * @return Row index (size() if none).
+     */
+    size_t lowerBound(int tick) const;
+
+    /**
+     * @brief First row whose start tick is greater than tick.
+     * @param tick Tick.
+     * @return Row index (size() if none).
+     */
+    size_t upperBound(int tick) const;
+
+    /**
+     * @brief Find the row of a note by its ID.
+     * @param note_id Note ID.
+     * @return Row index, or -1 if the note is not part of the snapshot.
+     */
+    int64_t findRow(unsigned long note_id) const;
+
+    /**
+     * @brief Find the notes overlapping the tick range [from, to) in O(log n + k).
+     * @param from First tick of the range.
+     * @param to End tick of the range (exclusive).
+     * @param rows Receives the matching rows in ascending order (appended, not cleared).
+     * @return Number of rows found.
+     */
+    size_t findOverlapping(int from, int to, std::vector<uint32_t> &rows) const;
+
+    /**
+     * @brief Find the notes sounding at a tick (start <= tick < start + length).
+     * @param tick Tick.
+     * @param rows Receives the matching rows in ascending order (appended, not cleared).
+     * @return Number of rows found.
+     */
+    size_t findSounding(int tick, std::vector<uint32_t> &rows) const { return findOverlapping(tick, tick + 1, rows); }
+
+    /**
+     * @brief Build a full note from one row (keeps the stable ID).
+     * @param row Row index.
+     * @param parent Track to set as the note's parent.
+     * @return Note.
+     */
+    NN_Note_t toNote(size_t row, NoteNagaTrack *parent) const;
+};
+
+/**
+ * @brief Batch of note edits of one track, applied as a single transaction by
+ * NoteNagaTrack::applyNoteChanges().
+ *
+ * Notes are matched by ID. The change set only holds the touched notes, so it doubles
+ * as a compact undo record: applying inverted() restores the previous state.
+ */
+struct NOTE_NAGA_ENGINE_API NN_NoteChangeSet_t {
+    std::vector<NN_Note_t> added;    ///< Notes to insert
+    std::vector<NN_Note_t> removed;  ///< Notes to remove (matched by ID)
+    std::vector<NN_Note_t> updated;  ///< New values of modified notes (matched by ID)
+    std::vector<NN_Note_t> previous; ///< Old values of the updated notes (same order as updated)
+
+    /**
+     * @brief Check whether the change set contains no edit.
+     */
+    bool empty() const { return added.empty() && removed.empty() && updated.empty(); }
+
+    /**
+     * @brief Number of touched notes.
+     */
+    size_t size() const { return added.size() + removed.size() + updated.size(); }
+
+    /**
+     * @brief Change set that reverts this one (added and removed swapped, updated
+     * notes restored to their previous values).
+     * @return Inverted change set.
+     */
+    NN_NoteChangeSet_t inverted() const;
+};
+
 /*******************************************************************************************************/
 // Note Naga Tempo Event
 /*******************************************************************************************************/
@@ -302,7 +429,7 @@ public:
     void addNote(const NN_Note_t &note);
 
     /**
-     * @brief Adds multiple MIDI notes to the track in bulk (optimized, no signal per note).
+     * @brief Adds multiple MIDI notes to the track in bulk (one sort and merge, single signal).
      * @param notes Vector of MIDI notes to add.
      */
     void addNotesBulk(const std::vector<NN_Note_t> &notes);
@@ -313,6 +440,17 @@ public:
      */
     void removeNote(const NN_Note_t &note);
 
+    /**
+     * @brief Applies a batch of note edits in one pass over the note list.
+     * Removals and updates are matched by note ID, moved and added notes are sorted
+     * once and merged into the start-ordered list. The notes revision is bumped and
+     * metadataChanged is emitted once.
+     * @param changes Edits to apply (the previous list is ignored).
+     * @return The edits that were actually applied, with removed and previous holding
+     *         the full old notes (usable as an undo record through inverted()).
+     */
+    NN_NoteChangeSet_t applyNoteChanges(const NN_NoteChangeSet_t &changes);
+
     // GETTERS
     // ///////////////////////////////////////////////////////////////////////////////
 
@@ -330,10 +468,36 @@ public:
 
     /**
      * @brief Gets all MIDI notes in the track.
-     * @return Vector of notes.
+     * @return Vector of notes (copy, for callers that modify and write the notes back).
      */
     std::vector<NN_Note_t> getNotes() const { return midi_notes; }
 
+    /**
+     * @brief Read-only view of the MIDI notes without copying them.
+     * The view is invalidated by the next note edit of this track, so it must only be
+     * used by the thread that edits the notes (GUI) and not be stored.
+     * @return Span over the track's notes.
+     */
+    std::span<const NN_Note_t> getNotesView() const { return midi_notes; }
+
+    /**
+     * @brief Packed column snapshot of the notes. Single edits (addNote, removeNote,
+     * applyNoteChanges) derive it from the previous snapshot, bulk edits rebuild it lazily.
+     * The returned snapshot is immutable and stays valid while it is held, so it can
+     * be kept across edits and used from the playback and render threads. The rebuild
+     * reads the note list under the mutex that every note edit holds, so it is safe
+     * from any thread (it allocates, so not from the audio callback).
+     * @return Shared pointer to the snapshot (never nullptr).
+     */
+    std::shared_ptr<const NN_NoteColumns_t> getNoteColumns() const;
+
+    /**
+     * @brief Gets the revision of the note list. Incremented by every note edit,
+     * so caches built from the notes (e.g. playback schedulers) can detect changes cheaply.
+     * @return Notes revision counter.
+     */
+    uint64_t getNotesRevision() const { return notes_revision_.load(std::memory_order_acquire); }
+
     /**
      * @brief Gets the track's instrument index.
      * @return Optional instrument index.
@@ -442,7 +606,11 @@ public:
      * @brief Sets the notes for this track.
      * @param notes Vector of notes.
      */
-    void setNotes(const std::vector<NN_Note_t> &notes) { this->midi_notes = notes; }
+    void setNotes(const std::vector<NN_Note_t> &notes) {
+        std::lock_guard<std::mutex> lock(this->notes_mutex_);
+        this->midi_notes = notes;
+        this->notes_revision_.fetch_add(1, std::memory_order_release);
+    }
 
     /**
      * @brief Sets the instrument index.
@@ -557,7 +725,21 @@ protected:
     bool solo;                         ///< Track solo state
     float volume;                      ///< Track volume (0.0 - 1.0) - legacy, use audio_volume_db_
     std::vector<NN_Note_t> midi_notes; ///< MIDI notes in this track
+    std::atomic<uint64_t> notes_revision_{0}; ///< Incremented on every note edit
+    mutable std::mutex notes_mutex_;          ///< Held by note edits and snapshot rebuilds (guards midi_notes writes and note_columns_)
+    mutable std::shared_ptr<const NN_NoteColumns_t> note_columns_; ///< Cached column snapshot
     NoteNagaMidiSeq *parent;           ///< Pointer to parent MIDI sequence
+
+    /**
+     * @brief Derive the snapshot of the current revision from the previous one after a
+     * single edit (called with notes_mutex_ held, after the revision bump). Rows are taken
+     * from the start-ordered note list and the ID index is merged instead of sorted, so
+     * nothing is sorted except the touched notes. Leaves the snapshot to the lazy rebuild
+     * in getNoteColumns() if there is no snapshot of the previous revision or the list
+     * is not ordered.
+     * @param applied Edits that produced the current note list.
+     */
+    void patchNoteColumns(const NN_NoteChangeSet_t &applied);
     
     // Per-track synthesizer (new architecture)
     NoteNagaSynthesizer *synth_;           ///< Track's own synthesizer instance
@@ -568,6 +750,15 @@ protected:
     bool is_tempo_track;                         ///< True if this is a tempo track
     bool tempo_track_active;                     ///< True if tempo track is active (overrides fixed BPM)
     std::vector<NN_TempoEvent_t> tempo_events;   ///< Tempo events (only used if is_tempo_track)
+    mutable std::mutex tempo_map_mutex_;         ///< Guards tempo_map_
+    mutable std::shared_ptr<const NoteNagaTempoMap> tempo_map_; ///< Tempo map of tempo_events
+
+    /**
+     * @brief Publish a new tempo map after an edit of the tempo events.
+     * @param changed_tick Lowest changed tick (only the map from there is recomputed),
+     * std::nullopt rebuilds the whole map.
+     */
+    void updateTempoMap(std::optional<int> changed_tick = std::nullopt);
 
 public:
     // TEMPO TRACK METHODS
@@ -628,6 +819,14 @@ public:
      * @return BPM at that tick.
      */
     double getTempoAtTick(int tick) const;
+
+    /**
+     * @brief Gets the tempo map of the tempo events. The map is rebuilt (incrementally
+     * for single event edits) whenever the events change, before tempoEventsChanged is
+     * emitted. The returned snapshot is immutable and safe to use from any thread.
+     * @return Shared tempo map.
+     */
+    std::shared_ptr<const NoteNagaTempoMap> getTempoMap() const;
     
     /**
      * @brief Clears all tempo events and adds a single event at tick 0.
@@ -800,7 +999,7 @@ public:
      * @brief Gets all tracks in the sequence.
      * @return Vector of track pointers.
      */
-    std::vector<NoteNagaTrack *> getTracks() const { return tracks; }
+    const std::vector<NoteNagaTrack *> &getTracks() const { return tracks; }
 
     /**
      * @brief Gets a track by its ID.
@@ -927,6 +1126,13 @@ public:
      */
     int secondsToTicks(double seconds) const;
 
+    /**
+     * @brief Gets the tempo map of the sequence: the map of the active tempo track, or a
+     * constant map of the fixed tempo.
+     * @return Shared tempo map (immutable snapshot).
+     */
+    std::shared_ptr<const NoteNagaTempoMap> getTempoMap() const;
+
 protected:
     int sequence_id;                     ///< Unique sequence ID
     std::string file_path;               ///< Path to the MIDI file
@@ -937,6 +1143,8 @@ protected:
     int ppq;                             ///< Pulses per quarter note (PPQ)
     int tempo;                           ///< Tempo (BPM)
     int max_tick;                        ///< Maximum tick in the sequence
+    mutable std::mutex tempo_map_mutex_; ///< Guards fixed_tempo_map_
+    mutable std::shared_ptr<const NoteNagaTempoMap> fixed_tempo_map_; ///< Constant map of the fixed tempo
 
     // SIGNALS
     // ////////////////////////////////////////////////////////////////////////////////
@@ -1321,6 +1529,15 @@ public:
      */
     bool resizeClip(int clipId, int newDuration);
 
+    /**
+     * @brief Sets fade in/out of a clip.
+     * @param clipId The clip ID.
+     * @param fadeInTicks Fade in duration in ticks.
+     * @param fadeOutTicks Fade out duration in ticks.
+     * @return True if successful.
+     */
+    bool setClipFades(int clipId, int fadeInTicks, int fadeOutTicks);
+
     // CHANNEL REMAPPING
     // ///////////////////////////////////////////////////////////////////////////////
 
@@ -31,8 +31,6 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Auto Wah"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float sensitivity_ = 2.0f;
     float minFreq_ = 200.0f;
@@ -40,8 +38,6 @@ private:
     float resonance_ = 3.0f;
     float mix_ = 0.8f;
     
-    float sampleRate_ = 44100.0f;
-    
     // Envelope follower state
     float envelopeL_ = 0.0f;
     float envelopeR_ = 0.0f;
@@ -21,6 +21,9 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Chorus"; }
+    double getTailSeconds() const override { return 0.025; }
+
+    void setSampleRate(float sampleRate) override;
 
 private:
     float speed_;   // Hz, 0.2 ... 5.0
@@ -29,10 +32,10 @@ private:
 
     // Internal state
     float lfoPhase_ = 0.0f;
-    float sampleRate_ = 44100.0f; // Should be set from engine!
     std::vector<float> delayBufferL_, delayBufferR_;
     size_t delayIdx_ = 0;
     size_t maxDelaySamples_ = 0;
 
+    void resizeDelayBuffers();
     void prepareDelayBuffer(size_t numFrames);
 };
\ No newline at end of file
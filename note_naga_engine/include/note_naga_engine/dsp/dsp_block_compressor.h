@@ -22,7 +22,8 @@ public:
      * @param makeup The makeup gain in dB.
      */
     DSPBlockCompressor(float threshold, float ratio, float attack, float release, float makeup)
-        : threshold_db_(threshold), ratio_(ratio), attack_ms_(attack), release_ms_(release), makeup_db_(makeup) {}
+        : threshold_db_(threshold), ratio_(ratio), attack_ms_(attack), release_ms_(release), makeup_db_(makeup),
+          makeupRamp_(dB_to_linear(makeup)) {}
 
     void process(float* left, float* right, size_t numFrames) override;
     void resetState() override { gainSmooth_ = 1.0f; }
@@ -31,6 +32,7 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Compressor"; }
+    double getTailSeconds() const override { return release_ms_ * 0.001; }
 
 private:
     // Parameters
@@ -40,9 +42,16 @@ private:
     float release_ms_ = 80.0f;
     float makeup_db_ = 0.0f;
 
+    // Cached coefficients (recalcCoefficients)
+    float attack_coeff_ = 0.0f;
+    float release_coeff_ = 0.0f;
+    DSPSmoothedValue makeupRamp_; // Linear makeup gain
+
     // Internal state
     float gainSmooth_ = 1.0f;
 
+    void recalcCoefficients() override;
+
     // Helper
-    inline float dB_to_linear(float db) const { return powf(10.0f, db / 20.0f); }
+    static float dB_to_linear(float db) { return powf(10.0f, db / 20.0f); }
 };
\ No newline at end of file
@@ -28,15 +28,11 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "De-Esser"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float freq_ = 6000.0f;
     float threshold_ = -20.0f;
     float reduction_ = 6.0f;
     
-    float sampleRate_ = 44100.0f;
-    
     // High-pass filter state for detection
     float hpStateL_ = 0.0f;
     float hpStateR_ = 0.0f;
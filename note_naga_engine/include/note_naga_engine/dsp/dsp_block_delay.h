@@ -27,9 +27,10 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Delay"; }
+    double getTailSeconds() const override;
 
     // Call when changing sample rate
-    void setSampleRate(float sr);
+    void setSampleRate(float sampleRate) override;
 
 private:
     // Parameters
@@ -38,7 +39,6 @@ private:
     float mix_ = 0.5f;
 
     // Internal state
-    float sampleRate_ = 44100.0f;
     size_t delayIdx_ = 0;
     size_t maxDelaySamples_ = 44100; // 1 second max
 
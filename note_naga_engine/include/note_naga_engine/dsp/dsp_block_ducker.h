@@ -31,8 +31,6 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Ducker"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float threshold_ = -20.0f;
     float ratio_ = 8.0f;
@@ -40,8 +38,6 @@ private:
     float release_ = 200.0f;
     float depth_ = 20.0f;
     
-    float sampleRate_ = 44100.0f;
-    
     // Envelope follower state
     float envelope_ = 0.0f;
     
@@ -29,5 +29,4 @@ private:
 
     // Internal state for single-pole HP filter
     float hpL_ = 0.0f, hpR_ = 0.0f;
-    float sampleRate_ = 44100.0f;
 };
\ No newline at end of file
@@ -32,8 +32,6 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Filter"; }
 
-    void setSampleRate(float sr);
-
 private:
     // Parameters
     FilterType type_ = FilterType::Lowpass;
@@ -41,12 +39,16 @@ private:
     float resonance_ = 0.7f;     // Q (0.1 ... 2.0)
     float mix_ = 1.0f;           // 0 ... 1
 
-    float sampleRate_ = 44100.0f;
+    // Ramped parameters (audio thread)
+    DSPSmoothedValue cutoffSmooth_;
+    DSPSmoothedValue mixSmooth_;
+    FilterType coeffType_ = FilterType::Lowpass; // Type the coefficients were computed for
 
     // Biquad coefficients and state
     float a0_, a1_, a2_, b1_, b2_;
     float z1L_ = 0.0f, z2L_ = 0.0f;
     float z1R_ = 0.0f, z2R_ = 0.0f;
 
-    void calcCoeffs();
+    void recalcCoefficients() override;
+    void calcCoeffs(float cutoff);
 };
\ No newline at end of file
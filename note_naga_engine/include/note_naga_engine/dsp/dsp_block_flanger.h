@@ -21,6 +21,9 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Flanger"; }
+    double getTailSeconds() const override;
+
+    void setSampleRate(float sampleRate) override;
 
 private:
     float speed_;   // Hz, 0.05 ... 2.0
@@ -30,8 +33,9 @@ private:
 
     // Internal state
     float lfoPhase_ = 0.0f;
-    float sampleRate_ = 44100.0f; // Should be set from engine!
     std::vector<float> delayBufferL_, delayBufferR_;
     size_t delayIdx_ = 0;
     size_t maxDelaySamples_ = 0;
+
+    void resizeDelayBuffers();
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include <note_naga_engine/note_naga_api.h>
 
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <cmath>
 
 /** 
  * @brief DSP Block for a gain effect.
@@ -14,7 +15,7 @@ public:
      *
      * @param gain The gain value in dB.
      */
-    DSPBlockGain(float gain) : gain_(gain) {}
+    DSPBlockGain(float gain) : gain_(gain), gainRamp_(powf(10.0f, gain)) {}
 
     void process(float* left, float* right, size_t numFrames) override;
 
@@ -25,4 +26,7 @@ public:
 
 private:
     float gain_ = 0.0f;
+    DSPSmoothedValue gainRamp_; // Linear gain
+
+    void recalcCoefficients() override;
 };
\ No newline at end of file
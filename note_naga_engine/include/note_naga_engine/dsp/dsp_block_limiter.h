@@ -20,7 +20,8 @@ public:
      * @param makeup The makeup gain in dB.
      */
     DSPBlockLimiter(float threshold, float release, float makeup)
-        : threshold_db_(threshold), release_ms_(release), makeup_db_(makeup) {}
+        : threshold_db_(threshold), release_ms_(release), makeup_db_(makeup),
+          thresholdRamp_(dB_to_linear(threshold)), makeupRamp_(dB_to_linear(makeup)) {}
 
     void process(float* left, float* right, size_t numFrames) override;
     void resetState() override { gainSmooth_ = 1.0f; }
@@ -29,6 +30,7 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Limiter"; }
+    double getTailSeconds() const override { return release_ms_ * 0.001; }
 
 private:
     // Parameters
@@ -36,9 +38,16 @@ private:
     float release_ms_ = 50.0f;
     float makeup_db_ = 0.0f;
 
+    // Cached coefficients (recalcCoefficients)
+    float release_coeff_ = 0.0f;
+    DSPSmoothedValue thresholdRamp_; // Linear threshold
+    DSPSmoothedValue makeupRamp_;    // Linear makeup gain
+
     // Internal state
     float gainSmooth_ = 1.0f;
 
+    void recalcCoefficients() override;
+
     // Helper
-    inline float dB_to_linear(float db) const { return powf(10.0f, db / 20.0f); }
+    static float dB_to_linear(float db) { return powf(10.0f, db / 20.0f); }
 };
\ No newline at end of file
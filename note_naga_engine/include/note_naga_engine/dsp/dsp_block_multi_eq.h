@@ -20,15 +20,17 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Multi Band EQ"; }
 
-    void recalcCoeffs(int band);
-    void setSampleRate(float sr);
-
 private:
     struct Band {
         float freq;
         float gain;
         float q;
 
+        DSPSmoothedValue gainSmooth; // Ramped gain (audio thread)
+
+        // cos(omega) and alpha of the band frequency, they change only with the sample rate
+        float cs = 1.0f, alpha = 0.0f;
+
         // biquad coefficients (RBJ cookbook)
         float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
         float a0 = 1.0f, a1 = 0.0f, a2 = 0.0f;
@@ -39,5 +41,8 @@ private:
     };
 
     std::vector<Band> bands_;
-    float sampleRate_ = 44100.0f;
+    float trigSampleRate_ = 0.0f; // Sample rate of the cached cs / alpha
+
+    void recalcCoefficients() override;
+    void calcCoeffs(Band &band, float gain);
 };
\ No newline at end of file
@@ -30,5 +30,4 @@ private:
 
     // Internal state
     float gain_ = 0.0f;
-    float sampleRate_ = 44100.0f; // Should be set from engine!
 };
\ No newline at end of file
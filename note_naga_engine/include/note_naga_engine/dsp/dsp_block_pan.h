@@ -16,7 +16,7 @@ public:
      *
      * @param pan The pan value, where -1 is full left, 0 is center, and 1 is full right.
      */
-    DSPBlockPan(float pan) : pan_(pan) {}
+    DSPBlockPan(float pan);
 
     void process(float* left, float* right, size_t numFrames) override;
 
@@ -27,4 +27,10 @@ public:
 
 private:
     float pan_ = 0.0f; // -1 = Left, 0 = Center, 1 = Right
+
+    // Ramped channel gains (audio thread)
+    DSPSmoothedValue leftGain_;
+    DSPSmoothedValue rightGain_;
+
+    void recalcCoefficients() override;
 };
\ No newline at end of file
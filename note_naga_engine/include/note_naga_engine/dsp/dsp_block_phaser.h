@@ -28,7 +28,6 @@ private:
     float feedback_;   // Feedback amount, 0..0.95
     float mix_;        // Dry/Wet, 0..1
 
-    float sampleRate_ = 44100.0f; // Should be set from engine!
     float lfoPhase_ = 0.0f;
 
     // Phaser state: 6 all-pass stages per channel
@@ -26,21 +26,27 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Pitch Shifter"; }
+    double getTailSeconds() const override { return 0.2; }
 
-    void setSampleRate(float sr);
+    void setSampleRate(float sampleRate) override;
 
 private:
     float semitones_ = 0.0f;
     float mix_ = 1.0f;
     
-    float sampleRate_ = 44100.0f;
+    // Cached coefficients (recalcCoefficients)
+    float ratio_ = 1.0f;       // Read speed, 2^(semitones / 12)
+    float grainSize_ = 882.0f; // Crossfade grain length in samples
+    DSPSmoothedValue mixRamp_;
     
     // Delay buffer and crossfade for granular pitch shifting
     std::vector<float> bufferL_, bufferR_;
     size_t bufferSize_ = 8192;
     float readPosL_ = 0.0f;
     float readPosR_ = 0.0f;
+    float grainPos_ = 0.0f;    // readPosL_ modulo grainSize_
     size_t writeIdx_ = 0;
     
+    void recalcCoefficients() override;
     void resizeBuffers();
 };
@@ -19,8 +19,9 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Reverb"; }
+    double getTailSeconds() const override;
 
-    void setSampleRate(float sr);
+    void setSampleRate(float sampleRate) override;
 
 private:
     // Parameters
@@ -30,7 +31,6 @@ private:
     float predelay_ = 40.0f;  // ms
 
     // Internal state
-    float sampleRate_ = 44100.0f;
 
     // Comb filters (4 per channel)
     struct CombFilter {
@@ -27,12 +27,9 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Ring Modulator"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float freq_ = 440.0f;
     float mix_ = 0.5f;
     
-    float sampleRate_ = 44100.0f;
     float phase_ = 0.0f;
 };
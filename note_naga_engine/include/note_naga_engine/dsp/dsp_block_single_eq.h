@@ -18,15 +18,15 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Single Band EQ"; }
 
-    void recalcCoeffs();
-
-    void setSampleRate(float sr);
-
 private:
     float freq_ = 1000.0f;
     float gain_ = 0.0f;
     float q_ = 1.0f;
 
+    // Ramped parameters (audio thread), the biquad follows them once per block
+    DSPSmoothedValue freqSmooth_;
+    DSPSmoothedValue gainSmooth_;
+
     // biquad coefficients (RBJ cookbook)
     float b0_ = 1.0f, b1_ = 0.0f, b2_ = 0.0f;
     float a0_ = 1.0f, a1_ = 0.0f, a2_ = 0.0f;
@@ -35,5 +35,7 @@ private:
     float x1l_ = 0, x2l_ = 0, y1l_ = 0, y2l_ = 0;
     float x1r_ = 0, x2r_ = 0, y1r_ = 0, y2r_ = 0;
 
-    float sampleRate_ = 44100.0f;
+    void recalcCoefficients() override;
+    void calcCoeffs(float freq, float gain);
+
 };
\ No newline at end of file
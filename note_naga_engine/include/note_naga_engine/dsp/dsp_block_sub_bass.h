@@ -28,15 +28,11 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Sub Bass"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float freq_ = 80.0f;
     float amount_ = 0.5f;
     float mix_ = 0.5f;
     
-    float sampleRate_ = 44100.0f;
-    
     // Low-pass filter state for isolating bass
     float lpStateL1_ = 0.0f, lpStateL2_ = 0.0f;
     float lpStateR1_ = 0.0f, lpStateR2_ = 0.0f;
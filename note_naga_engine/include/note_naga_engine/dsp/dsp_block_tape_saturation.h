@@ -30,16 +30,12 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Tape Saturation"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float drive_ = 2.0f;
     float saturation_ = 0.5f;
     float warmth_ = 0.5f;
     float mix_ = 0.8f;
     
-    float sampleRate_ = 44100.0f;
-    
     // Low-pass filter state for warmth
     float lpStateL_ = 0.0f;
     float lpStateR_ = 0.0f;
@@ -27,14 +27,10 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Transient Shaper"; }
 
-    void setSampleRate(float sr) { sampleRate_ = sr; }
-
 private:
     float attack_ = 0.0f;
     float sustain_ = 0.0f;
     
-    float sampleRate_ = 44100.0f;
-    
     // Envelope followers with different time constants
     float fastEnvL_ = 0.0f, fastEnvR_ = 0.0f;
     float slowEnvL_ = 0.0f, slowEnvR_ = 0.0f;
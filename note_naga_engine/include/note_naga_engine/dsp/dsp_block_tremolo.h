@@ -19,12 +19,9 @@ public:
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Tremolo"; }
 
-    void setSampleRate(float sr);
-
 private:
     float speed_ = 5.0f; // Hz
     float depth_ = 0.8f; // 0 ... 1
     float mix_ = 1.0f;   // 0 ... 1
-    float sampleRate_ = 44100.0f;
     float phase_ = 0.0f;
 };
\ No newline at end of file
@@ -27,15 +27,15 @@ public:
     float getParamValue(size_t idx) const override;
     void setParamValue(size_t idx, float value) override;
     std::string getBlockName() const override { return "Vibrato"; }
+    double getTailSeconds() const override { return 0.05; }
 
-    void setSampleRate(float sr);
+    void setSampleRate(float sampleRate) override;
 
 private:
     float speed_ = 5.0f;
     float depth_ = 30.0f;
     float mix_ = 1.0f;
     
-    float sampleRate_ = 44100.0f;
     float lfoPhase_ = 0.0f;
     
     // Delay buffer for pitch shifting
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <note_naga_engine/core/async_queue_component.h>
+#include <note_naga_engine/core/seqlock.h>
+#include <note_naga_engine/core/triple_buffer.h>
+#include <note_naga_engine/note_naga_api.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+class NoteNagaSpectrumAnalyzer;
+class NoteNagaPanAnalyzer;
+
+/**
+ * @brief Level summary of one rendered block of a stereo signal.
+ */
+struct NOTE_NAGA_ENGINE_API NN_BlockLevels_t {
+    float sum_sq_left = 0.0f;  ///< Sum of squared left samples
+    float sum_sq_right = 0.0f; ///< Sum of squared right samples
+    float peak_left = 0.0f;    ///< Largest absolute left sample
+    float peak_right = 0.0f;   ///< Largest absolute right sample
+    uint32_t frames = 0;       ///< Number of frames summarized
+
+    /**
+     * @brief Add one stereo frame.
+     */
+    void add(float left, float right) {
+        sum_sq_left += left * left;
+        sum_sq_right += right * right;
+        float abs_left = left < 0.0f ? -left : left;
+        float abs_right = right < 0.0f ? -right : right;
+        if (abs_left > peak_left) peak_left = abs_left;
+        if (abs_right > peak_right) peak_right = abs_right;
+    }
+
+    /**
+     * @brief Merge another summary into this one.
+     */
+    void merge(const NN_BlockLevels_t &other) {
+        sum_sq_left += other.sum_sq_left;
+        sum_sq_right += other.sum_sq_right;
+        if (other.peak_left > peak_left) peak_left = other.peak_left;
+        if (other.peak_right > peak_right) peak_right = other.peak_right;
+        frames += other.frames;
+    }
+};
+
+/**
+ * @brief Levels of the master output, all values in dBFS (-100 = silence).
+ */
+struct NOTE_NAGA_ENGINE_API NN_MasterLevels_t {
+    float rms_left = -100.0f;
+    float rms_right = -100.0f;
+    float peak_left = -100.0f;
+    float peak_right = -100.0f;
+    float true_peak_left = -100.0f;  ///< Inter-sample peak (4x oversampled)
+    float true_peak_right = -100.0f;
+};
+
+/**
+ * @brief Metered level of one render source (track or arrangement track).
+ */
+struct NOTE_NAGA_ENGINE_API NN_SourceLevel_t {
+    const void *source = nullptr; ///< NoteNagaTrack* or NoteNagaArrangementTrack*
+    float rms_left = -100.0f;     ///< RMS in dB
+    float rms_right = -100.0f;
+};
+
+/**
+ * @brief NoteNagaAnalysisBus carries everything the visualizers need from the render thread
+ * to one analysis worker, and the results from that worker to the GUI.
+ *
+ * Render thread side (lock-free, no allocations):
+ * - the master mix is written into a sample ring with an atomic write position; the ring has
+ *   several readers (meters, spectrum, pan), each keeps its own cursor and checks after copying
+ *   that the writer did not wrap over the copied range, including the block it is still copying,
+ * - every track publishes a block summary (NN_BlockLevels_t, computed by the render jobs while
+ *   the block is still in cache) into a record ring instead of copying its audio.
+ *
+ * The worker (the AsyncQueueComponent thread, woken every kTriggerInterval samples through its
+ * lock-free wake counter) computes
+ * master RMS, peak and true peak, per source RMS with decay, and runs the spectrum and pan
+ * analyzers. Master levels are published through a sequence lock (any reader thread), source
+ * levels through a triple buffer (one reader thread, the GUI).
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaAnalysisBus : public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
+public:
+    static constexpr size_t kSampleRingSize = 32768;   ///< Master sample ring capacity (power of two)
+    static constexpr size_t kLevelRingSize = 4096;     ///< Block summary ring capacity (power of two)
+    static constexpr uint64_t kTriggerInterval = 256;  ///< Samples between worker wake ups
+    static constexpr float kDecayDbPerSample = 1.0f / 512.0f; ///< Fall of sources which stopped publishing
+
+    /**
+     * @brief Create the bus and start its worker.
+     * @param spectrum_analyzer Spectrum analyzer run by the worker (may be null).
+     * @param pan_analyzer Pan analyzer run by the worker (may be null).
+     */
+    NoteNagaAnalysisBus(NoteNagaSpectrumAnalyzer *spectrum_analyzer, NoteNagaPanAnalyzer *pan_analyzer);
+    ~NoteNagaAnalysisBus() override;
+
+    /*******************************************************************************************************/
+    // Render thread
+    /*******************************************************************************************************/
+
+    /**
+     * @brief Summarize a stereo block.
+     * @param left Left channel samples.
+     * @param right Right channel samples.
+     * @param num_frames Number of frames.
+     */
+    static NN_BlockLevels_t measure(const float *left, const float *right, size_t num_frames);
+
+    /**
+     * @brief Publish the block summary of a source (render thread only).
+     * Several summaries of one source in one block are merged.
+     * @param source Metered object (NoteNagaTrack* or NoteNagaArrangementTrack*).
+     * @param levels Block summary.
+     */
+    void publishLevels(const void *source, const NN_BlockLevels_t &levels);
+
+    /**
+     * @brief Publish a block of the master mix and wake the worker when due (render thread only).
+     * @param left Left channel samples.
+     * @param right Right channel samples.
+     * @param num_frames Number of frames.
+     */
+    void publishMaster(const float *left, const float *right, size_t num_frames);
+
+    /**
+     * @brief Drop all source levels (any thread, applied by the worker).
+     */
+    void resetLevels() { reset_levels_.store(true, std::memory_order_release); }
+
+    /*******************************************************************************************************/
+    // Sample ring readers (analysis worker)
+    /*******************************************************************************************************/
+
+    /**
+     * @brief Total number of master frames written so far.
+     */
+    uint64_t getSampleWritePosition() const { return sample_write_pos_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Copy master frames from the ring.
+     * @param start Position of the first frame (at most kSampleRingSize behind the write position).
+     * @param num_frames Number of frames (at most kSampleRingSize).
+     * @param left Destination of the left channel.
+     * @param right Destination of the right channel.
+     * @return False if the writer overwrote part of the range while it was copied.
+     */
+    bool readSamples(uint64_t start, size_t num_frames, float *left, float *right) const;
+
+    /*******************************************************************************************************/
+    // Results (GUI)
+    /*******************************************************************************************************/
+
+    /**
+     * @brief Latest master levels (any thread, never blocks the worker).
+     */
+    NN_MasterLevels_t getMasterLevels() const { return master_levels_.load(); }
+
+    /**
+     * @brief Latest RMS of a source in dB (single reader thread, normally the GUI thread).
+     * @param source Metered object.
+     * @return Left and right RMS in dB, -100 if the source is silent or unknown.
+     */
+    std::pair<float, float> getSourceLevelDb(const void *source) const;
+
+private:
+    static constexpr size_t kTruePeakTaps = 12;   ///< FIR length of one oversampling phase
+    static constexpr size_t kTruePeakPhases = 4;  ///< Oversampling factor
+    static constexpr size_t kChunkFrames = 1024;  ///< Frames copied from the ring at once
+
+    struct LevelRecord {
+        const void *source = nullptr;
+        NN_BlockLevels_t levels;
+    };
+
+    struct SourceState {
+        const void *source = nullptr;
+        NN_BlockLevels_t pending; ///< Summaries received since the last worker cycle
+        float rms_left = -100.0f;
+        float rms_right = -100.0f;
+    };
+
+    NoteNagaSpectrumAnalyzer *spectrum_analyzer_;
+    NoteNagaPanAnalyzer *pan_analyzer_;
+
+    // Master sample ring, written only by the render thread
+    std::vector<float> ring_left_;
+    std::vector<float> ring_right_;
+    std::atomic<uint64_t> sample_write_pos_{0}; ///< Total frames written (published after the data)
+    std::atomic<uint64_t> sample_write_end_{0}; ///< End of the block being copied (published before the data)
+    uint64_t trigger_pos_ = 0;                  ///< Write position at the last wake up (render thread)
+
+    // Block summary ring, written only by the render thread
+    std::vector<LevelRecord> level_ring_;
+    std::atomic<uint64_t> level_write_pos_{0};
+
+    std::atomic<bool> reset_levels_{false};
+
+    // Worker state
+    uint64_t master_cursor_ = 0;
+    uint64_t level_cursor_ = 0;
+    std::vector<SourceState> sources_; ///< Sorted by source
+    std::vector<float> chunk_left_;
+    std::vector<float> chunk_right_;
+    std::array<std::array<float, kTruePeakTaps>, kTruePeakPhases> true_peak_fir_;
+    std::array<float, kTruePeakTaps> history_left_{};  ///< Last input samples, newest first
+    std::array<float, kTruePeakTaps> history_right_{};
+
+    // Published results
+    NoteNagaSeqLock<NN_MasterLevels_t> master_levels_;
+    mutable NoteNagaTripleBuffer<std::vector<NN_SourceLevel_t>> source_levels_;
+
+    void onItem(const NN_AsyncTriggerMessage_t &message) override;
+
+    void processMaster();
+    void processSourceLevels(uint64_t elapsed_frames);
+    float truePeak(float sample, std::array<float, kTruePeakTaps> &history) const;
+};
@@ -4,16 +4,99 @@
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/core/note_naga_synthesizer.h>
 #include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/render_thread_pool.h>
+#include <note_naga_engine/core/lock_free_spsc_queue.h>
+#include <note_naga_engine/core/seqlock.h>
+#include <note_naga_engine/core/arrangement_render_plan.h>
 #include <note_naga_engine/audio/audio_resource.h>
 #include <note_naga_engine/module/metronome.h>
-#include <note_naga_engine/module/spectrum_analyzer.h>
-#include <note_naga_engine/module/pan_analyzer.h>
+#include <note_naga_engine/module/analysis_bus.h>
 #include <note_naga_engine/core/runtime_data.h>
 #include <note_naga_engine/module/playback_worker.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <vector>
 #include <mutex>
 #include <map>
+#include <unordered_map>
+
+/**
+ * @brief Immutable snapshot of the DSP routing used by the audio thread.
+ * A new snapshot is built on every edit (add/remove/reorder) and published
+ * atomically, so NoteNagaDSPEngine::render() never has to take a lock.
+ */
+struct NOTE_NAGA_ENGINE_API NN_DSPRenderGraph_t {
+    std::vector<NoteNagaDSPBlockBase*> master_blocks; ///< Master channel DSP chain
+    std::unordered_map<INoteNagaSoftSynth*, std::vector<NoteNagaDSPBlockBase*>> synth_blocks; ///< Per-synth DSP chains
+
+    /**
+     * @brief Find DSP chain of a synthesizer.
+     * @param synth Pointer to the synthesizer.
+     * @return Pointer to the chain or nullptr if the synth has no DSP blocks.
+     */
+    const std::vector<NoteNagaDSPBlockBase*>* findSynthBlocks(INoteNagaSoftSynth *synth) const {
+        auto it = synth_blocks.find(synth);
+        return it != synth_blocks.end() ? &it->second : nullptr;
+    }
+};
+
+/**
+ * @brief Render instrumentation of the DSP engine (see NoteNagaDSPEngine::getRenderStats()).
+ * A node is one synth render job (a synth with its DSP chain); silent nodes are skipped.
+ */
+struct NOTE_NAGA_ENGINE_API NN_RenderStats_t {
+    uint32_t nodes = 0;          ///< Nodes in the last block
+    uint32_t skipped_synths = 0; ///< Nodes of the last block whose synth was not rendered
+    uint32_t skipped_chains = 0; ///< Nodes of the last block whose DSP chain was not processed
+    uint64_t skipped_total = 0;  ///< Skipped synth renders and chain passes since start
+};
+
+/**
+ * @brief MIDI event scheduled on the audio clock (see NoteNagaDSPEngine::scheduleMidiEvent()).
+ */
+struct NOTE_NAGA_ENGINE_API NN_ScheduledMidiEvent_t {
+    /// Action applied to the track's synthesizer
+    enum class Type : uint8_t {
+        NoteOn,       ///< NoteNagaTrack::playNote()
+        NoteOff,      ///< NoteNagaTrack::stopNote()
+        AllNotesOff   ///< NoteNagaTrack::stopAllNotes()
+    };
+
+    int64_t sample_time = 0;         ///< Audio clock time (see getRenderedSampleTime()), past times fire immediately
+    NoteNagaTrack *track = nullptr;  ///< Target track (parent of the note)
+    unsigned long note_id = 0;       ///< Note ID, pairs a note-off with its note-on
+    uint32_t generation = 0;         ///< Flush generation, stamped by scheduleMidiEvent()
+    Type type = Type::NoteOn;
+    uint8_t pitch = 0;               ///< MIDI note number
+    uint8_t velocity = 0;            ///< Velocity (0 = unset)
+    uint8_t pan = NN_NoteColumns_t::PAN_UNSET; ///< Note pan (PAN_UNSET = unset)
+
+    /**
+     * @brief Fill the note fields from a note (unused for AllNotesOff).
+     * @param note Note to play or stop.
+     */
+    void setNote(const NN_Note_t &note) {
+        note_id = note.id;
+        pitch = static_cast<uint8_t>(std::clamp(note.note, 0, 127));
+        velocity = static_cast<uint8_t>(std::clamp(note.velocity.value_or(0), 0, 127));
+        pan = note.pan.has_value() ? static_cast<uint8_t>(std::clamp(*note.pan, 0, 127))
+                                   : NN_NoteColumns_t::PAN_UNSET;
+    }
+
+    /**
+     * @brief Rebuild the note for the synthesizer call.
+     * @return Note with the original ID, parented to the target track.
+     */
+    NN_Note_t toNote() const {
+        NN_Note_t note(pitch, track);
+        note.id = note_id;
+        if (velocity > 0) note.velocity = velocity;
+        if (pan != NN_NoteColumns_t::PAN_UNSET) note.pan = pan;
+        return note;
+    }
+};
 
 /** 
  * @brief NoteNagaDSPEngine is the main DSP engine for the Note Naga project.
@@ -26,20 +109,20 @@ public:
      * @brief Construct a new NoteNagaDSPEngine object.
      * 
      * @param metronome Pointer to the metronome module.
-     * @param spectrum_analyzer Pointer to the spectrum analyzer module.
-     * @param pan_analyzer Pointer to the pan analyzer module.
+     * @param analysis_bus Analysis bus receiving the master mix and track levels (meters, spectrum, pan).
      */
-    NoteNagaDSPEngine(NoteNagaMetronome* metronome = nullptr, NoteNagaSpectrumAnalyzer* spectrum_analyzer = nullptr, NoteNagaPanAnalyzer* pan_analyzer = nullptr);
-    ~NoteNagaDSPEngine() = default;
+    NoteNagaDSPEngine(NoteNagaMetronome* metronome = nullptr, NoteNagaAnalysisBus* analysis_bus = nullptr);
+    ~NoteNagaDSPEngine();
 
     /**
      * @brief Render audio output.
+     * Lock-free: the DSP routing is read from the currently published render graph snapshot.
      * 
      * @param output Pointer to the output buffer.
      * @param num_frames Number of frames to render.
-     * @param compute_rms Whether to compute RMS levels for volume metering.
+     * @param analyze Whether to publish the master mix to the analysis bus (master meters, spectrum, pan).
      */
-    void render(float *output, size_t num_frames, bool compute_rms = true);
+    void render(float *output, size_t num_frames, bool analyze = true);
 
     /**
      * @brief Add a DSP block to the master channel.
@@ -50,6 +133,7 @@ public:
 
     /**
      * @brief Remove a DSP block from the master channel.
+     * Returns only after the audio thread stopped using the block, so it can be deleted right away.
      * 
      * @param block Pointer to the DSP block to remove.
      */
@@ -73,6 +157,7 @@ public:
 
     /**
      * @brief Remove a DSP block from a specific synthesizer.
+     * Returns only after the audio thread stopped using the block, so it can be deleted right away.
      * 
      * @param synth Pointer to the synthesizer.
      * @param block Pointer to the DSP block to remove.
@@ -93,7 +178,7 @@ public:
      * 
      * @return std::vector<NoteNagaDSPBlockBase*> List of DSP blocks.
      */
-    std::vector<NoteNagaDSPBlockBase*> getDSPBlocks() const { return dsp_blocks_; }
+    std::vector<NoteNagaDSPBlockBase*> getDSPBlocks() const;
 
     /**
      * @brief Get all DSP blocks for a specific synthesizer.
@@ -115,7 +200,74 @@ public:
      * 
      * @return True if DSP is enabled, false otherwise.
      */
-    bool isDSPEnabled() const { return enable_dsp_; }
+    bool isDSPEnabled() const { return enable_dsp_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set number of threads used to render synthesizers in parallel.
+     * Outputs are always summed in the same order, so the result does not depend on the thread count.
+     * Must not be called from the audio thread.
+     * 
+     * @param num_threads Total rendering threads (0 = automatic, 1 = single-threaded).
+     */
+    void setRenderThreadCount(int num_threads);
+
+    /**
+     * @brief Get number of threads used to render synthesizers.
+     * 
+     * @return Thread count (1 = single-threaded).
+     */
+    int getRenderThreadCount() const;
+
+    /**
+     * @brief Get render instrumentation (skipped silent nodes).
+     * A synth without voices and events is no longer rendered once its output stayed silent
+     * for longer than its tail, a DSP chain is no longer processed once its input stayed
+     * silent for longer than the tails of its blocks. Safe to call from any thread.
+     *
+     * @return Statistics of the last rendered block.
+     */
+    NN_RenderStats_t getRenderStats() const { return render_stats_.load(); }
+
+    /**
+     * @brief Enable sample-accurate MIDI scheduling. When enabled, the playback worker follows
+     * the audio clock and queues timestamped note events with scheduleMidiEvent() instead of
+     * calling the synthesizers directly; render() applies them at their exact sample offset by
+     * splitting the synth rendering at event boundaries.
+     * 
+     * @param enable True to enable sample-accurate scheduling.
+     */
+    void setSampleAccurateMidi(bool enable) { sample_accurate_midi_.store(enable, std::memory_order_relaxed); }
+
+    /**
+     * @brief Check if sample-accurate MIDI scheduling is enabled.
+     * 
+     * @return True if enabled.
+     */
+    bool isSampleAccurateMidi() const { return sample_accurate_midi_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Audio clock: total number of frames rendered by render() so far.
+     * The next rendered block starts at this time.
+     * 
+     * @return Rendered sample time.
+     */
+    int64_t getRenderedSampleTime() const { return rendered_sample_time_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Queue a MIDI event for the block containing its sample time.
+     * Lock-free, single producer (the playback thread). Events must be queued in time order.
+     * 
+     * @param event Event to schedule.
+     * @return False if the queue is full (the event is dropped).
+     */
+    bool scheduleMidiEvent(const NN_ScheduledMidiEvent_t &event);
+
+    /**
+     * @brief Drop all queued MIDI events which were not applied yet (producer thread only).
+     * Events scheduled after the call are kept. Queued all-notes-off events are not dropped,
+     * they fire at the start of the next block.
+     */
+    void flushScheduledMidiEvents();
 
     /**
      * @brief Set the runtime data for track-based rendering.
@@ -135,10 +287,29 @@ public:
      * @brief Set the playback mode (Sequence or Arrangement).
      * In Sequence mode, only the active sequence's tracks are rendered.
      * In Arrangement mode, all sequences' tracks are rendered.
+     * Switching to Arrangement mode rebuilds the arrangement render plan.
      * 
      * @param mode The playback mode.
      */
-    void setPlaybackMode(PlaybackMode mode) { playback_mode_ = mode; }
+    void setPlaybackMode(PlaybackMode mode);
+
+    /**
+     * @brief Rebuild the precomputed arrangement routing table (synth -> arrangement track,
+     * active clip, fade envelope). Call whenever arrangement clips/tracks, the sequence list
+     * or track synthesizers change. Must not be called from the audio thread.
+     *
+     * @param wait_for_render When true, returns only once no render() references the previous
+     * plan, so synths and arrangement tracks dropped from the project can be deleted afterwards.
+     */
+    void rebuildArrangementRenderPlan(bool wait_for_render = false);
+
+    /**
+     * @brief Publish the current arrangement tempo map (NoteNagaRuntimeData::getArrangementTempoMap())
+     * for the audio thread, which only reads the published pointer. Call whenever the arrangement
+     * tempo track, its activation or the active sequence tempo change (rebuildArrangementRenderPlan()
+     * publishes it too). Must not be called from the audio thread.
+     */
+    void publishArrangementTempoMap();
 
     /**
      * @brief Get the current playback mode.
@@ -159,10 +330,10 @@ public:
      * 
      * @return float Current output volume (0.0 to 1.0).
      */
-    float getOutputVolume() const { return output_volume_; }
+    float getOutputVolume() const { return output_volume_.load(std::memory_order_relaxed); }
 
     /**
-     * @brief Get the current volume in dB.
+     * @brief Get the current volume in dB (any thread).
      * 
      * @return std::pair<float, float> Current volume in dB (left, right).
      */
@@ -170,6 +341,7 @@ public:
 
     /**
      * @brief Get the current volume in dB for a specific track.
+     * Track levels are read from a triple buffer, call from one thread only (GUI).
      * 
      * @param track Pointer to the track.
      * @return std::pair<float, float> Current volume in dB (left, right).
@@ -186,14 +358,18 @@ public:
     /**
      * @brief Reset internal state of all DSP blocks.
      * Call this when playback restarts to prevent state bleed.
+     * The reset itself is deferred to the start of the next render() call,
+     * so DSP block state is only ever touched by the audio thread.
      */
     void resetAllBlocks();
 
     /**
      * @brief Set the sample rate for audio calculations.
+     * Blocks added later get it right away, blocks already in the graph receive it
+     * at the start of the next render() call (on the audio thread).
      * @param sampleRate Sample rate in Hz.
      */
-    void setSampleRate(int sampleRate) { sampleRate_ = sampleRate; }
+    void setSampleRate(int sampleRate);
 
     /**
      * @brief Get the current sample rate.
@@ -240,33 +416,103 @@ public:
      * @brief Reset all arrangement track RMS values to silence.
      */
     void resetArrangementTrackRMS() {
-        arr_track_rms_values_.clear();
+        if (analysis_bus_) analysis_bus_->resetLevels();
     }
 
     /**
      * @brief Convert tick position to sample position.
      * @param tick Tick position.
-     * @param tempo Tempo in microseconds per quarter note.
+     * @param tempo_map Tempo map of the timeline (see NoteNagaRuntimeData::getArrangementTempoMap()).
      * @param ppq Pulses per quarter note.
      * @return Sample position.
      */
-    int64_t tickToSamples(int tick, int tempo, int ppq) const;
+    int64_t tickToSamples(int tick, const NoteNagaTempoMap &tempo_map, int ppq) const;
 
     /**
      * @brief Convert sample position to tick position.
      * @param sample Sample position.
-     * @param tempo Tempo in microseconds per quarter note.
+     * @param tempo_map Tempo map of the timeline.
      * @param ppq Pulses per quarter note.
      * @return Tick position.
      */
-    int sampleToTicks(int64_t sample, int tempo, int ppq) const;
+    int sampleToTicks(int64_t sample, const NoteNagaTempoMap &tempo_map, int ppq) const;
 
 private:
-    std::mutex dsp_engine_mutex_;
-    std::vector<NoteNagaDSPBlockBase*> dsp_blocks_;
-    
-    // Mapping from synth to its DSP blocks (for per-track synths)
-    std::map<INoteNagaSoftSynth*, std::vector<NoteNagaDSPBlockBase*>> synth_dsp_blocks_;
+    // Render graph publication (RCU style). Writers are serialized by dsp_engine_mutex_,
+    // build a new snapshot and swap it in; render() only loads the pointer.
+    mutable std::mutex dsp_engine_mutex_;                          ///< Serializes graph writers (never taken by render)
+    std::atomic<const NN_DSPRenderGraph_t*> render_graph_{nullptr}; ///< Currently published snapshot
+    std::atomic<uint64_t> render_epoch_{0};                        ///< Odd while render() is running
+    std::vector<std::pair<const NN_DSPRenderGraph_t*, uint64_t>> retired_graphs_; ///< Snapshots waiting for reclamation (graph, epoch at retire)
+    std::atomic<bool> reset_blocks_pending_{false};                ///< Set by resetAllBlocks(), handled in render()
+    std::atomic<bool> sample_rate_pending_{false};                 ///< Set by setSampleRate(), handled in render()
+    std::atomic<NoteNagaRenderThreadPool*> render_pool_{nullptr};  ///< Parallel synth rendering (replaced like the graph)
+    std::atomic<NoteNagaArrangementRenderPlan*> arrangement_plan_{nullptr}; ///< Arrangement routing table
+    std::vector<std::pair<NoteNagaArrangementRenderPlan*, uint64_t>> retired_plans_; ///< Plans waiting for reclamation
+    using TempoMapRef = std::shared_ptr<const NoteNagaTempoMap>;
+    std::atomic<const TempoMapRef*> arrangement_tempo_map_{nullptr}; ///< Arrangement tempo map (the reference is released only through retirement)
+    std::vector<std::pair<const TempoMapRef*, uint64_t>> retired_tempo_maps_; ///< Tempo map references waiting for reclamation
+
+    /**
+     * @brief Publish the arrangement tempo map. Caller must hold dsp_engine_mutex_.
+     */
+    void publishArrangementTempoMapLocked();
+
+    // Silence tracking of render nodes (audio thread only)
+    static constexpr float kSilenceThreshold = 1e-5f;   ///< Peak below -100 dB counts as silence
+    static constexpr double kSilenceHoldSeconds = 0.05; ///< Added to chain tails (filter and envelope state)
+    struct NodeState {
+        const void *key = nullptr;       ///< Track (Sequence mode) or synth (Arrangement mode)
+        int64_t synth_idle_frames = 0;   ///< Frames since the synth last had voices or events
+        int64_t chain_idle_frames = 0;   ///< Frames since the chain input was last audible
+        bool synth_quiet = false;        ///< Last rendered synth output was silent
+        bool chain_quiet = false;        ///< Last processed chain output was silent
+        uint64_t last_block = 0;         ///< Last block the node had a job in
+    };
+
+    /// One synthesizer rendered as an independent job of the render pool
+    struct SynthRenderJob {
+        INoteNagaSoftSynth *synth = nullptr;
+        NoteNagaTrack *track = nullptr;               ///< Sequence mode: source track
+        NoteNagaArrangementTrack *arr_track = nullptr; ///< Arrangement mode: owning arrangement track
+        int arr_track_index = -1;                     ///< Arrangement mode: index in the render plan
+        bool has_clip = false;                        ///< Arrangement mode: a clip is active (fades)
+        float volume = 1.0f;
+        float pan_l = 1.0f;
+        float pan_r = 1.0f;
+        int64_t fade_in_samples = 0;
+        int64_t fade_out_samples = 0;
+        int64_t clip_start_sample = 0;
+        int64_t clip_end_sample = 0;
+        bool has_fade_out = false;
+        NN_BlockLevels_t levels;                      ///< Result: level summary of the rendered block
+        NodeState *node = nullptr;                       ///< Silence tracking of the job's node
+        bool synth_skipped = false;                   ///< Result: synth was silent, not rendered
+        bool chain_skipped = false;                   ///< Result: DSP chain was silent, not processed
+        bool silent = false;                          ///< Result: nothing audible, left out of the mix
+    };
+    std::vector<SynthRenderJob> render_jobs_; ///< Job slots, reused between callbacks
+
+    std::vector<NodeState> node_states_; ///< Sorted by key
+    uint64_t node_block_ = 0;            ///< Block counter of the node states
+    uint64_t skipped_total_ = 0;
+    NoteNagaSeqLock<NN_RenderStats_t> render_stats_;
+
+    // Sample-accurate MIDI scheduling
+    static constexpr size_t kMidiQueueSize = 4096;          ///< Capacity of the scheduled event queue
+    static constexpr size_t kMaxBlockMidiEvents = 1024;     ///< Events applied per block (rest waits for the next one)
+    std::atomic<bool> sample_accurate_midi_{false};
+    std::atomic<int64_t> rendered_sample_time_{0};          ///< Audio clock (frames rendered so far)
+    std::atomic<uint32_t> midi_flush_generation_{0};        ///< Events with an older generation are dropped
+    std::unique_ptr<LockFreeSPSCQueue<NN_ScheduledMidiEvent_t, kMidiQueueSize>> midi_queue_;
+    std::vector<NN_ScheduledMidiEvent_t> block_midi_events_; ///< Events of the current block (audio thread only)
+    std::vector<size_t> block_midi_offsets_;                ///< Frame offset of each block event
+    std::vector<int> block_midi_jobs_;                      ///< Render job applying each block event (-1 = none)
+    std::vector<std::pair<INoteNagaSoftSynth *, int>> job_lookup_; ///< Synth -> render job, sorted by synth
+    std::vector<uint32_t> job_lane_start_;                  ///< Per-job lanes: first entry of job j in job_lane_events_
+    std::vector<uint32_t> job_lane_cursor_;                 ///< Fill cursors used while building the lanes
+    std::vector<uint32_t> job_lane_events_;                 ///< Block event indices grouped by job, in time order
+    std::vector<float> job_buffers_;          ///< Per-job stereo buffers [job][L frames | R frames]
     
     // Runtime data for track-based rendering
     NoteNagaRuntimeData* runtime_data_ = nullptr;
@@ -278,19 +524,12 @@ private:
     std::vector<float> mix_right_;
     std::vector<float> temp_left_;
     std::vector<float> temp_right_;
-    std::vector<float> track_left_;
-    std::vector<float> track_right_;
     
-    float output_volume_ = 1.0f;
-    float last_rms_left_ = -100.0f;
-    float last_rms_right_ = -100.0f;
-    std::map<NoteNagaTrack*, std::pair<float, float>> track_rms_values_; ///< Per-track RMS in dB
-    std::map<NoteNagaArrangementTrack*, std::pair<float, float>> arr_track_rms_values_; ///< Per-arrangement-track RMS in dB
-    bool enable_dsp_ = true;
+    std::atomic<float> output_volume_{1.0f};
+    std::atomic<bool> enable_dsp_{true};
     
     NoteNagaMetronome* metronome_ = nullptr;
-    NoteNagaSpectrumAnalyzer* spectrum_analyzer_ = nullptr;
-    NoteNagaPanAnalyzer* pan_analyzer_ = nullptr;
+    NoteNagaAnalysisBus* analysis_bus_ = nullptr;
     
     // Audio rendering state
     int sampleRate_ = 44100;
@@ -298,19 +537,120 @@ private:
     std::atomic<bool> audioPlaybackActive_{false}; ///< True when playback is active
     std::vector<float> audioClipBuffer_; ///< Temporary buffer for audio clip samples
     
-    /// Track fade out state for synths that played clips with fade out
-    /// Maps synth to (clipEndSample, fadeOutSamples) for continuing fade after clip ends
-    std::map<INoteNagaSoftSynth*, std::pair<int64_t, int64_t>> synthFadeOutState_;
-    
-    void calculateRMS(float *left, float *right, size_t numFrames);
-    std::pair<float, float> calculateTrackRMS(float *left, float *right, size_t numFrames);
+    /**
+     * @brief Copy of the currently published render graph. Caller must hold dsp_engine_mutex_.
+     * @return Newly allocated mutable copy.
+     */
+    NN_DSPRenderGraph_t *cloneRenderGraph() const;
+
+    /**
+     * @brief Publish a new render graph and retire the previous one. Caller must hold dsp_engine_mutex_.
+     * @param graph New snapshot (ownership is transferred to the engine).
+     */
+    void publishRenderGraph(NN_DSPRenderGraph_t *graph);
+
+    /**
+     * @brief Free retired snapshots (render graphs and arrangement plans) which the audio
+     * thread can no longer reference.
+     * Caller must hold dsp_engine_mutex_.
+     */
+    void reclaimRetiredGraphs();
+
+    /**
+     * @brief Block the calling (non-audio) thread until any render() that could still
+     * see a retired snapshot has finished. Bounded by the duration of one audio block.
+     */
+    void waitForRenderQuiescence();
+
+    /**
+     * @brief Reset state of all blocks in the given graph (audio thread only).
+     * @param graph Render graph snapshot.
+     */
+    void resetGraphBlocks(const NN_DSPRenderGraph_t *graph);
+
+    /**
+     * @brief Pass the engine sample rate to all DSP blocks of a graph (audio thread).
+     */
+    void applyGraphSampleRate(const NN_DSPRenderGraph_t *graph);
+
+    /**
+     * @brief Make sure job buffers can hold num_jobs stereo blocks of num_frames.
+     * @param num_jobs Number of jobs.
+     * @param num_frames Frames per block.
+     */
+    void ensureJobBuffers(size_t num_jobs, size_t num_frames);
+
+    /**
+     * @brief Move queued MIDI events due in the current block into block_midi_events_ (audio thread).
+     * @param block_start Audio clock time of the first frame of the block.
+     * @param num_frames Frames in the block.
+     */
+    void collectBlockMidiEvents(int64_t block_start, size_t num_frames);
+
+    /**
+     * @brief Assign block events to the render jobs of their synthesizers and group them into
+     * one lane per job, so each job only visits its own events. Events without a job (muted
+     * track, no synth) are applied right away.
+     */
+    void assignBlockMidiEvents();
+
+    /**
+     * @brief Apply one scheduled event to its track. Only soft synth tracks are queued, their note
+     * state is a preallocated lock-free table (NoteNagaActiveNotes), so this neither locks nor allocates.
+     * @param event Event to apply.
+     */
+    static void applyMidiEvent(const NN_ScheduledMidiEvent_t &event);
+
+    /**
+     * @brief Render the source of a job (track in Sequence mode, synth in Arrangement mode),
+     * applying its block events at their frame offsets.
+     * @param job Render job.
+     * @param job_index Index of the job.
+     * @param left Left output buffer.
+     * @param right Right output buffer.
+     * @param num_frames Frames in the block.
+     */
+    void renderJobSource(const SynthRenderJob &job, size_t job_index, float *left, float *right, size_t num_frames);
+
+    /**
+     * @brief Attach the silence tracking state of its node to every render job.
+     * Nodes without a job in the previous block are forgotten (they start audible again).
+     */
+    void bindNodeStates();
+
+    /**
+     * @brief Render a job's source and DSP chain, skipping the parts that are silent past their tail.
+     * @param job Render job (its node state must be bound).
+     * @param job_index Index of the job.
+     * @param graph Render graph snapshot.
+     * @param dsp_enabled Whether per-synth DSP chains should be applied.
+     * @param left Left output buffer.
+     * @param right Right output buffer.
+     * @param num_frames Frames in the block.
+     * @return False if the output is silent (the buffers may hold stale data then).
+     */
+    bool renderJobNode(SynthRenderJob &job, size_t job_index, const NN_DSPRenderGraph_t *graph, bool dsp_enabled,
+                       float *left, float *right, size_t num_frames);
+
+    /**
+     * @brief Count skipped nodes of the finished jobs and publish the render statistics.
+     */
+    void publishRenderStats();
+
+    float *jobLeft(size_t job, size_t num_frames) { return job_buffers_.data() + job * 2 * num_frames; }
+    float *jobRight(size_t job, size_t num_frames) { return jobLeft(job, num_frames) + num_frames; }
+
     
     /**
      * @brief Render MIDI tracks based on arrangement tracks with their volume/pan settings.
      * In Arrangement mode, each arrangement track's clips determine which synths to render.
+     * @param graph Render graph snapshot loaded by render().
+     * @param pool Thread pool used to render synthesizers in parallel (may be nullptr).
+     * @param dspEnabled Whether per-synth DSP chains should be applied.
      * @param numFrames Number of frames to render.
      */
-    void renderArrangementTracks(size_t numFrames);
+    void renderArrangementTracks(const NN_DSPRenderGraph_t *graph, NoteNagaRenderThreadPool *pool,
+                                 bool dspEnabled, size_t numFrames);
     
     /**
      * @brief Render audio clips from arrangement tracks into the mix buffers.
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+#include <note_naga_engine/core/types.h>
+#include <note_naga_engine/core/dsp_block_base.h>
+#include <note_naga_engine/core/render_thread_pool.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class NoteNagaRuntimeData;
+class NoteNagaDSPEngine;
+
+/**
+ * @brief Settings of an offline render (see NoteNagaOfflineRenderer).
+ */
+struct NOTE_NAGA_ENGINE_API NN_OfflineRenderSettings_t {
+    int block_size = 16384;    ///< Frames rendered per block (MIDI events still land on their exact sample)
+    int num_threads = 0;       ///< Rendering threads (0 = automatic, 1 = single-threaded)
+    double tail_seconds = 2.0; ///< Time rendered after the last tick (note releases, effect tails)
+};
+
+/**
+ * @brief Faster-than-real-time renderer used by audio export.
+ *
+ * prepareSequence() / prepareArrangement() build a private copy of everything the
+ * render needs: one FluidSynth instance per synthesizer used by the project (same
+ * SoundFont, loaded synchronously), copies of the master and per-synth DSP chains
+ * with their current parameters, and the complete note timeline converted to absolute
+ * sample positions through the tempo track. render() then produces the mix block by
+ * block as fast as the CPU allows: synthesizers and audio clips are independent jobs of
+ * a private NoteNagaRenderThreadPool and each synth render is split at the exact sample
+ * offset of its note events.
+ *
+ * The live engine is never touched: no manual mode, no muted audio worker, no shared
+ * synth or DSP state, so playback and monitoring keep working while an export runs.
+ * Project data (tracks, notes, clips) is only read during prepare, render() works on
+ * the snapshot. Master output volume and the metronome are monitoring controls and
+ * are not part of the render.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaOfflineRenderer {
+public:
+    /**
+     * @brief Construct the renderer.
+     * @param runtime_data Project runtime data (not owned).
+     * @param dsp_engine Live DSP engine, read once in prepare to copy the DSP chains (not owned, may be nullptr).
+     * @param settings Render settings.
+     */
+    NoteNagaOfflineRenderer(NoteNagaRuntimeData *runtime_data, NoteNagaDSPEngine *dsp_engine,
+                            const NN_OfflineRenderSettings_t &settings = NN_OfflineRenderSettings_t());
+    ~NoteNagaOfflineRenderer();
+
+    NoteNagaOfflineRenderer(const NoteNagaOfflineRenderer &) = delete;
+    NoteNagaOfflineRenderer &operator=(const NoteNagaOfflineRenderer &) = delete;
+
+    /**
+     * @brief Prepare rendering of one sequence (muted tracks and solo are respected).
+     * @param sequence Sequence to render.
+     * @return False if there is nothing to render.
+     */
+    bool prepareSequence(NoteNagaMidiSeq *sequence);
+
+    /**
+     * @brief Prepare rendering of the project arrangement (MIDI clips, audio clips,
+     * arrangement track volume/pan/mute/solo and clip fades).
+     * @return False if there is nothing to render.
+     */
+    bool prepareArrangement();
+
+    /**
+     * @brief Output sample rate.
+     * @return Sample rate in Hz.
+     */
+    int getSampleRate() const { return sample_rate_; }
+
+    /**
+     * @brief Length of the prepared render including the tail.
+     * @return Number of frames.
+     */
+    int64_t getTotalFrames() const { return total_frames_; }
+
+    /**
+     * @brief Number of frames rendered so far.
+     * @return Number of frames.
+     */
+    int64_t getRenderedFrames() const { return rendered_frames_; }
+
+    /**
+     * @brief Check whether the whole prepared range was rendered.
+     * @return True if finished.
+     */
+    bool isFinished() const { return rendered_frames_ >= total_frames_; }
+
+    /**
+     * @brief Render the next frames of the prepared range.
+     * @param output Interleaved stereo output buffer (2 * max_frames floats).
+     * @param max_frames Maximum number of frames to render.
+     * @return Number of frames written (0 when finished).
+     */
+    int64_t render(float *output, int64_t max_frames);
+
+private:
+    struct Voice;
+    struct ClipSource;
+
+    NoteNagaRuntimeData *runtime_data_;
+    NoteNagaDSPEngine *dsp_engine_;
+    NN_OfflineRenderSettings_t settings_;
+    int sample_rate_ = 44100;
+
+    std::unique_ptr<NoteNagaRenderThreadPool> pool_;
+    std::vector<std::unique_ptr<Voice>> voices_;        ///< One per synthesizer, summed in this order
+    std::vector<std::unique_ptr<ClipSource>> clips_;    ///< Audio clips of the arrangement
+    std::vector<std::unique_ptr<NoteNagaDSPBlockBase>> master_blocks_; ///< Copy of the master DSP chain
+
+    int64_t total_frames_ = 0;
+    int64_t rendered_frames_ = 0;
+
+    std::vector<float> mix_left_;
+    std::vector<float> mix_right_;
+
+    void reset();
+    Voice *addVoice(INoteNagaSoftSynth *synth);
+    void copyMasterChain();
+    void renderBlock(int64_t block_start, size_t num_frames);
+    void renderVoice(Voice &voice, int64_t block_start, size_t num_frames);
+    void renderClip(ClipSource &clip, int64_t block_start, size_t num_frames);
+};
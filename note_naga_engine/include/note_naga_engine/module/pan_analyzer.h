@@ -4,14 +4,17 @@
 #include <QObject>
 #endif
 
-#include <note_naga_engine/core/async_queue_component.h>
+#include <note_naga_engine/core/seqlock.h>
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/note_naga_api.h>
 
 #include <array>
-#include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <vector>
 
+class NoteNagaAnalysisBus;
+
 /**
  * @brief Number of angular segments for pan visualization (semicircle divided into segments)
  */
@@ -31,15 +34,16 @@ struct NOTE_NAGA_ENGINE_API NN_PanData_t {
  * @brief NoteNagaPanAnalyzer analyzes stereo audio to visualize pan/stereo field.
  * Uses a semicircle divided into segments to show where sound is coming from.
  * Efficient: only updates a few times per second.
+ *
+ * Consecutive blocks of buffer_size samples are read from the sample ring of
+ * NoteNagaAnalysisBus by the bus worker (process()); the result is published through a
+ * sequence lock, so getPanData() never blocks the analysis.
  */
 #ifndef QT_DEACTIVATED
-class NOTE_NAGA_ENGINE_API NoteNagaPanAnalyzer
-    : public QObject,
-      public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
+class NOTE_NAGA_ENGINE_API NoteNagaPanAnalyzer : public QObject {
     Q_OBJECT
 #else
-class NOTE_NAGA_ENGINE_API NoteNagaPanAnalyzer
-    : public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
+class NOTE_NAGA_ENGINE_API NoteNagaPanAnalyzer {
 #endif
 public:
     explicit NoteNagaPanAnalyzer(size_t buffer_size = 2048);
@@ -47,44 +51,36 @@ public:
     /**
      * @brief Enable or disable pan analysis.
      */
-    void setEnabled(bool enable) { enabled_ = enable; }
+    void setEnabled(bool enable) { enabled_.store(enable, std::memory_order_relaxed); }
     
     /**
      * @brief Check if pan analysis is enabled.
      */
-    bool isEnabled() const { return enabled_; }
-
-    /**
-     * @brief Push audio samples to left channel buffer.
-     */
-    void pushSamplesToLeftBuffer(float* samples, size_t num_samples);
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
 
     /**
-     * @brief Push audio samples to right channel buffer.
+     * @brief Analyze all complete blocks waiting in the bus sample ring
+     * (called by the analysis bus worker).
+     * @param bus Analysis bus providing the master mix.
      */
-    void pushSamplesToRightBuffer(float* samples, size_t num_samples);
+    void process(const NoteNagaAnalysisBus &bus);
 
     /**
-     * @brief Get the latest pan analysis data.
+     * @brief Get the latest pan analysis data (any thread).
      */
-    NN_PanData_t getPanData() {
-        std::lock_guard<std::mutex> lock(data_mutex_);
-        return pan_data_;
-    }
+    NN_PanData_t getPanData() const { return published_data_.load(); }
 
 private:
-    bool enabled_ = false;
+    std::atomic<bool> enabled_{false};
     size_t buffer_size_;
     
     std::vector<float> left_buffer_;
     std::vector<float> right_buffer_;
-    size_t left_pos_ = 0;
-    size_t right_pos_ = 0;
+    uint64_t read_pos_ = 0; ///< Ring position of the next block (bus worker)
     
-    mutable std::mutex data_mutex_;
-    NN_PanData_t pan_data_;
+    NN_PanData_t pan_data_; ///< Smoothed data, owned by the bus worker
+    NoteNagaSeqLock<NN_PanData_t> published_data_;
     
-    void onItem(const NN_AsyncTriggerMessage_t &message) override;
     void processBuffers();
 
 #ifndef QT_DEACTIVATED
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <note_naga_engine/core/arrangement_scheduler.h>
 #include <note_naga_engine/core/runtime_data.h>
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/note_naga_api.h>
@@ -7,6 +8,7 @@
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <thread>
 #include <vector>
@@ -59,6 +61,11 @@ public:
     explicit NoteNagaPlaybackWorker(NoteNagaRuntimeData *project,
                             double timer_interval_ms);
 
+    /**
+     * @brief Destroys the playback worker and the arrangement scheduler.
+     */
+    ~NoteNagaPlaybackWorker();
+
     /**
      * @brief Returns whether playback is currently running.
      * @return True if playing, false otherwise.
@@ -167,6 +174,7 @@ private:
     std::thread worker_thread;             ///< Thread running the playback logic
     PlaybackThreadWorker *worker{nullptr}; ///< Pointer to the thread worker
     std::atomic<bool> pending_cleanup{false}; ///< Flag: worker needs to be deleted in next play()
+    NoteNagaArrangementScheduler *arrangement_scheduler_{nullptr}; ///< Compiled arrangement events (kept between plays)
 
     // Callbacks
     // ////////////////////////////////////////////////////////////////////////////////
@@ -337,10 +345,17 @@ public:
      */
     void setExternalMidiRouter(ExternalMidiRouter* router) { external_midi_router_ = router; }
 
+    /**
+     * @brief Sets the arrangement event scheduler used in Arrangement mode.
+     * @param scheduler Pointer to the scheduler (not owned).
+     */
+    void setArrangementScheduler(NoteNagaArrangementScheduler *scheduler) { arrangement_scheduler_ = scheduler; }
+
 private:
     NoteNagaRuntimeData *project; ///< Pointer to project data (not owned)
     class NoteNagaDSPEngine* dsp_engine_ = nullptr; ///< DSP engine for audio sync
     ExternalMidiRouter* external_midi_router_ = nullptr; ///< External MIDI router (not owned)
+    NoteNagaArrangementScheduler *arrangement_scheduler_ = nullptr; ///< Arrangement event timeline (not owned)
 
     // Timing
     // ////////////////////////////////////////////////////////////////////////////////
@@ -354,6 +369,27 @@ private:
     bool looping; ///< Looping is enabled
     PlaybackMode playback_mode_; ///< Current playback mode (Sequence or Arrangement)
 
+    // Sample-accurate MIDI scheduling (audio clock driven)
+    // ////////////////////////////////////////////////////////////////////////////////
+
+    /// External MIDI note waiting for its audio clock time
+    struct PendingExternalNote {
+        int64_t sample_time;                  ///< Audio clock time
+        bool play;                            ///< Note on (true) or note off (false)
+        NN_Note_t note;
+        NoteNagaTrack *track;                 ///< Source track (Sequence mode routing)
+        NoteNagaArrangementTrack *arr_track;  ///< Arrangement track (Arrangement mode routing), may be nullptr
+    };
+
+    bool sample_accurate_ = false;   ///< Notes are queued on the DSP engine's audio clock
+    int64_t audio_clock_last_ = 0;   ///< Audio clock at the previous iteration
+    std::chrono::high_resolution_clock::time_point
+        audio_clock_changed_;        ///< Wall time of the last audio clock advance
+    int64_t schedule_anchor_sample_ = 0; ///< Audio clock time of schedule_anchor_tick_
+    double schedule_anchor_tick_ = 0.0;  ///< Exact playback position at the anchor
+    double samples_per_tick_ = 0.0;      ///< Samples per tick at the current tempo
+    std::deque<PendingExternalNote> pending_external_notes_; ///< External notes in time order
+
     // Callbacks
     // ////////////////////////////////////////////////////////////////////////////////
 
@@ -385,6 +421,77 @@ private:
      */
     void emitNotePlayed(const NN_Note_t &note);
 
+    /**
+     * @brief Select the MIDI scheduling mode for this run and reset the audio clock state.
+     */
+    void beginMidiScheduling();
+
+    /**
+     * @brief Time elapsed since the previous iteration. In sample-accurate mode this is
+     * measured on the audio clock (falls back to the wall clock if audio stops rendering).
+     * @param wall_elapsed_ms Elapsed wall clock time in milliseconds.
+     * @return Elapsed playback time in milliseconds.
+     */
+    double elapsedPlaybackMs(double wall_elapsed_ms);
+
+    /**
+     * @brief Bind the playback position to the current audio clock time.
+     * @param position_ticks Exact playback position (including the fractional tick).
+     * @param ms_per_tick Milliseconds per tick at the current tempo.
+     */
+    void anchorSchedule(double position_ticks, double ms_per_tick);
+
+    /**
+     * @brief Last tick whose notes should be dispatched in this iteration
+     * (current tick plus the scheduling lookahead in sample-accurate mode).
+     * @param current_tick Current playback tick.
+     * @param ms_per_tick Milliseconds per tick at the current tempo.
+     * @return Last tick to dispatch (inclusive).
+     */
+    int scheduleWindowEnd(int current_tick, double ms_per_tick) const;
+
+    /**
+     * @brief Play a note at a tick: queued on the audio clock in sample-accurate mode, immediately otherwise.
+     * @param track Source MIDI track.
+     * @param note Note to play.
+     * @param tick Tick of the note on.
+     * @param arr_track Arrangement track for external MIDI routing (nullptr in Sequence mode).
+     */
+    void routePlayNote(NoteNagaTrack *track, const NN_Note_t &note, int tick, NoteNagaArrangementTrack *arr_track);
+
+    /**
+     * @brief Stop a note at a tick: queued on the audio clock in sample-accurate mode, immediately otherwise.
+     * @param track Source MIDI track.
+     * @param note Note to stop.
+     * @param tick Tick of the note off.
+     * @param arr_track Arrangement track for external MIDI routing (nullptr in Sequence mode).
+     */
+    void routeStopNote(NoteNagaTrack *track, const NN_Note_t &note, int tick, NoteNagaArrangementTrack *arr_track);
+
+    /**
+     * @brief Stop all notes of a track at a tick (or in the next audio block if tick < 0).
+     * @param track MIDI track.
+     * @param tick Tick of the stop, -1 = as soon as possible.
+     */
+    void routeStopAllNotes(NoteNagaTrack *track, int tick = -1);
+
+    /**
+     * @brief Drop queued notes which were not played yet (seek, loop, stop). Pending external
+     * note offs are sent right away so no external note hangs.
+     */
+    void flushScheduledNotes();
+
+    /**
+     * @brief Add an external MIDI note to the pending list (kept sorted by time).
+     * @param pending Note to send when the audio clock reaches its time.
+     */
+    void queueExternalNote(const PendingExternalNote &pending);
+
+    /**
+     * @brief Send external MIDI notes whose audio clock time has been reached.
+     */
+    void firePendingExternalNotes();
+
     /**
      * @brief Run playback in Sequence mode (single MIDI sequence).
      */
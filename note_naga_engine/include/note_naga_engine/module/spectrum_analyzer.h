@@ -4,96 +4,129 @@
 #include <QObject>
 #endif
 
-#include <note_naga_engine/core/async_queue_component.h>
+#include <note_naga_engine/audio/real_fft.h>
+#include <note_naga_engine/core/triple_buffer.h>
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/note_naga_api.h>
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class NoteNagaAnalysisBus;
+
 /** Channel mode for spectrum analysis */
 enum class NOTE_NAGA_ENGINE_API ChannelMode { Left, Right, Merged };
 
 /**
  * @brief NoteNagaSpectrumAnalyzer is a component for analyzing audio spectrum.
- * It processes audio samples and computes the frequency spectrum using FFT.
- * It uses an asynchronous queue to handle incoming audio data.
+ *
+ * The analyzer reads the master mix from the sample ring of NoteNagaAnalysisBus and is run
+ * by the bus worker (process()). Each run takes the newest complete frame on the hop grid,
+ * so frames overlap (75% by default) and the display updates every fft_size * (1 - overlap)
+ * samples at any FFT size. Frames that fall behind are skipped, only the latest one is shown.
+ *
+ * The spectrum is computed by a planned real-input FFT (NoteNagaRealFFT) with a
+ * precomputed window; no memory is allocated per frame. The FFT size can be changed at
+ * runtime, the plan is rebuilt by the bus worker. The result goes to the GUI through a
+ * triple buffer, neither side waits for the other.
  */
 #ifndef QT_DEACTIVATED
-class NOTE_NAGA_ENGINE_API NoteNagaSpectrumAnalyzer
-    : public QObject,
-      public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
+class NOTE_NAGA_ENGINE_API NoteNagaSpectrumAnalyzer : public QObject {
     Q_OBJECT
 #else
-class NOTE_NAGA_ENGINE_API NoteNagaSpectrumAnalyzer
-    : public AsyncQueueComponent<NN_AsyncTriggerMessage_t, 16> {
+class NOTE_NAGA_ENGINE_API NoteNagaSpectrumAnalyzer {
 #endif
 public:
+    static constexpr size_t kMinFFTSize = 64;    ///< Smallest supported FFT size
+    static constexpr size_t kMaxFFTSize = 16384; ///< Largest supported FFT size
+
     explicit NoteNagaSpectrumAnalyzer(size_t fft_size, ChannelMode mode = ChannelMode::Merged);
 
     /**
      * @brief Enable or disable spectrum analysis.
      * @param enable True to enable, false to disable.
      */
-    void setEnableSpectrumAnalysis(bool enable) {
-        this->enable_ = enable;
-    }    
-    
+    void setEnableSpectrumAnalysis(bool enable) { enable_.store(enable, std::memory_order_relaxed); }
+
     /**
      * @brief Check if spectrum analysis is enabled.
      * @return True if enabled, false otherwise.
      */
-    bool isEnabled() const { return enable_; }
+    bool isEnabled() const { return enable_.load(std::memory_order_relaxed); }
 
     /**
-     * @brief Push audio samples to the analyzer.
-     * @param samples Pointer to the audio samples buffer.
-     * @param num_samples Number of samples in the buffer.
+     * @brief Analyze the newest frame of the bus sample ring if a new hop is complete
+     * (called by the analysis bus worker).
+     * @param bus Analysis bus providing the master mix.
      */
-    void pushSamplesToLeftBuffer(float* samples, size_t num_samples);
+    void process(const NoteNagaAnalysisBus &bus);
 
     /**
-     * @brief Push audio samples to the analyzer.
-     * @param samples Pointer to the audio samples buffer.
-     * @param num_samples Number of samples in the buffer.
+     * @brief Set the FFT size (rounded up to a power of two, clamped to kMinFFTSize..kMaxFFTSize).
+     * @param fft_size New FFT size.
      */
-    void pushSamplesToRightBuffer(float* samples, size_t num_samples);
+    void setFFTSize(size_t fft_size);
+
+    /**
+     * @brief Get the FFT size.
+     * @return FFT size in samples.
+     */
+    size_t getFFTSize() const { return fft_size_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Set the overlap of consecutive analysis frames.
+     * @param overlap Overlap ratio (0 = no overlap, 0.75 = new frame every quarter FFT size), clamped to 0..0.9375.
+     */
+    void setOverlap(float overlap);
+
+    /**
+     * @brief Get the overlap of consecutive analysis frames.
+     * @return Overlap ratio.
+     */
+    float getOverlap() const { return overlap_.load(std::memory_order_relaxed); }
 
     /**
      * @brief Set the channel mode for spectrum analysis.
      * @param mode The channel mode to set (Left, Right, Merged).
      */
-    void setChannelMode(ChannelMode mode) { channel_mode_ = mode; }
+    void setChannelMode(ChannelMode mode) { channel_mode_.store(mode, std::memory_order_relaxed); }
 
     /**
      * @brief Get the current channel mode.
      * @return The current channel mode (Left, Right, Merged).
      */
-    ChannelMode getChannelMode() const { return channel_mode_; }
+    ChannelMode getChannelMode() const { return channel_mode_.load(std::memory_order_relaxed); }
 
     /**
-     * @brief Get the current frequency spectrum.
-     * @return Vector of float values representing the frequency spectrum.
+     * @brief Get the current frequency spectrum (single reader thread, normally the GUI thread).
+     * @return Vector of float values representing the frequency spectrum (fft_size / 2 bins).
      */
     std::vector<float> getSpectrum() {
-        std::lock_guard<std::mutex> lock(this->spectrum_mutex_);
-        return spectrum_;
+        spectrum_.update();
+        return spectrum_.readBuffer();
     }
 
 private:
-    bool enable_; /// Enable/disable spectrum analysis
-    size_t fft_size_;        /// Required FFT size for the spectrum analysis
-
-    // Buffers for audio samples
-    std::vector<float> samples_buffer_left_;
-    std::vector<float> samples_buffer_right_;
-    size_t fft_current_pos_left_;
-    size_t fft_current_pos_right_;
-    ChannelMode channel_mode_;
-
-    mutable std::mutex spectrum_mutex_; // Mutex for thread-safe access to spectrum data
-    std::vector<float> spectrum_;       // Frequency spectrum data
-
-    void onItem(const NN_AsyncTriggerMessage_t &message) override;
-
-    void processSampleBuffer();
+    std::atomic<bool> enable_;              ///< Enable/disable spectrum analysis
+    std::atomic<size_t> fft_size_;          ///< Requested FFT size
+    std::atomic<float> overlap_;            ///< Requested frame overlap
+    std::atomic<ChannelMode> channel_mode_; ///< Analyzed channel(s)
+
+    // Analysis state, owned by the analysis bus worker
+    std::unique_ptr<NoteNagaRealFFT> fft_;
+    std::vector<float> window_;      ///< Hann window of the current size
+    std::vector<float> frame_;       ///< Windowed frame
+    std::vector<float> frame_right_; ///< Right channel of the frame while it is read
+    std::vector<float> magnitudes_;  ///< Normalized magnitudes of the last frame
+    uint64_t next_frame_pos_ = 0;    ///< Ring position of the next frame on the hop grid
+
+    NoteNagaTripleBuffer<std::vector<float>> spectrum_; ///< Frequency spectrum handed to the GUI
+
+    static size_t hopSize(size_t fft_size, float overlap);
+    void preparePlan(size_t fft_size);
+    bool readFrame(const NoteNagaAnalysisBus &bus, uint64_t start);
 
 #ifndef QT_DEACTIVATED
 Q_SIGNALS:
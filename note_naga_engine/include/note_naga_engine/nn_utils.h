@@ -171,7 +171,8 @@ public:
 
 private:
     /**
-     * @brief Pomocná funkce pro aktualizaci not ve stopě po změně.
+     * @brief Pomocná funkce pro aktualizaci not ve stopě po změně (noty se párují podle ID,
+     *        jedna dávková změna NN_NoteChangeSet_t na stopu).
      * @param selectedNotes Vektor vybraných not.
      */
     static void applySelectedNotesToTracks(const std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selectedNotes);
@@ -11,6 +11,7 @@
 #include <note_naga_engine/module/playback_worker.h>
 #include <note_naga_engine/module/spectrum_analyzer.h>
 #include <note_naga_engine/module/pan_analyzer.h>
+#include <note_naga_engine/module/analysis_bus.h>
 #include <note_naga_engine/module/metronome.h>
 #include <note_naga_engine/module/external_midi_router.h>
 
@@ -174,6 +175,37 @@ public:
      */
     std::pair<float, float> getCurrentVolumeDb();
 
+    /*******************************************************************************************************/
+    // Audio Settings
+    /*******************************************************************************************************/
+
+    /**
+     * @brief Sets the number of threads rendering synthesizers in parallel. The value is stored
+     * in the application settings and applied again by initialize().
+     * @param num_threads Rendering threads (0 = automatic, 1 = single-threaded).
+     */
+    void setRenderThreadCount(int num_threads);
+
+    /**
+     * @brief Gets the configured number of rendering threads.
+     * @return Configured value (0 = automatic, 1 = single-threaded).
+     */
+    int getRenderThreadCount() const { return this->render_threads; }
+
+    /**
+     * @brief Enables sample-accurate MIDI scheduling on the audio clock (enabled by default).
+     * Playback falls back to timer-driven scheduling when the audio clock stalls. The value is
+     * stored in the application settings and takes effect when playback starts.
+     * @param enable True to schedule notes on the audio clock.
+     */
+    void setSampleAccurateMidi(bool enable);
+
+    /**
+     * @brief Checks if sample-accurate MIDI scheduling is enabled.
+     * @return True if notes are scheduled on the audio clock.
+     */
+    bool isSampleAccurateMidi() const { return this->sample_accurate_midi; }
+
     /*******************************************************************************************************/
     // Getters for main components
     /*******************************************************************************************************/
@@ -220,6 +252,12 @@ public:
      */
     NoteNagaPanAnalyzer *getPanAnalyzer() { return this->pan_analyzer; }
 
+    /**
+     * @brief Gets the analysis bus instance.
+     * @return Pointer to the NoteNagaAnalysisBus.
+     */
+    NoteNagaAnalysisBus *getAnalysisBus() { return this->analysis_bus; }
+
     /**
      * @brief Gets the external MIDI router instance.
      * @return Pointer to the ExternalMidiRouter.
@@ -252,6 +290,15 @@ protected:
     NoteNagaAudioWorker *audio_worker;               ///< Pointer to the audio worker instance
     NoteNagaSpectrumAnalyzer *spectrum_analyzer;     ///< Pointer to the spectrum analyzer instance
     NoteNagaPanAnalyzer *pan_analyzer;               ///< Pointer to the pan analyzer instance
+    NoteNagaAnalysisBus *analysis_bus;               ///< Pointer to the analysis bus (runs the analyzers)
     NoteNagaMetronome *metronome;                    ///< Pointer to the metronome instance
     ExternalMidiRouter *external_midi_router;        ///< Pointer to the external MIDI router instance
+
+    int render_threads = 0;                          ///< Configured rendering threads (0 = automatic)
+    bool sample_accurate_midi = true;                ///< Schedule MIDI on the audio clock
+
+    /**
+     * @brief Loads the stored audio settings and applies them to the DSP engine.
+     */
+    void loadAudioSettings();
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <note_naga_engine/note_naga_api.h>
+#include <fluidsynth.h>
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief A SoundFont file read once and shared by any number of FluidSynth instances.
+ *
+ * The pool keeps the file image in memory. Every synthesizer loads its own fluid_sfont_t
+ * from that image through a custom SoundFont loader, so FluidSynth state (SoundFont ID,
+ * sample reference counts) is never shared between synths rendering on different threads.
+ * Samples are loaded on demand, a synth only copies the samples of the presets selected on
+ * its channels. Instances are created by NoteNagaSoundFontPool and released when the last
+ * user drops its shared pointer.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaSharedSoundFont {
+public:
+    ~NoteNagaSharedSoundFont();
+
+    NoteNagaSharedSoundFont(const NoteNagaSharedSoundFont &) = delete;
+    NoteNagaSharedSoundFont &operator=(const NoteNagaSharedSoundFont &) = delete;
+
+    /**
+     * @brief Path the SoundFont was loaded from (pool key).
+     */
+    const std::string &getPath() const { return path_; }
+
+    /**
+     * @brief Contents of the SoundFont file.
+     */
+    const std::vector<char> &getData() const { return data_; }
+
+    /**
+     * @brief Load the SoundFont into a synthesizer from the shared file image. Call it once
+     * per synth; the synth owns the loaded SoundFont and frees it when it is deleted. The
+     * caller must keep this object alive as long as the synth, samples are read on demand.
+     * Enables dynamic sample loading in the synth's settings.
+     * @param synth Target FluidSynth instance.
+     * @return SoundFont ID inside the target synth, or -1 on failure.
+     */
+    int attach(fluid_synth_t *synth) const;
+
+private:
+    friend class NoteNagaSoundFontPool;
+    NoteNagaSharedSoundFont() = default;
+
+    std::string path_;
+    std::vector<char> data_; ///< File image, immutable after the load
+};
+
+/**
+ * @brief Process-wide pool of loaded SoundFonts, keyed by canonical file path.
+ *
+ * acquire() returns the already loaded SoundFont when another synthesizer holds it,
+ * otherwise loads it. Concurrent requests for a file that is being loaded wait for
+ * that load instead of starting another one, so tracks created together with async
+ * loading still read the file once.
+ */
+class NOTE_NAGA_ENGINE_API NoteNagaSoundFontPool {
+public:
+    /**
+     * @brief Get the pool instance.
+     */
+    static NoteNagaSoundFontPool &instance();
+
+    /**
+     * @brief Get a SoundFont, loading it if it is not in the pool. May block for the
+     * duration of the load, call it from a loading thread when that matters.
+     * @param path Path to the .sf2/.sf3 file.
+     * @return Shared SoundFont, nullptr if the file could not be loaded.
+     */
+    std::shared_ptr<NoteNagaSharedSoundFont> acquire(const std::string &path);
+
+    /**
+     * @brief Get a SoundFont that is already loaded, never loads.
+     * @param path Pool key (NoteNagaSharedSoundFont::getPath()).
+     * @return Shared SoundFont, nullptr if it is not in the pool.
+     */
+    std::shared_ptr<NoteNagaSharedSoundFont> find(const std::string &path);
+
+    /**
+     * @brief Number of SoundFonts currently loaded.
+     */
+    size_t getLoadedCount();
+
+private:
+    NoteNagaSoundFontPool() = default;
+
+    struct Entry {
+        std::weak_ptr<NoteNagaSharedSoundFont> font;                        ///< Loaded SoundFont
+        std::shared_future<std::shared_ptr<NoteNagaSharedSoundFont>> loading; ///< Load in progress
+    };
+
+    std::mutex mutex_;
+    std::map<std::string, Entry> entries_;
+
+    static std::shared_ptr<NoteNagaSharedSoundFont> load(const std::string &path);
+};
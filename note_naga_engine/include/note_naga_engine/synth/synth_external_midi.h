@@ -71,6 +71,14 @@ protected:
      */
     void sendProgramChange(int channel, int program);
 
+    /**
+     * @brief Send MIDI Note Off message
+     * @param channel MIDI channel (0-15)
+     * @param pitch Note number (0-127)
+     * @return True if the message was sent
+     */
+    bool sendNoteOff(int channel, int pitch);
+
 private:
     // Mutex for thread-safe access to the synthesizer
     std::mutex synth_mutex_;
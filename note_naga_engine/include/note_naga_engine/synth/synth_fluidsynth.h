@@ -2,8 +2,10 @@
 
 #include <note_naga_engine/core/note_naga_synthesizer.h>
 #include <note_naga_engine/core/types.h>
+#include <note_naga_engine/synth/soundfont_pool.h>
 #include <fluidsynth.h>
 #include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
@@ -13,6 +15,8 @@ class DSPEngine;
 
 /**
  * FluidSynth syntetizér pro NoteNagaEngine.
+ * SoundFonty se načítají přes NoteNagaSoundFontPool: soubor se z disku čte jen jednou a každý
+ * syntetizér si z jeho obrazu v paměti nahraje jen samply předvoleb, které právě používá.
  */
 class NoteNagaSynthFluidSynth : public NoteNagaSynthesizer, public INoteNagaSoftSynth {
 public:
@@ -29,6 +33,7 @@ public:
     virtual void stopNote(const NN_Note_t &note) override;
     virtual void stopAllNotes(NoteNagaMidiSeq *seq = nullptr, NoteNagaTrack *track = nullptr) override;
     virtual void renderAudio(float* left, float* right, size_t num_frames) override;
+    virtual bool hasActiveVoices() const override;
     virtual void setMasterPan(float pan) override;
 
     virtual std::string getConfig(const std::string &key) const override;
@@ -91,6 +96,9 @@ protected:
     fluid_settings_t *synth_settings_;
     fluid_synth_t *fluidsynth_;
 
+    // SoundFont shared through the pool (attached to fluidsynth_)
+    std::shared_ptr<NoteNagaSharedSoundFont> soundfont_;
+
     // Store the current SoundFont path
     std::string sf2_path_;
     
@@ -104,6 +112,11 @@ protected:
     std::function<void(bool)> load_completed_callback_;
 
     void ensureFluidsynth();
+
+    /**
+     * @brief Detach the shared SoundFont and delete the FluidSynth instance.
+     */
+    void releaseFluidsynth();
     
     /**
      * @brief Internal method to load SoundFont (can be called from background thread)
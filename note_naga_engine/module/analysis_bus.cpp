@@ -0,0 +1,238 @@
+#include <note_naga_engine/module/analysis_bus.h>
+
+#include <note_naga_engine/audio/mix_kernels.h>
+#include <note_naga_engine/module/pan_analyzer.h>
+#include <note_naga_engine/module/spectrum_analyzer.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+float toDb(float amplitude) { return amplitude > 0.000001f ? 20.0f * std::log10(amplitude) : -100.0f; }
+
+float rmsDb(float sum_sq, uint32_t frames) {
+    return frames > 0 ? toDb(std::sqrt(sum_sq / float(frames))) : -100.0f;
+}
+
+} // namespace
+
+NoteNagaAnalysisBus::NoteNagaAnalysisBus(NoteNagaSpectrumAnalyzer *spectrum_analyzer, NoteNagaPanAnalyzer *pan_analyzer)
+    : spectrum_analyzer_(spectrum_analyzer), pan_analyzer_(pan_analyzer),
+      ring_left_(kSampleRingSize, 0.0f), ring_right_(kSampleRingSize, 0.0f),
+      level_ring_(kLevelRingSize), chunk_left_(kChunkFrames, 0.0f), chunk_right_(kChunkFrames, 0.0f) {
+    sources_.reserve(64);
+
+    // Windowed sinc interpolators for the positions between two samples (phase p at p / 4),
+    // phase 0 is the sample itself and stays unused
+    const double center = double(kTruePeakTaps / 2);
+    for (size_t p = 0; p < kTruePeakPhases; ++p) {
+        double sum = 0.0;
+        std::array<double, kTruePeakTaps> taps{};
+        for (size_t k = 0; k < kTruePeakTaps; ++k) {
+            double t = center - double(k) - double(p) / double(kTruePeakPhases);
+            double sinc = t == 0.0 ? 1.0 : std::sin(M_PI * t) / (M_PI * t);
+            double window = std::fabs(t) < center ? 0.5 * (1.0 + std::cos(M_PI * t / center)) : 0.0;
+            taps[k] = sinc * window;
+            sum += taps[k];
+        }
+        for (size_t k = 0; k < kTruePeakTaps; ++k) true_peak_fir_[p][k] = float(taps[k] / sum);
+    }
+}
+
+NoteNagaAnalysisBus::~NoteNagaAnalysisBus() {
+    // The worker uses members of this class, stop it before they are destroyed
+    killThread();
+}
+
+/*******************************************************************************************************/
+// Render thread
+/*******************************************************************************************************/
+
+NN_BlockLevels_t NoteNagaAnalysisBus::measure(const float *left, const float *right, size_t num_frames) {
+    NN_BlockLevels_t levels;
+    nn_sum_squares_peak(left, num_frames, levels.sum_sq_left, levels.peak_left);
+    nn_sum_squares_peak(right, num_frames, levels.sum_sq_right, levels.peak_right);
+    levels.frames = static_cast<uint32_t>(num_frames);
+    return levels;
+}
+
+void NoteNagaAnalysisBus::publishLevels(const void *source, const NN_BlockLevels_t &levels) {
+    uint64_t pos = level_write_pos_.load(std::memory_order_relaxed);
+    LevelRecord &record = level_ring_[pos & (kLevelRingSize - 1)];
+    record.source = source;
+    record.levels = levels;
+    level_write_pos_.store(pos + 1, std::memory_order_release);
+}
+
+void NoteNagaAnalysisBus::publishMaster(const float *left, const float *right, size_t num_frames) {
+    if (num_frames == 0) return;
+
+    uint64_t pos = sample_write_pos_.load(std::memory_order_relaxed);
+    // Only the newest kSampleRingSize frames can be kept
+    if (num_frames > kSampleRingSize) {
+        pos += num_frames - kSampleRingSize;
+        left += num_frames - kSampleRingSize;
+        right += num_frames - kSampleRingSize;
+        num_frames = kSampleRingSize;
+    }
+
+    // Announce the range before overwriting it, readers that copied from it see the new end
+    sample_write_end_.store(pos + num_frames, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    size_t offset = static_cast<size_t>(pos & (kSampleRingSize - 1));
+    size_t first = std::min(num_frames, kSampleRingSize - offset);
+    std::copy(left, left + first, ring_left_.begin() + offset);
+    std::copy(right, right + first, ring_right_.begin() + offset);
+    std::copy(left + first, left + num_frames, ring_left_.begin());
+    std::copy(right + first, right + num_frames, ring_right_.begin());
+    pos += num_frames;
+    sample_write_pos_.store(pos, std::memory_order_release);
+
+    if (pos - trigger_pos_ >= kTriggerInterval) {
+        trigger_pos_ = pos;
+        this->pushToQueue(NN_AsyncTriggerMessage_t{});
+    }
+}
+
+/*******************************************************************************************************/
+// Sample ring readers
+/*******************************************************************************************************/
+
+bool NoteNagaAnalysisBus::readSamples(uint64_t start, size_t num_frames, float *left, float *right) const {
+    if (num_frames > kSampleRingSize) return false;
+    size_t offset = static_cast<size_t>(start & (kSampleRingSize - 1));
+    size_t first = std::min(num_frames, kSampleRingSize - offset);
+    std::copy(ring_left_.begin() + offset, ring_left_.begin() + offset + first, left);
+    std::copy(ring_right_.begin() + offset, ring_right_.begin() + offset + first, right);
+    std::copy(ring_left_.begin(), ring_left_.begin() + (num_frames - first), left + first);
+    std::copy(ring_right_.begin(), ring_right_.begin() + (num_frames - first), right + first);
+    // The range is valid if the writer did not wrap over it while it was copied, the block
+    // still being copied counts as written
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sample_write_end_.load(std::memory_order_relaxed) - start <= kSampleRingSize;
+}
+
+/*******************************************************************************************************/
+// Results
+/*******************************************************************************************************/
+
+std::pair<float, float> NoteNagaAnalysisBus::getSourceLevelDb(const void *source) const {
+    source_levels_.update();
+    const std::vector<NN_SourceLevel_t> &levels = source_levels_.readBuffer();
+    auto it = std::lower_bound(levels.begin(), levels.end(), source,
+                               [](const NN_SourceLevel_t &level, const void *key) { return level.source < key; });
+    if (it != levels.end() && it->source == source) return {it->rms_left, it->rms_right};
+    return {-100.0f, -100.0f};
+}
+
+/*******************************************************************************************************/
+// Worker
+/*******************************************************************************************************/
+
+void NoteNagaAnalysisBus::onItem(const NN_AsyncTriggerMessage_t &) {
+    const uint64_t previous_cursor = master_cursor_;
+    processMaster();
+    processSourceLevels(master_cursor_ - previous_cursor);
+    if (spectrum_analyzer_) spectrum_analyzer_->process(*this);
+    if (pan_analyzer_) pan_analyzer_->process(*this);
+}
+
+float NoteNagaAnalysisBus::truePeak(float sample, std::array<float, kTruePeakTaps> &history) const {
+    std::copy_backward(history.begin(), history.end() - 1, history.end());
+    history[0] = sample;
+
+    float peak = 0.0f;
+    for (size_t p = 1; p < kTruePeakPhases; ++p) {
+        const std::array<float, kTruePeakTaps> &fir = true_peak_fir_[p];
+        float value = 0.0f;
+        for (size_t k = 0; k < kTruePeakTaps; ++k) value += fir[k] * history[k];
+        peak = std::max(peak, std::fabs(value));
+    }
+    return peak;
+}
+
+void NoteNagaAnalysisBus::processMaster() {
+    const uint64_t written = getSampleWritePosition();
+    // Far behind the writer: continue with the oldest part of the ring that is still safe
+    if (written - master_cursor_ > kSampleRingSize - kChunkFrames) {
+        master_cursor_ = written - (kSampleRingSize - kChunkFrames);
+    }
+    if (written == master_cursor_) return;
+
+    NN_BlockLevels_t levels;
+    float true_peak_left = 0.0f;
+    float true_peak_right = 0.0f;
+    while (master_cursor_ < written) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(kChunkFrames, written - master_cursor_));
+        if (readSamples(master_cursor_, count, chunk_left_.data(), chunk_right_.data())) {
+            for (size_t i = 0; i < count; ++i) {
+                levels.add(chunk_left_[i], chunk_right_[i]);
+                true_peak_left = std::max(true_peak_left, truePeak(chunk_left_[i], history_left_));
+                true_peak_right = std::max(true_peak_right, truePeak(chunk_right_[i], history_right_));
+            }
+            levels.frames += static_cast<uint32_t>(count);
+        }
+        master_cursor_ += count;
+    }
+    if (levels.frames == 0) return;
+
+    NN_MasterLevels_t master;
+    master.rms_left = rmsDb(levels.sum_sq_left, levels.frames);
+    master.rms_right = rmsDb(levels.sum_sq_right, levels.frames);
+    master.peak_left = toDb(levels.peak_left);
+    master.peak_right = toDb(levels.peak_right);
+    master.true_peak_left = toDb(std::max(levels.peak_left, true_peak_left));
+    master.true_peak_right = toDb(std::max(levels.peak_right, true_peak_right));
+    master_levels_.store(master);
+}
+
+void NoteNagaAnalysisBus::processSourceLevels(uint64_t elapsed_frames) {
+    const uint64_t written = level_write_pos_.load(std::memory_order_acquire);
+    if (reset_levels_.exchange(false, std::memory_order_acq_rel)) {
+        sources_.clear();
+        level_cursor_ = written;
+    }
+    if (written - level_cursor_ > kLevelRingSize) level_cursor_ = written - kLevelRingSize;
+
+    for (; level_cursor_ < written; ++level_cursor_) {
+        LevelRecord record = level_ring_[level_cursor_ & (kLevelRingSize - 1)];
+        // At exactly kLevelRingSize ahead the writer may be filling this slot right now
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (level_write_pos_.load(std::memory_order_relaxed) - level_cursor_ >= kLevelRingSize) continue;
+
+        auto it = std::lower_bound(sources_.begin(), sources_.end(), record.source,
+                                   [](const SourceState &state, const void *key) { return state.source < key; });
+        if (it == sources_.end() || it->source != record.source) {
+            it = sources_.insert(it, SourceState{});
+            it->source = record.source;
+        }
+        it->pending.merge(record.levels);
+    }
+
+    // Fresh summaries replace the level, sources without any fall until they reach silence
+    const float decay = float(elapsed_frames) * kDecayDbPerSample;
+    for (SourceState &state : sources_) {
+        if (state.pending.frames > 0) {
+            state.rms_left = rmsDb(state.pending.sum_sq_left, state.pending.frames);
+            state.rms_right = rmsDb(state.pending.sum_sq_right, state.pending.frames);
+        } else {
+            state.rms_left = std::max(-100.0f, state.rms_left - decay);
+            state.rms_right = std::max(-100.0f, state.rms_right - decay);
+        }
+        state.pending = NN_BlockLevels_t{};
+    }
+    sources_.erase(std::remove_if(sources_.begin(), sources_.end(),
+                                  [](const SourceState &state) {
+                                      return state.rms_left <= -100.0f && state.rms_right <= -100.0f;
+                                  }),
+                   sources_.end());
+
+    std::vector<NN_SourceLevel_t> &out = source_levels_.writeBuffer();
+    out.clear();
+    for (const SourceState &state : sources_) {
+        out.push_back(NN_SourceLevel_t{state.source, state.rms_left, state.rms_right});
+    }
+    source_levels_.publish();
+}
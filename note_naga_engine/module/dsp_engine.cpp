@@ -1,410 +1,744 @@
 #include <note_naga_engine/module/dsp_engine.h>
 
 #include <note_naga_engine/core/types.h>
+#include <note_naga_engine/audio/mix_kernels.h>
 
 #include <cmath>
 #include <algorithm>
 #include <cstring>
-#include <set>
 #include <map>
+#include <thread>
 
-NoteNagaDSPEngine::NoteNagaDSPEngine(NoteNagaMetronome* metronome, NoteNagaSpectrumAnalyzer * spectrum_analyzer, NoteNagaPanAnalyzer* pan_analyzer) {
+NoteNagaDSPEngine::NoteNagaDSPEngine(NoteNagaMetronome* metronome, NoteNagaAnalysisBus* analysis_bus) {
     this->metronome_ = metronome;
-    this->spectrum_analyzer_ = spectrum_analyzer;
-    this->pan_analyzer_ = pan_analyzer;
-    this->enable_dsp_ = true;
+    this->analysis_bus_ = analysis_bus;
+    this->enable_dsp_.store(true, std::memory_order_relaxed);
+    this->render_graph_.store(new NN_DSPRenderGraph_t(), std::memory_order_release);
+    this->render_pool_.store(new NoteNagaRenderThreadPool(0), std::memory_order_release);
+    this->midi_queue_ = std::make_unique<LockFreeSPSCQueue<NN_ScheduledMidiEvent_t, kMidiQueueSize>>();
+    this->block_midi_events_.reserve(kMaxBlockMidiEvents);
+    this->block_midi_offsets_.reserve(kMaxBlockMidiEvents);
+    this->block_midi_jobs_.reserve(kMaxBlockMidiEvents);
+    this->job_lane_events_.reserve(kMaxBlockMidiEvents);
+    this->node_states_.reserve(128);
     NOTE_NAGA_LOG_INFO("DSP Engine initialized");
 }
 
-void NoteNagaDSPEngine::render(float *output, size_t num_frames, bool compute_rms) {
+NoteNagaDSPEngine::~NoteNagaDSPEngine() {
+    // Audio worker is destroyed before the DSP engine, nobody renders anymore
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    for (auto &retired : retired_graphs_) {
+        delete retired.first;
+    }
+    retired_graphs_.clear();
+    delete render_graph_.exchange(nullptr, std::memory_order_acq_rel);
+    for (auto &retired : retired_plans_) {
+        delete retired.first;
+    }
+    retired_plans_.clear();
+    for (auto &retired : retired_tempo_maps_) {
+        delete retired.first;
+    }
+    retired_tempo_maps_.clear();
+    delete arrangement_tempo_map_.exchange(nullptr, std::memory_order_acq_rel);
+    delete render_pool_.exchange(nullptr, std::memory_order_acq_rel);
+    delete arrangement_plan_.exchange(nullptr, std::memory_order_acq_rel);
+}
+
+void NoteNagaDSPEngine::render(float *output, size_t num_frames, bool analyze) {
     // Prepare mix buffers
     if (mix_left_.size() < num_frames) mix_left_.resize(num_frames, 0.0f);
     if (mix_right_.size() < num_frames) mix_right_.resize(num_frames, 0.0f);
     if (temp_left_.size() < num_frames) temp_left_.resize(num_frames, 0.0f);
     if (temp_right_.size() < num_frames) temp_right_.resize(num_frames, 0.0f);
-    if (track_left_.size() < num_frames) track_left_.resize(num_frames, 0.0f);
-    if (track_right_.size() < num_frames) track_right_.resize(num_frames, 0.0f);
     
     std::fill(mix_left_.begin(), mix_left_.begin() + num_frames, 0.0f);
     std::fill(mix_right_.begin(), mix_right_.begin() + num_frames, 0.0f);
 
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    // Enter render epoch (odd = rendering) BEFORE loading the graph, writers use
+    // the epoch to decide when a retired snapshot can be freed
+    render_epoch_.fetch_add(1, std::memory_order_seq_cst);
+    const NN_DSPRenderGraph_t *graph = render_graph_.load(std::memory_order_seq_cst);
+    const bool dsp_enabled = enable_dsp_.load(std::memory_order_relaxed);
+    NoteNagaRenderThreadPool *pool = render_pool_.load(std::memory_order_seq_cst);
+
+    // Deferred block reset requested by resetAllBlocks()
+    if (reset_blocks_pending_.exchange(false, std::memory_order_acq_rel)) {
+        resetGraphBlocks(graph);
+    }
+    // Deferred sample rate change requested by setSampleRate()
+    if (sample_rate_pending_.exchange(false, std::memory_order_acq_rel)) {
+        applyGraphSampleRate(graph);
+    }
+
+    // Scheduled MIDI events due in this block (applied by the render jobs at their offsets)
+    const int64_t block_start = rendered_sample_time_.load(std::memory_order_relaxed);
+    collectBlockMidiEvents(block_start, num_frames);
     
     // Render audio from tracks based on playback mode
     if (runtime_data_) {
         if (playback_mode_ == PlaybackMode::Arrangement) {
             // In Arrangement mode, render based on arrangement tracks
             // Each arrangement track has its own volume/pan settings
-            renderArrangementTracks(num_frames);
+            renderArrangementTracks(graph, pool, dsp_enabled, num_frames);
         } else {
             // In Sequence mode, only render the active sequence
             NoteNagaMidiSeq* activeSeq = runtime_data_->getActiveSequence();
             if (activeSeq) {
+                render_jobs_.clear();
                 for (NoteNagaTrack* track : activeSeq->getTracks()) {
                     if (!track || track->isMuted() || track->isTempoTrack()) continue;
                     
                     INoteNagaSoftSynth* softSynth = track->getSoftSynth();
                     if (!softSynth) continue;
                     
-                    // Clear track buffers
-                    std::fill(track_left_.begin(), track_left_.begin() + num_frames, 0.0f);
-                    std::fill(track_right_.begin(), track_right_.begin() + num_frames, 0.0f);
-                    
-                    // Render this track (applies its own volume internally)
-                    track->renderAudio(track_left_.data(), track_right_.data(), num_frames);
-                    
-                    // Apply track's synth DSP blocks if DSP is enabled
-                    if (this->enable_dsp_) {
-                        auto it = synth_dsp_blocks_.find(softSynth);
-                        if (it != synth_dsp_blocks_.end()) {
-                            for (NoteNagaDSPBlockBase *block : it->second) {
-                                if (block->isActive()) {
-                                    block->process(track_left_.data(), track_right_.data(), num_frames);
-                                }
-                            }
-                        }
-                    }
+                    SynthRenderJob job;
+                    job.synth = softSynth;
+                    job.track = track;
+                    render_jobs_.push_back(job);
+                }
+                ensureJobBuffers(render_jobs_.size(), num_frames);
+                assignBlockMidiEvents();
+                bindNodeStates();
+                
+                // Render tracks in parallel, each job owns its buffers
+                auto renderTrackJob = [&](size_t j) {
+                    SynthRenderJob &job = render_jobs_[j];
+                    float *left = jobLeft(j, num_frames);
+                    float *right = jobRight(j, num_frames);
                     
-                    // Calculate and store per-track RMS
-                    track_rms_values_[track] = calculateTrackRMS(track_left_.data(), track_right_.data(), num_frames);
+                    // Render this track (applies its own volume internally) and its synth DSP blocks,
+                    // silent nodes are skipped
+                    if (!renderJobNode(job, j, graph, dsp_enabled, left, right, num_frames)) return;
                     
-                    // Add to mix buffers
-                    for (size_t i = 0; i < num_frames; i++) {
-                        mix_left_[i] += track_left_[i];
-                        mix_right_[i] += track_right_[i];
-                    }
+                    job.levels = NoteNagaAnalysisBus::measure(left, right, num_frames);
+                };
+                if (pool) {
+                    pool->run(render_jobs_.size(), renderTrackJob);
+                } else {
+                    for (size_t j = 0; j < render_jobs_.size(); ++j) renderTrackJob(j);
+                }
+                
+                // Publish per-track levels and sum in track order (deterministic)
+                for (size_t j = 0; j < render_jobs_.size(); ++j) {
+                    if (analysis_bus_) analysis_bus_->publishLevels(render_jobs_[j].track, render_jobs_[j].levels);
+                    if (render_jobs_[j].silent) continue;
+                    nn_mix_add(mix_left_.data(), jobLeft(j, num_frames), num_frames);
+                    nn_mix_add(mix_right_.data(), jobRight(j, num_frames), num_frames);
                 }
+                publishRenderStats();
             }
         }
     }
 
+    // Events of synths which were not rendered in this block
+    for (size_t e = 0; e < block_midi_events_.size(); ++e) {
+        if (block_midi_jobs_[e] == -2) applyMidiEvent(block_midi_events_[e]);
+    }
+    block_midi_events_.clear();
+
     // Render audio clips from arrangement tracks (in Arrangement mode)
     renderAudioClips(num_frames);
 
     // Master DSP blocks processing
-    if (this->enable_dsp_) {
-        for (NoteNagaDSPBlockBase *block : this->dsp_blocks_) {
+    if (dsp_enabled && graph) {
+        for (NoteNagaDSPBlockBase *block : graph->master_blocks) {
             if (block->isActive()) {
                 block->process(mix_left_.data(), mix_right_.data(), num_frames);
             }
         }
     }
 
+    // Leave render epoch, the graph snapshot is not referenced past this point
+    render_epoch_.fetch_add(1, std::memory_order_seq_cst);
+
     // Metronome rendering
     if (this->metronome_) {
         this->metronome_->render(mix_left_.data(), mix_right_.data(), num_frames);
     }
 
     // apply master volume with logarithmic effect
-    if (output_volume_ < 1.0f) {
+    const float output_volume = output_volume_.load(std::memory_order_relaxed);
+    if (output_volume < 1.0f) {
         // Use a simple logarithmic curve for perceptual loudness
-        float log_volume = powf(output_volume_, 2.0f); // or use another exponent for desired curve
-        for (size_t i = 0; i < num_frames; ++i) {
-            mix_left_[i] *= log_volume;
-            mix_right_[i] *= log_volume;
-        }
+        float log_volume = powf(output_volume, 2.0f); // or use another exponent for desired curve
+        nn_apply_gain(mix_left_.data(), mix_right_.data(), num_frames, log_volume, log_volume);
     }
 
-    // Calculate RMS for visualization
-    if (compute_rms) {
-        this->calculateRMS(mix_left_.data(), mix_right_.data(), num_frames);
-    } else {
-        this->last_rms_left_ = -100.0f;
-        this->last_rms_right_ = -100.0f;
-    }
-
-    // push to spectrum analyzer
-    if (this->spectrum_analyzer_) {
-        this->spectrum_analyzer_->pushSamplesToLeftBuffer(mix_left_.data(), num_frames);
-        this->spectrum_analyzer_->pushSamplesToRightBuffer(mix_right_.data(), num_frames);
+    // Hand the master mix to the analysis bus (meters, spectrum, pan are computed by its worker)
+    if (analyze && this->analysis_bus_) {
+        this->analysis_bus_->publishMaster(mix_left_.data(), mix_right_.data(), num_frames);
     }
 
-    // push to pan analyzer
-    if (this->pan_analyzer_) {
-        this->pan_analyzer_->pushSamplesToLeftBuffer(mix_left_.data(), num_frames);
-        this->pan_analyzer_->pushSamplesToRightBuffer(mix_right_.data(), num_frames);
-    }
+    // Interleave left and right channels
+    nn_interleave(output, mix_left_.data(), mix_right_.data(), num_frames);
 
-    // Interleave left and right channels using pointer arithmetic for efficiency
-    float *left = mix_left_.data();
-    float *right = mix_right_.data();
-    float *out = output;
-    size_t i = 0;
-    size_t n = num_frames;
-    // Unroll loop for better performance
-    for (; i + 3 < n; i += 4) {
-        out[0] = left[i];
-        out[1] = right[i];
-        out[2] = left[i + 1];
-        out[3] = right[i + 1];
-        out[4] = left[i + 2];
-        out[5] = right[i + 2];
-        out[6] = left[i + 3];
-        out[7] = right[i + 3];
-        out += 8;
-    }
-    // Handle remaining frames
-    for (; i < n; ++i) {
-        *out++ = left[i];
-        *out++ = right[i];
-    }
+    // Advance the audio clock
+    rendered_sample_time_.fetch_add(static_cast<int64_t>(num_frames), std::memory_order_release);
 }
 
 void NoteNagaDSPEngine::setEnableDSP(bool enable) {
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    this->enable_dsp_ = enable;
+    this->enable_dsp_.store(enable, std::memory_order_relaxed);
 }
 
 void NoteNagaDSPEngine::addDSPBlock(NoteNagaDSPBlockBase *block) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    dsp_blocks_.push_back(block);
+    block->setSampleRate(static_cast<float>(sampleRate_));
+    NN_DSPRenderGraph_t *graph = cloneRenderGraph();
+    graph->master_blocks.push_back(block);
+    publishRenderGraph(graph);
 }
 
 void NoteNagaDSPEngine::removeDSPBlock(NoteNagaDSPBlockBase *block) {
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    dsp_blocks_.erase(std::remove(dsp_blocks_.begin(), dsp_blocks_.end(), block),
-                      dsp_blocks_.end());
+    {
+        std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+        NN_DSPRenderGraph_t *graph = cloneRenderGraph();
+        auto &blocks = graph->master_blocks;
+        blocks.erase(std::remove(blocks.begin(), blocks.end(), block), blocks.end());
+        publishRenderGraph(graph);
+    }
+    // Callers delete the block right after removal
+    waitForRenderQuiescence();
 }
 
 void NoteNagaDSPEngine::reorderDSPBlock(int from_idx, int to_idx) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    if (from_idx < 0 || from_idx >= int(dsp_blocks_.size()) || to_idx < 0 ||
-        to_idx >= int(dsp_blocks_.size()) || from_idx == to_idx)
+    const NN_DSPRenderGraph_t *current = render_graph_.load(std::memory_order_acquire);
+    int count = int(current->master_blocks.size());
+    if (from_idx < 0 || from_idx >= count || to_idx < 0 || to_idx >= count || from_idx == to_idx)
         return;
-    auto it_from = dsp_blocks_.begin() + from_idx;
+    NN_DSPRenderGraph_t *graph = cloneRenderGraph();
+    auto &blocks = graph->master_blocks;
+    auto it_from = blocks.begin() + from_idx;
     auto block = *it_from;
-    dsp_blocks_.erase(it_from);
-    dsp_blocks_.insert(dsp_blocks_.begin() + to_idx, block);
+    blocks.erase(it_from);
+    blocks.insert(blocks.begin() + to_idx, block);
+    publishRenderGraph(graph);
 }
 
 void NoteNagaDSPEngine::addSynthDSPBlock(INoteNagaSoftSynth *synth, NoteNagaDSPBlockBase *block) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    synth_dsp_blocks_[synth].push_back(block);
+    block->setSampleRate(static_cast<float>(sampleRate_));
+    NN_DSPRenderGraph_t *graph = cloneRenderGraph();
+    graph->synth_blocks[synth].push_back(block);
+    publishRenderGraph(graph);
 }
 
 void NoteNagaDSPEngine::removeSynthDSPBlock(INoteNagaSoftSynth *synth, NoteNagaDSPBlockBase *block) {
-    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    auto it = synth_dsp_blocks_.find(synth);
-    if (it != synth_dsp_blocks_.end()) {
+    {
+        std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+        const NN_DSPRenderGraph_t *current = render_graph_.load(std::memory_order_acquire);
+        if (!current->findSynthBlocks(synth)) return;
+        NN_DSPRenderGraph_t *graph = cloneRenderGraph();
+        auto it = graph->synth_blocks.find(synth);
         auto &blocks = it->second;
         blocks.erase(std::remove(blocks.begin(), blocks.end(), block), blocks.end());
+        if (blocks.empty()) {
+            graph->synth_blocks.erase(it);
+        }
+        publishRenderGraph(graph);
     }
+    // Callers delete the block right after removal
+    waitForRenderQuiescence();
 }
 
 void NoteNagaDSPEngine::reorderSynthDSPBlock(INoteNagaSoftSynth *synth, int from_idx, int to_idx) {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    auto it = synth_dsp_blocks_.find(synth);
-    if (it == synth_dsp_blocks_.end()) return;
+    const NN_DSPRenderGraph_t *current = render_graph_.load(std::memory_order_acquire);
+    const auto *chain = current->findSynthBlocks(synth);
+    if (!chain) return;
     
-    auto &blocks = it->second;
-    if (from_idx < 0 || from_idx >= int(blocks.size()) || to_idx < 0 ||
-        to_idx >= int(blocks.size()) || from_idx == to_idx)
+    int count = int(chain->size());
+    if (from_idx < 0 || from_idx >= count || to_idx < 0 || to_idx >= count || from_idx == to_idx)
         return;
         
+    NN_DSPRenderGraph_t *graph = cloneRenderGraph();
+    auto &blocks = graph->synth_blocks[synth];
     auto it_from = blocks.begin() + from_idx;
     auto block = *it_from;
     blocks.erase(it_from);
     blocks.insert(blocks.begin() + to_idx, block);
+    publishRenderGraph(graph);
+}
+
+std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getDSPBlocks() const {
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    return render_graph_.load(std::memory_order_acquire)->master_blocks;
 }
 
 std::vector<NoteNagaDSPBlockBase*> NoteNagaDSPEngine::getSynthDSPBlocks(INoteNagaSoftSynth *synth) const {
-    auto it = synth_dsp_blocks_.find(synth);
-    if (it != synth_dsp_blocks_.end()) {
-        return it->second;
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    const auto *chain = render_graph_.load(std::memory_order_acquire)->findSynthBlocks(synth);
+    if (chain) {
+        return *chain;
     }
     return {};
 }
 
-void NoteNagaDSPEngine::setOutputVolume(float volume) {
-    // Ensure volume is within [0.0, 1.0] range
+void NoteNagaDSPEngine::setRenderThreadCount(int num_threads) {
+    NoteNagaRenderThreadPool *pool = new NoteNagaRenderThreadPool(num_threads);
+    NoteNagaRenderThreadPool *old = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+        old = render_pool_.exchange(pool, std::memory_order_seq_cst);
+    }
+    // The old pool may still be running a batch of the current block
+    waitForRenderQuiescence();
+    delete old;
+}
+
+int NoteNagaDSPEngine::getRenderThreadCount() const {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    this->output_volume_ = std::clamp(volume, 0.0f, 1.0f);
+    NoteNagaRenderThreadPool *pool = render_pool_.load(std::memory_order_acquire);
+    return pool ? pool->getThreadCount() : 1;
 }
 
-std::pair<float, float> NoteNagaDSPEngine::getCurrentVolumeDb() const {
-    return {last_rms_left_, last_rms_right_};
+void NoteNagaDSPEngine::ensureJobBuffers(size_t num_jobs, size_t num_frames) {
+    size_t required = num_jobs * 2 * num_frames;
+    if (job_buffers_.size() < required) {
+        job_buffers_.resize(required, 0.0f);
+    }
 }
 
-void NoteNagaDSPEngine::calculateRMS(float *left, float *right, size_t numFrames) {
-    // Výpočet RMS pro left/right
-    double sum_left = 0.0, sum_right = 0.0;
-    for (size_t i = 0; i < numFrames; ++i) {
-        sum_left += left[i] * left[i];
-        sum_right += right[i] * right[i];
+/*******************************************************************************************************/
+// Sample-accurate MIDI scheduling
+/*******************************************************************************************************/
+
+bool NoteNagaDSPEngine::scheduleMidiEvent(const NN_ScheduledMidiEvent_t &event) {
+    NN_ScheduledMidiEvent_t stamped = event;
+    stamped.generation = midi_flush_generation_.load(std::memory_order_relaxed);
+    return midi_queue_->tryEnqueue(stamped);
+}
+
+void NoteNagaDSPEngine::flushScheduledMidiEvents() {
+    midi_flush_generation_.fetch_add(1, std::memory_order_release);
+}
+
+void NoteNagaDSPEngine::collectBlockMidiEvents(int64_t block_start, size_t num_frames) {
+    block_midi_events_.clear();
+    block_midi_offsets_.clear();
+    block_midi_jobs_.clear();
+
+    const int64_t block_end = block_start + static_cast<int64_t>(num_frames);
+    uint32_t generation = midi_flush_generation_.load(std::memory_order_acquire);
+    while (block_midi_events_.size() < kMaxBlockMidiEvents) {
+        const NN_ScheduledMidiEvent_t *event = midi_queue_->peek();
+        if (!event) break;
+        bool flushed = false;
+        if (event->generation != generation) {
+            // Either flushed, or queued after a flush we have not seen yet
+            generation = midi_flush_generation_.load(std::memory_order_acquire);
+            flushed = event->generation != generation;
+        }
+        // A flush drops notes, but never an all-notes-off: it silences its track at once
+        if (flushed && event->type != NN_ScheduledMidiEvent_t::Type::AllNotesOff) {
+            midi_queue_->pop();
+            continue;
+        }
+        if (!flushed && event->sample_time >= block_end) break;
+
+        // Late events (scheduled for an already rendered block) fire at the block start
+        block_midi_events_.push_back(*event);
+        block_midi_offsets_.push_back(!flushed && event->sample_time > block_start
+                                          ? static_cast<size_t>(event->sample_time - block_start)
+                                          : 0);
+        block_midi_jobs_.push_back(-2); // Not assigned yet
+        midi_queue_->pop();
+    }
+}
+
+void NoteNagaDSPEngine::assignBlockMidiEvents() {
+    const size_t numJobs = render_jobs_.size();
+    job_lookup_.clear();
+    for (size_t j = 0; j < numJobs; ++j) {
+        job_lookup_.emplace_back(render_jobs_[j].synth, static_cast<int>(j));
+    }
+    std::sort(job_lookup_.begin(), job_lookup_.end());
+
+    job_lane_start_.assign(numJobs + 1, 0);
+    for (size_t e = 0; e < block_midi_events_.size(); ++e) {
+        if (block_midi_jobs_[e] == -2) {
+            const NN_ScheduledMidiEvent_t &event = block_midi_events_[e];
+            INoteNagaSoftSynth *synth = event.track ? event.track->getSoftSynth() : nullptr;
+
+            int jobIndex = -1;
+            if (synth) {
+                auto it = std::lower_bound(job_lookup_.begin(), job_lookup_.end(),
+                                           std::make_pair(synth, -1));
+                if (it != job_lookup_.end() && it->first == synth) jobIndex = it->second;
+            }
+            block_midi_jobs_[e] = jobIndex;
+            if (jobIndex < 0) applyMidiEvent(event);
+        }
+        if (block_midi_jobs_[e] >= 0) ++job_lane_start_[block_midi_jobs_[e] + 1];
     }
-    float rms_left = sqrt(sum_left / numFrames);
-    float rms_right = sqrt(sum_right / numFrames);
 
-    // Konverze na dBFS (0 dB = max, typicky -60 až 0)
-    this->last_rms_left_ = (rms_left > 0.000001f) ? 20.0f * log10(rms_left) : -100.0f;
-    this->last_rms_right_ = (rms_right > 0.000001f) ? 20.0f * log10(rms_right) : -100.0f;
+    // Counting sort into per-job lanes (stable, events stay in time order)
+    for (size_t j = 0; j < numJobs; ++j) job_lane_start_[j + 1] += job_lane_start_[j];
+    job_lane_cursor_.assign(job_lane_start_.begin(), job_lane_start_.end() - 1);
+    job_lane_events_.resize(job_lane_start_[numJobs]);
+    for (size_t e = 0; e < block_midi_events_.size(); ++e) {
+        int job = block_midi_jobs_[e];
+        if (job >= 0) job_lane_events_[job_lane_cursor_[job]++] = static_cast<uint32_t>(e);
+    }
 }
 
-std::pair<float, float> NoteNagaDSPEngine::calculateTrackRMS(float *left, float *right, size_t numFrames) {
-    double sum_left = 0.0, sum_right = 0.0;
-    for (size_t i = 0; i < numFrames; ++i) {
-        sum_left += left[i] * left[i];
-        sum_right += right[i] * right[i];
+void NoteNagaDSPEngine::applyMidiEvent(const NN_ScheduledMidiEvent_t &event) {
+    if (!event.track) return;
+    switch (event.type) {
+    case NN_ScheduledMidiEvent_t::Type::NoteOn:
+        event.track->playNote(event.toNote());
+        break;
+    case NN_ScheduledMidiEvent_t::Type::NoteOff:
+        event.track->stopNote(event.toNote());
+        break;
+    case NN_ScheduledMidiEvent_t::Type::AllNotesOff:
+        event.track->stopAllNotes();
+        break;
     }
-    float rms_left = sqrt(sum_left / numFrames);
-    float rms_right = sqrt(sum_right / numFrames);
-    
-    float db_left = (rms_left > 0.000001f) ? 20.0f * log10(rms_left) : -100.0f;
-    float db_right = (rms_right > 0.000001f) ? 20.0f * log10(rms_right) : -100.0f;
-    return {db_left, db_right};
 }
 
-std::pair<float, float> NoteNagaDSPEngine::getTrackVolumeDb(NoteNagaTrack* track) const {
-    auto it = track_rms_values_.find(track);
-    if (it != track_rms_values_.end()) {
-        return it->second;
+void NoteNagaDSPEngine::renderJobSource(const SynthRenderJob &job, size_t job_index, float *left, float *right,
+                                        size_t num_frames) {
+    auto renderRange = [&](size_t from, size_t count) {
+        if (count == 0) return;
+        if (job.track) {
+            job.track->renderAudio(left + from, right + from, count);
+        } else {
+            job.synth->renderAudio(left + from, right + from, count);
+        }
+    };
+
+    // Split the block at the offsets of this job's events
+    size_t pos = 0;
+    for (uint32_t k = job_lane_start_[job_index]; k < job_lane_start_[job_index + 1]; ++k) {
+        const uint32_t e = job_lane_events_[k];
+        size_t offset = std::min(block_midi_offsets_[e], num_frames);
+        if (offset > pos) {
+            renderRange(pos, offset - pos);
+            pos = offset;
+        }
+        applyMidiEvent(block_midi_events_[e]);
     }
-    return {-100.0f, -100.0f};
+    renderRange(pos, num_frames - pos);
 }
 
-std::pair<float, float> NoteNagaDSPEngine::getArrangementTrackVolumeDb(NoteNagaArrangementTrack* track) const {
-    auto it = arr_track_rms_values_.find(track);
-    if (it != arr_track_rms_values_.end()) {
-        return it->second;
+/*******************************************************************************************************/
+// Silence tracking
+/*******************************************************************************************************/
+
+void NoteNagaDSPEngine::bindNodeStates() {
+    ++node_block_;
+    // Forget nodes which had no job in the previous block
+    node_states_.erase(std::remove_if(node_states_.begin(), node_states_.end(),
+                                      [this](const NodeState &state) { return state.last_block + 1 < node_block_; }),
+                       node_states_.end());
+
+    auto nodeKey = [](const SynthRenderJob &job) -> const void * {
+        return job.track ? static_cast<const void *>(job.track) : static_cast<const void *>(job.synth);
+    };
+    auto byKey = [](const NodeState &state, const void *key) { return state.key < key; };
+
+    // Insert the new nodes first, the pointers are bound once the vector stopped changing
+    for (const SynthRenderJob &job : render_jobs_) {
+        const void *key = nodeKey(job);
+        auto it = std::lower_bound(node_states_.begin(), node_states_.end(), key, byKey);
+        if (it == node_states_.end() || it->key != key) {
+            NodeState state;
+            state.key = key;
+            node_states_.insert(it, state);
+        }
+    }
+    for (SynthRenderJob &job : render_jobs_) {
+        auto it = std::lower_bound(node_states_.begin(), node_states_.end(), nodeKey(job), byKey);
+        it->last_block = node_block_;
+        job.node = &*it;
     }
-    return {-100.0f, -100.0f};
 }
 
-void NoteNagaDSPEngine::resetAllBlocks() {
+bool NoteNagaDSPEngine::renderJobNode(SynthRenderJob &job, size_t job_index, const NN_DSPRenderGraph_t *graph,
+                                      bool dsp_enabled, float *left, float *right, size_t num_frames) {
+    NodeState &node = *job.node;
+    const double rate = double(sampleRate_);
+    const int64_t frames = static_cast<int64_t>(num_frames);
+    job.levels = NN_BlockLevels_t{};
+    job.levels.frames = static_cast<uint32_t>(num_frames);
+
+    // Synth: skipped without voices and events once its output stayed silent past its tail
+    const bool has_events = job_lane_start_[job_index] != job_lane_start_[job_index + 1];
+    const bool synth_idle = !has_events && !job.synth->hasActiveVoices();
+    job.synth_skipped =
+        synth_idle && node.synth_quiet && double(node.synth_idle_frames) >= job.synth->getTailSeconds() * rate;
+    node.synth_idle_frames = synth_idle ? node.synth_idle_frames + frames : 0;
+
+    bool quiet = true;
+    if (!job.synth_skipped) {
+        std::fill(left, left + num_frames, 0.0f);
+        std::fill(right, right + num_frames, 0.0f);
+        renderJobSource(job, job_index, left, right, num_frames);
+        float sum_sq = 0.0f, peak = 0.0f;
+        nn_sum_squares_peak(left, num_frames, sum_sq, peak);
+        nn_sum_squares_peak(right, num_frames, sum_sq, peak);
+        quiet = peak < kSilenceThreshold;
+        node.synth_quiet = quiet;
+    }
+
+    // DSP chain: skipped once its input stayed silent past the tails of its blocks
+    const std::vector<NoteNagaDSPBlockBase *> *chain =
+        dsp_enabled && graph ? graph->findSynthBlocks(job.synth) : nullptr;
+    job.chain_skipped = false;
+    if (chain && !chain->empty()) {
+        double tail = kSilenceHoldSeconds;
+        for (NoteNagaDSPBlockBase *block : *chain) {
+            if (block->isActive()) tail += block->getTailSeconds();
+        }
+        job.chain_skipped = quiet && node.chain_quiet && double(node.chain_idle_frames) >= tail * rate;
+        node.chain_idle_frames = quiet ? node.chain_idle_frames + frames : 0;
+
+        if (!job.chain_skipped) {
+            if (job.synth_skipped) {
+                std::fill(left, left + num_frames, 0.0f);
+                std::fill(right, right + num_frames, 0.0f);
+            }
+            for (NoteNagaDSPBlockBase *block : *chain) {
+                if (block->isActive()) {
+                    block->process(left, right, num_frames);
+                }
+            }
+            float sum_sq = 0.0f, peak = 0.0f;
+            nn_sum_squares_peak(left, num_frames, sum_sq, peak);
+            nn_sum_squares_peak(right, num_frames, sum_sq, peak);
+            quiet = peak < kSilenceThreshold;
+            node.chain_quiet = quiet;
+        }
+    }
+
+    job.silent = quiet;
+    return !quiet;
+}
+
+void NoteNagaDSPEngine::publishRenderStats() {
+    NN_RenderStats_t stats;
+    stats.nodes = static_cast<uint32_t>(render_jobs_.size());
+    for (const SynthRenderJob &job : render_jobs_) {
+        if (job.synth_skipped) ++stats.skipped_synths;
+        if (job.chain_skipped) ++stats.skipped_chains;
+    }
+    skipped_total_ += stats.skipped_synths + stats.skipped_chains;
+    stats.skipped_total = skipped_total_;
+    render_stats_.store(stats);
+}
+
+/*******************************************************************************************************/
+// Render graph publication
+/*******************************************************************************************************/
+
+NN_DSPRenderGraph_t *NoteNagaDSPEngine::cloneRenderGraph() const {
+    const NN_DSPRenderGraph_t *current = render_graph_.load(std::memory_order_acquire);
+    return current ? new NN_DSPRenderGraph_t(*current) : new NN_DSPRenderGraph_t();
+}
+
+void NoteNagaDSPEngine::publishRenderGraph(NN_DSPRenderGraph_t *graph) {
+    const NN_DSPRenderGraph_t *old = render_graph_.exchange(graph, std::memory_order_seq_cst);
+    if (old) {
+        // Epoch observed AFTER the swap: any render() entering later sees the new graph
+        retired_graphs_.emplace_back(old, render_epoch_.load(std::memory_order_seq_cst));
+    }
+    reclaimRetiredGraphs();
+}
+
+/// Remove and free retired snapshots which no render() can reference anymore
+template <typename T>
+static void reclaimRetired(std::vector<std::pair<T*, uint64_t>> &retired_list, uint64_t epoch) {
+    auto it = std::remove_if(retired_list.begin(), retired_list.end(),
+        [epoch](const std::pair<T*, uint64_t> &retired) {
+            // Even epoch at retire time = no render in flight; odd = wait until that render leaves
+            bool reclaimable = (retired.second % 2 == 0) || (epoch > retired.second);
+            if (reclaimable) delete retired.first;
+            return reclaimable;
+        });
+    retired_list.erase(it, retired_list.end());
+}
+
+void NoteNagaDSPEngine::reclaimRetiredGraphs() {
+    uint64_t epoch = render_epoch_.load(std::memory_order_seq_cst);
+    reclaimRetired(retired_graphs_, epoch);
+    reclaimRetired(retired_plans_, epoch);
+    reclaimRetired(retired_tempo_maps_, epoch);
+}
+
+void NoteNagaDSPEngine::rebuildArrangementRenderPlan(bool wait_for_render) {
+    {
+        std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+        NoteNagaArrangementRenderPlan *plan =
+            NoteNagaArrangementRenderPlan::build(runtime_data_, arrangement_plan_.load(std::memory_order_acquire));
+        NoteNagaArrangementRenderPlan *old = arrangement_plan_.exchange(plan, std::memory_order_seq_cst);
+        if (old) {
+            retired_plans_.emplace_back(old, render_epoch_.load(std::memory_order_seq_cst));
+        }
+        publishArrangementTempoMapLocked();
+        reclaimRetiredGraphs();
+    }
+    // Callers delete the dropped synths / tracks right after the rebuild
+    if (wait_for_render) waitForRenderQuiescence();
+}
+
+void NoteNagaDSPEngine::publishArrangementTempoMap() {
     std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
-    
-    // Reset master DSP blocks
-    for (NoteNagaDSPBlockBase *block : dsp_blocks_) {
-        if (block) block->resetState();
+    publishArrangementTempoMapLocked();
+    reclaimRetiredGraphs();
+}
+
+void NoteNagaDSPEngine::publishArrangementTempoMapLocked() {
+    if (!runtime_data_) return;
+    TempoMapRef tempoMap = runtime_data_->getArrangementTempoMap();
+    const TempoMapRef *current = arrangement_tempo_map_.load(std::memory_order_acquire);
+    if (current && *current == tempoMap) return;
+
+    // The audio thread never drops the last reference, the retired holder is freed here
+    const TempoMapRef *old = arrangement_tempo_map_.exchange(new TempoMapRef(std::move(tempoMap)),
+                                                             std::memory_order_seq_cst);
+    if (old) {
+        retired_tempo_maps_.emplace_back(old, render_epoch_.load(std::memory_order_seq_cst));
+    }
+}
+
+void NoteNagaDSPEngine::setPlaybackMode(PlaybackMode mode) {
+    if (mode == PlaybackMode::Arrangement) {
+        rebuildArrangementRenderPlan();
+    }
+    playback_mode_ = mode;
+}
+
+void NoteNagaDSPEngine::waitForRenderQuiescence() {
+    uint64_t epoch = render_epoch_.load(std::memory_order_seq_cst);
+    if (epoch % 2 == 0) return;
+    while (render_epoch_.load(std::memory_order_seq_cst) == epoch) {
+        std::this_thread::yield();
+    }
+    std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+    reclaimRetiredGraphs();
+}
+
+void NoteNagaDSPEngine::resetGraphBlocks(const NN_DSPRenderGraph_t *graph) {
+    if (graph) {
+        // Reset master DSP blocks
+        for (NoteNagaDSPBlockBase *block : graph->master_blocks) {
+            if (block) block->resetState();
+        }
+        
+        // Reset synth-specific DSP blocks
+        for (const auto &pair : graph->synth_blocks) {
+            for (NoteNagaDSPBlockBase *block : pair.second) {
+                if (block) block->resetState();
+            }
+        }
     }
     
-    // Reset synth-specific DSP blocks
-    for (auto &pair : synth_dsp_blocks_) {
+    // Clear fade out tracking state
+    if (NoteNagaArrangementRenderPlan *plan = arrangement_plan_.load(std::memory_order_seq_cst)) {
+        plan->resetFadeState();
+    }
+}
+
+void NoteNagaDSPEngine::applyGraphSampleRate(const NN_DSPRenderGraph_t *graph) {
+    if (!graph) return;
+    const float sampleRate = static_cast<float>(sampleRate_);
+    for (NoteNagaDSPBlockBase *block : graph->master_blocks) {
+        if (block) block->setSampleRate(sampleRate);
+    }
+    for (const auto &pair : graph->synth_blocks) {
         for (NoteNagaDSPBlockBase *block : pair.second) {
-            if (block) block->resetState();
+            if (block) block->setSampleRate(sampleRate);
         }
     }
+}
+
+void NoteNagaDSPEngine::setSampleRate(int sampleRate) {
+    {
+        // Serialized with addDSPBlock() / addSynthDSPBlock(), which pass the rate to new blocks
+        std::lock_guard<std::mutex> lock(dsp_engine_mutex_);
+        sampleRate_ = sampleRate;
+    }
+    sample_rate_pending_.store(true, std::memory_order_release);
+}
+
+void NoteNagaDSPEngine::setOutputVolume(float volume) {
+    // Ensure volume is within [0.0, 1.0] range
+    this->output_volume_.store(std::clamp(volume, 0.0f, 1.0f), std::memory_order_relaxed);
+}
+
+std::pair<float, float> NoteNagaDSPEngine::getCurrentVolumeDb() const {
+    if (!analysis_bus_) return {-100.0f, -100.0f};
+    NN_MasterLevels_t levels = analysis_bus_->getMasterLevels();
+    return {levels.rms_left, levels.rms_right};
+}
+
+std::pair<float, float> NoteNagaDSPEngine::getTrackVolumeDb(NoteNagaTrack* track) const {
+    if (!analysis_bus_) return {-100.0f, -100.0f};
+    return analysis_bus_->getSourceLevelDb(track);
+}
+
+std::pair<float, float> NoteNagaDSPEngine::getArrangementTrackVolumeDb(NoteNagaArrangementTrack* track) const {
+    if (!analysis_bus_) return {-100.0f, -100.0f};
+    return analysis_bus_->getSourceLevelDb(track);
+}
+
+void NoteNagaDSPEngine::resetAllBlocks() {
+    // Block state belongs to the audio thread, the reset is performed by the next render()
+    reset_blocks_pending_.store(true, std::memory_order_release);
     
     // Reset audio sample position
     audioSamplePosition_.store(0, std::memory_order_relaxed);
-    
-    // Clear fade out tracking state
-    synthFadeOutState_.clear();
 }
 
-int64_t NoteNagaDSPEngine::tickToSamples(int tick, int tempo, int ppq) const {
-    // tempo is in microseconds per quarter note
-    // samples = ticks * (samples_per_quarter_note)
-    // samples_per_quarter_note = sampleRate * (tempo_us / 1000000)
-    double usPerTick = static_cast<double>(tempo) / ppq;
-    double secondsPerTick = usPerTick / 1000000.0;
-    return static_cast<int64_t>(tick * secondsPerTick * sampleRate_);
+int64_t NoteNagaDSPEngine::tickToSamples(int tick, const NoteNagaTempoMap &tempo_map, int ppq) const {
+    return tempo_map.ticksToSamples(tick, ppq, sampleRate_);
 }
 
-int NoteNagaDSPEngine::sampleToTicks(int64_t sample, int tempo, int ppq) const {
-    double usPerTick = static_cast<double>(tempo) / ppq;
-    double secondsPerTick = usPerTick / 1000000.0;
-    double samplesPerTick = secondsPerTick * sampleRate_;
-    return static_cast<int>(sample / samplesPerTick);
+int NoteNagaDSPEngine::sampleToTicks(int64_t sample, const NoteNagaTempoMap &tempo_map, int ppq) const {
+    return static_cast<int>(tempo_map.samplesToTicks(sample, ppq, sampleRate_));
 }
 
-void NoteNagaDSPEngine::renderArrangementTracks(size_t numFrames) {
+void NoteNagaDSPEngine::renderArrangementTracks(const NN_DSPRenderGraph_t *graph, NoteNagaRenderThreadPool *pool,
+                                                bool dspEnabled, size_t numFrames) {
     if (!runtime_data_) return;
     
     NoteNagaArrangement* arrangement = runtime_data_->getArrangement();
     if (!arrangement) return;
     
+    NoteNagaArrangementRenderPlan* plan = arrangement_plan_.load(std::memory_order_seq_cst);
+    if (!plan) return;
+    
     int currentTick = runtime_data_->getCurrentArrangementTick();
+    const auto& arrTracks = plan->getArrangementTracks();
     
     // Check if any arrangement track has solo enabled
     bool hasSoloTrack = false;
-    for (size_t i = 0; i < arrangement->getTrackCount(); ++i) {
-        NoteNagaArrangementTrack* arrTrack = arrangement->getTracks()[i];
+    for (NoteNagaArrangementTrack* arrTrack : arrTracks) {
         if (arrTrack && arrTrack->isSolo()) {
             hasSoloTrack = true;
             break;
         }
     }
     
-    // Build a map of synth -> arrangement track based on ACTIVE clips at current tick
-    // This ensures the synth uses the volume/pan of the track where the clip is currently playing
-    std::map<INoteNagaSoftSynth*, NoteNagaArrangementTrack*> synthToArrTrack;
-    std::map<INoteNagaSoftSynth*, const NN_MidiClip_t*> synthToClip;  // For fade in/out
+    // Reset the level summaries of all arrangement tracks first
+    std::fill(plan->track_levels.begin(), plan->track_levels.end(), NN_BlockLevels_t{});
     
-    for (size_t trackIdx = 0; trackIdx < arrangement->getTrackCount(); ++trackIdx) {
-        NoteNagaArrangementTrack* arrTrack = arrangement->getTracks()[trackIdx];
-        if (!arrTrack) continue;
-        
-        // Skip muted tracks
-        if (arrTrack->isMuted()) continue;
-        if (hasSoloTrack && !arrTrack->isSolo()) continue;
-        
-        // Check only ACTIVE clips at current tick
-        std::vector<const NN_MidiClip_t*> activeClips = arrTrack->getClipsAtTick(currentTick);
-        for (const auto* clip : activeClips) {
-            if (!clip || clip->muted) continue;
-            
-            NoteNagaMidiSeq* seq = runtime_data_->getSequenceById(clip->sequenceId);
-            if (!seq) continue;
-            
-            for (NoteNagaTrack* midiTrack : seq->getTracks()) {
-                if (!midiTrack || midiTrack->isTempoTrack()) continue;
-                
-                INoteNagaSoftSynth* softSynth = midiTrack->getSoftSynth();
-                if (softSynth) {
-                    // Override previous assignment - the currently active clip wins
-                    synthToArrTrack[softSynth] = arrTrack;
-                    synthToClip[softSynth] = clip;
-                }
-            }
-        }
-    }
-    
-    // Also collect all synths that may have notes still playing (from sequences)
-    // even if no clip is currently active (for note release/sustain)
-    std::set<INoteNagaSoftSynth*> allSynths;
-    for (NoteNagaMidiSeq* seq : runtime_data_->getSequences()) {
-        if (!seq) continue;
-        for (NoteNagaTrack* midiTrack : seq->getTracks()) {
-            if (!midiTrack || midiTrack->isTempoTrack()) continue;
-            INoteNagaSoftSynth* softSynth = midiTrack->getSoftSynth();
-            if (softSynth) {
-                allSynths.insert(softSynth);
-            }
-        }
-    }
-    
-    // Reset RMS for all arrangement tracks first
-    for (size_t trackIdx = 0; trackIdx < arrangement->getTrackCount(); ++trackIdx) {
-        NoteNagaArrangementTrack* arrTrack = arrangement->getTracks()[trackIdx];
-        if (arrTrack) {
-            arr_track_rms_values_[arrTrack] = {-100.0f, -100.0f};
-        }
-    }
-    
-    // Track RMS accumulation per arrangement track
-    std::map<NoteNagaArrangementTrack*, std::pair<float, float>> arrTrackRmsSum;
-    std::map<NoteNagaArrangementTrack*, int> arrTrackSampleCount;
+    // Tempo map published by publishArrangementTempoMap(), no locks or reference counting here
+    const TempoMapRef *tempoMapRef = arrangement_tempo_map_.load(std::memory_order_acquire);
+    if (!tempoMapRef || !*tempoMapRef) return;
+    const NoteNagaTempoMap *tempoMap = tempoMapRef->get();
+    int ppq = runtime_data_->getPPQ();
     
-    // Render all synths
-    for (INoteNagaSoftSynth* synth : allSynths) {
-        if (!synth) continue;
-        
-        // Find the arrangement track for this synth (if any)
-        NoteNagaArrangementTrack* arrTrack = nullptr;
-        const NN_MidiClip_t* activeClip = nullptr;
-        auto it = synthToArrTrack.find(synth);
-        if (it != synthToArrTrack.end()) {
-            arrTrack = it->second;
-        }
-        auto clipIt = synthToClip.find(synth);
-        if (clipIt != synthToClip.end()) {
-            activeClip = clipIt->second;
-        }
+    // Prepare one job per synth from the precomputed plan. The active clip of each synth
+    // is found by its segment cursor (the clip that started last wins on overlap).
+    render_jobs_.clear();
+    for (size_t s = 0; s < plan->getSynthCount(); ++s) {
+        NoteNagaArrangementRenderPlan::SynthEntry& entry = plan->getSynth(s);
+        const NoteNagaArrangementRenderPlan::Segment* segment = entry.segmentAt(currentTick);
         
-        // Default volume/pan if no arrangement track owns this synth
-        float arrVolume = arrTrack ? arrTrack->getVolume() : 1.0f;
-        float arrPan = arrTrack ? arrTrack->getPan() : 0.0f;
+        NoteNagaArrangementTrack* arrTrack = segment ? arrTracks[segment->arr_track_index] : nullptr;
         
         // Check mute/solo state
         if (arrTrack) {
@@ -412,129 +746,97 @@ void NoteNagaDSPEngine::renderArrangementTracks(size_t numFrames) {
             if (hasSoloTrack && !arrTrack->isSolo()) continue;
         }
         
-        // Calculate pan gains (constant power)
-        float panAngle = (arrPan + 1.0f) * 0.25f * 3.14159265f; // 0 to pi/2
-        float panL = cosf(panAngle);
-        float panR = sinf(panAngle);
-        
-        // Clear track buffers
-        std::fill(track_left_.begin(), track_left_.begin() + numFrames, 0.0f);
-        std::fill(track_right_.begin(), track_right_.begin() + numFrames, 0.0f);
-        
-        // Render synth directly (no MIDI track volume/pan - we apply arr track settings)
-        synth->renderAudio(track_left_.data(), track_right_.data(), numFrames);
+        SynthRenderJob job;
+        job.synth = entry.synth;
+        job.arr_track = arrTrack;
+        job.arr_track_index = segment ? segment->arr_track_index : -1;
+        job.has_clip = segment != nullptr;
         
-        // Apply synth-specific DSP blocks if DSP is enabled
-        if (this->enable_dsp_) {
-            auto dspIt = synth_dsp_blocks_.find(synth);
-            if (dspIt != synth_dsp_blocks_.end()) {
-                for (NoteNagaDSPBlockBase *block : dspIt->second) {
-                    if (block->isActive()) {
-                        block->process(track_left_.data(), track_right_.data(), numFrames);
-                    }
-                }
-            }
-        }
+        // Default volume/pan if no arrangement track owns this synth
+        job.volume = arrTrack ? arrTrack->getVolume() : 1.0f;
+        float arrPan = arrTrack ? arrTrack->getPan() : 0.0f;
         
-        // Apply arrangement track volume and pan, then add to mix
-        // Pan crossfeed: pan affects how much of each channel goes to L/R output
-        float sumL = 0.0f, sumR = 0.0f;
+        // Calculate pan gains (constant power)
+        nn_pan_gains(arrPan, job.pan_l, job.pan_r);
         
         // Calculate fade parameters for MIDI clip (if any active clip)
-        int64_t clipFadeInSamples = 0;
-        int64_t clipFadeOutSamples = 0;
-        int64_t clipStartSample = 0;
-        int64_t clipEndSample = 0;
-        bool hasFadeOut = false;
-        
-        int tempo = runtime_data_->getTempo();
-        int ppq = runtime_data_->getPPQ();
-        
-        if (activeClip && (activeClip->fadeInTicks > 0 || activeClip->fadeOutTicks > 0)) {
-            clipFadeInSamples = tickToSamples(activeClip->fadeInTicks, tempo, ppq);
-            clipFadeOutSamples = tickToSamples(activeClip->fadeOutTicks, tempo, ppq);
-            clipStartSample = tickToSamples(activeClip->startTick, tempo, ppq);
-            clipEndSample = tickToSamples(activeClip->startTick + activeClip->durationTicks, tempo, ppq);
+        if (segment && (segment->fade_in_ticks > 0 || segment->fade_out_ticks > 0)) {
+            job.clip_start_sample = tickToSamples(segment->clip_start_tick, *tempoMap, ppq);
+            job.clip_end_sample = tickToSamples(segment->clip_end_tick, *tempoMap, ppq);
+            job.fade_in_samples =
+                tickToSamples(segment->clip_start_tick + segment->fade_in_ticks, *tempoMap, ppq) - job.clip_start_sample;
+            job.fade_out_samples =
+                job.clip_end_sample - tickToSamples(segment->clip_end_tick - segment->fade_out_ticks, *tempoMap, ppq);
             
             // Store fade out state for this synth so we can continue fading after clip ends
-            if (activeClip->fadeOutTicks > 0) {
-                synthFadeOutState_[synth] = {clipEndSample, clipFadeOutSamples};
+            if (segment->fade_out_ticks > 0) {
+                entry.fade_out_end_sample.store(job.clip_end_sample, std::memory_order_relaxed);
+                entry.fade_out_samples.store(job.fade_out_samples, std::memory_order_relaxed);
             }
-            hasFadeOut = clipFadeOutSamples > 0;
-        } else if (!activeClip) {
+            job.has_fade_out = job.fade_out_samples > 0;
+        } else if (!segment) {
             // No active clip - check if this synth was playing a clip with fade out
-            auto fadeIt = synthFadeOutState_.find(synth);
-            if (fadeIt != synthFadeOutState_.end()) {
-                clipEndSample = fadeIt->second.first;
-                clipFadeOutSamples = fadeIt->second.second;
-                hasFadeOut = true;
+            int64_t fadeOutSamples = entry.fade_out_samples.load(std::memory_order_relaxed);
+            if (fadeOutSamples > 0) {
+                job.clip_end_sample = entry.fade_out_end_sample.load(std::memory_order_relaxed);
+                job.fade_out_samples = fadeOutSamples;
+                job.has_fade_out = true;
             }
         }
+        render_jobs_.push_back(job);
+    }
+    ensureJobBuffers(render_jobs_.size(), numFrames);
+    assignBlockMidiEvents();
+    bindNodeStates();
+    
+    // Get current sample position for fade calculation
+    int64_t currentSamplePos = audioSamplePosition_.load(std::memory_order_relaxed);
+    
+    // Render all synths in parallel, each job writes only into its own buffers
+    auto renderSynthJob = [&](size_t j) {
+        SynthRenderJob &job = render_jobs_[j];
+        float *left = jobLeft(j, numFrames);
+        float *right = jobRight(j, numFrames);
         
-        // Get current sample position for fade calculation
-        int64_t currentSamplePos = audioSamplePosition_.load(std::memory_order_relaxed);
+        // Render synth directly (no MIDI track volume/pan - we apply arr track settings) and
+        // its synth-specific DSP blocks, silent nodes are skipped
+        if (!renderJobNode(job, j, graph, dspEnabled, left, right, numFrames)) return;
         
-        for (size_t i = 0; i < numFrames; i++) {
-            // Calculate fade gain for MIDI clip
-            float fadeGain = 1.0f;
-            int64_t absSamplePos = currentSamplePos + static_cast<int64_t>(i);
-            
-            if (activeClip && clipFadeInSamples > 0) {
-                // Fade in (only when inside clip)
-                if (absSamplePos < clipStartSample + clipFadeInSamples) {
-                    int64_t fadePos = absSamplePos - clipStartSample;
-                    fadeGain = static_cast<float>(fadePos) / static_cast<float>(clipFadeInSamples);
-                    fadeGain = std::max(0.0f, std::min(1.0f, fadeGain));
-                }
-            }
-            
-            // Fade out - apply both during clip and after clip ends (for note release)
-            if (hasFadeOut && clipFadeOutSamples > 0) {
-                int64_t fadeOutStartSample = clipEndSample - clipFadeOutSamples;
-                if (absSamplePos >= fadeOutStartSample) {
-                    int64_t fadePos = clipEndSample - absSamplePos;
-                    float fadeOutGain = static_cast<float>(fadePos) / static_cast<float>(clipFadeOutSamples);
-                    // Clamp: after clip end, fadeOutGain becomes negative, so clamp to 0
-                    fadeOutGain = std::max(0.0f, std::min(1.0f, fadeOutGain));
-                    fadeGain *= fadeOutGain;
-                }
-            }
-            
-            // Apply volume first, then pan crossfeed for stereo
-            float srcL = track_left_[i] * arrVolume * fadeGain;
-            float srcR = track_right_[i] * arrVolume * fadeGain;
-            
-            // Pan crossfeed: at pan=0, L goes 100% left, R goes 100% right
-            // At pan=-1, both go left; at pan=+1, both go right
-            float sampleL = srcL * panL + srcR * (1.0f - panR);
-            float sampleR = srcR * panR + srcL * (1.0f - panL);
-            
-            mix_left_[i] += sampleL;
-            mix_right_[i] += sampleR;
-            
-            // Accumulate for RMS calculation
-            sumL += sampleL * sampleL;
-            sumR += sampleR * sampleR;
+        // Apply clip fades and arrangement track volume, then the pan crossfeed: at pan=0
+        // L goes 100% left and R 100% right, at pan=-1 both go left, at pan=+1 both go right.
+        // Fade out also applies after the clip end (note release).
+        NN_FadeRamp_t fade = NN_FadeRamp_t::forBlock(currentSamplePos, numFrames, job.clip_start_sample,
+                                                     job.has_clip ? job.fade_in_samples : 0, job.clip_end_sample,
+                                                     job.has_fade_out ? job.fade_out_samples : 0);
+        nn_apply_gain(left, right, numFrames, job.volume, job.volume, fade);
+        nn_pan_crossfeed(left, right, numFrames, job.pan_l, job.pan_r);
+        job.levels = NoteNagaAnalysisBus::measure(left, right, numFrames);
+    };
+    if (pool) {
+        pool->run(render_jobs_.size(), renderSynthJob);
+    } else {
+        for (size_t j = 0; j < render_jobs_.size(); ++j) renderSynthJob(j);
+    }
+    
+    // Sum into the mix in job order (deterministic regardless of thread count)
+    for (size_t j = 0; j < render_jobs_.size(); ++j) {
+        const SynthRenderJob &job = render_jobs_[j];
+        if (!job.silent) {
+            nn_mix_add(mix_left_.data(), jobLeft(j, numFrames), numFrames);
+            nn_mix_add(mix_right_.data(), jobRight(j, numFrames), numFrames);
         }
         
-        // Accumulate RMS for this arrangement track (if any)
-        if (arrTrack) {
-            arrTrackRmsSum[arrTrack].first += sumL;
-            arrTrackRmsSum[arrTrack].second += sumR;
-            arrTrackSampleCount[arrTrack] += static_cast<int>(numFrames);
+        // Accumulate levels for this arrangement track (if any)
+        if (job.arr_track_index >= 0) {
+            plan->track_levels[job.arr_track_index].merge(job.levels);
         }
     }
+    publishRenderStats();
     
-    // Calculate and store RMS for each arrangement track
-    for (const auto& [arrTrack, sums] : arrTrackRmsSum) {
-        if (!arrTrack) continue;
-        int count = arrTrackSampleCount[arrTrack];
-        if (count > 0) {
-            float rmsLeft = sqrtf(sums.first / count);
-            float rmsRight = sqrtf(sums.second / count);
-            float dbLeft = (rmsLeft > 0.0f) ? 20.0f * log10f(rmsLeft) : -100.0f;
-            float dbRight = (rmsRight > 0.0f) ? 20.0f * log10f(rmsRight) : -100.0f;
-            arr_track_rms_values_[arrTrack] = {dbLeft, dbRight};
+    // Publish the levels of every arrangement track which rendered something
+    if (analysis_bus_) {
+        for (size_t t = 0; t < arrTracks.size(); ++t) {
+            if (plan->track_levels[t].frames > 0) analysis_bus_->publishLevels(arrTracks[t], plan->track_levels[t]);
         }
     }
 }
@@ -549,32 +851,32 @@ void NoteNagaDSPEngine::renderAudioClips(size_t numFrames) {
         return;
     }
     
-    NoteNagaArrangement* arrangement = runtime_data_->getArrangement();
-    if (!arrangement) {
+    // Arrangement tracks come from the published render plan, tracks removed from the
+    // project leave the plan before they are deleted
+    NoteNagaArrangementRenderPlan* plan = arrangement_plan_.load(std::memory_order_seq_cst);
+    if (!plan) {
         return;
     }
+    const auto& arrTracks = plan->getArrangementTracks();
     
     // Get current sample position and advance it for next callback
     int64_t currentSamplePos = audioSamplePosition_.fetch_add(static_cast<int64_t>(numFrames), 
                                                                std::memory_order_relaxed);
     
-    // Get tempo and PPQ for tick-to-sample conversion
-    // Use getTempo() which gets tempo from active sequence, not getProjectTempo()
-    int tempo = runtime_data_->getTempo();
+    // Tick-to-sample conversion follows the arrangement tempo track (or the fixed tempo
+    // of the active sequence), same timeline as the MIDI clips. The map is the published one,
+    // no locks or reference counting on the audio thread.
+    const TempoMapRef *tempoMapRef = arrangement_tempo_map_.load(std::memory_order_acquire);
+    if (!tempoMapRef || !*tempoMapRef) return;
+    const NoteNagaTempoMap *tempoMap = tempoMapRef->get();
     int ppq = runtime_data_->getPPQ();
     
-    // Fallback to default tempo if not set (120 BPM = 500000 us per quarter)
-    if (tempo <= 0) {
-        tempo = 500000;
-    }
-    
     NoteNagaAudioManager& audioManager = runtime_data_->getAudioManager();
     
     // DEBUG: Log basic info periodically
     // Check if any track has solo enabled
     bool hasSoloTrack = false;
-    for (size_t i = 0; i < arrangement->getTrackCount(); ++i) {
-        NoteNagaArrangementTrack* track = arrangement->getTracks()[i];
+    for (NoteNagaArrangementTrack* track : arrTracks) {
         if (track && track->isSolo()) {
             hasSoloTrack = true;
             break;
@@ -587,18 +889,18 @@ void NoteNagaDSPEngine::renderAudioClips(size_t numFrames) {
     }
     
     // Iterate all arrangement tracks
-    for (size_t trackIdx = 0; trackIdx < arrangement->getTrackCount(); ++trackIdx) {
-        NoteNagaArrangementTrack* arrTrack = arrangement->getTracks()[trackIdx];
+    for (NoteNagaArrangementTrack* arrTrack : arrTracks) {
         if (!arrTrack) continue;
         
-        // Track audio accumulation for RMS calculation
-        float trackSumLeft = 0.0f;
-        float trackSumRight = 0.0f;
-        int trackSampleCount = 0;
+        // Track audio accumulation for level metering
+        NN_BlockLevels_t trackLevels;
         
         if (arrTrack->isMuted() || (hasSoloTrack && !arrTrack->isSolo())) {
-            // Reset RMS for muted/non-solo tracks
-            arr_track_rms_values_[arrTrack] = {-100.0f, -100.0f};
+            // Muted/non-solo tracks meter silence
+            if (analysis_bus_) {
+                trackLevels.frames = static_cast<uint32_t>(numFrames);
+                analysis_bus_->publishLevels(arrTrack, trackLevels);
+            }
             continue;
         }
         
@@ -607,9 +909,8 @@ void NoteNagaDSPEngine::renderAudioClips(size_t numFrames) {
         float trackPan = arrTrack->getPan();
         
         // Calculate pan gains (constant power)
-        float panAngle = (trackPan + 1.0f) * 0.25f * 3.14159265f; // 0 to pi/2
-        float panL = cosf(panAngle);
-        float panR = sinf(panAngle);
+        float panL = 1.0f, panR = 1.0f;
+        nn_pan_gains(trackPan, panL, panR);
         
         // Iterate audio clips on this track
         for (const auto& clip : arrTrack->getAudioClips()) {
@@ -621,9 +922,8 @@ void NoteNagaDSPEngine::renderAudioClips(size_t numFrames) {
             if (!resource || !resource->isLoaded()) continue;
             
             // Calculate clip's start and end in samples
-            int64_t clipStartSample = tickToSamples(clip.startTick, tempo, ppq);
-            int64_t clipDurationSamples = tickToSamples(clip.durationTicks, tempo, ppq);
-            int64_t clipEndSample = clipStartSample + clipDurationSamples;
+            int64_t clipStartSample = tickToSamples(clip.startTick, *tempoMap, ppq);
+            int64_t clipEndSample = tickToSamples(clip.startTick + clip.durationTicks, *tempoMap, ppq);
             
             // Skip if completely outside current render window
             if (currentSamplePos + static_cast<int64_t>(numFrames) <= clipStartSample ||
@@ -644,7 +944,8 @@ void NoteNagaDSPEngine::renderAudioClips(size_t numFrames) {
             // Calculate position in the audio resource
             // offsetTicks represents how much of the start is trimmed (in ticks)
             // offsetSamples is an additional sample-level offset
-            int64_t offsetFromTicks = tickToSamples(clip.offsetTicks, tempo, ppq);
+            // (the trimmed part would have played right before the clip start)
+            int64_t offsetFromTicks = clipStartSample - tickToSamples(clip.startTick - clip.offsetTicks, *tempoMap, ppq);
             int64_t resourceOffset = clip.offsetSamples + offsetFromTicks + (renderStart - clipStartSample);
             
             // Handle looping
@@ -661,69 +962,33 @@ void NoteNagaDSPEngine::renderAudioClips(size_t numFrames) {
             }
             float* clipLeft = audioClipBuffer_.data();
             float* clipRight = audioClipBuffer_.data() + numFrames;
-            std::fill(clipLeft, clipLeft + samplesToRender, 0.0f);
-            std::fill(clipRight, clipRight + samplesToRender, 0.0f);
             
-            // Get samples from resource (returns number of samples read)
+            // Get samples from resource (lock-free, returns number of samples written;
+            // streaming underruns come back zero-filled and are counted by the resource)
             int gotSamples = resource->getSamples(resourceOffset, static_cast<int>(samplesToRender), 
                                                    clipLeft, clipRight);
             
             // Calculate fade in/out regions in samples
-            int64_t fadeInSamples = tickToSamples(clip.fadeInTicks, tempo, ppq);
-            int64_t fadeOutSamples = tickToSamples(clip.fadeOutTicks, tempo, ppq);
-            int64_t fadeOutStartSample = clipEndSample - fadeOutSamples;
+            int64_t fadeInSamples = tickToSamples(clip.startTick + clip.fadeInTicks, *tempoMap, ppq) - clipStartSample;
+            int64_t fadeOutSamples = clipEndSample - tickToSamples(clip.startTick + clip.durationTicks - clip.fadeOutTicks, *tempoMap, ppq);
+            if (gotSamples <= 0) continue;
+            size_t gotFrames = static_cast<size_t>(gotSamples);
             
             // Apply clip gain, track volume, pan, and fade, then add to mix
             float combinedGain = clip.gain * trackVolume;
-            float gainL = combinedGain * panL;
-            float gainR = combinedGain * panR;
+            NN_FadeRamp_t fade = NN_FadeRamp_t::forBlock(renderStart, gotFrames, clipStartSample, fadeInSamples,
+                                                         clipEndSample, fadeOutSamples);
+            nn_apply_gain(clipLeft, clipRight, gotFrames, combinedGain * panL, combinedGain * panR, fade);
+            nn_mix_add(mix_left_.data() + bufferOffset, clipLeft, gotFrames);
+            nn_mix_add(mix_right_.data() + bufferOffset, clipRight, gotFrames);
             
-            for (int i = 0; i < gotSamples; ++i) {
-                // Calculate absolute sample position for this sample
-                int64_t absSamplePos = renderStart + i;
-                
-                // Calculate fade multiplier
-                float fadeGain = 1.0f;
-                
-                // Fade in: from clipStart to clipStart + fadeInSamples
-                if (fadeInSamples > 0 && absSamplePos < clipStartSample + fadeInSamples) {
-                    int64_t fadePos = absSamplePos - clipStartSample;
-                    fadeGain = static_cast<float>(fadePos) / static_cast<float>(fadeInSamples);
-                    fadeGain = std::max(0.0f, std::min(1.0f, fadeGain));
-                }
-                
-                // Fade out: from fadeOutStartSample to clipEndSample
-                if (fadeOutSamples > 0 && absSamplePos >= fadeOutStartSample) {
-                    int64_t fadePos = clipEndSample - absSamplePos;
-                    float fadeOutGain = static_cast<float>(fadePos) / static_cast<float>(fadeOutSamples);
-                    fadeOutGain = std::max(0.0f, std::min(1.0f, fadeOutGain));
-                    fadeGain *= fadeOutGain;  // Combine with fade in if overlapping
-                }
-                
-                float sampleL = clipLeft[i] * gainL * fadeGain;
-                float sampleR = clipRight[i] * gainR * fadeGain;
-                mix_left_[bufferOffset + i] += sampleL;
-                mix_right_[bufferOffset + i] += sampleR;
-                
-                // Accumulate for RMS calculation
-                trackSumLeft += sampleL * sampleL;
-                trackSumRight += sampleR * sampleR;
-            }
-            trackSampleCount += gotSamples;
+            // Accumulate for level metering
+            trackLevels.merge(NoteNagaAnalysisBus::measure(clipLeft, clipRight, gotFrames));
         }
         
-        // Calculate and store RMS for this arrangement track
-        if (trackSampleCount > 0) {
-            float rmsLeft = sqrtf(trackSumLeft / trackSampleCount);
-            float rmsRight = sqrtf(trackSumRight / trackSampleCount);
-            float dbLeft = (rmsLeft > 0.000001f) ? 20.0f * log10f(rmsLeft) : -100.0f;
-            float dbRight = (rmsRight > 0.000001f) ? 20.0f * log10f(rmsRight) : -100.0f;
-            arr_track_rms_values_[arrTrack] = {dbLeft, dbRight};
-        } else {
-            // No audio rendered - decay RMS
-            auto& rms = arr_track_rms_values_[arrTrack];
-            rms.first = std::max(-100.0f, rms.first - 1.0f);
-            rms.second = std::max(-100.0f, rms.second - 1.0f);
+        // Publish the levels of this arrangement track (without audio the bus lets the meter decay)
+        if (trackLevels.frames > 0 && analysis_bus_) {
+            analysis_bus_->publishLevels(arrTrack, trackLevels);
         }
     }
 }
\ No newline at end of file
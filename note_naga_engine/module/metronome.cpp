@@ -1,5 +1,6 @@
 #include <note_naga_engine/module/metronome.h>
 
+#include <algorithm>
 #include <deque>
 #include <cmath>
 #include <cstring>
@@ -31,18 +32,15 @@ void NoteNagaMetronome::render(float* left, float* right, size_t numFrames) {
     int ppq = project_->getPPQ();
     if (ppq <= 0) ppq = 480;
 
-    double us_per_qn = double(project_->getTempo());
-    double bpm = 60'000'000.0 / us_per_qn;
-    if (bpm <= 0) bpm = 120.0;
+    // Click positions follow the tempo map, so they stay on the beat under tempo automation
+    std::shared_ptr<const NoteNagaTempoMap> tempoMap = project_->getTempoMap();
 
-    double sec_per_tick = (us_per_qn / 1e6) / double(ppq);
-    double samples_per_tick = sec_per_tick * double(sampleRate_);
-
-    int ticks_per_metronome = ppq / ticksPerBeat_;
+    int ticks_per_metronome = std::max(1, ppq / ticksPerBeat_);
     int current_tick = project_->getCurrentTick();
 
     double tick_at_sample0 = double(current_tick);
-    double tick_at_sampleN = tick_at_sample0 + double(numFrames) / samples_per_tick;
+    double seconds_at_sample0 = tempoMap->ticksToSeconds(tick_at_sample0, ppq);
+    double tick_at_sampleN = tempoMap->secondsToTicks(seconds_at_sample0 + double(numFrames) / sampleRate_, ppq);
 
     int first_metro_tick = int(std::ceil(tick_at_sample0 / ticks_per_metronome)) * ticks_per_metronome;
     if (first_metro_tick < tick_at_sample0) first_metro_tick += ticks_per_metronome;
@@ -52,8 +50,8 @@ void NoteNagaMetronome::render(float* left, float* right, size_t numFrames) {
 
     // Přidej nové kliky z tohoto bloku
     for (int metro_tick = first_metro_tick; double(metro_tick) < tick_at_sampleN; metro_tick += ticks_per_metronome) {
-        double tick_offset = double(metro_tick) - tick_at_sample0;
-        int sample_offset = int(std::round(tick_offset * samples_per_tick));
+        double seconds_offset = tempoMap->ticksToSeconds(metro_tick, ppq) - seconds_at_sample0;
+        int sample_offset = int(std::round(seconds_offset * sampleRate_));
         if (sample_offset < 0 || sample_offset >= int(numFrames)) continue;
         bool accent = ((metro_tick / ticks_per_metronome) % ticksPerBeat_ == 0);
         runningClicks.push_back({sample_offset, 0, accent});
@@ -0,0 +1,532 @@
+#include <note_naga_engine/module/offline_renderer.h>
+
+#include <note_naga_engine/audio/audio_resource.h>
+#include <note_naga_engine/audio/mix_kernels.h>
+#include <note_naga_engine/core/arrangement_render_plan.h>
+#include <note_naga_engine/core/arrangement_scheduler.h>
+#include <note_naga_engine/core/runtime_data.h>
+#include <note_naga_engine/dsp/dsp_factory.h>
+#include <note_naga_engine/logger.h>
+#include <note_naga_engine/module/dsp_engine.h>
+#include <note_naga_engine/synth/synth_fluidsynth.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <unordered_map>
+
+namespace {
+
+/// Tick to sample conversion of one render (tempo map snapshot taken in prepare)
+struct TickClock {
+    std::shared_ptr<const NoteNagaTempoMap> map;
+    int ppq = 480;
+    int sample_rate = 44100;
+
+    int64_t sampleAt(int tick) const { return map->ticksToSamples(tick, ppq, sample_rate); }
+};
+
+/// Note event of one voice at an absolute sample position
+struct VoiceEvent {
+    enum class Type : uint8_t { NoteOff, NoteOn, AllNotesOff };
+    int64_t sample = 0;
+    Type type = Type::NoteOn;
+    NoteNagaTrack *track = nullptr;
+    NN_Note_t note;
+};
+
+/// Arrangement track gains of one voice over a time range (render plan segment)
+struct GainSegment {
+    int64_t start = 0;
+    int64_t end = 0;
+    bool audible = true;      ///< False when the owning arrangement track is muted or not soloed
+    float volume = 1.0f;
+    float pan_l = 1.0f;
+    float pan_r = 1.0f;
+    int64_t clip_start = 0;
+    int64_t clip_end = 0;
+    int64_t fade_in = 0;
+    int64_t fade_out = 0;
+};
+
+/// Copy a DSP block (type, active flag and parameter values) running at the given sample rate
+std::unique_ptr<NoteNagaDSPBlockBase> copyDSPBlock(NoteNagaDSPBlockBase *block, int sampleRate) {
+    const std::string name = block->getBlockName();
+    std::unique_ptr<NoteNagaDSPBlockBase> copy;
+    for (const DSPBlockFactoryEntry &entry : DSPBlockFactory::allBlocks()) {
+        if (entry.name == name) {
+            copy.reset(entry.create());
+            break;
+        }
+    }
+    if (!copy) {
+        // Some blocks report a different name than their factory entry
+        for (const DSPBlockFactoryEntry &entry : DSPBlockFactory::allBlocks()) {
+            std::unique_ptr<NoteNagaDSPBlockBase> candidate(entry.create());
+            if (candidate->getBlockName() == name) {
+                copy = std::move(candidate);
+                break;
+            }
+        }
+    }
+    if (!copy) {
+        NOTE_NAGA_LOG_WARNING("Offline render: DSP block '" + name + "' cannot be copied, skipped");
+        return nullptr;
+    }
+
+    copy->setSampleRate(static_cast<float>(sampleRate));
+    copy->setActive(block->isActive());
+    size_t numParams = block->getParamDescriptors().size();
+    for (size_t i = 0; i < numParams; ++i) {
+        copy->setParamValue(i, block->getParamValue(i));
+    }
+    return copy;
+}
+
+} // namespace
+
+/// Private copy of one synthesizer with its events and DSP chain
+struct NoteNagaOfflineRenderer::Voice {
+    std::unique_ptr<NoteNagaSynthFluidSynth> synth;
+    std::vector<std::unique_ptr<NoteNagaDSPBlockBase>> blocks;
+
+    std::vector<VoiceEvent> events; ///< Sorted by sample
+    size_t next_event = 0;
+
+    // Sequence mode: track volume and pan (NoteNagaTrack::renderAudio())
+    bool track_gain = false;
+    float gain_l = 1.0f;
+    float gain_r = 1.0f;
+
+    // Arrangement mode: arrangement track volume/pan/fades (render plan segments)
+    bool arrangement = false;
+    std::vector<GainSegment> segments;
+    size_t segment = 0;
+    int64_t fade_out_end = 0;     ///< Fade out carried past the end of the last clip
+    int64_t fade_out_samples = 0;
+
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+/// Audio clip of the arrangement with precomputed sample positions
+struct NoteNagaOfflineRenderer::ClipSource {
+    NoteNagaAudioResource *resource = nullptr;
+    std::unique_ptr<NoteNagaAudioResource::Reader> reader; ///< File handle and decode buffers of the render
+    int64_t start = 0;         ///< First output sample
+    int64_t end = 0;           ///< Output end (exclusive)
+    int64_t offset = 0;        ///< Resource sample played at start
+    int64_t length = 0;        ///< Resource length (looping)
+    bool looping = false;
+    float gain_l = 1.0f;
+    float gain_r = 1.0f;
+    int64_t fade_in = 0;
+    int64_t fade_out = 0;
+
+    std::vector<float> left;
+    std::vector<float> right;
+};
+
+NoteNagaOfflineRenderer::NoteNagaOfflineRenderer(NoteNagaRuntimeData *runtime_data, NoteNagaDSPEngine *dsp_engine,
+                                                 const NN_OfflineRenderSettings_t &settings)
+    : runtime_data_(runtime_data), dsp_engine_(dsp_engine), settings_(settings) {
+    settings_.block_size = std::max(1, settings_.block_size);
+    settings_.tail_seconds = std::max(0.0, settings_.tail_seconds);
+    if (dsp_engine_) {
+        sample_rate_ = dsp_engine_->getSampleRate();
+    }
+    pool_ = std::make_unique<NoteNagaRenderThreadPool>(settings_.num_threads);
+    mix_left_.resize(settings_.block_size);
+    mix_right_.resize(settings_.block_size);
+}
+
+NoteNagaOfflineRenderer::~NoteNagaOfflineRenderer() = default;
+
+void NoteNagaOfflineRenderer::reset() {
+    voices_.clear();
+    clips_.clear();
+    master_blocks_.clear();
+    total_frames_ = 0;
+    rendered_frames_ = 0;
+}
+
+NoteNagaOfflineRenderer::Voice *NoteNagaOfflineRenderer::addVoice(INoteNagaSoftSynth *synth) {
+    auto *fluidSynth = dynamic_cast<NoteNagaSynthFluidSynth *>(synth);
+    if (!fluidSynth) {
+        NOTE_NAGA_LOG_WARNING("Offline render: unsupported soft synthesizer skipped");
+        return nullptr;
+    }
+
+    auto voice = std::make_unique<Voice>();
+    voice->synth = std::make_unique<NoteNagaSynthFluidSynth>(fluidSynth->getName(), fluidSynth->getSoundFontPath());
+    if (!voice->synth->isValid()) {
+        NOTE_NAGA_LOG_WARNING("Offline render: synth '" + fluidSynth->getName() + "' has no SoundFont, rendered silent");
+    }
+    if (dsp_engine_ && dsp_engine_->isDSPEnabled()) {
+        for (NoteNagaDSPBlockBase *block : dsp_engine_->getSynthDSPBlocks(synth)) {
+            if (auto copy = copyDSPBlock(block, sample_rate_)) voice->blocks.push_back(std::move(copy));
+        }
+    }
+    voice->left.resize(settings_.block_size);
+    voice->right.resize(settings_.block_size);
+
+    voices_.push_back(std::move(voice));
+    return voices_.back().get();
+}
+
+void NoteNagaOfflineRenderer::copyMasterChain() {
+    if (!dsp_engine_ || !dsp_engine_->isDSPEnabled()) return;
+    for (NoteNagaDSPBlockBase *block : dsp_engine_->getDSPBlocks()) {
+        if (auto copy = copyDSPBlock(block, sample_rate_)) master_blocks_.push_back(std::move(copy));
+    }
+}
+
+bool NoteNagaOfflineRenderer::prepareSequence(NoteNagaMidiSeq *sequence) {
+    reset();
+    if (!sequence) return false;
+
+    TickClock clock{sequence->getTempoMap(), sequence->getPPQ(), sample_rate_};
+
+    NoteNagaTrack *soloTrack = sequence->getSoloTrack();
+    std::unordered_map<INoteNagaSoftSynth *, Voice *> voiceBySynth;
+    for (NoteNagaTrack *track : sequence->getTracks()) {
+        if (!track || track->isTempoTrack() || track->isMuted()) continue;
+        if (soloTrack && soloTrack != track) continue;
+        INoteNagaSoftSynth *softSynth = track->getSoftSynth();
+        if (!softSynth) continue;
+
+        Voice *voice = nullptr;
+        auto it = voiceBySynth.find(softSynth);
+        if (it != voiceBySynth.end()) {
+            voice = it->second;
+        } else {
+            voice = addVoice(softSynth);
+            if (!voice) continue;
+            voiceBySynth[softSynth] = voice;
+
+            // Same gain and pan law as NoteNagaTrack::renderAudio()
+            float gain = track->getAudioVolumeLinear();
+            float pan = track->getPanNormalized();
+            voice->track_gain = true;
+            voice->gain_l = ((pan <= 0.0f) ? 1.0f : (1.0f - pan)) * gain;
+            voice->gain_r = ((pan >= 0.0f) ? 1.0f : (1.0f + pan)) * gain;
+        }
+
+        for (const NN_Note_t &note : track->getNotesView()) {
+            if (!note.start.has_value() || !note.length.has_value()) continue;
+            VoiceEvent event;
+            event.track = track;
+            event.note = note;
+            event.note.parent = track;
+            event.type = VoiceEvent::Type::NoteOn;
+            event.sample = clock.sampleAt(note.start.value());
+            voice->events.push_back(event);
+            event.type = VoiceEvent::Type::NoteOff;
+            event.sample = clock.sampleAt(note.start.value() + note.length.value());
+            voice->events.push_back(event);
+        }
+    }
+
+    // Note offs first, a note restarted on the same sample must not be cut
+    for (auto &voice : voices_) {
+        std::stable_sort(voice->events.begin(), voice->events.end(), [](const VoiceEvent &a, const VoiceEvent &b) {
+            return a.sample != b.sample ? a.sample < b.sample : a.type < b.type;
+        });
+    }
+
+    copyMasterChain();
+    total_frames_ = clock.sampleAt(sequence->getMaxTick()) +
+                    static_cast<int64_t>(settings_.tail_seconds * sample_rate_);
+    return !voices_.empty();
+}
+
+bool NoteNagaOfflineRenderer::prepareArrangement() {
+    reset();
+    NoteNagaArrangement *arrangement = runtime_data_ ? runtime_data_->getArrangement() : nullptr;
+    if (!arrangement) return false;
+
+    arrangement->updateMaxTick();
+    TickClock clock{runtime_data_->getArrangementTempoMap(), runtime_data_->getPPQ(), sample_rate_};
+
+    bool hasSoloTrack = false;
+    for (NoteNagaArrangementTrack *arrTrack : arrangement->getTracks()) {
+        if (arrTrack && arrTrack->isSolo()) {
+            hasSoloTrack = true;
+            break;
+        }
+    }
+    auto isAudible = [hasSoloTrack](NoteNagaArrangementTrack *arrTrack) {
+        return arrTrack && !arrTrack->isMuted() && (!hasSoloTrack || arrTrack->isSolo());
+    };
+
+    // One voice per synth of the render plan, with the plan segments converted to samples
+    std::unique_ptr<NoteNagaArrangementRenderPlan> plan(NoteNagaArrangementRenderPlan::build(runtime_data_, nullptr));
+    const auto &planTracks = plan->getArrangementTracks();
+    std::unordered_map<INoteNagaSoftSynth *, Voice *> voiceBySynth;
+    for (size_t s = 0; s < plan->getSynthCount(); ++s) {
+        const NoteNagaArrangementRenderPlan::SynthEntry &entry = plan->getSynth(s);
+        Voice *voice = addVoice(entry.synth);
+        if (!voice) continue;
+        voiceBySynth[entry.synth] = voice;
+        voice->arrangement = true;
+
+        for (const NoteNagaArrangementRenderPlan::Segment &segment : entry.segments) {
+            NoteNagaArrangementTrack *arrTrack = planTracks[segment.arr_track_index];
+            GainSegment gains;
+            gains.start = clock.sampleAt(segment.start_tick);
+            gains.end = clock.sampleAt(segment.end_tick);
+            gains.audible = isAudible(arrTrack);
+            gains.volume = arrTrack ? arrTrack->getVolume() : 1.0f;
+            nn_pan_gains(arrTrack ? arrTrack->getPan() : 0.0f, gains.pan_l, gains.pan_r);
+            gains.clip_start = clock.sampleAt(segment.clip_start_tick);
+            gains.clip_end = clock.sampleAt(segment.clip_end_tick);
+            gains.fade_in = clock.sampleAt(segment.clip_start_tick + segment.fade_in_ticks) - gains.clip_start;
+            gains.fade_out = gains.clip_end - clock.sampleAt(segment.clip_end_tick - segment.fade_out_ticks);
+            voice->segments.push_back(gains);
+        }
+    }
+
+    // Note events from the same compiled timeline the playback thread uses
+    NoteNagaArrangementScheduler scheduler(runtime_data_);
+    scheduler.update(true);
+    const auto &schedulerTracks = scheduler.getArrangementTracks();
+    auto pushEvent = [&](NoteNagaTrack *track, VoiceEvent::Type type, const NN_Note_t &note, int64_t sample) {
+        auto it = voiceBySynth.find(track->getSoftSynth());
+        if (it == voiceBySynth.end()) return;
+        VoiceEvent event;
+        event.sample = sample;
+        event.type = type;
+        event.track = track;
+        event.note = note;
+        it->second->events.push_back(event);
+    };
+    scheduler.dispatch(-1, std::numeric_limits<int>::max(), [&](const NN_ArrangementEvent_t &ev) {
+        if (!isAudible(schedulerTracks[ev.arr_track_index])) return;
+        int64_t sample = clock.sampleAt(ev.tick);
+        switch (ev.type) {
+        case NN_ArrangementEventType_t::StopSequence:
+            for (NoteNagaTrack *midiTrack : ev.sequence->getTracks()) {
+                if (midiTrack) pushEvent(midiTrack, VoiceEvent::Type::AllNotesOff, NN_Note_t(), sample);
+            }
+            break;
+        case NN_ArrangementEventType_t::NoteOn:
+            if (!ev.midi_track->isMuted()) pushEvent(ev.midi_track, VoiceEvent::Type::NoteOn, ev.note, sample);
+            break;
+        case NN_ArrangementEventType_t::NoteOff:
+            if (!ev.midi_track->isMuted()) pushEvent(ev.midi_track, VoiceEvent::Type::NoteOff, ev.note, sample);
+            break;
+        }
+    });
+
+    // Audio clips
+    NoteNagaAudioManager &audioManager = runtime_data_->getAudioManager();
+    for (NoteNagaArrangementTrack *arrTrack : arrangement->getTracks()) {
+        if (!isAudible(arrTrack)) continue;
+        float panL = 1.0f, panR = 1.0f;
+        nn_pan_gains(arrTrack->getPan(), panL, panR);
+
+        for (const NN_AudioClip_t &clip : arrTrack->getAudioClips()) {
+            if (clip.muted) continue;
+            NoteNagaAudioResource *resource = audioManager.getResource(clip.audioResourceId);
+            if (!resource || !resource->isLoaded()) continue;
+
+            auto source = std::make_unique<ClipSource>();
+            source->resource = resource;
+            source->reader = std::make_unique<NoteNagaAudioResource::Reader>(resource);
+            source->start = clock.sampleAt(clip.startTick);
+            source->end = clock.sampleAt(clip.startTick + clip.durationTicks);
+            source->offset = clip.offsetSamples + (source->start - clock.sampleAt(clip.startTick - clip.offsetTicks));
+            source->length = resource->getTotalSamples();
+            source->looping = clip.looping;
+            source->gain_l = clip.gain * arrTrack->getVolume() * panL;
+            source->gain_r = clip.gain * arrTrack->getVolume() * panR;
+            source->fade_in = clock.sampleAt(clip.startTick + clip.fadeInTicks) - source->start;
+            source->fade_out = source->end - clock.sampleAt(clip.startTick + clip.durationTicks - clip.fadeOutTicks);
+            source->left.resize(settings_.block_size);
+            source->right.resize(settings_.block_size);
+            clips_.push_back(std::move(source));
+        }
+    }
+
+    copyMasterChain();
+    total_frames_ = clock.sampleAt(arrangement->getMaxTick()) +
+                    static_cast<int64_t>(settings_.tail_seconds * sample_rate_);
+    return !voices_.empty() || !clips_.empty();
+}
+
+int64_t NoteNagaOfflineRenderer::render(float *output, int64_t max_frames) {
+    int64_t frames = std::min(max_frames, total_frames_ - rendered_frames_);
+    if (frames <= 0) return 0;
+
+    int64_t done = 0;
+    while (done < frames) {
+        size_t blockFrames = static_cast<size_t>(std::min<int64_t>(settings_.block_size, frames - done));
+        renderBlock(rendered_frames_, blockFrames);
+
+        nn_interleave(output + done * 2, mix_left_.data(), mix_right_.data(), blockFrames);
+        rendered_frames_ += static_cast<int64_t>(blockFrames);
+        done += static_cast<int64_t>(blockFrames);
+    }
+    return frames;
+}
+
+void NoteNagaOfflineRenderer::renderBlock(int64_t block_start, size_t num_frames) {
+    // Every voice and clip renders into its own buffers, the mix is summed in a fixed order
+    const size_t voiceCount = voices_.size();
+    pool_->run(voiceCount + clips_.size(), [&](size_t j) {
+        if (j < voiceCount) {
+            renderVoice(*voices_[j], block_start, num_frames);
+        } else {
+            renderClip(*clips_[j - voiceCount], block_start, num_frames);
+        }
+    });
+
+    std::fill(mix_left_.begin(), mix_left_.begin() + num_frames, 0.0f);
+    std::fill(mix_right_.begin(), mix_right_.begin() + num_frames, 0.0f);
+    auto addToMix = [&](const std::vector<float> &left, const std::vector<float> &right) {
+        nn_mix_add(mix_left_.data(), left.data(), num_frames);
+        nn_mix_add(mix_right_.data(), right.data(), num_frames);
+    };
+    for (const auto &voice : voices_) addToMix(voice->left, voice->right);
+    for (const auto &clip : clips_) addToMix(clip->left, clip->right);
+
+    for (const auto &block : master_blocks_) {
+        if (block->isActive()) {
+            block->process(mix_left_.data(), mix_right_.data(), num_frames);
+        }
+    }
+}
+
+void NoteNagaOfflineRenderer::renderVoice(Voice &voice, int64_t block_start, size_t num_frames) {
+    float *left = voice.left.data();
+    float *right = voice.right.data();
+
+    // Split the synth render at the exact sample of every event in this block
+    const int64_t blockEnd = block_start + static_cast<int64_t>(num_frames);
+    size_t pos = 0;
+    while (voice.next_event < voice.events.size() && voice.events[voice.next_event].sample < blockEnd) {
+        const VoiceEvent &event = voice.events[voice.next_event++];
+        size_t offset = event.sample > block_start ? static_cast<size_t>(event.sample - block_start) : 0;
+        if (offset > pos) {
+            voice.synth->renderAudio(left + pos, right + pos, offset - pos);
+            pos = offset;
+        }
+        switch (event.type) {
+        case VoiceEvent::Type::NoteOn:
+            voice.synth->playNote(event.note, event.track->getChannel().value_or(0), 0.0f);
+            break;
+        case VoiceEvent::Type::NoteOff:
+            voice.synth->stopNote(event.note);
+            break;
+        case VoiceEvent::Type::AllNotesOff:
+            voice.synth->stopAllNotes(nullptr, event.track);
+            break;
+        }
+    }
+    if (pos < num_frames) {
+        voice.synth->renderAudio(left + pos, right + pos, num_frames - pos);
+    }
+
+    if (voice.track_gain) {
+        for (size_t i = 0; i < num_frames; ++i) {
+            float mono = (left[i] + right[i]) * 0.5f;
+            left[i] = mono * voice.gain_l;
+            right[i] = mono * voice.gain_r;
+        }
+    }
+
+    for (const auto &block : voice.blocks) {
+        if (block->isActive()) {
+            block->process(left, right, num_frames);
+        }
+    }
+
+    if (!voice.arrangement) return;
+
+    // Arrangement track volume, pan crossfeed and clip fades (same law as the live mix)
+    float centerL = 1.0f, centerR = 1.0f;
+    nn_pan_gains(0.0f, centerL, centerR);
+    for (size_t i = 0; i < num_frames; ++i) {
+        const int64_t sample = block_start + static_cast<int64_t>(i);
+        while (voice.segment < voice.segments.size() && voice.segments[voice.segment].end <= sample) {
+            ++voice.segment;
+        }
+        const GainSegment *segment = (voice.segment < voice.segments.size() &&
+                                      voice.segments[voice.segment].start <= sample)
+                                         ? &voice.segments[voice.segment]
+                                         : nullptr;
+
+        float volume = 1.0f;
+        float panL = centerL;
+        float panR = centerR;
+        float fadeGain = 1.0f;
+        int64_t fadeOutEnd = voice.fade_out_end;
+        int64_t fadeOutSamples = voice.fade_out_samples;
+        if (segment) {
+            if (!segment->audible) {
+                left[i] = 0.0f;
+                right[i] = 0.0f;
+                continue;
+            }
+            volume = segment->volume;
+            panL = segment->pan_l;
+            panR = segment->pan_r;
+            if (segment->fade_in > 0 && sample < segment->clip_start + segment->fade_in) {
+                fadeGain = std::clamp(static_cast<float>(sample - segment->clip_start) /
+                                          static_cast<float>(segment->fade_in), 0.0f, 1.0f);
+            }
+            if (segment->fade_out > 0) {
+                voice.fade_out_end = segment->clip_end;
+                voice.fade_out_samples = segment->fade_out;
+            }
+            fadeOutEnd = segment->clip_end;
+            fadeOutSamples = segment->fade_out;
+        }
+        // Fade out, continued after the clip end for note releases
+        if (fadeOutSamples > 0 && sample >= fadeOutEnd - fadeOutSamples) {
+            fadeGain *= std::clamp(static_cast<float>(fadeOutEnd - sample) / static_cast<float>(fadeOutSamples),
+                                   0.0f, 1.0f);
+        }
+
+        float srcL = left[i] * volume * fadeGain;
+        float srcR = right[i] * volume * fadeGain;
+        left[i] = srcL * panL + srcR * (1.0f - panR);
+        right[i] = srcR * panR + srcL * (1.0f - panL);
+    }
+}
+
+void NoteNagaOfflineRenderer::renderClip(ClipSource &clip, int64_t block_start, size_t num_frames) {
+    float *left = clip.left.data();
+    float *right = clip.right.data();
+    std::fill(left, left + num_frames, 0.0f);
+    std::fill(right, right + num_frames, 0.0f);
+
+    const int64_t from = std::max(block_start, clip.start);
+    const int64_t to = std::min(block_start + static_cast<int64_t>(num_frames), clip.end);
+    if (to <= from) return;
+
+    // Read the overlapping range, looped clips wrap around the end of the resource
+    int64_t pos = from;
+    while (pos < to) {
+        int64_t source = clip.offset + (pos - clip.start);
+        if (clip.looping && clip.length > 0) source %= clip.length;
+        size_t index = static_cast<size_t>(pos - block_start);
+        int64_t got = clip.reader->read(source, to - pos, left + index, right + index);
+        if (got <= 0) break;
+        pos += got;
+    }
+
+    const int64_t fadeOutStart = clip.end - clip.fade_out;
+    for (int64_t sample = from; sample < to; ++sample) {
+        size_t i = static_cast<size_t>(sample - block_start);
+        float fadeGain = 1.0f;
+        if (clip.fade_in > 0 && sample < clip.start + clip.fade_in) {
+            fadeGain = std::clamp(static_cast<float>(sample - clip.start) / static_cast<float>(clip.fade_in), 0.0f, 1.0f);
+        }
+        if (clip.fade_out > 0 && sample >= fadeOutStart) {
+            fadeGain *= std::clamp(static_cast<float>(clip.end - sample) / static_cast<float>(clip.fade_out), 0.0f, 1.0f);
+        }
+        left[i] *= clip.gain_l * fadeGain;
+        right[i] *= clip.gain_r * fadeGain;
+    }
+}
@@ -1,52 +1,46 @@
 #include <note_naga_engine/module/pan_analyzer.h>
 
+#include <note_naga_engine/module/analysis_bus.h>
+
 #include <algorithm>
 #include <cmath>
 #include <numeric>
 
 NoteNagaPanAnalyzer::NoteNagaPanAnalyzer(size_t buffer_size)
-    : buffer_size_(buffer_size),
-      left_buffer_(buffer_size, 0.0f),
-      right_buffer_(buffer_size, 0.0f)
+    : buffer_size_(std::clamp<size_t>(buffer_size, 16, NoteNagaAnalysisBus::kSampleRingSize / 2)),
+      left_buffer_(buffer_size_, 0.0f),
+      right_buffer_(buffer_size_, 0.0f)
 {
     pan_data_.segments.fill(0.0f);
     pan_data_.leftRms = 0.0f;
     pan_data_.rightRms = 0.0f;
     pan_data_.pan = 0.0f;
+    published_data_.store(pan_data_);
 }
 
-void NoteNagaPanAnalyzer::pushSamplesToLeftBuffer(float *samples, size_t num_samples) {
-    if (!enabled_) return;
-
-    size_t to_copy = std::min(num_samples, buffer_size_ - left_pos_);
-    std::copy(samples, samples + to_copy, left_buffer_.begin() + left_pos_);
-    left_pos_ += to_copy;
-
-    // Trigger processing when both buffers are full
-    if (left_pos_ >= buffer_size_ && right_pos_ >= buffer_size_) {
-        left_pos_ = 0;
-        right_pos_ = 0;
-        this->pushToQueue(NN_AsyncTriggerMessage_t{});
+void NoteNagaPanAnalyzer::process(const NoteNagaAnalysisBus &bus) {
+    const uint64_t written = bus.getSampleWritePosition();
+    if (!isEnabled()) {
+        read_pos_ = written;
+        return;
     }
-}
 
-void NoteNagaPanAnalyzer::pushSamplesToRightBuffer(float *samples, size_t num_samples) {
-    if (!enabled_) return;
-    
-    size_t to_copy = std::min(num_samples, buffer_size_ - right_pos_);
-    std::copy(samples, samples + to_copy, right_buffer_.begin() + right_pos_);
-    right_pos_ += to_copy;
+    // Fell behind (or just enabled): continue with the newest complete block
+    if (written - read_pos_ > NoteNagaAnalysisBus::kSampleRingSize - buffer_size_) {
+        read_pos_ = written - std::min<uint64_t>(written, buffer_size_);
+    }
 
-    // Trigger processing when both buffers are full
-    if (left_pos_ >= buffer_size_ && right_pos_ >= buffer_size_) {
-        left_pos_ = 0;
-        right_pos_ = 0;
-        this->pushToQueue(NN_AsyncTriggerMessage_t{});
+    bool updated = false;
+    while (written - read_pos_ >= buffer_size_) {
+        if (bus.readSamples(read_pos_, buffer_size_, left_buffer_.data(), right_buffer_.data())) {
+            processBuffers();
+            updated = true;
+        }
+        read_pos_ += buffer_size_;
     }
-}
+    if (!updated) return;
 
-void NoteNagaPanAnalyzer::onItem(const NN_AsyncTriggerMessage_t &) {
-    processBuffers();
+    published_data_.store(pan_data_);
     NN_QT_EMIT(panDataUpdated(pan_data_));
 }
 
@@ -112,17 +106,12 @@ void NoteNagaPanAnalyzer::processBuffers() {
     }
     
     // Apply smoothing/decay to existing data
-    {
-        std::lock_guard<std::mutex> lock(data_mutex_);
-        
-        // Smooth transition
-        const float smoothing = 0.3f;
-        for (int i = 0; i < PAN_NUM_SEGMENTS; ++i) {
-            pan_data_.segments[i] = pan_data_.segments[i] * (1.0f - smoothing) + segments[i] * smoothing;
-        }
-        
-        pan_data_.leftRms = pan_data_.leftRms * (1.0f - smoothing) + leftRms * smoothing;
-        pan_data_.rightRms = pan_data_.rightRms * (1.0f - smoothing) + rightRms * smoothing;
-        pan_data_.pan = pan_data_.pan * (1.0f - smoothing) + pan * smoothing;
+    const float smoothing = 0.3f;
+    for (int i = 0; i < PAN_NUM_SEGMENTS; ++i) {
+        pan_data_.segments[i] = pan_data_.segments[i] * (1.0f - smoothing) + segments[i] * smoothing;
     }
+    
+    pan_data_.leftRms = pan_data_.leftRms * (1.0f - smoothing) + leftRms * smoothing;
+    pan_data_.rightRms = pan_data_.rightRms * (1.0f - smoothing) + rightRms * smoothing;
+    pan_data_.pan = pan_data_.pan * (1.0f - smoothing) + pan * smoothing;
 }
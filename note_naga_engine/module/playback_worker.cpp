@@ -3,8 +3,8 @@
 #include <note_naga_engine/module/external_midi_router.h>
 
 #include <algorithm>
+#include <cmath>
 #include <map>
-#include <unordered_map>
 #include <note_naga_engine/logger.h>
 
 /*******************************************************************************************************/
@@ -22,10 +22,42 @@ NoteNagaPlaybackWorker::NoteNagaPlaybackWorker(NoteNagaRuntimeData *project,
     this->last_id = 0;
     this->pending_cleanup = false;
     this->playback_mode_ = PlaybackMode::Sequence;
+    this->arrangement_scheduler_ = new NoteNagaArrangementScheduler(project);
+
+#ifndef QT_DEACTIVATED
+    // Changes the scheduler cannot detect by polling clips and note revisions
+    if (project) {
+        NoteNagaArrangementScheduler *scheduler = this->arrangement_scheduler_;
+        connect(project, &NoteNagaRuntimeData::sequenceListChanged, this,
+                [scheduler]() { scheduler->invalidateAll(); }, Qt::DirectConnection);
+        connect(project, &NoteNagaRuntimeData::activeSequenceTrackListChanged, this,
+                [scheduler](NoteNagaMidiSeq *seq) {
+                    if (seq) scheduler->invalidateSequence(seq->getId());
+                }, Qt::DirectConnection);
+        connect(project, &NoteNagaRuntimeData::trackMetaChanged, this,
+                [scheduler](NoteNagaTrack *track, const std::string &param) {
+                    if (param == "is_tempo_track" && track && track->getParent())
+                        scheduler->invalidateSequence(track->getParent()->getId());
+                }, Qt::DirectConnection);
+    }
+#endif
+
     NOTE_NAGA_LOG_INFO("Initialized successfully with timer interval: " +
                        std::to_string(timer_interval_ms) + " ms");
 }
 
+NoteNagaPlaybackWorker::~NoteNagaPlaybackWorker() {
+    should_stop = true;
+    if (worker) worker->stop();
+    if (worker_thread.joinable()) worker_thread.join();
+    if (worker) {
+        delete worker;
+        worker = nullptr;
+    }
+    delete arrangement_scheduler_;
+    arrangement_scheduler_ = nullptr;
+}
+
 NoteNagaPlaybackWorker::CallbackId NoteNagaPlaybackWorker::addFinishedCallback(FinishedCallback cb) {
     CallbackId id = ++last_id;
     finished_callbacks.emplace_back(id, std::move(cb));
@@ -135,6 +167,7 @@ bool NoteNagaPlaybackWorker::play() {
     worker->enableLooping(this->looping);
     worker->setDSPEngine(this->dsp_engine_);
     worker->setExternalMidiRouter(this->external_midi_router_);
+    worker->setArrangementScheduler(this->arrangement_scheduler_);
 
     // Forward events from thread worker to this worker
     worker->addPositionChangedCallback([this](int tick) { emitPositionChanged(tick); });
@@ -151,6 +184,7 @@ bool NoteNagaPlaybackWorker::play() {
     
     // Enable audio clip rendering in DSP engine
     if (dsp_engine_ && playback_mode_ == PlaybackMode::Arrangement) {
+        dsp_engine_->rebuildArrangementRenderPlan();
         dsp_engine_->setAudioPlaybackActive(true);
     }
 
@@ -302,6 +336,175 @@ void PlaybackThreadWorker::removeNotePlayedCallback(CallbackId id) {
 
 void PlaybackThreadWorker::stop() { should_stop = true; }
 
+/*******************************************************************************************************/
+// Playback Thread Worker - MIDI scheduling
+/*******************************************************************************************************/
+
+/// Audio clock stall after which playback falls back to the wall clock
+static constexpr double kAudioClockTimeoutMs = 250.0;
+
+void PlaybackThreadWorker::beginMidiScheduling() {
+    sample_accurate_ = dsp_engine_ && dsp_engine_->isSampleAccurateMidi();
+    pending_external_notes_.clear();
+    if (sample_accurate_) {
+        dsp_engine_->flushScheduledMidiEvents();
+        audio_clock_last_ = dsp_engine_->getRenderedSampleTime();
+        audio_clock_changed_ = std::chrono::high_resolution_clock::now();
+        schedule_anchor_sample_ = audio_clock_last_;
+        NOTE_NAGA_LOG_INFO("Sample-accurate MIDI scheduling enabled");
+    }
+}
+
+double PlaybackThreadWorker::elapsedPlaybackMs(double wall_elapsed_ms) {
+    if (!sample_accurate_) return wall_elapsed_ms;
+
+    auto now = std::chrono::high_resolution_clock::now();
+    int64_t audioNow = dsp_engine_->getRenderedSampleTime();
+    if (audioNow == audio_clock_last_) {
+        double stalledMs = std::chrono::duration<double, std::milli>(now - audio_clock_changed_).count();
+        if (stalledMs > kAudioClockTimeoutMs) {
+            // Audio is not rendering, queued notes would never play
+            NOTE_NAGA_LOG_WARNING("Audio clock stopped, falling back to timer-driven MIDI scheduling");
+            flushScheduledNotes();
+            sample_accurate_ = false;
+            return wall_elapsed_ms;
+        }
+        return 0.0;
+    }
+
+    double elapsedMs = static_cast<double>(audioNow - audio_clock_last_) * 1000.0 / dsp_engine_->getSampleRate();
+    audio_clock_last_ = audioNow;
+    audio_clock_changed_ = now;
+    firePendingExternalNotes();
+    return elapsedMs;
+}
+
+void PlaybackThreadWorker::anchorSchedule(double position_ticks, double ms_per_tick) {
+    if (!sample_accurate_) return;
+    schedule_anchor_sample_ = audio_clock_last_;
+    schedule_anchor_tick_ = position_ticks;
+    samples_per_tick_ = ms_per_tick * dsp_engine_->getSampleRate() / 1000.0;
+}
+
+int PlaybackThreadWorker::scheduleWindowEnd(int current_tick, double ms_per_tick) const {
+    if (!sample_accurate_ || ms_per_tick <= 0.0) return current_tick;
+    // Notes must be queued before the audio block containing them is rendered:
+    // cover two worker periods plus one audio block
+    double lookaheadMs = timer_interval * 2000.0 + 20.0;
+    return current_tick + static_cast<int>(std::ceil(lookaheadMs / ms_per_tick));
+}
+
+void PlaybackThreadWorker::routePlayNote(NoteNagaTrack *track, const NN_Note_t &note, int tick,
+                                         NoteNagaArrangementTrack *arr_track) {
+    // Only soft synths render on the audio clock, other synths (external MIDI) are played here
+    if (sample_accurate_ && track->getSoftSynth()) {
+        NN_ScheduledMidiEvent_t event;
+        event.sample_time = schedule_anchor_sample_ +
+                            std::llround((tick - schedule_anchor_tick_) * samples_per_tick_);
+        event.type = NN_ScheduledMidiEvent_t::Type::NoteOn;
+        event.track = track;
+        event.setNote(note);
+        if (dsp_engine_->scheduleMidiEvent(event)) {
+            if (external_midi_router_) {
+                queueExternalNote({event.sample_time, true, note, track, arr_track});
+            }
+            return;
+        }
+        // Queue full, play immediately
+    }
+
+    track->playNote(note);
+    if (external_midi_router_) {
+        if (arr_track) {
+            external_midi_router_->playNoteForArrangement(note, arr_track);
+        } else {
+            external_midi_router_->playNote(note, track);
+        }
+    }
+}
+
+void PlaybackThreadWorker::routeStopNote(NoteNagaTrack *track, const NN_Note_t &note, int tick,
+                                         NoteNagaArrangementTrack *arr_track) {
+    if (sample_accurate_ && track->getSoftSynth()) {
+        NN_ScheduledMidiEvent_t event;
+        event.sample_time = schedule_anchor_sample_ +
+                            std::llround((tick - schedule_anchor_tick_) * samples_per_tick_);
+        event.type = NN_ScheduledMidiEvent_t::Type::NoteOff;
+        event.track = track;
+        event.setNote(note);
+        if (dsp_engine_->scheduleMidiEvent(event)) {
+            if (external_midi_router_) {
+                queueExternalNote({event.sample_time, false, note, track, arr_track});
+            }
+            return;
+        }
+    }
+
+    track->stopNote(note);
+    if (external_midi_router_) {
+        if (arr_track) {
+            external_midi_router_->stopNoteForArrangement(note, arr_track);
+        } else {
+            external_midi_router_->stopNote(note, track);
+        }
+    }
+}
+
+void PlaybackThreadWorker::routeStopAllNotes(NoteNagaTrack *track, int tick) {
+    if (!track || track->isTempoTrack()) return;
+    if (sample_accurate_ && track->getSoftSynth()) {
+        NN_ScheduledMidiEvent_t event;
+        event.sample_time = (tick < 0) ? 0
+                                       : schedule_anchor_sample_ +
+                                             std::llround((tick - schedule_anchor_tick_) * samples_per_tick_);
+        event.type = NN_ScheduledMidiEvent_t::Type::AllNotesOff;
+        event.track = track;
+        if (dsp_engine_->scheduleMidiEvent(event)) return;
+    }
+    track->stopAllNotes();
+}
+
+void PlaybackThreadWorker::flushScheduledNotes() {
+    if (!sample_accurate_) return;
+    dsp_engine_->flushScheduledMidiEvents();
+    for (const PendingExternalNote &pending : pending_external_notes_) {
+        if (pending.play || !external_midi_router_) continue;
+        if (pending.arr_track) {
+            external_midi_router_->stopNoteForArrangement(pending.note, pending.arr_track);
+        } else {
+            external_midi_router_->stopNote(pending.note, pending.track);
+        }
+    }
+    pending_external_notes_.clear();
+}
+
+void PlaybackThreadWorker::queueExternalNote(const PendingExternalNote &pending) {
+    auto it = std::upper_bound(pending_external_notes_.begin(), pending_external_notes_.end(), pending.sample_time,
+                               [](int64_t t, const PendingExternalNote &p) { return t < p.sample_time; });
+    pending_external_notes_.insert(it, pending);
+}
+
+void PlaybackThreadWorker::firePendingExternalNotes() {
+    while (!pending_external_notes_.empty() &&
+           pending_external_notes_.front().sample_time <= audio_clock_last_) {
+        const PendingExternalNote &pending = pending_external_notes_.front();
+        if (external_midi_router_) {
+            if (pending.play) {
+                if (pending.arr_track) {
+                    external_midi_router_->playNoteForArrangement(pending.note, pending.arr_track);
+                } else {
+                    external_midi_router_->playNote(pending.note, pending.track);
+                }
+            } else if (pending.arr_track) {
+                external_midi_router_->stopNoteForArrangement(pending.note, pending.arr_track);
+            } else {
+                external_midi_router_->stopNote(pending.note, pending.track);
+            }
+        }
+        pending_external_notes_.pop_front();
+    }
+}
+
 void PlaybackThreadWorker::run() {
     if (playback_mode_ == PlaybackMode::Arrangement) {
         runArrangementMode();
@@ -319,10 +522,9 @@ void PlaybackThreadWorker::runSequenceMode() {
     }
 
     // Stop all notes on all tracks
+    beginMidiScheduling();
     for (auto* track : active_sequence->getTracks()) {
-        if (track && !track->isTempoTrack()) {
-            track->stopAllNotes();
-        }
+        routeStopAllNotes(track);
     }
 
     // Ensure we start from a valid tick
@@ -335,19 +537,27 @@ void PlaybackThreadWorker::runSequenceMode() {
     int current_tick = this->project->getCurrentTick();
     recalculateTempo();
 
-    // start and end indices for each track
-    std::unordered_map<NoteNagaTrack*, size_t> trackNoteStartIndex;
-    for (auto* track : active_sequence->getTracks()) trackNoteStartIndex[track] = 0;
+    // Note events of one iteration, routed in tick order
+    struct WindowEvent {
+        int tick;
+        bool play;
+        NoteNagaTrack *track;
+        const NN_Note_t *note;
+    };
+    std::vector<WindowEvent> windowEvents;
+    std::vector<NN_Note_t> windowNotes; // Backing storage of WindowEvent::note (per track copy)
+    int dispatched_tick = current_tick - 1; // Sample-accurate mode: last tick already queued
 
     using clock = std::chrono::high_resolution_clock;
     auto last_iteration_time = clock::now();
     double fractional_ticks = 0.0;  // Accumulate fractional tick advances
     
     while (!should_stop) {
-        // Calculate time since last iteration
+        // Calculate time since last iteration (audio clock in sample-accurate mode)
         auto now = clock::now();
         double elapsed_ms = std::chrono::duration<double, std::milli>(now - last_iteration_time).count();
         last_iteration_time = now;
+        elapsed_ms = elapsedPlaybackMs(elapsed_ms);
         
         // Get current tempo (supports dynamic tempo from tempo track)
         int effectiveTempo;
@@ -389,41 +599,46 @@ void PlaybackThreadWorker::runSequenceMode() {
             if (!this->looping) this->should_stop = true;
         }
 
-        // Helper lambda to process notes for a track
+        // Notes to process: (last_tick, current_tick] when played immediately, up to the
+        // lookahead when queued on the audio clock
+        anchorSchedule(current_tick + fractional_ticks, current_ms_per_tick);
+        int note_on_from = last_tick;  // inclusive (catches notes at position 0)
+        int note_off_after = last_tick;
+        int dispatch_to = current_tick;
+        if (sample_accurate_) {
+            dispatch_to = std::min(scheduleWindowEnd(current_tick, current_ms_per_tick),
+                                   active_sequence->getMaxTick());
+            note_on_from = dispatched_tick + 1;
+            note_off_after = dispatched_tick;
+            dispatched_tick = std::max(dispatched_tick, dispatch_to);
+        }
+
+        // Helper lambda to collect notes of a track
+        windowEvents.clear();
+        windowNotes.clear();
         auto processTrackNotes = [&, this](NoteNagaTrack* track) {
             if (!track || track->isMuted() || track->isTempoTrack()) return;
             
-            size_t& index = trackNoteStartIndex[track];
-            index = (index > 10) ? index - 10 : 0; // Start 10 before the last processed note
-
-            const std::vector<NN_Note_t>& notes = track->getNotes();
-            for (; index < notes.size(); ++index) {
-                const NN_Note_t& note = notes[index];
-                if (!note.start.has_value() || !note.length.has_value())
-                    continue;
-
-                // Note ON (use <= for first tick to catch notes at position 0)
-                if (last_tick <= note.start.value() && note.start.value() <= current_tick) {
-                    track->playNote(note);
-                    // Also route to external MIDI if configured
-                    if (external_midi_router_) {
-                        external_midi_router_->playNote(note, track);
-                    }
-                    emitNotePlayed(note);
+            // Column snapshot sorted by start: only notes starting in the window or
+            // ending in it (start no earlier than max_length before it) are visited
+            std::shared_ptr<const NN_NoteColumns_t> columns = track->getNoteColumns();
+            const NN_NoteColumns_t &c = *columns;
+            int scan_from = std::min(note_on_from, note_off_after + 1 - c.max_length);
+            size_t end = c.upperBound(dispatch_to);
+            for (size_t row = c.lowerBound(scan_from); row < end; ++row) {
+                const int start = c.start[row];
+                const int note_end = start + c.length[row];
+
+                // Note ON
+                if (note_on_from <= start) {
+                    windowNotes.push_back(c.toNote(row, track));
+                    windowEvents.push_back({start, true, track, nullptr});
                 }
                 // Note OFF
-                int note_end = note.start.value() + note.length.value();
-                if (last_tick < note_end && note_end <= current_tick) {
-                    track->stopNote(note);
-                    // Also stop on external MIDI if configured
-                    if (external_midi_router_) {
-                        external_midi_router_->stopNote(note, track);
-                    }
+                if (note_off_after < note_end && note_end <= dispatch_to) {
+                    windowNotes.push_back(c.toNote(row, track));
+                    windowEvents.push_back({note_end, false, track, nullptr});
                 }
-
-                // If the note starts after the current tick, we can stop checking
-                if (note.start.value() > current_tick)
-                    break;
             }
         };
 
@@ -437,18 +652,30 @@ void PlaybackThreadWorker::runSequenceMode() {
             }
         }
 
+        // Route collected notes in tick order (the audio clock queue must be time ordered)
+        for (size_t e = 0; e < windowEvents.size(); ++e) windowEvents[e].note = &windowNotes[e];
+        std::stable_sort(windowEvents.begin(), windowEvents.end(),
+                         [](const WindowEvent &a, const WindowEvent &b) { return a.tick < b.tick; });
+        for (const WindowEvent &ev : windowEvents) {
+            if (ev.play) {
+                routePlayNote(ev.track, *ev.note, ev.tick, nullptr);
+                emitNotePlayed(*ev.note);
+            } else {
+                routeStopNote(ev.track, *ev.note, ev.tick, nullptr);
+            }
+        }
+
         // Looping if enabled
         if (this->looping && current_tick >= active_sequence->getMaxTick()) {
             // Stop all notes before looping
+            flushScheduledNotes();
             for (auto* track : active_sequence->getTracks()) {
-                if (track && !track->isTempoTrack()) {
-                    track->stopAllNotes();
-                }
+                routeStopAllNotes(track);
             }
             current_tick = 0; // Loop back to start
+            dispatched_tick = -1;
             this->project->setCurrentTick(current_tick);
             recalculateTempo();
-            for (auto* track : active_sequence->getTracks()) trackNoteStartIndex[track] = 0;
             NOTE_NAGA_LOG_INFO("Reached max tick, looping back to start");
         }
 
@@ -459,10 +686,9 @@ void PlaybackThreadWorker::runSequenceMode() {
     }
 
     // Stop all notes on finish
+    flushScheduledNotes();
     for (auto* track : active_sequence->getTracks()) {
-        if (track && !track->isTempoTrack()) {
-            track->stopAllNotes();
-        }
+        routeStopAllNotes(track);
     }
 
     NOTE_NAGA_LOG_INFO("Playback thread finished (Sequence mode)");
@@ -486,11 +712,10 @@ void PlaybackThreadWorker::runArrangementMode() {
     }
 
     // Stop all notes on all sequences
+    beginMidiScheduling();
     for (auto* seq : this->project->getSequences()) {
         for (auto* track : seq->getTracks()) {
-            if (track && !track->isTempoTrack()) {
-                track->stopAllNotes();
-            }
+            routeStopAllNotes(track);
         }
     }
 
@@ -503,11 +728,11 @@ void PlaybackThreadWorker::runArrangementMode() {
 
     // Get project settings
     int projectPPQ = this->project->getPPQ();
-    int projectTempo = this->project->getProjectTempo();
+    std::shared_ptr<const NoteNagaTempoMap> tempoMap = this->project->getArrangementTempoMap();
     
     // Synchronize audio sample position with tick position
     if (dsp_engine_) {
-        int64_t startSamplePos = dsp_engine_->tickToSamples(current_tick, projectTempo, projectPPQ);
+        int64_t startSamplePos = dsp_engine_->tickToSamples(current_tick, *tempoMap, projectPPQ);
         dsp_engine_->setAudioSamplePosition(startSamplePos);
     }
     
@@ -515,9 +740,10 @@ void PlaybackThreadWorker::runArrangementMode() {
     // Look ahead by 5 seconds worth of ticks to preload audio that will play soon
     {
         NoteNagaAudioManager& audioManager = this->project->getAudioManager();
-        double usPerTick = static_cast<double>(projectTempo) / projectPPQ;
-        int64_t lookAheadTicks = static_cast<int64_t>(5.0 * 1'000'000.0 / usPerTick);  // 5 seconds ahead
-        int64_t lookAheadEnd = current_tick + lookAheadTicks;
+        audioManager.resetUnderrunStats();
+        const int sampleRate = audioManager.getSampleRate();
+        double startSeconds = tempoMap->ticksToSeconds(current_tick, projectPPQ);
+        int64_t lookAheadEnd = static_cast<int64_t>(tempoMap->secondsToTicks(startSeconds + 5.0, projectPPQ));  // 5 seconds ahead
         
         for (size_t trackIdx = 0; trackIdx < arrangement->getTrackCount(); ++trackIdx) {
             NoteNagaArrangementTrack* arrTrack = arrangement->getTracks()[trackIdx];
@@ -532,15 +758,15 @@ void PlaybackThreadWorker::runArrangementMode() {
                     if (resource && resource->isLoaded()) {
                         // Calculate the sample position this clip will start reading from
                         // Taking into account offsetTicks for trimmed clips
-                        double tickToSecond = usPerTick / 1'000'000.0;
-                        int64_t clipOffsetSamples = clip.offsetSamples + 
-                            static_cast<int64_t>(clip.offsetTicks * tickToSecond * audioManager.getSampleRate());
+                        // (same conversion as NoteNagaDSPEngine::renderAudioClips())
+                        int64_t clipStartSample = tempoMap->ticksToSamples(clip.startTick, projectPPQ, sampleRate);
+                        int64_t clipOffsetSamples = clip.offsetSamples + clipStartSample -
+                            tempoMap->ticksToSamples(clip.startTick - clip.offsetTicks, projectPPQ, sampleRate);
                         
                         // If playback position is inside clip, calculate actual read position
                         if (current_tick >= clip.startTick) {
-                            int64_t ticksIntoClip = current_tick - clip.startTick;
-                            int64_t samplesIntoClip = static_cast<int64_t>(ticksIntoClip * tickToSecond * audioManager.getSampleRate());
-                            clipOffsetSamples += samplesIntoClip;
+                            clipOffsetSamples +=
+                                tempoMap->ticksToSamples(current_tick, projectPPQ, sampleRate) - clipStartSample;
                         }
                         
                         resource->prepareForPosition(clipOffsetSamples);
@@ -560,23 +786,30 @@ void PlaybackThreadWorker::runArrangementMode() {
     
     // Track last processed tick - initialize to -1 so first iteration processes starting tick
     int last_tick = current_tick - 1;
+    int dispatched_tick = last_tick; // Sample-accurate mode: last tick already queued
     bool firstIteration = true;
     
     // Track solo state to detect changes and stop notes on non-solo tracks
     bool lastHadSoloTrack = false;
 
-    // Simple approach: for each tick range, iterate ALL tracks and ALL clips
-    // and check if any notes should be played or stopped
-    
+    // Precompiled event timeline of all clips (cached between plays when owned by the
+    // playback worker, fall back to a local one otherwise)
+    NoteNagaArrangementScheduler localScheduler(this->project);
+    NoteNagaArrangementScheduler &scheduler =
+        arrangement_scheduler_ ? *arrangement_scheduler_ : localScheduler;
+    scheduler.update(true);
+
     while (!should_stop) {
         auto now = clock::now();
         double elapsed_ms = std::chrono::duration<double, std::milli>(now - last_iteration_time).count();
         last_iteration_time = now;
+        elapsed_ms = elapsedPlaybackMs(elapsed_ms);
 
         // Get effective tempo (dynamic from tempo track or fixed from project)
+        tempoMap = this->project->getArrangementTempoMap();
         int effectiveTempo;
         if (hasArrangementTempoTrack) {
-            effectiveTempo = arrangement->getEffectiveTempoAtTick(current_tick);
+            effectiveTempo = tempoMap->getTempoAtTick(current_tick);
             
             // Emit BPM change for UI update (throttled to avoid spam)
             static int bpmEmitCounter = 0;
@@ -622,20 +855,20 @@ void PlaybackThreadWorker::runArrangementMode() {
         // Check for loop region end
         if (hasLoopRegion && current_tick >= loopEnd) {
             // Stop all notes before looping
+            flushScheduledNotes();
             for (auto* seq : this->project->getSequences()) {
                 for (auto* track : seq->getTracks()) {
-                    if (track && !track->isTempoTrack()) {
-                        track->stopAllNotes();
-                    }
+                    routeStopAllNotes(track);
                 }
             }
             current_tick = static_cast<int>(loopStart);
             last_tick = current_tick - 1; // Force re-processing from loop start
+            dispatched_tick = last_tick;
             this->project->setCurrentArrangementTick(current_tick);
             
             // Sync audio sample position for loop
             if (dsp_engine_) {
-                int64_t samplePos = dsp_engine_->tickToSamples(current_tick, effectiveTempo, projectPPQ);
+                int64_t samplePos = dsp_engine_->tickToSamples(current_tick, *tempoMap, projectPPQ);
                 dsp_engine_->setAudioSamplePosition(samplePos);
             }
         }
@@ -646,15 +879,15 @@ void PlaybackThreadWorker::runArrangementMode() {
                 current_tick = arrangement_max_tick;
             } else {
                 // Stop all notes before looping
+                flushScheduledNotes();
                 for (auto* seq : this->project->getSequences()) {
                     for (auto* track : seq->getTracks()) {
-                        if (track && !track->isTempoTrack()) {
-                            track->stopAllNotes();
-                        }
+                        routeStopAllNotes(track);
                     }
                 }
                 current_tick = 0;
                 last_tick = -1; // Force re-processing from start
+                dispatched_tick = last_tick;
                 this->project->setCurrentArrangementTick(current_tick);
                 
                 // Sync audio sample position for loop
@@ -687,109 +920,53 @@ void PlaybackThreadWorker::runArrangementMode() {
                     NoteNagaMidiSeq* seq = this->project->getSequenceById(clip.sequenceId);
                     if (!seq) continue;
                     for (auto* midiTrack : seq->getTracks()) {
-                        if (midiTrack && !midiTrack->isTempoTrack()) {
-                            midiTrack->stopAllNotes();
-                        }
+                        routeStopAllNotes(midiTrack);
                     }
                 }
             }
         }
         lastHadSoloTrack = hasSoloTrack;
         
-        for (size_t trackIdx = 0; trackIdx < arrangement->getTrackCount(); ++trackIdx) {
-            NoteNagaArrangementTrack* arrTrack = arrangement->getTracks()[trackIdx];
-            if (!arrTrack || arrTrack->isMuted()) continue;
-            
-            // If any track is soloed, only play soloed tracks
-            if (hasSoloTrack && !arrTrack->isSolo()) continue;
-
-            // Iterate ALL clips in this track
-            for (const auto& clip : arrTrack->getClips()) {
-                if (clip.muted) continue;
-
-                // Check if current tick is within clip's timeline range
-                // Clip covers from clip.startTick to clip.startTick + clip.durationTicks
-                int clipStart = clip.startTick;
-                int clipEnd = clip.startTick + clip.durationTicks;
-                
-                // Skip if we're completely outside this clip's range
-                if (current_tick < clipStart || last_tick >= clipEnd) continue;
-
-                // Get the referenced MIDI sequence
-                NoteNagaMidiSeq* seq = this->project->getSequenceById(clip.sequenceId);
-                if (!seq) continue;
-
-                int seqLength = seq->getMaxTick();
-                if (seqLength <= 0) continue;
-
-                // For each tick in the range [last_tick+1, current_tick], calculate the
-                // corresponding sequence tick (with looping) and check for notes
-                for (int arrangeTick = last_tick + 1; arrangeTick <= current_tick; ++arrangeTick) {
-                    // Skip if outside clip range
-                    if (arrangeTick < clipStart || arrangeTick >= clipEnd) continue;
+        // Pick up clip and note edits, then play all events due in (last_tick, current_tick],
+        // or up to the lookahead when notes are queued on the audio clock
+        scheduler.update();
+        anchorSchedule(current_tick + fractional_ticks, ms_per_tick);
+        int dispatch_from = last_tick;
+        int dispatch_to = current_tick;
+        if (sample_accurate_) {
+            int windowEnd = scheduleWindowEnd(current_tick, ms_per_tick);
+            windowEnd = std::min(windowEnd, hasLoopRegion ? static_cast<int>(loopEnd) - 1 : arrangement_max_tick);
+            dispatch_from = dispatched_tick;
+            dispatch_to = std::max(dispatched_tick, windowEnd);
+            dispatched_tick = dispatch_to;
+        }
+        const auto &arrTracks = scheduler.getArrangementTracks();
+        scheduler.dispatch(dispatch_from, dispatch_to, [&, this](const NN_ArrangementEvent_t &ev) {
+            NoteNagaArrangementTrack *arrTrack = arrTracks[ev.arr_track_index];
+            if (!arrTrack || arrTrack->isMuted()) return;
 
-                    // Calculate sequence-local tick with looping
-                    int localTick = (arrangeTick - clipStart) + clip.offsetTicks;
-                    int seqTick = localTick % seqLength;
-                    
-                    // Check for loop boundary (when seqTick wraps to 0)
-                    int prevLocalTick = localTick - 1;
-                    int prevSeqTick = (prevLocalTick >= 0) ? (prevLocalTick % seqLength) : -1;
-                    bool crossedLoopBoundary = (prevSeqTick >= 0 && seqTick < prevSeqTick);
-                    
-                    // Also check for clip boundary - when we're at the last tick of a clip
-                    // that ends exactly at the sequence length, notes need to be stopped
-                    bool atClipEnd = (arrangeTick == clipEnd - 1);
-                    
-                    // If we crossed a loop boundary, stop all notes from this sequence
-                    if (crossedLoopBoundary) {
-                        for (auto* midiTrack : seq->getTracks()) {
-                            if (midiTrack && !midiTrack->isTempoTrack()) {
-                                midiTrack->stopAllNotes();
-                            }
-                        }
-                    }
+            // If any track is soloed, only play soloed tracks
+            if (hasSoloTrack && !arrTrack->isSolo()) return;
 
-                    // Process notes for each MIDI track in the sequence
-                    for (auto* midiTrack : seq->getTracks()) {
-                        if (!midiTrack || midiTrack->isMuted() || midiTrack->isTempoTrack()) continue;
-
-                        const auto& notes = midiTrack->getNotes();
-                        for (const auto& note : notes) {
-                            if (!note.start.has_value() || !note.length.has_value()) continue;
-
-                            int noteStart = note.start.value();
-                            int noteEnd = noteStart + note.length.value();
-
-                            // Note ON: if this tick matches the note start
-                            if (seqTick == noteStart) {
-                                midiTrack->playNote(note);
-                                // Also route to external MIDI for arrangement track
-                                if (external_midi_router_) {
-                                    external_midi_router_->playNoteForArrangement(note, arrTrack);
-                                }
-                                emitNotePlayed(note);
-                            }
-
-                            // Note OFF: if this tick matches the note end
-                            // Also handle notes that end at exactly seqLength (which wraps to 0)
-                            bool isNoteOff = (seqTick == noteEnd);
-                            // If note ends exactly at sequence length and we're at clip end
-                            if (noteEnd == seqLength && atClipEnd && seqTick == seqLength - 1) {
-                                isNoteOff = true;
-                            }
-                            if (isNoteOff) {
-                                midiTrack->stopNote(note);
-                                // Also stop on external MIDI for arrangement track
-                                if (external_midi_router_) {
-                                    external_midi_router_->stopNoteForArrangement(note, arrTrack);
-                                }
-                            }
-                        }
-                    }
+            switch (ev.type) {
+            case NN_ArrangementEventType_t::StopSequence:
+                // Clip looped back to the sequence start, stop all notes from this sequence
+                for (auto *midiTrack : ev.sequence->getTracks()) {
+                    routeStopAllNotes(midiTrack, ev.tick);
                 }
+                break;
+            case NN_ArrangementEventType_t::NoteOn:
+                if (ev.midi_track->isMuted()) return;
+                // Also routed to external MIDI for arrangement track
+                routePlayNote(ev.midi_track, ev.note, ev.tick, arrTrack);
+                emitNotePlayed(ev.note);
+                break;
+            case NN_ArrangementEventType_t::NoteOff:
+                if (ev.midi_track->isMuted()) return;
+                routeStopNote(ev.midi_track, ev.note, ev.tick, arrTrack);
+                break;
             }
-        }
+        });
 
         // Emit position changed
         this->emitPositionChanged(current_tick);
@@ -799,14 +976,18 @@ void PlaybackThreadWorker::runArrangementMode() {
     }
 
     // Stop all notes on finish
+    flushScheduledNotes();
     for (auto* seq : this->project->getSequences()) {
         for (auto* track : seq->getTracks()) {
-            if (track && !track->isTempoTrack()) {
-                track->stopAllNotes();
-            }
+            routeStopAllNotes(track);
         }
     }
 
+    uint64_t underruns = this->project->getAudioManager().getUnderrunCount();
+    if (underruns > 0) {
+        NOTE_NAGA_LOG_WARNING("Audio streaming underruns during playback: " + std::to_string(underruns));
+    }
+
     NOTE_NAGA_LOG_INFO("Playback thread finished (Arrangement mode)");
     emitFinished();
 }
\ No newline at end of file
@@ -1,108 +1,100 @@
 #include <note_naga_engine/module/spectrum_analyzer.h>
 
+#include <note_naga_engine/module/analysis_bus.h>
+
 #include <algorithm>
 #include <cmath>
 #include <numeric>
 
+namespace {
+
+size_t roundFFTSize(size_t fft_size) {
+    size_t size = NoteNagaSpectrumAnalyzer::kMinFFTSize;
+    while (size < fft_size && size < NoteNagaSpectrumAnalyzer::kMaxFFTSize) size <<= 1;
+    return size;
+}
+
+} // namespace
+
 NoteNagaSpectrumAnalyzer::NoteNagaSpectrumAnalyzer(size_t fft_size, ChannelMode mode)
-    : fft_size_(fft_size), fft_current_pos_left_(0), fft_current_pos_right_(0),
-      samples_buffer_left_(fft_size, 0.0f), samples_buffer_right_(fft_size, 0.0f),
-      spectrum_(fft_size / 2, 0.0f), channel_mode_(mode) {
-    this->enable_ = false; 
-    // Reset all buffers to zero
-    std::fill(samples_buffer_left_.begin(), samples_buffer_left_.end(), 0.0f);
-    std::fill(samples_buffer_right_.begin(), samples_buffer_right_.end(), 0.0f);
-    std::fill(spectrum_.begin(), spectrum_.end(), 0.0f);
+    : enable_(false), fft_size_(roundFFTSize(fft_size)), overlap_(0.75f), channel_mode_(mode) {
+    preparePlan(fft_size_.load());
 }
 
-void NoteNagaSpectrumAnalyzer::pushSamplesToLeftBuffer(float *samples, size_t num_samples) {
-    if (!this->enable_) return; // Do not process if disabled
-
-    size_t to_copy = std::min(num_samples, fft_size_ - fft_current_pos_left_);
-    std::copy(samples, samples + to_copy, samples_buffer_left_.begin() + fft_current_pos_left_);
-    fft_current_pos_left_ += to_copy;
-
-    if (channel_mode_ == ChannelMode::Left && fft_current_pos_left_ >= fft_size_) {
-        fft_current_pos_left_ = 0;
-        this->pushToQueue(NN_AsyncTriggerMessage_t{});
-    } else if (channel_mode_ == ChannelMode::Merged && fft_current_pos_left_ >= fft_size_ &&
-               fft_current_pos_right_ >= fft_size_) {
-        fft_current_pos_left_ = 0;
-        fft_current_pos_right_ = 0;
-        this->pushToQueue(NN_AsyncTriggerMessage_t{});
-    }
+void NoteNagaSpectrumAnalyzer::setFFTSize(size_t fft_size) {
+    fft_size_.store(roundFFTSize(fft_size), std::memory_order_relaxed);
 }
 
-void NoteNagaSpectrumAnalyzer::pushSamplesToRightBuffer(float *samples, size_t num_samples) {
-    if (!this->enable_) return; // Do not process if disabled
-    
-    size_t to_copy = std::min(num_samples, fft_size_ - fft_current_pos_right_);
-    std::copy(samples, samples + to_copy, samples_buffer_right_.begin() + fft_current_pos_right_);
-    fft_current_pos_right_ += to_copy;
-
-    if (channel_mode_ == ChannelMode::Right && fft_current_pos_right_ >= fft_size_) {
-        fft_current_pos_right_ = 0;
-        this->pushToQueue(NN_AsyncTriggerMessage_t{});
-    } else if (channel_mode_ == ChannelMode::Merged && fft_current_pos_left_ >= fft_size_ &&
-               fft_current_pos_right_ >= fft_size_) {
-        fft_current_pos_left_ = 0;
-        fft_current_pos_right_ = 0;
-        this->pushToQueue(NN_AsyncTriggerMessage_t{});
-    }
+void NoteNagaSpectrumAnalyzer::setOverlap(float overlap) {
+    overlap_.store(std::clamp(overlap, 0.0f, 0.9375f), std::memory_order_relaxed);
 }
 
-void NoteNagaSpectrumAnalyzer::onItem(const NN_AsyncTriggerMessage_t &) {
-    processSampleBuffer();
-    NN_QT_EMIT(spectrumUpdated(spectrum_));
+size_t NoteNagaSpectrumAnalyzer::hopSize(size_t fft_size, float overlap) {
+    return std::max<size_t>(1, static_cast<size_t>(std::lround(fft_size * (1.0f - overlap))));
 }
 
-void NoteNagaSpectrumAnalyzer::processSampleBuffer() {
-    std::vector<float> working_buffer(fft_size_, 0.0f);
+void NoteNagaSpectrumAnalyzer::preparePlan(size_t fft_size) {
+    fft_ = std::make_unique<NoteNagaRealFFT>(fft_size);
+    window_.resize(fft_size);
+    for (size_t i = 0; i < fft_size; ++i)
+        window_[i] = 0.5f * (1.0f - std::cos(2.0f * float(M_PI) * i / (fft_size - 1)));
+    frame_.assign(fft_size, 0.0f);
+    frame_right_.assign(fft_size, 0.0f);
+    magnitudes_.assign(fft_size / 2, 0.0f);
+}
+
+bool NoteNagaSpectrumAnalyzer::readFrame(const NoteNagaAnalysisBus &bus, uint64_t start) {
+    const size_t size = frame_.size();
+    if (!bus.readSamples(start, size, frame_.data(), frame_right_.data())) return false;
 
-    if (channel_mode_ == ChannelMode::Left) {
-        std::copy(samples_buffer_left_.begin(), samples_buffer_left_.end(), working_buffer.begin());
-    } else if (channel_mode_ == ChannelMode::Right) {
-        std::copy(samples_buffer_right_.begin(), samples_buffer_right_.end(), working_buffer.begin());
-    } else if (channel_mode_ == ChannelMode::Merged) {
-        for (size_t i = 0; i < fft_size_; ++i)
-            working_buffer[i] = 0.5f * (samples_buffer_left_[i] + samples_buffer_right_[i]);
+    const ChannelMode mode = getChannelMode();
+    if (mode == ChannelMode::Right) {
+        frame_.swap(frame_right_);
+    } else if (mode == ChannelMode::Merged) {
+        for (size_t i = 0; i < size; ++i)
+            frame_[i] = 0.5f * (frame_[i] + frame_right_[i]);
     }
+    return true;
+}
 
-    // DC offset removal
-    float mean = std::accumulate(working_buffer.begin(), working_buffer.end(), 0.0f) /
-                 float(working_buffer.size());
-    for (size_t i = 0; i < working_buffer.size(); ++i)
-        working_buffer[i] -= mean;
+void NoteNagaSpectrumAnalyzer::process(const NoteNagaAnalysisBus &bus) {
+    if (!isEnabled()) return;
 
-    // Hann window
-    for (size_t i = 0; i < working_buffer.size(); ++i)
-        working_buffer[i] *=
-            0.5f * (1.0f - std::cos(2.0f * M_PI * i / (working_buffer.size() - 1)));
+    const size_t size = getFFTSize();
+    if (!fft_ || fft_->getSize() != size) {
+        preparePlan(size);
+        next_frame_pos_ = 0;
+    }
+    const uint64_t hop = hopSize(size, getOverlap());
+
+    // Newest complete frame on the hop grid, older pending frames are skipped
+    const uint64_t written = bus.getSampleWritePosition();
+    if (written < next_frame_pos_ + size) return;
+    const uint64_t start = next_frame_pos_ + (written - size - next_frame_pos_) / hop * hop;
+    next_frame_pos_ = start + hop;
+    if (!readFrame(bus, start)) return;
 
-    // FFT
-    std::vector<std::complex<float>> fft_in(fft_size_);
-    for (size_t i = 0; i < fft_size_; ++i)
-        fft_in[i] = std::complex<float>(working_buffer[i], 0.0f);
+    // DC offset removal
+    float mean = std::accumulate(frame_.begin(), frame_.end(), 0.0f) / float(size);
+    for (size_t i = 0; i < size; ++i)
+        frame_[i] = (frame_[i] - mean) * window_[i];
 
-    nn_fft(fft_in);
+    fft_->magnitudes(frame_.data(), magnitudes_.data());
 
     // Magnitude spectrum - use absolute amplitude, not normalized to max
-    std::vector<float> mag(fft_size_ / 2, 0.0f);
-    
     // Reference amplitude for 0 dB (full scale = 1.0 in audio samples)
     // FFT magnitude for full scale sine is fft_size/2
-    const float referenceAmplitude = float(fft_size_) / 2.0f;
+    const float invReference = 2.0f / float(size);
     const float noiseFloor = 1e-6f; // Very small threshold
-    
-    for (size_t k = 1; k < fft_size_ / 2; ++k) {
-        float amplitude = std::abs(fft_in[k]);
+    for (size_t k = 1; k < magnitudes_.size(); ++k) {
         // Normalize to 0-1 range where 1.0 = 0dB (full scale)
-        float normalized = amplitude / referenceAmplitude;
+        float normalized = magnitudes_[k] * invReference;
         // Apply noise floor
-        mag[k] = normalized > noiseFloor ? normalized : 0.0f;
+        magnitudes_[k] = normalized > noiseFloor ? normalized : 0.0f;
     }
-    mag[0] = 0.0f; // Remove DC
+    magnitudes_[0] = 0.0f; // Remove DC
 
-    std::lock_guard<std::mutex> lock(this->spectrum_mutex_);
-    spectrum_ = mag;
+    spectrum_.writeBuffer().assign(magnitudes_.begin(), magnitudes_.end());
+    spectrum_.publish();
+    NN_QT_EMIT(spectrumUpdated(magnitudes_));
 }
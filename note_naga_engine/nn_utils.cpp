@@ -1,6 +1,7 @@
 #include <note_naga_engine/nn_utils.h>
 
 #include <algorithm>
+#include <climits>
 #include <cmath>
 #include <numeric>
 #include <random>
@@ -195,35 +196,36 @@ void NN_Utils::legato(NoteNagaMidiSeq &seq, int strength_percent)
 
     for (auto &track : seq.getTracks())
     {
-        std::vector<NN_Note_t> notes = track->getNotes();
-        if (notes.size() < 2)
+        // Noty seřazené podle začátku ze snapshotu stopy (bez kopírování a řazení)
+        std::shared_ptr<const NN_NoteColumns_t> cols = track->getNoteColumns();
+        if (cols->size() < 2)
             continue;
+        std::span<const NN_Note_t> view = track->getNotesView();
 
-        // Seřadit noty podle času začátku
-        std::sort(notes.begin(), notes.end(), [](const NN_Note_t &a, const NN_Note_t &b)
-                  { return a.start.value_or(0) < b.start.value_or(0); });
-
-        for (size_t i = 0; i < notes.size() - 1; ++i)
+        NN_NoteChangeSet_t changes;
+        for (size_t row = 0; row < cols->size(); ++row)
         {
-            if (notes[i].start.has_value() && notes[i].length.has_value() && notes[i + 1].start.has_value())
+            // Další nota s pozdějším začátkem (všechny noty akordu se prodlouží stejně)
+            size_t next = cols->upperBound(cols->start[row]);
+            if (next >= cols->size())
+                break;
+
+            int ideal_length = cols->start[next] - cols->start[row];
+            int new_length = cols->length[row] + static_cast<int>((ideal_length - cols->length[row]) * factor);
+            new_length = std::max(1, new_length);
+
+            if (new_length != cols->length[row])
             {
-                int current_end = *notes[i].start + *notes[i].length;
-                int next_start = *notes[i + 1].start;
-                if (next_start > *notes[i].start)
-                {
-                    int ideal_length = next_start - *notes[i].start;
-                    int new_length = *notes[i].length + static_cast<int>((ideal_length - *notes[i].length) * factor);
-                    new_length = std::max(1, new_length);
-
-                    if (new_length != *notes[i].length)
-                    {
-                        notes[i].length = new_length;
-                        changed = true;
-                    }
-                }
+                NN_Note_t note = view[cols->source[row]];
+                note.length = new_length;
+                changes.updated.push_back(note);
             }
         }
-        track->setNotes(notes);
+        if (!changes.empty())
+        {
+            track->applyNoteChanges(changes);
+            changed = true;
+        }
     }
 
     if (changed)
@@ -332,40 +334,33 @@ void NN_Utils::deleteOverlappingNotes(NoteNagaMidiSeq &seq)
     bool changed = false;
     for (auto &track : seq.getTracks())
     {
-        std::vector<NN_Note_t> notes = track->getNotes();
-        if (notes.size() < 2)
+        std::shared_ptr<const NN_NoteColumns_t> cols = track->getNoteColumns();
+        if (cols->size() < 2)
             continue;
+        std::span<const NN_Note_t> view = track->getNotesView();
 
-        // Seřadit noty podle výšky a pak podle času
-        std::sort(notes.begin(), notes.end(), [](const NN_Note_t &a, const NN_Note_t &b)
-                  {
-            if (a.note != b.note) return a.note < b.note;
-            return a.start.value_or(0) < b.start.value_or(0); });
-
-        std::vector<NN_Note_t> cleaned_notes;
-        cleaned_notes.push_back(notes[0]);
+        // Průchod notami seřazenými podle začátku: ponechané noty stejné výšky se
+        // nepřekrývají, stačí tedy pamatovat si konec poslední ponechané noty
+        int kept_end[128];
+        std::fill(std::begin(kept_end), std::end(kept_end), INT_MIN);
 
-        for (size_t i = 1; i < notes.size(); ++i)
+        NN_NoteChangeSet_t changes;
+        for (size_t row = 0; row < cols->size(); ++row)
         {
-            NN_Note_t &last_note = cleaned_notes.back();
-            NN_Note_t &current_note = notes[i];
-
-            if (last_note.note == current_note.note && last_note.start.has_value() && last_note.length.has_value() && current_note.start.has_value())
+            int &last_end = kept_end[cols->pitch[row]];
+            // Pokud nota začíná před koncem poslední noty stejné výšky, odstraníme ji
+            if (cols->start[row] < last_end)
             {
-                int last_note_end = *last_note.start + *last_note.length;
-                // Pokud aktuální nota začíná před koncem poslední noty stejné výšky, přeskočíme ji
-                if (*current_note.start < last_note_end)
-                {
-                    continue;
-                }
+                changes.removed.push_back(view[cols->source[row]]);
+                continue;
             }
-            cleaned_notes.push_back(current_note);
+            last_end = cols->start[row] + cols->length[row];
         }
 
-        if (cleaned_notes.size() != notes.size())
+        if (!changes.empty())
         {
             changed = true;
-            track->setNotes(cleaned_notes);
+            track->applyNoteChanges(changes);
         }
     }
 
@@ -407,41 +402,37 @@ void NN_Utils::scaleTiming(NoteNagaMidiSeq &seq, double factor)
 
 // ==================== Implementace pro vybrané noty ====================
 
+namespace {
+
+/// Write edited notes back to their tracks: one change set per affected track,
+/// notes matched by ID. Returns the parent sequence of the first affected track.
+NoteNagaMidiSeq *applyToTracks(const std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selectedNotes,
+                               const std::set<NoteNagaTrack*> &affectedTracks)
+{
+    std::map<NoteNagaTrack*, NN_NoteChangeSet_t> changes;
+    for (const auto &pair : selectedNotes) {
+        if (pair.first && affectedTracks.count(pair.first)) {
+            changes[pair.first].updated.push_back(pair.second);
+        }
+    }
+
+    NoteNagaMidiSeq *parentSeq = nullptr;
+    for (auto &[track, changeSet] : changes) {
+        track->applyNoteChanges(changeSet);
+        if (!parentSeq) parentSeq = track->getParent();
+    }
+    return parentSeq;
+}
+
+} // namespace
+
 void NN_Utils::applySelectedNotesToTracks(const std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selectedNotes)
 {
-    // Seskupíme změněné noty podle tracku
-    std::map<NoteNagaTrack*, std::vector<NN_Note_t>> trackNotes;
     std::set<NoteNagaTrack*> affectedTracks;
-    
     for (const auto &pair : selectedNotes) {
         affectedTracks.insert(pair.first);
     }
-    
-    // Pro každý dotčený track aktualizujeme noty
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        
-        // Pro každou vybranou notu v tomto tracku najdeme a aktualizujeme ji
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            
-            const NN_Note_t &selectedNote = selectedPair.second;
-            
-            // Hledáme notu podle původní pozice a výšky (předpokládáme unikátní kombinaci)
-            for (auto &note : allNotes) {
-                // Porovnáváme podle unikátních identifikátorů noty
-                if (note.note == selectedNote.note &&
-                    note.start.has_value() && selectedNote.start.has_value() &&
-                    note.length.has_value() && selectedNote.length.has_value()) {
-                    // Aktualizujeme notu
-                    note = selectedNote;
-                    break;
-                }
-            }
-        }
-        
-        track->setNotes(allNotes);
-    }
+    applyToTracks(selectedNotes, affectedTracks);
 }
 
 void NN_Utils::quantize(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selectedNotes, int ppq, int grid_divisor)
@@ -463,22 +454,7 @@ void NN_Utils::quantize(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selec
         }
     }
 
-    // Aktualizujeme noty v trackách
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -508,21 +484,7 @@ void NN_Utils::humanize(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selec
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -541,21 +503,7 @@ void NN_Utils::transpose(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &sele
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note - semitones) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -581,21 +529,7 @@ void NN_Utils::changeVelocity(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>>
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -621,21 +555,7 @@ void NN_Utils::changeDuration(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>>
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -658,21 +578,7 @@ void NN_Utils::staccato(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selec
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -692,25 +598,7 @@ void NN_Utils::invert(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &selecte
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                // Pro invert je trochu složitější najít notu - používáme start a length
-                if (note.start.has_value() && selectedPair.second.start.has_value() &&
-                    *note.start == *selectedPair.second.start &&
-                    note.length.has_value() && selectedPair.second.length.has_value() &&
-                    *note.length == *selectedPair.second.length) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -733,21 +621,7 @@ void NN_Utils::scaleTiming(std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> &se
         affectedTracks.insert(pair.first);
     }
 
-    NoteNagaMidiSeq* parentSeq = nullptr;
-    for (NoteNagaTrack* track : affectedTracks) {
-        std::vector<NN_Note_t> allNotes = track->getNotes();
-        for (const auto &selectedPair : selectedNotes) {
-            if (selectedPair.first != track) continue;
-            for (auto &note : allNotes) {
-                if (note.note == selectedPair.second.note) {
-                    note = selectedPair.second;
-                    break;
-                }
-            }
-        }
-        track->setNotes(allNotes);
-        if (!parentSeq) parentSeq = track->getParent();
-    }
+    NoteNagaMidiSeq* parentSeq = applyToTracks(selectedNotes, affectedTracks);
     if (parentSeq) {
         NN_QT_EMIT(parentSeq->metadataChanged(parentSeq, "notes"));
     }
@@ -5,6 +5,20 @@
 #include <note_naga_engine/synth/synth_fluidsynth.h>
 #include <note_naga_engine/core/soundfont_finder.h>
 
+#ifndef QT_DEACTIVATED
+#include <QSettings>
+#endif
+
+#include <algorithm>
+
+#ifndef QT_DEACTIVATED
+// Application settings store (shared with the recent projects)
+static const char *kSettingsOrganization = "NoteNaga";
+static const char *kSettingsApplication = "NoteNaga";
+static const char *kRenderThreadsKey = "audio/renderThreads";
+static const char *kSampleAccurateMidiKey = "audio/sampleAccurateMidi";
+#endif
+
 NoteNagaEngine::NoteNagaEngine()
 #ifndef QT_DEACTIVATED
     : QObject(nullptr)
@@ -16,6 +30,7 @@ NoteNagaEngine::NoteNagaEngine()
     this->audio_worker = nullptr;
     this->spectrum_analyzer = nullptr;
     this->pan_analyzer = nullptr;
+    this->analysis_bus = nullptr;
     this->metronome = nullptr;
     this->external_midi_router = nullptr;
     NOTE_NAGA_LOG_INFO("Instance created. Version: " + std::string(NOTE_NAGA_VERSION_STR));
@@ -45,6 +60,12 @@ NoteNagaEngine::~NoteNagaEngine() {
         runtime_data = nullptr;
     }
 
+    // The analysis bus worker runs the analyzers, stop it first
+    if (analysis_bus) {
+        delete analysis_bus;
+        analysis_bus = nullptr;
+    }
+
     if (spectrum_analyzer) {
         delete spectrum_analyzer;
         spectrum_analyzer = nullptr;
@@ -83,6 +104,11 @@ bool NoteNagaEngine::initialize() {
         this->pan_analyzer = new NoteNagaPanAnalyzer(2048);
     }
 
+    // Initialize analysis bus (meters, spectrum and pan are computed by its worker)
+    if (!this->analysis_bus) {
+        this->analysis_bus = new NoteNagaAnalysisBus(this->spectrum_analyzer, this->pan_analyzer);
+    }
+
     // Initialize metronome
     if (!this->metronome) {
         this->metronome = new NoteNagaMetronome();
@@ -117,10 +143,47 @@ bool NoteNagaEngine::initialize() {
 
     // dsp engine - now works with tracks instead of global synths
     if (!this->dsp_engine) {
-        this->dsp_engine = new NoteNagaDSPEngine(this->metronome, this->spectrum_analyzer, this->pan_analyzer);
+        this->dsp_engine = new NoteNagaDSPEngine(this->metronome, this->analysis_bus);
         // Set runtime data for track-based rendering
         this->dsp_engine->setRuntimeData(this->runtime_data);
         this->dsp_engine->setSampleRate(44100);
+        loadAudioSettings();
+
+#ifndef QT_DEACTIVATED
+        // Keep the precomputed arrangement routing table in sync with the project. Track, sequence
+        // and synth removals delete the dropped objects right after their signal returns, those
+        // rebuilds (direct connections) wait until no render() references the previous plan.
+        auto rebuildPlan = [this]() {
+            if (this->dsp_engine) this->dsp_engine->rebuildArrangementRenderPlan();
+        };
+        auto rebuildPlanAndWait = [this]() {
+            if (this->dsp_engine) this->dsp_engine->rebuildArrangementRenderPlan(true);
+        };
+        NoteNagaArrangement *arrangement = this->runtime_data->getArrangement();
+        connect(arrangement, &NoteNagaArrangement::clipsChanged, this, rebuildPlan);
+        connect(arrangement, &NoteNagaArrangement::tracksChanged, this, rebuildPlanAndWait, Qt::DirectConnection);
+        connect(this->runtime_data, &NoteNagaRuntimeData::sequenceListChanged, this, rebuildPlanAndWait,
+                Qt::DirectConnection);
+        connect(this->runtime_data, &NoteNagaRuntimeData::sequenceTrackListChanged, this, rebuildPlanAndWait,
+                Qt::DirectConnection);
+        connect(this->runtime_data, &NoteNagaRuntimeData::trackMetaChanged, this,
+                [rebuildPlan, rebuildPlanAndWait](NoteNagaTrack *, const std::string &param) {
+                    if (param == "synth") rebuildPlanAndWait();
+                    else if (param == "is_tempo_track") rebuildPlan();
+                }, Qt::DirectConnection);
+
+        // The audio thread reads the arrangement tempo map only from the published pointer
+        auto publishTempoMap = [this]() {
+            if (this->dsp_engine) this->dsp_engine->publishArrangementTempoMap();
+        };
+        connect(this->runtime_data->getArrangement(), &NoteNagaArrangement::tempoTrackChanged, this,
+                publishTempoMap);
+        connect(this->runtime_data, &NoteNagaRuntimeData::activeSequenceChanged, this, publishTempoMap);
+        connect(this->runtime_data, &NoteNagaRuntimeData::sequenceMetadataChanged, this,
+                [publishTempoMap](NoteNagaMidiSeq *, const std::string &param) {
+                    if (param == "tempo") publishTempoMap();
+                });
+#endif
     }
     
     // Set DSP engine on playback worker for audio synchronization
@@ -148,6 +211,49 @@ bool NoteNagaEngine::initialize() {
     return status;
 }
 
+/*******************************************************************************************************/
+// Audio Settings
+/*******************************************************************************************************/
+
+void NoteNagaEngine::loadAudioSettings() {
+#ifndef QT_DEACTIVATED
+    QSettings settings(kSettingsOrganization, kSettingsApplication);
+    this->render_threads = std::max(0, settings.value(kRenderThreadsKey, 0).toInt());
+    this->sample_accurate_midi = settings.value(kSampleAccurateMidiKey, true).toBool();
+#endif
+    if (this->dsp_engine) {
+        this->dsp_engine->setSampleAccurateMidi(this->sample_accurate_midi);
+    }
+    // The DSP engine starts with an automatic thread count
+    if (this->dsp_engine && this->render_threads != 0) {
+        this->dsp_engine->setRenderThreadCount(this->render_threads);
+    }
+}
+
+void NoteNagaEngine::setRenderThreadCount(int num_threads) {
+    this->render_threads = std::max(0, num_threads);
+    if (this->dsp_engine) {
+        this->dsp_engine->setRenderThreadCount(this->render_threads);
+        NOTE_NAGA_LOG_INFO("Render threads set to: " + std::to_string(this->dsp_engine->getRenderThreadCount()));
+    }
+#ifndef QT_DEACTIVATED
+    QSettings settings(kSettingsOrganization, kSettingsApplication);
+    settings.setValue(kRenderThreadsKey, this->render_threads);
+#endif
+}
+
+void NoteNagaEngine::setSampleAccurateMidi(bool enable) {
+    this->sample_accurate_midi = enable;
+    if (this->dsp_engine) {
+        this->dsp_engine->setSampleAccurateMidi(enable);
+    }
+    NOTE_NAGA_LOG_INFO(std::string("Sample-accurate MIDI scheduling ") + (enable ? "enabled" : "disabled"));
+#ifndef QT_DEACTIVATED
+    QSettings settings(kSettingsOrganization, kSettingsApplication);
+    settings.setValue(kSampleAccurateMidiKey, enable);
+#endif
+}
+
 /*******************************************************************************************************/
 // Playback Control
 /*******************************************************************************************************/
@@ -0,0 +1,176 @@
+#include <note_naga_engine/synth/soundfont_pool.h>
+
+#include <note_naga_engine/logger.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+/*******************************************************************************************************/
+// SoundFont Loader
+/*******************************************************************************************************/
+
+namespace {
+
+/// Open SoundFont file, a read position in the pooled image (keeps the image alive)
+struct PooledFile {
+    std::shared_ptr<NoteNagaSharedSoundFont> font;
+    fluid_long_long_t position = 0;
+};
+
+void *pooledOpen(const char *filename) {
+    std::shared_ptr<NoteNagaSharedSoundFont> font = NoteNagaSoundFontPool::instance().find(filename);
+    if (!font) return nullptr;
+    return new PooledFile{std::move(font), 0};
+}
+
+int pooledRead(void *buf, fluid_long_long_t count, void *handle) {
+    PooledFile *file = static_cast<PooledFile *>(handle);
+    const std::vector<char> &data = file->font->getData();
+    if (count < 0 || file->position + count > static_cast<fluid_long_long_t>(data.size())) return FLUID_FAILED;
+    std::memcpy(buf, data.data() + file->position, static_cast<size_t>(count));
+    file->position += count;
+    return FLUID_OK;
+}
+
+int pooledSeek(void *handle, fluid_long_long_t offset, int origin) {
+    PooledFile *file = static_cast<PooledFile *>(handle);
+    const fluid_long_long_t size = static_cast<fluid_long_long_t>(file->font->getData().size());
+    fluid_long_long_t position = offset;
+    if (origin == SEEK_CUR) position += file->position;
+    else if (origin == SEEK_END) position += size;
+    if (position < 0 || position > size) return FLUID_FAILED;
+    file->position = position;
+    return FLUID_OK;
+}
+
+fluid_long_long_t pooledTell(void *handle) { return static_cast<PooledFile *>(handle)->position; }
+
+int pooledClose(void *handle) {
+    delete static_cast<PooledFile *>(handle);
+    return FLUID_OK;
+}
+
+} // namespace
+
+/*******************************************************************************************************/
+// Shared SoundFont
+/*******************************************************************************************************/
+
+NoteNagaSharedSoundFont::~NoteNagaSharedSoundFont() {
+    NOTE_NAGA_LOG_INFO("SoundFont released from pool: " + path_);
+}
+
+int NoteNagaSharedSoundFont::attach(fluid_synth_t *synth) const {
+    if (!synth || data_.empty()) return -1;
+    fluid_settings_t *settings = fluid_synth_get_settings(synth);
+
+    // Samples are copied from the image when a preset is selected, not all at load time
+    fluid_settings_setint(settings, "synth.dynamic-sample-loading", 1);
+
+    // Stock SoundFont parser reading the pooled image; other paths fall through to the default loader
+    fluid_sfloader_t *loader = new_fluid_defsfloader(settings);
+    if (!loader) {
+        NOTE_NAGA_LOG_ERROR("SoundFont pool: failed to create SoundFont loader");
+        return -1;
+    }
+    fluid_sfloader_set_callbacks(loader, pooledOpen, pooledRead, pooledSeek, pooledTell, pooledClose);
+    fluid_synth_add_sfloader(synth, loader);
+
+    // Resetting the presets loads the default piano and drum kit here, on the loading thread
+    int sfid = fluid_synth_sfload(synth, path_.c_str(), 1);
+    return sfid == FLUID_FAILED ? -1 : sfid;
+}
+
+/*******************************************************************************************************/
+// SoundFont Pool
+/*******************************************************************************************************/
+
+NoteNagaSoundFontPool &NoteNagaSoundFontPool::instance() {
+    static NoteNagaSoundFontPool pool;
+    return pool;
+}
+
+std::shared_ptr<NoteNagaSharedSoundFont> NoteNagaSoundFontPool::acquire(const std::string &path) {
+    if (path.empty()) return nullptr;
+
+    std::error_code ec;
+    std::filesystem::path canonical = std::filesystem::weakly_canonical(path, ec);
+    const std::string key = ec ? path : canonical.string();
+
+    std::promise<std::shared_ptr<NoteNagaSharedSoundFont>> promise;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        Entry &entry = entries_[key];
+        if (auto font = entry.font.lock()) {
+            return font;
+        }
+        if (entry.loading.valid()) {
+            // Another thread is loading this file, wait for it
+            auto loading = entry.loading;
+            lock.unlock();
+            return loading.get();
+        }
+        entry.loading = promise.get_future().share();
+    }
+
+    std::shared_ptr<NoteNagaSharedSoundFont> font = load(key);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        Entry &entry = entries_[key];
+        entry.font = font;
+        entry.loading = {};
+        if (!font) entries_.erase(key);
+    }
+    promise.set_value(font);
+    return font;
+}
+
+std::shared_ptr<NoteNagaSharedSoundFont> NoteNagaSoundFontPool::find(const std::string &path) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = entries_.find(path);
+    return it != entries_.end() ? it->second.font.lock() : nullptr;
+}
+
+size_t NoteNagaSoundFontPool::getLoadedCount() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if (it->second.font.expired() && !it->second.loading.valid()) {
+            it = entries_.erase(it);
+        } else {
+            ++count;
+            ++it;
+        }
+    }
+    return count;
+}
+
+std::shared_ptr<NoteNagaSharedSoundFont> NoteNagaSoundFontPool::load(const std::string &path) {
+    std::shared_ptr<NoteNagaSharedSoundFont> font(new NoteNagaSharedSoundFont());
+    font->path_ = path;
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) {
+        NOTE_NAGA_LOG_ERROR("SoundFont pool: failed to open " + path);
+        return nullptr;
+    }
+    const std::streamsize size = file.tellg();
+    font->data_.resize(size > 0 ? static_cast<size_t>(size) : 0);
+    file.seekg(0);
+    if (size <= 0 || !file.read(font->data_.data(), size)) {
+        NOTE_NAGA_LOG_ERROR("SoundFont pool: failed to read " + path);
+        return nullptr;
+    }
+
+    // RIFF container with the sfbk form type (both .sf2 and .sf3)
+    if (font->data_.size() < 12 || std::memcmp(font->data_.data(), "RIFF", 4) != 0 ||
+        std::memcmp(font->data_.data() + 8, "sfbk", 4) != 0) {
+        NOTE_NAGA_LOG_ERROR("SoundFont pool: not a SoundFont file: " + path);
+        return nullptr;
+    }
+
+    NOTE_NAGA_LOG_INFO("SoundFont loaded into pool: " + path);
+    return font;
+}
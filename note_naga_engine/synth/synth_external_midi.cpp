@@ -40,11 +40,11 @@ NoteNagaSynthExternalMidi::NoteNagaSynthExternalMidi(const std::string &name,
 }
 
 NoteNagaSynthExternalMidi::~NoteNagaSynthExternalMidi() {
-    std::lock_guard<std::mutex> lock(synth_mutex_);
-    
     // Stop all sounds before terminating
     stopAllNotes();
-    
+
+    std::lock_guard<std::mutex> lock(synth_mutex_);
+
     // Close MIDI port and release resources
     if (midi_out_ && is_connected_) {
         midi_out_->closePort();
@@ -150,12 +150,14 @@ void NoteNagaSynthExternalMidi::sendProgramChange(int channel, int program) {
 }
 
 void NoteNagaSynthExternalMidi::playNote(const NN_Note_t &note, int channel, float pan) {
+    // RtMidi is not thread-safe. External synths produce no audio, the playback worker
+    // plays their notes directly and never queues them for the render thread.
     std::lock_guard<std::mutex> lock(synth_mutex_);
 
     if (!note.velocity.has_value() || note.velocity.value() <= 0) return;
     
     NoteNagaTrack *track = note.parent;
-    if (!track) return;
+    if (!track || channel < 0 || channel >= NoteNagaActiveNotes::kChannels) return;
     
     // If not connected to MIDI, try to establish connection
     if (!ensureMidiOutput()) return;
@@ -176,8 +178,8 @@ void NoteNagaSynthExternalMidi::playNote(const NN_Note_t &note, int channel, flo
         channel_pan_[channel] = pan;
     }
     
-    // Check if note is already playing
-    if (playing_notes_[track].find(note.id) != playing_notes_[track].end()) {
+    // Check if note is already playing (marks it as playing for later stop)
+    if (!active_notes_.noteOn(note, channel)) {
         return;
     }
     
@@ -189,90 +191,65 @@ void NoteNagaSynthExternalMidi::playNote(const NN_Note_t &note, int channel, flo
     
     try {
         midi_out_->sendMessage(&message);
-        
-        // Store the note in playing_notes_ for later stop
-        playing_notes_[track][note.id] = PlayedNote_t{note, channel};
     } catch (RtMidiError &error) {
         NOTE_NAGA_LOG_ERROR("RtMidi error when sending Note On: " + error.getMessage());
         is_connected_ = false;
+        active_notes_.noteOff(note);
+    }
+}
+
+bool NoteNagaSynthExternalMidi::sendNoteOff(int channel, int pitch) {
+    std::vector<unsigned char> message;
+    message.push_back(0x80 + channel); // Note Off on specified channel
+    message.push_back(pitch);          // Note number
+    message.push_back(0);              // Velocity for Note Off
+    
+    try {
+        midi_out_->sendMessage(&message);
+        return true;
+    } catch (RtMidiError &error) {
+        NOTE_NAGA_LOG_ERROR("RtMidi error when sending Note Off: " + error.getMessage());
+        is_connected_ = false;
+        return false;
     }
 }
 
 void NoteNagaSynthExternalMidi::stopNote(const NN_Note_t &note) {
-    NoteNagaTrack *track = note.parent;
-    if (!track) return;
+    if (!note.parent) return;
+
+    std::lock_guard<std::mutex> lock(synth_mutex_);
     
     if (!ensureMidiOutput()) return;
     
-    // Find note in playing notes by ID
-    TrackNotesMap &playingTrackNotes = playing_notes_[track];
-    auto it = playingTrackNotes.find(note.id);
-    
-    // Retrieve note parameters and stop it
-    if (it != playingTrackNotes.end()) {
-        const PlayedNote_t &pn = it->second;
-        
-        // Send Note Off message
-        std::vector<unsigned char> message;
-        message.push_back(0x80 + pn.channel); // Note Off on specified channel
-        message.push_back(pn.note.note);      // Note number
-        message.push_back(0);                 // Velocity for Note Off
-        
-        try {
-            midi_out_->sendMessage(&message);
-            playingTrackNotes.erase(it);
-        } catch (RtMidiError &error) {
-            NOTE_NAGA_LOG_ERROR("RtMidi error when sending Note Off: " + error.getMessage());
-            is_connected_ = false;
-        }
+    // Find the channel the note was started on and stop it
+    int channel = active_notes_.noteOff(note);
+    if (channel >= 0) {
+        sendNoteOff(channel, note.note);
     }
 }
 
 void NoteNagaSynthExternalMidi::stopAllNotes(NoteNagaMidiSeq *seq, NoteNagaTrack *track) {
+    std::lock_guard<std::mutex> lock(synth_mutex_);
+
     if (!ensureMidiOutput()) return;
     
+    // Notes are released from the table even when sending fails (the port is gone)
+    auto noteOff = [this](int channel, int pitch) {
+        if (is_connected_) sendNoteOff(channel, pitch);
+    };
+
     // Stop notes according to function parameters
     if (track) {
         // Stop notes for specified track
-        for (const auto &[id, pn] : playing_notes_[track]) {
-            std::vector<unsigned char> message;
-            message.push_back(0x80 + pn.channel); // Note Off on specified channel
-            message.push_back(pn.note.note);      // Note number
-            message.push_back(0);                 // Velocity for Note Off
-            
-            try {
-                midi_out_->sendMessage(&message);
-            } catch (RtMidiError &error) {
-                NOTE_NAGA_LOG_ERROR("RtMidi error when sending Note Off: " + error.getMessage());
-                is_connected_ = false;
-                break;
-            }
-        }
-        playing_notes_[track].clear();
+        active_notes_.releaseAll(track, noteOff);
     } else if (seq) {
         // Stop notes for the entire sequence
         for (auto &tr : seq->getTracks()) {
-            if (tr) stopAllNotes(nullptr, tr);
+            if (tr) active_notes_.releaseAll(tr, noteOff);
         }
     } else {
         // Stop all notes
-        for (auto &[track, notes] : playing_notes_) {
-            for (const auto &[id, pn] : notes) {
-                std::vector<unsigned char> message;
-                message.push_back(0x80 + pn.channel); // Note Off on specified channel
-                message.push_back(pn.note.note);      // Note number
-                message.push_back(0);                 // Velocity for Note Off
-                
-                try {
-                    midi_out_->sendMessage(&message);
-                } catch (RtMidiError &error) {
-                    NOTE_NAGA_LOG_ERROR("RtMidi error when sending Note Off: " + error.getMessage());
-                    is_connected_ = false;
-                    break;
-                }
-            }
-            notes.clear();
-        }
+        active_notes_.releaseAll(nullptr, noteOff);
         
         // Alternatively, we can send MIDI "All Notes Off" message to all channels
         if (is_connected_) {
@@ -59,8 +59,11 @@ NoteNagaSynthFluidSynth::NoteNagaSynthFluidSynth(const std::string &name,
 }
 
 void NoteNagaSynthFluidSynth::loadSoundFontInternal() {
-  int sfid = fluid_synth_sfload(fluidsynth_, sf2_path_.c_str(), 1);
+  // Shared pool: the file is read only by the first synth that needs it
+  soundfont_ = NoteNagaSoundFontPool::instance().acquire(sf2_path_);
+  int sfid = soundfont_ ? soundfont_->attach(fluidsynth_) : -1;
   if (sfid < 0) {
+    soundfont_.reset();
     last_error_ = "Failed to load SoundFont: " + sf2_path_;
     NOTE_NAGA_LOG_ERROR(last_error_);
     soundfont_loaded_.store(false, std::memory_order_release);
@@ -92,10 +95,21 @@ NoteNagaSynthFluidSynth::~NoteNagaSynthFluidSynth() {
   // Small delay to ensure audio callback finishes
   std::this_thread::sleep_for(std::chrono::milliseconds(50));
 
-  if (fluidsynth_)
+  releaseFluidsynth();
+}
+
+void NoteNagaSynthFluidSynth::releaseFluidsynth() {
+  // The synth frees its own SoundFont, the pooled file image is released after it
+  if (fluidsynth_) {
     delete_fluid_synth(fluidsynth_);
-  if (synth_settings_)
+    fluidsynth_ = nullptr;
+  }
+  soundfont_.reset();
+
+  if (synth_settings_) {
     delete_fluid_settings(synth_settings_);
+    synth_settings_ = nullptr;
+  }
 }
 
 void NoteNagaSynthFluidSynth::renderAudio(float *left, float *right,
@@ -114,6 +128,16 @@ void NoteNagaSynthFluidSynth::renderAudio(float *left, float *right,
                           1);
 }
 
+bool NoteNagaSynthFluidSynth::hasActiveVoices() const {
+  // Not ready synths render silence
+  if (!synth_ready_.load(std::memory_order_acquire) ||
+      !soundfont_loaded_.load(std::memory_order_acquire) || !fluidsynth_)
+    return false;
+  // Voices stay active until their release ends; the decay of the internal reverb and
+  // chorus is covered by the engine, which waits until the rendered output is silent
+  return fluid_synth_get_active_voice_count(fluidsynth_) > 0;
+}
+
 void NoteNagaSynthFluidSynth::playNote(const NN_Note_t &note, int channel,
                                        float pan) {
   if (!note.velocity.has_value() || note.velocity.value() <= 0)
@@ -124,16 +148,17 @@ void NoteNagaSynthFluidSynth::playNote(const NN_Note_t &note, int channel,
     return;
 
   NoteNagaTrack *track = note.parent;
-  if (!track)
+  if (!track || channel < 0 || channel >= NoteNagaActiveNotes::kChannels)
     return;
 
+  // Called from the render thread, the playback worker and the GUI preview at once:
+  // note state is lock-free, FluidSynth serializes its own API calls
   // get program for the track (parent of note)
   int prog = track->getInstrument().value_or(0);
 
   // Set program change if needed
-  if (channel_programs_[channel] != prog) {
+  if (channel_programs_[channel].exchange(prog, std::memory_order_relaxed) != prog) {
     fluid_synth_program_change(fluidsynth_, channel, prog);
-    channel_programs_[channel] = prog;
   }
 
   // Always set pan before playing note (MIDI CC 10: 0=left, 64=center, 127=right)
@@ -143,64 +168,47 @@ void NoteNagaSynthFluidSynth::playNote(const NN_Note_t &note, int channel,
   int midiPan = static_cast<int>(std::round(clampedPan * 63.5f + 63.5f));
   midiPan = std::clamp(midiPan, 0, 127);
   fluid_synth_cc(fluidsynth_, channel, 10, midiPan);
-  channel_pan_[channel] = pan;
+  channel_pan_[channel].store(pan, std::memory_order_relaxed);
 
-  // Check if note is already playing
-  if (playing_notes_[track].find(note.id) != playing_notes_[track].end()) {
+  // Skip notes which are already playing
+  if (!active_notes_.noteOn(note, channel)) {
     return;
   }
 
   // play note
   fluid_synth_noteon(fluidsynth_, channel, note.note,
                      note.velocity.value_or(100));
-
-  // Store the note in playing_notes_ for later stop
-  playing_notes_[track][note.id] = PlayedNote_t{note, channel};
 }
 
 void NoteNagaSynthFluidSynth::stopNote(const NN_Note_t &note) {
-  NoteNagaTrack *track = note.parent;
-  if (!track)
+  if (!note.parent)
     return;
 
-  // find note in playing notes by ID
-  TrackNotesMap &playingTrackNotes = playing_notes_[track];
-  auto it = playingTrackNotes.find(note.id);
-
-  // retrieve note parameters and stop it
-  if (it != playingTrackNotes.end()) {
-    const PlayedNote_t &pn = it->second;
-    if (fluidsynth_) {
-      fluid_synth_noteoff(fluidsynth_, pn.channel, pn.note.note);
-    }
-    playingTrackNotes.erase(it);
+  // find the channel the note was started on and stop it
+  int channel = active_notes_.noteOff(note);
+  if (channel >= 0 && fluidsynth_) {
+    fluid_synth_noteoff(fluidsynth_, channel, note.note);
   }
 }
 
 void NoteNagaSynthFluidSynth::stopAllNotes(NoteNagaMidiSeq *seq,
                                            NoteNagaTrack *track) {
-  if (track) {
-    for (const auto &[id, pn] : playing_notes_[track]) {
-      if (fluidsynth_) {
-        fluid_synth_noteoff(fluidsynth_, pn.channel, pn.note.note);
-      }
+  auto noteOff = [this](int channel, int pitch) {
+    if (fluidsynth_) {
+      fluid_synth_noteoff(fluidsynth_, channel, pitch);
     }
-    playing_notes_[track].clear();
+  };
+
+  if (track) {
+    active_notes_.releaseAll(track, noteOff);
   } else if (seq) {
     for (auto &tr : seq->getTracks()) {
       if (tr)
-        stopAllNotes(nullptr, tr);
+        active_notes_.releaseAll(tr, noteOff);
     }
   } else {
     // Stop all tracked notes first
-    for (auto &[track, notes] : playing_notes_) {
-      for (const auto &[id, pn] : notes) {
-        if (fluidsynth_) {
-          fluid_synth_noteoff(fluidsynth_, pn.channel, pn.note.note);
-        }
-      }
-      notes.clear();
-    }
+    active_notes_.releaseAll(nullptr, noteOff);
     
     // Also send "All Notes Off" (CC 123) to all 16 MIDI channels
     // This ensures no hanging notes even if they weren't tracked properly
@@ -227,7 +235,7 @@ void NoteNagaSynthFluidSynth::setMasterPan(float pan) {
   if (fluidsynth_) {
     for (int channel = 0; channel < 16; ++channel) {
       fluid_synth_cc(fluidsynth_, channel, 10, midiPan);
-      channel_pan_[channel] = pan;  // Update cache
+      channel_pan_[channel].store(pan, std::memory_order_relaxed);  // Update cache
     }
   }
 }
@@ -271,15 +279,7 @@ bool NoteNagaSynthFluidSynth::setSoundFont(const std::string &sf2_path) {
   last_error_.clear();
 
   // Reload FluidSynth with new SoundFont
-  if (fluidsynth_) {
-    delete_fluid_synth(fluidsynth_);
-    fluidsynth_ = nullptr;
-  }
-
-  if (synth_settings_) {
-    delete_fluid_settings(synth_settings_);
-    synth_settings_ = nullptr;
-  }
+  releaseFluidsynth();
 
   // Reinitialize FluidSynth
   synth_settings_ = new_fluid_settings();
@@ -308,8 +308,10 @@ bool NoteNagaSynthFluidSynth::setSoundFont(const std::string &sf2_path) {
 
   // Load SoundFont if path is provided
   if (!sf2_path.empty()) {
-    int sfid = fluid_synth_sfload(fluidsynth_, sf2_path.c_str(), 1);
+    soundfont_ = NoteNagaSoundFontPool::instance().acquire(sf2_path);
+    int sfid = soundfont_ ? soundfont_->attach(fluidsynth_) : -1;
     if (sfid < 0) {
+      soundfont_.reset();
       last_error_ = "Failed to load SoundFont: " + sf2_path;
       NOTE_NAGA_LOG_ERROR(last_error_);
       synth_ready_.store(true, std::memory_order_release);
@@ -359,13 +359,13 @@ std::vector<float> MidiSequenceProgressBar::computeWaveformData() const {
         return result;
     }
 
-    std::vector<NoteNagaTrack *> tracks = midi_seq->getTracks();
+    const std::vector<NoteNagaTrack *> &tracks = midi_seq->getTracks();
     std::vector<const NN_Note_t *> notes;
     for (auto *t : tracks) {
         if (!t->isVisible() || t->isMuted() || t->isTempoTrack()) {
             continue;
         }
-        for (const auto &n : t->getNotes()) {
+        for (const auto &n : t->getNotesView()) {
             notes.push_back(&n);
         }
     }
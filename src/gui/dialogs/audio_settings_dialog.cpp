@@ -0,0 +1,133 @@
+#include "audio_settings_dialog.h"
+
+#include <QGridLayout>
+#include <algorithm>
+#include <thread>
+
+#include <note_naga_engine/note_naga_engine.h>
+#include <note_naga_engine/core/render_thread_pool.h>
+
+AudioSettingsDialog::AudioSettingsDialog(QWidget *parent, NoteNagaEngine *engine)
+    : QDialog(parent), m_engine(engine)
+{
+    setWindowTitle(tr("Audio Settings"));
+    setMinimumWidth(400);
+    setModal(true);
+
+    QVBoxLayout *mainLayout = new QVBoxLayout(this);
+    mainLayout->setSpacing(12);
+    mainLayout->setContentsMargins(16, 16, 16, 16);
+
+    // Style for group boxes
+    QString groupBoxStyle = R"(
+        QGroupBox {
+            font-weight: bold;
+            border: 1px solid #3a3d45;
+            border-radius: 6px;
+            margin-top: 12px;
+            padding-top: 4px;
+        }
+        QGroupBox::title {
+            subcontrol-origin: margin;
+            left: 10px;
+            padding: 0 5px;
+        }
+    )";
+
+    // =========================================================================
+    // Rendering Section
+    // =========================================================================
+    QGroupBox *renderGroup = new QGroupBox(tr("Rendering"));
+    renderGroup->setStyleSheet(groupBoxStyle);
+    QGridLayout *renderLayout = new QGridLayout(renderGroup);
+    renderLayout->setSpacing(8);
+    renderLayout->setContentsMargins(12, 16, 12, 12);
+
+    QLabel *threadsLabel = new QLabel(tr("Render threads:"));
+    renderLayout->addWidget(threadsLabel, 0, 0);
+
+    // 0 is shown as "Auto" and lets the pool pick the thread count
+    int maxThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    m_renderThreadsSpin = new QSpinBox();
+    m_renderThreadsSpin->setRange(0, maxThreads);
+    m_renderThreadsSpin->setSpecialValueText(
+        tr("Auto (%1)").arg(NoteNagaRenderThreadPool::defaultThreadCount()));
+    m_renderThreadsSpin->setValue(std::min(m_engine->getRenderThreadCount(), maxThreads));
+    m_renderThreadsSpin->setStyleSheet(R"(
+        QSpinBox {
+            background: #1e2028;
+            border: 1px solid #3a3d45;
+            border-radius: 4px;
+            padding: 4px 8px;
+            color: #e0e0e0;
+        }
+    )");
+    renderLayout->addWidget(m_renderThreadsSpin, 0, 1);
+
+    QLabel *threadsHint = new QLabel(tr("Synthesizers are rendered in parallel. "
+                                        "Set to 1 to render everything on the audio thread."));
+    threadsHint->setWordWrap(true);
+    threadsHint->setStyleSheet("color: #8a8f9a; font-size: 11px;");
+    renderLayout->addWidget(threadsHint, 1, 0, 1, 2);
+
+    m_sampleAccurateCheck = new QCheckBox(tr("Sample-accurate MIDI (audio clock)"));
+    m_sampleAccurateCheck->setChecked(m_engine->isSampleAccurateMidi());
+    renderLayout->addWidget(m_sampleAccurateCheck, 2, 0, 1, 2);
+
+    QLabel *sampleAccurateHint = new QLabel(tr("Notes are timed by the audio output. Playback falls back "
+                                               "to the timer when audio stops. Applies on the next play."));
+    sampleAccurateHint->setWordWrap(true);
+    sampleAccurateHint->setStyleSheet("color: #8a8f9a; font-size: 11px;");
+    renderLayout->addWidget(sampleAccurateHint, 3, 0, 1, 2);
+
+    mainLayout->addWidget(renderGroup);
+
+    // =========================================================================
+    // Dialog Buttons
+    // =========================================================================
+    mainLayout->addStretch();
+
+    QHBoxLayout *buttonRow = new QHBoxLayout();
+    buttonRow->setSpacing(12);
+    buttonRow->addStretch();
+
+    m_applyBtn = new QPushButton(tr("Apply"));
+    m_applyBtn->setStyleSheet(R"(
+        QPushButton {
+            background: #2a6030;
+            border: 1px solid #40a050;
+            border-radius: 4px;
+            padding: 8px 24px;
+            color: #90d090;
+            font-weight: bold;
+        }
+        QPushButton:hover { background: #306838; }
+        QPushButton:pressed { background: #205028; }
+    )");
+    connect(m_applyBtn, &QPushButton::clicked, this, &AudioSettingsDialog::onApply);
+    buttonRow->addWidget(m_applyBtn);
+
+    m_closeBtn = new QPushButton(tr("Close"));
+    m_closeBtn->setStyleSheet(R"(
+        QPushButton {
+            background: #3a4050;
+            border: 1px solid #4a5060;
+            border-radius: 4px;
+            padding: 8px 24px;
+            color: #e0e0e0;
+        }
+        QPushButton:hover { background: #4a5060; }
+        QPushButton:pressed { background: #2a3040; }
+    )");
+    connect(m_closeBtn, &QPushButton::clicked, this, &QDialog::accept);
+    buttonRow->addWidget(m_closeBtn);
+
+    mainLayout->addLayout(buttonRow);
+    setLayout(mainLayout);
+}
+
+void AudioSettingsDialog::onApply()
+{
+    m_engine->setRenderThreadCount(m_renderThreadsSpin->value());
+    m_engine->setSampleAccurateMidi(m_sampleAccurateCheck->isChecked());
+}
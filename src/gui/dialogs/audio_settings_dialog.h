@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QDialog>
+#include <QGroupBox>
+#include <QLabel>
+#include <QPushButton>
+#include <QSpinBox>
+#include <QCheckBox>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+
+class NoteNagaEngine;
+
+/**
+ * @brief Dialog for configuring the audio engine.
+ *        Settings are persisted by the engine and restored on the next start.
+ */
+class AudioSettingsDialog : public QDialog {
+    Q_OBJECT
+public:
+    /**
+     * @brief Constructor for AudioSettingsDialog.
+     * @param parent Parent widget.
+     * @param engine The engine to configure.
+     */
+    explicit AudioSettingsDialog(QWidget *parent, NoteNagaEngine *engine);
+
+private slots:
+    void onApply();
+
+private:
+    NoteNagaEngine *m_engine;
+
+    QSpinBox *m_renderThreadsSpin;
+    QCheckBox *m_sampleAccurateCheck;
+    QPushButton *m_applyBtn;
+    QPushButton *m_closeBtn;
+};
@@ -353,7 +353,11 @@ void AudioItemDelegate::drawWaveformPreview(QPainter *painter, const QRect &rect
 {
     if (!resource || !resource->isLoaded()) return;
     
-    const auto& peaks = resource->getWaveformPeaks();
+    if (rect.width() <= 0) return;
+    
+    // Coarsest pyramid level with at least one peak per pixel
+    int level = resource->selectPeakLevel(static_cast<double>(resource->getTotalSamples()) / rect.width());
+    const auto& peaks = resource->getWaveformPeaks(level);
     if (peaks.empty()) return;
     
     int numPeaks = static_cast<int>(peaks.size());
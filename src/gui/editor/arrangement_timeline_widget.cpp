@@ -1047,10 +1047,7 @@ void ArrangementTimelineWidget::drawAudioClipWaveform(QPainter &painter, const Q
                                                        const NN_AudioClip_t &audioClip,
                                                        const QColor &color)
 {
-    if (!resource || !resource->isLoaded()) return;
-    
-    const auto& peaks = resource->getWaveformPeaks();
-    if (peaks.empty()) return;
+    if (!resource || !resource->isLoaded() || resource->getPeakLevelCount() == 0) return;
     
     // Apply clipping to prevent drawing outside the clip rect
     painter.setClipRect(clipRect);
@@ -1059,10 +1056,6 @@ void ArrangementTimelineWidget::drawAudioClipWaveform(QPainter &painter, const Q
     QRect waveRect = clipRect.adjusted(2, 16, -2, -2);
     int centerY = waveRect.center().y();
     int halfHeight = waveRect.height() / 2 - 1;
-    
-    // Calculate how many samples/peaks we need per pixel
-    int samplesPerPeak = resource->getSamplesPerPeak();
-    int totalPeaks = static_cast<int>(peaks.size());
     int sampleRate = resource->getSampleRate();
     
     // Calculate the offset in samples based on offsetTicks
@@ -1081,34 +1074,37 @@ void ArrangementTimelineWidget::drawAudioClipWaveform(QPainter &painter, const Q
     
     // Calculate duration in samples
     int64_t durationSamples = static_cast<int64_t>((audioClip.durationTicks / ticksPerSecond) * sampleRate);
-    
-    // Map clip offset and duration to peak indices
-    int startPeak = static_cast<int>(totalOffsetSamples / samplesPerPeak);
-    int endPeak = static_cast<int>((totalOffsetSamples + durationSamples) / samplesPerPeak);
-    startPeak = std::max(0, startPeak);
-    endPeak = std::min(endPeak, totalPeaks);
-    int peakCount = endPeak - startPeak;
-    
-    if (peakCount <= 0) {
+    if (durationSamples <= 0 || waveRect.width() <= 0) {
         painter.setClipping(false);
         return;
     }
     
-    // Calculate peaks per pixel
-    float peaksPerPixel = static_cast<float>(peakCount) / waveRect.width();
+    // Pick the pyramid level matching the zoom, so each pixel column
+    // merges only a few peaks
+    double samplesPerPixel = static_cast<double>(durationSamples) / waveRect.width();
+    int level = resource->selectPeakLevel(samplesPerPixel);
+    const auto& peaks = resource->getWaveformPeaks(level);
+    double samplesPerPeak = static_cast<double>(resource->getSamplesPerPeak(level));
+    int64_t totalPeaks = static_cast<int64_t>(peaks.size());
+    
+    // Only visit pixel columns which are visible in the widget
+    int xFirst = std::max(0, -waveRect.left());
+    int xLast = std::min(waveRect.width(), width() - waveRect.left());
     
     painter.setPen(color);
     
-    for (int x = 0; x < waveRect.width(); ++x) {
-        int peakStart = startPeak + static_cast<int>(x * peaksPerPixel);
-        int peakEnd = startPeak + static_cast<int>((x + 1) * peaksPerPixel);
-        peakEnd = std::min(peakEnd, endPeak);
+    for (int x = xFirst; x < xLast; ++x) {
+        double sampleStart = totalOffsetSamples + x * samplesPerPixel;
+        double sampleEnd = totalOffsetSamples + (x + 1) * samplesPerPixel;
+        int64_t peakStart = std::max<int64_t>(0, static_cast<int64_t>(sampleStart / samplesPerPeak));
+        int64_t peakEnd = std::max(peakStart + 1, static_cast<int64_t>(std::ceil(sampleEnd / samplesPerPeak)));
+        peakEnd = std::min(peakEnd, totalPeaks);
         
         if (peakStart >= totalPeaks) break;
         
         // Find min/max across this range
         float minVal = 0, maxVal = 0;
-        for (int p = peakStart; p < peakEnd && p < totalPeaks; ++p) {
+        for (int64_t p = peakStart; p < peakEnd; ++p) {
             minVal = std::min(minVal, std::min(peaks[p].minLeft, peaks[p].minRight));
             maxVal = std::max(maxVal, std::max(peaks[p].maxLeft, peaks[p].maxRight));
         }
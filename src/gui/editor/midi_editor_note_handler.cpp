@@ -5,13 +5,54 @@
 #include <note_naga_engine/note_naga_engine.h>
 
 #include <QGraphicsRectItem>
-#include <QGraphicsEllipseItem>
 #include <QGraphicsScene>
 #include <QTimer>
 #include <algorithm>
 #include <cmath>
 #include <limits>
 
+namespace {
+
+/**
+ * @brief Check whether a note range overlaps a note of the same pitch on a track
+ * (interval query on the track's note snapshot).
+ * @param cols Note snapshot of the track.
+ * @param pitch MIDI note number.
+ * @param start First tick of the range.
+ * @param end End tick of the range (exclusive).
+ * @param ignoredIds Notes to skip (e.g. the ones being moved), may be nullptr.
+ */
+bool overlapsTrackNotes(const NN_NoteColumns_t &cols, int pitch, int start, int end,
+                        const QSet<unsigned long> *ignoredIds = nullptr) {
+    std::vector<uint32_t> rows;
+    cols.findOverlapping(start, end, rows);
+    for (uint32_t row : rows) {
+        if (cols.pitch[row] != pitch) continue;
+        if (ignoredIds && ignoredIds->contains(cols.id[row])) continue;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Check whether any two notes of a set overlap on the same pitch.
+ * @param notes Notes (sorted in place by pitch and start).
+ */
+bool notesOverlapEachOther(std::vector<NN_Note_t> &notes) {
+    std::sort(notes.begin(), notes.end(), [](const NN_Note_t &a, const NN_Note_t &b) {
+        if (a.note != b.note) return a.note < b.note;
+        return a.start.value_or(0) < b.start.value_or(0);
+    });
+    for (size_t i = 1; i < notes.size(); ++i) {
+        const NN_Note_t &prev = notes[i - 1];
+        if (prev.note != notes[i].note) continue;
+        if (notes[i].start.value_or(0) < prev.start.value_or(0) + prev.length.value_or(1)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
 MidiEditorNoteHandler::MidiEditorNoteHandler(MidiEditorWidget *editor, QObject *parent)
     : QObject(parent), m_editor(editor)
 {
@@ -26,36 +67,12 @@ void MidiEditorNoteHandler::selectNote(NoteGraphics *noteGraphics, bool clearPre
     if (!seq) return;
     
     if (clearPrevious) {
-        for (NoteGraphics *ng : m_selectedNotes) {
-            QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng->item);
-            if (shapeItem) {
-                bool is_active_track = seq->getActiveTrack() &&
-                                 seq->getActiveTrack()->getId() == ng->track->getId();
-                shapeItem->setPen(m_editor->getNotePen(ng->track, is_active_track, false));
-                // Active track notes get higher z-value (500+) so they're always on top
-                qreal zVal = is_active_track ? 500 + ng->track->getId() : ng->track->getId() + 10;
-                shapeItem->setZValue(zVal);
-                // Also update label z-value
-                if (ng->label) {
-                    ng->label->setZValue(zVal + 1);
-                }
-            }
-        }
         m_selectedNotes.clear();
     }
     
     if (!m_selectedNotes.contains(noteGraphics)) {
         m_selectedNotes.append(noteGraphics);
-        
-        QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(noteGraphics->item);
-        if (shapeItem) {
-            shapeItem->setPen(m_editor->getNotePen(noteGraphics->track, false, true));
-            shapeItem->setZValue(999);
-            // Also update label z-value
-            if (noteGraphics->label) {
-                noteGraphics->label->setZValue(1000);
-            }
-        }
+        m_editor->updateNoteLayer();
         
         // If single note selection (clearPrevious=true), emit track selection signal
         if (clearPrevious && noteGraphics->track) {
@@ -63,6 +80,8 @@ void MidiEditorNoteHandler::selectNote(NoteGraphics *noteGraphics, bool clearPre
         }
         
         emit selectionChanged();
+    } else if (clearPrevious) {
+        m_editor->updateNoteLayer();
     }
 }
 
@@ -70,24 +89,8 @@ void MidiEditorNoteHandler::deselectNote(NoteGraphics *noteGraphics) {
     if (!noteGraphics) return;
     if (!m_selectedNotes.contains(noteGraphics)) return;
     
-    auto *seq = m_editor->getSequence();
-    if (!seq) return;
-    
     m_selectedNotes.removeOne(noteGraphics);
-    
-    QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(noteGraphics->item);
-    if (shapeItem) {
-        bool is_active_track = seq->getActiveTrack() &&
-                         seq->getActiveTrack()->getId() == noteGraphics->track->getId();
-        shapeItem->setPen(m_editor->getNotePen(noteGraphics->track, is_active_track, false));
-        // Active track notes get higher z-value (500+) so they're always on top
-        qreal zVal = is_active_track ? 500 + noteGraphics->track->getId() : noteGraphics->track->getId() + 10;
-        shapeItem->setZValue(zVal);
-        // Also update label z-value
-        if (noteGraphics->label) {
-            noteGraphics->label->setZValue(zVal + 1);
-        }
-    }
+    m_editor->updateNoteLayer();
     
     emit selectionChanged();
 }
@@ -95,24 +98,8 @@ void MidiEditorNoteHandler::deselectNote(NoteGraphics *noteGraphics) {
 void MidiEditorNoteHandler::clearSelection() {
     if (m_selectedNotes.isEmpty()) return;
     
-    auto *seq = m_editor->getSequence();
-    
-    for (NoteGraphics *ng : m_selectedNotes) {
-        QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng->item);
-        if (shapeItem && seq) {
-            bool is_active_track = seq->getActiveTrack() &&
-                             seq->getActiveTrack()->getId() == ng->track->getId();
-            shapeItem->setPen(m_editor->getNotePen(ng->track, is_active_track, false));
-            // Active track notes get higher z-value (500+) so they're always on top
-            qreal zVal = is_active_track ? 500 + ng->track->getId() : ng->track->getId() + 10;
-            shapeItem->setZValue(zVal);
-            // Also update label z-value
-            if (ng->label) {
-                ng->label->setZValue(zVal + 1);
-            }
-        }
-    }
     m_selectedNotes.clear();
+    m_editor->updateNoteLayer();
     
     emit selectionChanged();
 }
@@ -122,46 +109,27 @@ void MidiEditorNoteHandler::selectNotesInRect(const QRectF &rect) {
     
     for (auto &trackPair : m_noteItems) {
         for (auto &ng : trackPair) {
-            QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng.item);
-            if (shapeItem) {
-                QRectF noteRect = getRealNoteRect(&ng);
-                if (rect.intersects(noteRect)) {
-                    if (!m_selectedNotes.contains(&ng)) {
-                        m_selectedNotes.append(&ng);
-                        shapeItem->setPen(m_editor->getNotePen(ng.track, false, true));
-                        shapeItem->setZValue(999);
-                        // Also update label z-value
-                        if (ng.label) {
-                            ng.label->setZValue(1000);
-                        }
-                    }
-                }
+            if (rect.intersects(getRealNoteRect(&ng)) && !m_selectedNotes.contains(&ng)) {
+                m_selectedNotes.append(&ng);
             }
         }
     }
     
     if (m_selectedNotes.size() != countBefore) {
+        m_editor->updateNoteLayer();
         emit selectionChanged();
     }
 }
 
 void MidiEditorNoteHandler::selectAll() {
-    clearSelection();
+    m_selectedNotes.clear();
     
     for (auto &trackPair : m_noteItems) {
         for (auto &ng : trackPair) {
-            QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng.item);
-            if (shapeItem) {
-                m_selectedNotes.append(&ng);
-                shapeItem->setPen(m_editor->getNotePen(ng.track, false, true));
-                shapeItem->setZValue(999);
-                // Also update label z-value
-                if (ng.label) {
-                    ng.label->setZValue(1000);
-                }
-            }
+            m_selectedNotes.append(&ng);
         }
     }
+    m_editor->updateNoteLayer();
     
     emit selectionChanged();
 }
@@ -173,27 +141,14 @@ void MidiEditorNoteHandler::invertSelection() {
     
     for (auto &trackPair : m_noteItems) {
         for (auto &ng : trackPair) {
-            QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng.item);
-            if (!shapeItem) continue;
-            
-            bool wasSelected = m_selectedNotes.contains(&ng);
-            bool is_active_track = seq->getActiveTrack() &&
-                             seq->getActiveTrack()->getId() == ng.track->getId();
-            
-            if (wasSelected) {
-                // Deselect
-                shapeItem->setPen(m_editor->getNotePen(ng.track, is_active_track, false));
-                shapeItem->setZValue(ng.track->getId() + 10);
-            } else {
-                // Select
+            if (!m_selectedNotes.contains(&ng)) {
                 newSelection.append(&ng);
-                shapeItem->setPen(m_editor->getNotePen(ng.track, false, true));
-                shapeItem->setZValue(999);
             }
         }
     }
     
     m_selectedNotes = newSelection;
+    m_editor->updateNoteLayer();
     emit selectionChanged();
 }
 
@@ -210,25 +165,27 @@ std::vector<std::pair<NoteNagaTrack*, NN_Note_t>> MidiEditorNoteHandler::getSele
 
 // --- Note lookup ---
 
-NoteGraphics* MidiEditorNoteHandler::findNoteUnderCursor(const QPointF &scenePos) {
+qreal MidiEditorNoteHandler::noteZValue(const NoteGraphics *ng) const {
+    if (m_selectedNotes.contains(const_cast<NoteGraphics*>(ng))) return 999;
     auto *seq = m_editor->getSequence();
-    NoteNagaTrack *activeTrack = seq ? seq->getActiveTrack() : nullptr;
-    
+    // Active track notes are painted on top of the other tracks
+    bool is_active_track = seq && seq->getActiveTrack() && seq->getActiveTrack()->getId() == ng->track->getId();
+    return is_active_track ? 500 + ng->track->getId() : ng->track->getId() + 10;
+}
+
+NoteGraphics* MidiEditorNoteHandler::findNoteUnderCursor(const QPointF &scenePos) {
     NoteGraphics *bestNote = nullptr;
     qreal bestZValue = -9999;
     
     for (auto &trackPair : m_noteItems) {
         for (auto &ng : trackPair) {
-            QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng.item);
-            if (shapeItem) {
-                QRectF noteRect = getRealNoteRect(&ng);
-                if (noteRect.contains(scenePos)) {
-                    // Always prefer note with highest z-value (active track notes have z >= 500)
-                    qreal zValue = shapeItem->zValue();
-                    if (zValue > bestZValue) {
-                        bestZValue = zValue;
-                        bestNote = &ng;
-                    }
+            QRectF noteRect = getRealNoteRect(&ng);
+            if (noteRect.contains(scenePos)) {
+                // Always prefer note with highest z-value (active track notes have z >= 500)
+                qreal zValue = noteZValue(&ng);
+                if (zValue > bestZValue) {
+                    bestZValue = zValue;
+                    bestNote = &ng;
                 }
             }
         }
@@ -238,21 +195,21 @@ NoteGraphics* MidiEditorNoteHandler::findNoteUnderCursor(const QPointF &scenePos
 }
 
 bool MidiEditorNoteHandler::isNoteEdge(NoteGraphics *ng, const QPointF &scenePos) {
-    if (!ng || !ng->item) return false;
+    if (!ng) return false;
     QRectF rect = getRealNoteRect(ng);
     return (scenePos.x() >= rect.right() - RESIZE_EDGE_MARGIN && 
             scenePos.x() <= rect.right() + RESIZE_EDGE_MARGIN);
 }
 
 QRectF MidiEditorNoteHandler::getRealNoteRect(const NoteGraphics *ng) const {
-    QRectF rect;
-    if (!ng || !ng->item) return rect;
-    // Check if item is still valid (has scene)
-    if (!ng->item->scene()) return rect;
-    if (QGraphicsRectItem *rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(ng->item)) {
-        rect = rectItem->sceneBoundingRect();
-    } else if (QGraphicsEllipseItem *ellipseItem = qgraphicsitem_cast<QGraphicsEllipseItem*>(ng->item)) {
-        rect = ellipseItem->sceneBoundingRect();
+    if (!ng) return QRectF();
+    QRectF rect = ng->rect;
+    // Selected notes show the drag in progress
+    if (m_dragOffset.isNull() || !m_selectedNotes.contains(const_cast<NoteGraphics*>(ng))) return rect;
+    if (m_dragMode == NoteDragMode::Move) {
+        rect.translate(m_dragOffset);
+    } else if (m_dragMode == NoteDragMode::Resize && !ng->is_drum) {
+        rect.setWidth(std::max<qreal>(1.0, rect.width() + m_dragOffset.x()));
     }
     return rect;
 }
@@ -294,17 +251,10 @@ void MidiEditorNoteHandler::addNewNote(const QPointF &scenePos) {
     newNote.length = std::max(1, noteLength);
 
     // Check for overlap
-    for (const auto& existingNote : activeTrack->getNotes()) {
-        if (existingNote.note == newNote.note) {
-            int newNoteStart = newNote.start.value_or(0);
-            int newNoteEnd = newNoteStart + newNote.length.value_or(0);
-            int existingNoteStart = existingNote.start.value_or(0);
-            int existingNoteEnd = existingNoteStart + existingNote.length.value_or(0);
-
-            if (newNoteStart < existingNoteEnd && existingNoteStart < newNoteEnd) {
-                return; // Overlap found, don't add
-            }
-        }
+    int newNoteStart = newNote.start.value_or(0);
+    if (overlapsTrackNotes(*activeTrack->getNoteColumns(), newNote.note, newNoteStart,
+                           newNoteStart + newNote.length.value_or(0))) {
+        return; // Overlap found, don't add
     }
 
     // Play the note for audio feedback BEFORE adding to track
@@ -339,28 +289,18 @@ void MidiEditorNoteHandler::addNewNote(const QPointF &scenePos) {
 
 void MidiEditorNoteHandler::moveSelectedNotes(const QPointF &delta) {
     if (m_selectedNotes.isEmpty() || (delta.x() == 0 && delta.y() == 0)) return;
-    
-    for (NoteGraphics *ng : m_selectedNotes) {
-        QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng->item);
-        if (shapeItem) {
-            shapeItem->moveBy(delta.x(), delta.y());
-            if (ng->label) {
-                ng->label->moveBy(delta.x(), delta.y());
-            }
-        }
-    }
+    setDragOffset(m_dragOffset + delta);
 }
 
 void MidiEditorNoteHandler::resizeSelectedNotes(const QPointF &delta) {
     if (m_selectedNotes.isEmpty() || delta.x() == 0) return;
-    
-    for (NoteGraphics *ng : m_selectedNotes) {
-        if (QGraphicsRectItem *rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(ng->item)) {
-            QRectF rect = rectItem->rect();
-            qreal newWidth = std::max(1.0, rect.width() + delta.x());
-            rectItem->setRect(rect.x(), rect.y(), newWidth, rect.height());
-        }
-    }
+    setDragOffset(QPointF(m_dragOffset.x() + delta.x(), 0));
+}
+
+void MidiEditorNoteHandler::setDragOffset(const QPointF &offset) {
+    if (offset == m_dragOffset) return;
+    m_dragOffset = offset;
+    m_editor->updateNoteLayer();
 }
 
 void MidiEditorNoteHandler::applyNoteChanges() {
@@ -445,71 +385,43 @@ void MidiEditorNoteHandler::applyNoteChanges() {
         NoteNagaTrack *track = trackIt.key();
         auto &trackChanges = trackIt.value();
         
-        // Get existing notes that are NOT being moved
-        std::vector<NN_Note_t> existingNotes = track->getNotes();
+        // Existing notes that are NOT being moved
+        std::shared_ptr<const NN_NoteColumns_t> cols = track->getNoteColumns();
         QSet<unsigned long> movingNoteIds;
+        std::vector<NN_Note_t> newNotes;
+        newNotes.reserve(trackChanges.size());
         for (const auto& change : trackChanges) {
             movingNoteIds.insert(std::get<1>(change).id);
+            newNotes.push_back(std::get<2>(change));
         }
         
         // Check each new note position for overlaps
-        for (const auto& change : trackChanges) {
-            const NN_Note_t& newNote = std::get<2>(change);
-            
-            // Check against existing notes (not being moved)
-            for (const auto& existing : existingNotes) {
-                if (movingNoteIds.contains(existing.id)) continue; // Skip notes being moved
-                if (existing.note != newNote.note) continue; // Different pitch, no overlap
-                
-                int newStart = newNote.start.value_or(0);
-                int newEnd = newStart + newNote.length.value_or(minNoteLength);
-                int existingStart = existing.start.value_or(0);
-                int existingEnd = existingStart + existing.length.value_or(1);
-                
-                if (newStart < existingEnd && existingStart < newEnd) {
-                    anyOverlap = true;
-                    break;
-                }
-            }
-            if (anyOverlap) break;
-            
-            // Check against other moving notes (in case they overlap each other after move)
-            for (const auto& otherChange : trackChanges) {
-                if (&otherChange == &change) continue;
-                const NN_Note_t& otherNote = std::get<2>(otherChange);
-                if (otherNote.note != newNote.note) continue;
-                
-                int newStart = newNote.start.value_or(0);
-                int newEnd = newStart + newNote.length.value_or(minNoteLength);
-                int otherStart = otherNote.start.value_or(0);
-                int otherEnd = otherStart + otherNote.length.value_or(1);
-                
-                if (newStart < otherEnd && otherStart < newEnd) {
-                    anyOverlap = true;
-                    break;
-                }
+        for (const NN_Note_t &newNote : newNotes) {
+            int newStart = newNote.start.value_or(0);
+            int newEnd = newStart + newNote.length.value_or(minNoteLength);
+            if (overlapsTrackNotes(*cols, newNote.note, newStart, newEnd, &movingNoteIds)) {
+                anyOverlap = true;
+                break;
             }
-            if (anyOverlap) break;
+        }
+        
+        // Check against other moving notes (in case they overlap each other after move)
+        if (!anyOverlap && notesOverlapEachOther(newNotes)) {
+            anyOverlap = true;
         }
     }
     
     // If overlap detected, cancel entire operation
     if (anyOverlap) {
         // Reset visual positions
-        for (NoteGraphics *ng : m_selectedNotes) {
-            if (ng->item) ng->item->setPos(0, 0);
-            if (ng->label) ng->label->setPos(0, 0);
-        }
+        setDragOffset(QPointF());
         clearGhostPreview();
         m_dragStartNoteStates.clear();
         return;
     }
     
-    // Reset visual positions before refresh (they were moved via setPos during drag)
-    for (NoteGraphics *ng : m_selectedNotes) {
-        if (ng->item) ng->item->setPos(0, 0);
-        if (ng->label) ng->label->setPos(0, 0);
-    }
+    // Reset visual positions before refresh (the drag was only shown by the note layer)
+    setDragOffset(QPointF());
     
     // Clear ghost preview
     clearGhostPreview();
@@ -616,8 +528,8 @@ void MidiEditorNoteHandler::moveSelectedNotesToTrack(NoteNagaTrack *targetTrack)
     auto *seq = m_editor->getSequence();
     if (!seq) return;
     
-    // Get existing notes on target track for overlap check
-    std::vector<NN_Note_t> targetExisting = targetTrack->getNotes();
+    // Existing notes on target track for overlap check
+    std::shared_ptr<const NN_NoteColumns_t> targetCols = targetTrack->getNoteColumns();
     
     // Collect notes that can be moved (no overlap)
     // Format: sourceTrack, targetTrack, originalNote, newNote
@@ -632,19 +544,8 @@ void MidiEditorNoteHandler::moveSelectedNotesToTrack(NoteNagaTrack *targetTrack)
         bool hasOverlap = false;
         
         // Check for overlap with existing notes on target track
-        for (const auto &existing : targetExisting) {
-            if (existing.note != note.note) continue;
-            
-            int noteStart = note.start.value_or(0);
-            int noteEnd = noteStart + note.length.value_or(1);
-            int existingStart = existing.start.value_or(0);
-            int existingEnd = existingStart + existing.length.value_or(1);
-            
-            if (noteStart < existingEnd && existingStart < noteEnd) {
-                hasOverlap = true;
-                break;
-            }
-        }
+        int noteStart = note.start.value_or(0);
+        hasOverlap = overlapsTrackNotes(*targetCols, note.note, noteStart, noteStart + note.length.value_or(1));
         
         // Also check against notes we're about to move
         if (!hasOverlap) {
@@ -791,6 +692,7 @@ void MidiEditorNoteHandler::updateDrag(const QPointF &pos) {
 
 void MidiEditorNoteHandler::endDrag() {
     m_dragMode = NoteDragMode::None;
+    setDragOffset(QPointF());
     m_dragStartNoteStates.clear();
     clearGhostPreview();
 }
@@ -878,31 +780,8 @@ void MidiEditorNoteHandler::clearGhostPreview() {
 // --- Note items management ---
 
 void MidiEditorNoteHandler::clearNoteItems() {
+    // Notes are painted by the note layer, there are no scene items to delete
     m_selectedNotes.clear();
-    
-    auto *scene = m_editor->getScene();
-    if (!scene) {
-        m_noteItems.clear();
-        return;
-    }
-    
-    for (auto &arr : m_noteItems) {
-        for (auto &ng : arr) {
-            // Check if item is still valid and belongs to a scene before removing
-            if (ng.item && ng.item->scene()) {
-                scene->removeItem(ng.item);
-                delete ng.item;
-            }
-            ng.item = nullptr;
-            
-            if (ng.label && ng.label->scene()) {
-                scene->removeItem(ng.label);
-                delete ng.label;
-            }
-            ng.label = nullptr;
-        }
-    }
-    
     m_noteItems.clear();
 }
 
@@ -915,26 +794,7 @@ void MidiEditorNoteHandler::clearTrackNoteItems(int trackId) {
             ++i;
         }
     }
-    
-    auto *scene = m_editor->getScene();
-    auto it = m_noteItems.find(trackId);
-    if (it != m_noteItems.end()) {
-        for (auto &ng : it.value()) {
-            // Check if item is still valid and belongs to a scene before removing
-            if (ng.item && scene && ng.item->scene()) {
-                scene->removeItem(ng.item);
-                delete ng.item;
-            }
-            ng.item = nullptr;
-            
-            if (ng.label && scene && ng.label->scene()) {
-                scene->removeItem(ng.label);
-                delete ng.label;
-            }
-            ng.label = nullptr;
-        }
-        m_noteItems.erase(it);
-    }
+    m_noteItems.remove(trackId);
 }
 
 // --- Copy/Paste ---
@@ -1056,42 +916,21 @@ void MidiEditorNoteHandler::commitPaste(const QPointF &scenePos) {
         NoteNagaTrack *track = seq->getTrackById(it.key());
         if (!track) continue;
         
-        std::vector<NN_Note_t> existingNotes = track->getNotes();
-        const QList<NN_Note_t> &notesToAdd = it.value();
+        std::shared_ptr<const NN_NoteColumns_t> cols = track->getNoteColumns();
+        std::vector<NN_Note_t> notesToAdd(it.value().begin(), it.value().end());
         
+        // Check against existing notes
         for (const NN_Note_t &newNote : notesToAdd) {
-            // Check against existing notes
-            for (const auto &existing : existingNotes) {
-                if (existing.note != newNote.note) continue;
-                
-                int newStart = newNote.start.value_or(0);
-                int newEnd = newStart + newNote.length.value_or(gridStep);
-                int existingStart = existing.start.value_or(0);
-                int existingEnd = existingStart + existing.length.value_or(1);
-                
-                if (newStart < existingEnd && existingStart < newEnd) {
-                    anyOverlap = true;
-                    break;
-                }
-            }
-            if (anyOverlap) break;
-            
-            // Check against other notes being pasted to same track
-            for (const NN_Note_t &otherNew : notesToAdd) {
-                if (&otherNew == &newNote) continue;
-                if (otherNew.note != newNote.note) continue;
-                
-                int newStart = newNote.start.value_or(0);
-                int newEnd = newStart + newNote.length.value_or(gridStep);
-                int otherStart = otherNew.start.value_or(0);
-                int otherEnd = otherStart + otherNew.length.value_or(1);
-                
-                if (newStart < otherEnd && otherStart < newEnd) {
-                    anyOverlap = true;
-                    break;
-                }
+            int newStart = newNote.start.value_or(0);
+            if (overlapsTrackNotes(*cols, newNote.note, newStart, newStart + newNote.length.value_or(gridStep))) {
+                anyOverlap = true;
+                break;
             }
-            if (anyOverlap) break;
+        }
+        
+        // Check against other notes being pasted to same track
+        if (!anyOverlap && notesOverlapEachOther(notesToAdd)) {
+            anyOverlap = true;
         }
     }
     
@@ -10,7 +10,6 @@
 
 class MidiEditorWidget;
 class QGraphicsScene;
-class QAbstractGraphicsShapeItem;
 class UndoManager;
 
 /**
@@ -49,7 +48,8 @@ public:
     // --- Note lookup ---
     NoteGraphics* findNoteUnderCursor(const QPointF &scenePos);
     bool isNoteEdge(NoteGraphics *note, const QPointF &scenePos);
-    QRectF getRealNoteRect(const NoteGraphics *ng) const;
+    QRectF getRealNoteRect(const NoteGraphics *ng) const; ///< Scene rectangle including drag feedback
+    qreal noteZValue(const NoteGraphics *ng) const;        ///< Stacking order (selected > active track > others)
     
     // --- Note creation ---
     void addNewNote(const QPointF &scenePos);
@@ -57,6 +57,7 @@ public:
     // --- Note manipulation ---
     void moveSelectedNotes(const QPointF &delta);
     void resizeSelectedNotes(const QPointF &delta);
+    void setDragOffset(const QPointF &offset); ///< Visual drag delta of the selected notes (painted only)
     void applyNoteChanges();
     void deleteSelectedNotes();
     void deleteNote(NoteGraphics *note);
@@ -84,6 +85,7 @@ public:
     void endDrag();
     NoteDragMode dragMode() const { return m_dragMode; }
     QPointF dragStartPos() const { return m_dragStartPos; }
+    QPointF dragOffset() const { return m_dragOffset; }
     
     // --- Ghost preview ---
     void updateGhostPreview(const QPointF &currentPos);
@@ -111,6 +113,7 @@ private:
     NoteDragMode m_dragMode = NoteDragMode::None;
     QPointF m_dragStartPos;
     QPointF m_lastDragPos;
+    QPointF m_dragOffset;
     QMap<NoteGraphics*, NN_Note_t> m_dragStartNoteStates;
     QList<QGraphicsItem*> m_ghostItems;
     
@@ -0,0 +1,120 @@
+#include "midi_editor_note_layer.h"
+#include "midi_editor_widget.h"
+#include "midi_editor_note_handler.h"
+
+#include <QPainter>
+#include <QSet>
+#include <QStyleOptionGraphicsItem>
+#include <algorithm>
+
+MidiEditorNoteLayer::MidiEditorNoteLayer(MidiEditorWidget *editor)
+    : m_editor(editor)
+{
+    // exposedRect is only filled in with this flag
+    setFlag(QGraphicsItem::ItemUsesExtendedStyleOption, true);
+    m_bounds = editor->sceneRect();
+}
+
+QRectF MidiEditorNoteLayer::boundingRect() const {
+    return m_bounds;
+}
+
+void MidiEditorNoteLayer::updateGeometry() {
+    if (m_bounds == m_editor->sceneRect()) return;
+    prepareGeometryChange();
+    m_bounds = m_editor->sceneRect();
+}
+
+QColor MidiEditorNoteLayer::noteFillColor(const NoteGraphics &ng) const {
+    NoteNagaMidiSeq *seq = m_editor->getSequence();
+    bool is_active_track = seq && seq->getActiveTrack() && seq->getActiveTrack()->getId() == ng.track->getId();
+    QColor baseColor = m_editor->getNoteColor(ng.note, ng.track);
+    if (is_active_track) return baseColor;
+    return nn_color_blend(NN_Color_t::fromQColor(baseColor), NN_Color_t::fromQColor(m_editor->colors().bg_color), 0.3)
+        .toQColor();
+}
+
+void MidiEditorNoteLayer::addToBatch(Batch &batch, const NoteGraphics &ng, const QRectF &rect,
+                                     const QRectF &exposed) const {
+    if (ng.is_drum) {
+        // Drum hits are circles centered in the note rectangle
+        int sz = rect.height() * 0.6;
+        QRectF circle(int(rect.x() + rect.width() / 2) - sz / 2, int(rect.y() + rect.height() / 2) - sz / 2, sz, sz);
+        if (!circle.intersects(exposed)) return;
+        batch.ellipses[noteFillColor(ng).rgba()].append(circle);
+        return;
+    }
+    // Outlines reach one pixel past the rectangle
+    if (!rect.adjusted(-2, -2, 2, 2).intersects(exposed)) return;
+    batch.rects[noteFillColor(ng).rgba()].append(rect);
+    if (rect.width() > 20 && rect.height() > 9 && m_editor->getConfig()->time_scale > 0.04) {
+        batch.labels.append(&ng);
+    }
+}
+
+void MidiEditorNoteLayer::paintBatch(QPainter *painter, const Batch &batch, const QPen &pen) const {
+    painter->setPen(pen);
+    for (auto it = batch.rects.constBegin(); it != batch.rects.constEnd(); ++it) {
+        painter->setBrush(QColor::fromRgba(it.key()));
+        painter->drawRects(it.value());
+    }
+    for (auto it = batch.ellipses.constBegin(); it != batch.ellipses.constEnd(); ++it) {
+        painter->setBrush(QColor::fromRgba(it.key()));
+        for (const QRectF &circle : it.value()) painter->drawEllipse(circle);
+    }
+
+    if (batch.labels.isEmpty()) return;
+    const int h = m_editor->getConfig()->key_height;
+    painter->setFont(QFont("Arial", std::max(6, h - 6)));
+    for (const NoteGraphics *ng : batch.labels) {
+        QRectF rect = m_editor->getNoteHandler()->getRealNoteRect(ng);
+        float luminance = nn_yiq_luminance(NN_Color_t::fromQColor(noteFillColor(*ng)));
+        painter->setPen(luminance < 128 ? Qt::white : Qt::black);
+        painter->drawText(QRectF(rect.x() + 2, rect.y() + 2, rect.width(), rect.height()),
+                          Qt::AlignLeft | Qt::AlignTop | Qt::TextDontClip,
+                          QString::fromStdString(nn_note_name(ng->note.note)));
+    }
+}
+
+void MidiEditorNoteLayer::paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget) {
+    Q_UNUSED(widget);
+    NoteNagaMidiSeq *seq = m_editor->getSequence();
+    if (!seq) return;
+
+    MidiEditorNoteHandler *handler = m_editor->getNoteHandler();
+    const QRectF exposed = option->exposedRect;
+    const QSet<const NoteGraphics *> selected(handler->selectedNotes().constBegin(),
+                                              handler->selectedNotes().constEnd());
+    NoteNagaTrack *activeTrack = seq->getActiveTrack();
+
+    // Same stacking as before: other tracks by ID, then the active track, then the selection
+    const QMap<int, std::list<NoteGraphics>> &noteItems = handler->noteItems();
+    const std::list<NoteGraphics> *activeNotes = nullptr;
+    for (auto it = noteItems.constBegin(); it != noteItems.constEnd(); ++it) {
+        if (it.value().empty()) continue;
+        if (activeTrack && it.key() == activeTrack->getId()) {
+            activeNotes = &it.value();
+            continue;
+        }
+        Batch batch;
+        for (const NoteGraphics &ng : it.value()) {
+            if (!selected.contains(&ng)) addToBatch(batch, ng, ng.rect, exposed);
+        }
+        paintBatch(painter, batch, m_editor->getNotePen(it.value().front().track, false, false));
+    }
+    if (activeNotes) {
+        Batch batch;
+        for (const NoteGraphics &ng : *activeNotes) {
+            if (!selected.contains(&ng)) addToBatch(batch, ng, ng.rect, exposed);
+        }
+        paintBatch(painter, batch, m_editor->getNotePen(activeNotes->front().track, true, false));
+    }
+    if (!selected.isEmpty()) {
+        // Selected notes follow the drag (getRealNoteRect includes the drag feedback)
+        Batch batch;
+        for (const NoteGraphics *ng : handler->selectedNotes()) {
+            addToBatch(batch, *ng, handler->getRealNoteRect(ng), exposed);
+        }
+        paintBatch(painter, batch, m_editor->getNotePen(nullptr, false, true));
+    }
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <QGraphicsItem>
+#include <QColor>
+#include <QHash>
+#include <QVector>
+#include <QRectF>
+
+#include "midi_editor_types.h"
+
+class MidiEditorWidget;
+
+/**
+ * @brief Single scene item that paints all notes of the MIDI editor.
+ *
+ * The notes are not scene items: the editor keeps only the notes intersecting the
+ * viewport (NoteGraphics, found through the per-track note column snapshots) and this
+ * layer paints the ones inside the exposed rectangle. Rectangles sharing a fill color
+ * are drawn in one call. Selection and drag feedback are painted from the note handler
+ * state, so changing them only repaints the layer.
+ */
+class MidiEditorNoteLayer : public QGraphicsItem {
+public:
+    explicit MidiEditorNoteLayer(MidiEditorWidget *editor);
+
+    QRectF boundingRect() const override;
+    void paint(QPainter *painter, const QStyleOptionGraphicsItem *option, QWidget *widget = nullptr) override;
+
+    /**
+     * @brief Must be called when the scene rectangle of the editor changes.
+     */
+    void updateGeometry();
+
+private:
+    /// Notes of one paint group (track or selection) batched by fill color
+    struct Batch {
+        QHash<QRgb, QVector<QRectF>> rects;    ///< Rectangle notes per fill color
+        QHash<QRgb, QVector<QRectF>> ellipses; ///< Drum notes per fill color
+        QVector<const NoteGraphics *> labels;  ///< Notes wide enough for a name
+    };
+
+    /**
+     * @brief Add a note to a batch.
+     * @param batch Target batch.
+     * @param ng Note.
+     * @param rect Scene rectangle to paint (including drag feedback).
+     * @param exposed Exposed rectangle, notes outside it are skipped.
+     */
+    void addToBatch(Batch &batch, const NoteGraphics &ng, const QRectF &rect, const QRectF &exposed) const;
+
+    /**
+     * @brief Paint a batch with one outline pen.
+     */
+    void paintBatch(QPainter *painter, const Batch &batch, const QPen &pen) const;
+
+    /**
+     * @brief Fill color of a note (full color on the active track, blended with the background otherwise).
+     */
+    QColor noteFillColor(const NoteGraphics &ng) const;
+
+    MidiEditorWidget *m_editor;
+    QRectF m_bounds;
+};
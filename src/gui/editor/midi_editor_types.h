@@ -3,6 +3,7 @@
 #include <QColor>
 #include <QGraphicsItem>
 #include <QGraphicsSimpleTextItem>
+#include <QRectF>
 #include <note_naga_engine/note_naga_engine.h>
 
 /** MIDI editor follow modes */
@@ -51,10 +52,10 @@ struct MidiEditorConfig {
     NoteColorMode color_mode = NoteColorMode::TrackColor;
 };
 
-/** Graphics representation of a note */
+/** Visible note of the editor (painted by MidiEditorNoteLayer) */
 struct NoteGraphics {
-    QGraphicsItem *item = nullptr;           // Graphic object for the note
-    QGraphicsSimpleTextItem *label = nullptr; // Text label for the note
+    QRectF rect;                             // Scene rectangle (without drag feedback)
+    bool is_drum = false;                    // Drawn as a circle (percussion track)
     NN_Note_t note;                          // Note data
     NoteNagaTrack *track = nullptr;          // Track the note belongs to
 };
@@ -1,6 +1,7 @@
 #include "midi_editor_widget.h"
 #include "midi_editor_context_menu.h"
 #include "midi_editor_note_handler.h"
+#include "midi_editor_note_layer.h"
 #include "../undo/undo_manager.h"
 
 #include <QHBoxLayout>
@@ -11,9 +12,11 @@
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QTimer>
+#include <QHash>
 #include <algorithm>
 #include <cmath>
 #include <climits>
+#include <utility>
 #include <QApplication>
 #include <QCursor>
 
@@ -56,8 +59,8 @@ MidiEditorWidget::MidiEditorWidget(NoteNagaEngine *engine, QWidget *parent)
     connect(m_noteHandler, &MidiEditorNoteHandler::notesModified, this, &MidiEditorWidget::notesModified);
     connect(m_noteHandler, &MidiEditorNoteHandler::noteTrackSelected, this, &MidiEditorWidget::noteTrackSelected);
     
-    // Refresh editor when notes are modified (added, deleted, moved, etc.)
-    connect(m_noteHandler, &MidiEditorNoteHandler::notesModified, this, &MidiEditorWidget::refreshAll);
+    // Note edits run through undo commands, which hand their applied change sets to
+    // applyNoteChangeSet(), so notesModified needs no full refresh of the scene
     
     // Connect context menu signals
     connect(m_contextMenu, &MidiEditorContextMenu::colorModeChanged, this, &MidiEditorWidget::onColorModeChanged);
@@ -149,7 +152,16 @@ void MidiEditorWidget::setupConnections() {
             });
 
     connect(project, &NoteNagaRuntimeData::trackMetaChanged, this,
-            [this](NoteNagaTrack *track, const std::string &) {
+            [this](NoteNagaTrack *track, const std::string &param) {
+                if (param == "notes") {
+                    // Undo commands follow up with applyNoteChangeSet() which clears the mark,
+                    // edits from elsewhere get one full refresh after the current event
+                    if (m_staleTracks.isEmpty()) {
+                        QTimer::singleShot(0, this, &MidiEditorWidget::refreshStaleTracks);
+                    }
+                    m_staleTracks.insert(track);
+                    return;
+                }
                 refreshTrack(track);
             });
 
@@ -355,6 +367,74 @@ void MidiEditorWidget::refreshTrack(NoteNagaTrack *track) {
     refreshAll();
 }
 
+void MidiEditorWidget::applyNoteChangeSet(NoteNagaTrack *track, const NN_NoteChangeSet_t &changes) {
+    if (!track) return;
+    m_staleTracks.remove(track);
+    if (!last_seq || changes.empty() || track->getParent() != last_seq) return;
+
+    if (track->isVisible()) {
+        QSet<unsigned long> removed;
+        for (const NN_Note_t &note : changes.removed) removed.insert(note.id);
+        QHash<unsigned long, const NN_Note_t *> updated;
+        for (const NN_Note_t &note : changes.updated) updated.insert(note.id, &note);
+
+        bool is_drum = track->getChannel().value_or(0) == 9;
+        auto &notes = m_noteHandler->noteItems()[track->getId()];
+        for (auto it = notes.begin(); it != notes.end();) {
+            const unsigned long id = it->note.id;
+            QRectF rect;
+            if (removed.contains(id) ||
+                (updated.contains(id) && !visibleNoteRect(*updated.value(id), rect))) {
+                m_noteHandler->deselectNote(&*it);
+                it = notes.erase(it);
+                continue;
+            }
+            if (updated.contains(id)) {
+                it->rect = rect;
+                it->note = *updated.take(id);
+                it->note.parent = track;
+            }
+            ++it;
+        }
+
+        // Added notes and updated notes that moved into the viewport
+        auto addItem = [&](const NN_Note_t &note) {
+            QRectF rect;
+            if (!visibleNoteRect(note, rect)) return;
+            NN_Note_t shown = note;
+            shown.parent = track;
+            notes.push_back({rect, is_drum, shown, track});
+        };
+        for (const NN_Note_t &note : changes.added) addItem(note);
+        for (const NN_Note_t *note : std::as_const(updated)) addItem(*note);
+        updateNoteLayer();
+    }
+
+    // Row backgrounds and lines span the content width, bar lines only the viewport. Done
+    // last: a clamped scroll bar may trigger refreshAll(), which rebuilds the notes anyway
+    const int old_width = content_width;
+    recalculateContentSize();
+    if (content_width != old_width) {
+        for (QGraphicsRectItem *row : row_backgrounds) {
+            QRectF r = row->rect();
+            r.setWidth(content_width);
+            row->setRect(r);
+        }
+        for (QGraphicsLineItem *line : grid_lines) {
+            QLineF l = line->line();
+            l.setP2(QPointF(content_width, l.y2()));
+            line->setLine(l);
+        }
+    }
+    emit dataRefreshed();
+}
+
+void MidiEditorWidget::refreshStaleTracks() {
+    if (m_staleTracks.isEmpty()) return;
+    m_staleTracks.clear();
+    refreshAll();
+}
+
 void MidiEditorWidget::refreshSequence(NoteNagaMidiSeq *seq) {
     bool isNewSequence = (last_seq != seq);
     this->last_seq = seq;
@@ -659,22 +739,8 @@ void MidiEditorWidget::mouseMoveEvent(QMouseEvent *event) {
         // This prevents accumulating errors and "jumping"
         QPointF totalDelta = scenePos - m_noteHandler->dragStartPos();
         
-        // Reset notes to original positions and apply new delta
-        for (NoteGraphics *ng : m_noteHandler->selectedNotes()) {
-            QAbstractGraphicsShapeItem *shapeItem = qgraphicsitem_cast<QAbstractGraphicsShapeItem*>(ng->item);
-            if (shapeItem) {
-                // Calculate original position from stored note state
-                auto *config = getConfig();
-                int origX = ng->note.start.value_or(0) * config->time_scale;
-                int origY = content_height - (ng->note.note - 0 + 1) * config->key_height;
-                
-                // Apply delta to get new visual position
-                shapeItem->setPos(totalDelta.x(), totalDelta.y());
-                if (ng->label) {
-                    ng->label->setPos(totalDelta.x(), totalDelta.y());
-                }
-            }
-        }
+        // The note layer paints the selected notes shifted by the delta
+        m_noteHandler->setDragOffset(totalDelta);
         
         // Update ghost preview showing snapped positions
         m_noteHandler->updateGhostPreview(scenePos);
@@ -684,17 +750,7 @@ void MidiEditorWidget::mouseMoveEvent(QMouseEvent *event) {
     else if (dragMode == NoteDragMode::Resize && m_noteHandler->hasSelection()) {
         QPointF totalDelta = scenePos - m_noteHandler->dragStartPos();
         
-        for (NoteGraphics *ng : m_noteHandler->selectedNotes()) {
-            if (QGraphicsRectItem *rectItem = qgraphicsitem_cast<QGraphicsRectItem*>(ng->item)) {
-                // Get original dimensions
-                auto *config = getConfig();
-                int origWidth = ng->note.length.value_or(1) * config->time_scale;
-                qreal newWidth = std::max(1.0, origWidth + totalDelta.x());
-                
-                QRectF rect = rectItem->rect();
-                rectItem->setRect(rect.x(), rect.y(), newWidth, rect.height());
-            }
-        }
+        m_noteHandler->setDragOffset(QPointF(totalDelta.x(), 0));
         m_noteHandler->updateDrag(scenePos);
     }
     else if (dragMode == NoteDragMode::None) {
@@ -862,6 +918,7 @@ void MidiEditorWidget::recalculateContentSize() {
         content_height = (MAX_NOTE - MIN_NOTE + 1) * config.key_height;
     }
     setSceneRect(0, 0, content_width, content_height);
+    if (m_noteLayer) m_noteLayer->updateGeometry();
     
     // Notify timeline overview about new max tick
     emit contentSizeChanged(getMaxTickFromContent());
@@ -881,6 +938,11 @@ void MidiEditorWidget::updateScene() {
 
     updateGrid();
     updateBarGrid();
+
+    // All notes are painted by one item above the grid and below the marker
+    m_noteLayer = new MidiEditorNoteLayer(this);
+    m_noteLayer->setZValue(10);
+    scene->addItem(m_noteLayer);
     updateAllNotes();
     refreshMarker();
 }
@@ -965,21 +1027,19 @@ void MidiEditorWidget::updateActiveNotes() {
     
     int currentTick = engine->getRuntimeData()->getCurrentTick();
     const auto& tracks = last_seq->getTracks();
+    std::vector<uint32_t> rows;
     
     for (int trackIdx = 0; trackIdx < (int)tracks.size(); ++trackIdx) {
         const auto& track = tracks[trackIdx];
         if (!track || !track->isVisible()) continue;
         
-        for (const auto& note : track->getNotes()) {
-            if (!note.start.has_value() || !note.length.has_value()) continue;
-            
-            int noteStart = note.start.value();
-            int noteEnd = noteStart + note.length.value();
-            
-            if (currentTick >= noteStart && currentTick < noteEnd) {
-                if (!m_activeNotes.contains(note.note)) {
-                    m_activeNotes.insert(note.note, trackIdx);
-                }
+        // Interval query on the track's note snapshot
+        std::shared_ptr<const NN_NoteColumns_t> cols = track->getNoteColumns();
+        rows.clear();
+        cols->findSounding(currentTick, rows);
+        for (uint32_t row : rows) {
+            if (!m_activeNotes.contains(cols->pitch[row])) {
+                m_activeNotes.insert(cols->pitch[row], trackIdx);
             }
         }
     }
@@ -1051,34 +1111,12 @@ void MidiEditorWidget::updateBarGrid() {
 void MidiEditorWidget::updateAllNotes() {
     m_noteHandler->clearNoteItems();
     if (!last_seq) return;
-    
-    int visible_x0 = horizontalScrollBar()->value();
-    int visible_x1 = visible_x0 + viewport()->width();
-    int visible_y0 = verticalScrollBar()->value();
-    int visible_y1 = visible_y0 + viewport()->height();
 
     for (const auto &track : last_seq->getTracks()) {
         if (!track || !track->isVisible()) continue;
-        
-        // Check if this is a percussion track (MIDI channel 10 / index 9)
-        bool is_drum = track->getChannel().value_or(0) == 9;
-        bool is_selected = last_seq->getActiveTrack() &&
-                         last_seq->getActiveTrack()->getId() == track->getId();
-
-        for (const auto &note : track->getNotes()) {
-            if (!note.start.has_value() || !note.length.has_value()) continue;
-            
-            int y = content_height - (note.note - MIN_NOTE + 1) * config.key_height;
-            int x = note.start.value() * config.time_scale;
-            int w = std::max(1, int(note.length.value() * config.time_scale));
-            int h = config.key_height;
-            
-            if (!((x + w > visible_x0 && x < visible_x1) &&
-                (y + h > visible_y0 && y < visible_y1))) continue;
-                
-            drawNote(note, track, is_selected, is_drum, x, y, w, h);
-        }
+        collectVisibleNotes(track);
     }
+    updateNoteLayer();
 }
 
 void MidiEditorWidget::updateTrackNotes(NoteNagaTrack *track) {
@@ -1087,6 +1125,11 @@ void MidiEditorWidget::updateTrackNotes(NoteNagaTrack *track) {
     // Don't draw notes for invisible tracks
     if (!track->isVisible()) return;
     
+    collectVisibleNotes(track);
+    updateNoteLayer();
+}
+
+void MidiEditorWidget::collectVisibleNotes(NoteNagaTrack *track) {
     int visible_x0 = horizontalScrollBar()->value();
     int visible_x1 = visible_x0 + viewport()->width();
     int visible_y0 = verticalScrollBar()->value();
@@ -1094,24 +1137,50 @@ void MidiEditorWidget::updateTrackNotes(NoteNagaTrack *track) {
 
     // Check if this is a percussion track (MIDI channel 10 / index 9)
     bool is_drum = track->getChannel().value_or(0) == 9;
-    bool is_selected = last_seq->getActiveTrack() &&
-                     last_seq->getActiveTrack()->getId() == track->getId();
 
-    for (const auto &note : track->getNotes()) {
-        if (!note.start.has_value() || !note.length.has_value()) continue;
-        
-        int y = content_height - (note.note - MIN_NOTE + 1) * config.key_height;
-        int x = note.start.value() * config.time_scale;
-        int w = std::max(1, int(note.length.value() * config.time_scale));
+    // Interval query on the track's note snapshot for the visible tick range
+    std::shared_ptr<const NN_NoteColumns_t> cols = track->getNoteColumns();
+    if (!cols || cols->empty()) return;
+    int tick0 = sceneXToTick(visible_x0);
+    int tick1 = static_cast<int>(visible_x1 / config.time_scale) + 1;
+    std::vector<uint32_t> rows;
+    cols->findOverlapping(tick0, tick1 + 1, rows);
+
+    auto &notes = m_noteHandler->noteItems()[track->getId()];
+    for (uint32_t row : rows) {
+        int y = content_height - (cols->pitch[row] - MIN_NOTE + 1) * config.key_height;
+        int x = cols->start[row] * config.time_scale;
+        int w = std::max(1, int(cols->length[row] * config.time_scale));
         int h = config.key_height;
-        
+
         if (!((x + w > visible_x0 && x < visible_x1) &&
               (y + h > visible_y0 && y < visible_y1))) continue;
-              
-        drawNote(note, track, is_selected, is_drum, x, y, w, h);
+
+        notes.push_back({QRectF(x, y, w, h), is_drum, cols->toNote(row, track), track});
     }
 }
 
+bool MidiEditorWidget::visibleNoteRect(const NN_Note_t &note, QRectF &rect) const {
+    if (!note.start.has_value() || !note.length.has_value()) return false;
+    int visible_x0 = horizontalScrollBar()->value();
+    int visible_x1 = visible_x0 + viewport()->width();
+    int visible_y0 = verticalScrollBar()->value();
+    int visible_y1 = visible_y0 + viewport()->height();
+
+    int pitch = std::clamp(note.note, 0, 127);
+    int y = content_height - (pitch - MIN_NOTE + 1) * config.key_height;
+    int x = *note.start * config.time_scale;
+    int w = std::max(1, int(*note.length * config.time_scale));
+    int h = config.key_height;
+    if (!((x + w > visible_x0 && x < visible_x1) && (y + h > visible_y0 && y < visible_y1))) return false;
+    rect = QRectF(x, y, w, h);
+    return true;
+}
+
+void MidiEditorWidget::updateNoteLayer() {
+    if (m_noteLayer) m_noteLayer->update();
+}
+
 QColor MidiEditorWidget::getNoteColor(const NN_Note_t &note, const NoteNagaTrack *track) const {
     switch (config.color_mode) {
     case NoteColorMode::Velocity: {
@@ -1145,48 +1214,6 @@ QColor MidiEditorWidget::getNoteColor(const NN_Note_t &note, const NoteNagaTrack
     }
 }
 
-void MidiEditorWidget::drawNote(const NN_Note_t &note, const NoteNagaTrack *track,
-                                bool is_selected, bool is_drum, int x, int y, int w, int h) {
-    QGraphicsItem *shape = nullptr;
-    
-    QColor baseColor = getNoteColor(note, track);
-    NN_Color_t t_color = is_selected ? NN_Color_t::fromQColor(baseColor)
-                                     : nn_color_blend(NN_Color_t::fromQColor(baseColor),
-                                                      NN_Color_t::fromQColor(m_colors.bg_color), 0.3);
-    QPen outline = getNotePen(track, is_selected, false);
-
-    if (is_drum) {
-        int sz = h * 0.6;
-        int cx = x + w / 2;
-        int cy = y + h / 2;
-        int left = cx - sz / 2;
-        int top = cy - sz / 2;
-        shape = scene->addEllipse(left, top, sz, sz, outline, QBrush(t_color.toQColor()));
-    } else {
-        shape = scene->addRect(x, y, w, h, outline, QBrush(t_color.toQColor()));
-    }
-    // Active track notes get higher z-value (500+) so they're always on top
-    bool is_active = last_seq && last_seq->getActiveTrack() && 
-                     last_seq->getActiveTrack()->getId() == track->getId();
-    qreal baseZ = is_active ? 500 + track->getId() : track->getId() + 10;
-    shape->setZValue(is_selected ? 999 : baseZ);
-
-    QGraphicsSimpleTextItem *txt = nullptr;
-    if (!is_drum && w > 20 && h > 9 && config.time_scale > 0.04) {
-        float luminance = nn_yiq_luminance(t_color);
-        QString note_str = QString::fromStdString(nn_note_name(note.note));
-        txt = scene->addSimpleText(note_str);
-        txt->setBrush(QBrush(luminance < 128 ? Qt::white : Qt::black));
-        QFont f("Arial", std::max(6, h - 6));
-        txt->setFont(f);
-        txt->setPos(x + 2, y + 2);
-        txt->setZValue(shape->zValue() + 1);
-    }
-    
-    NoteGraphics ng = {shape, txt, note, const_cast<NoteNagaTrack*>(track)};
-    m_noteHandler->noteItems()[track->getId()].push_back(ng);
-}
-
 void MidiEditorWidget::clearScene() {
     // Clear note items tracking BEFORE scene->clear() to avoid dangling pointers
     // scene->clear() will delete all items, so we just clear our tracking structures
@@ -1205,6 +1232,7 @@ void MidiEditorWidget::clearScene() {
     bar_grid_labels.clear();
     row_backgrounds.clear();
     marker_line = nullptr;
+    m_noteLayer = nullptr;
     m_lastActiveNotes.clear();
 }
 
@@ -9,6 +9,7 @@
 #include <QComboBox>
 #include <QRubberBand>
 #include <QLabel>
+#include <QSet>
 #include <vector>
 
 #include "midi_editor_types.h"
@@ -18,6 +19,7 @@ class NoteNagaMidiSeq;
 class NoteNagaTrack;
 class MidiEditorContextMenu;
 class MidiEditorNoteHandler;
+class MidiEditorNoteLayer;
 class UndoManager;
 
 /**
@@ -57,10 +59,21 @@ public:
     int snapTickToGridNearest(int tick) const;
     int getGridStepTicks() const;
     QPen getNotePen(const NoteNagaTrack *track, bool is_active_track, bool is_selected_note) const;
+    QColor getNoteColor(const NN_Note_t &note, const NoteNagaTrack *track) const;
     NoteDuration getNoteDuration() const;
     
     // --- Track refresh (called by helper classes) ---
     void refreshTrack(NoteNagaTrack *track);
+
+    /**
+     * @brief Update only the displayed notes touched by an applied change set.
+     * Removed notes are dropped (and deselected), updated notes keep their item and
+     * selection, added notes are shown if they are in the viewport.
+     * @param track Track the change set was applied to.
+     * @param changes Change set returned by NoteNagaTrack::applyNoteChanges().
+     */
+    void applyNoteChangeSet(NoteNagaTrack *track, const NN_NoteChangeSet_t &changes);
+    void updateNoteLayer(); ///< Repaint the notes (selection or drag feedback changed)
     
     /**
      * @brief Get the maximum tick value based on the scrollable content width
@@ -85,7 +98,7 @@ signals:
     void keyHeightChanged(int height);
     void loopingChanged(bool enabled);
     void notesModified();
-    void dataRefreshed();  ///< Emitted when refreshAll() is called (for undo/redo updates)
+    void dataRefreshed();  ///< Emitted after refreshAll() or applyNoteChangeSet() (for undo/redo updates)
     void selectionChanged();
     void contentSizeChanged(int maxTick);
     void noteTrackSelected(NoteNagaTrack *track);  ///< Emitted when clicking on a note to select its track
@@ -98,6 +111,7 @@ public slots:
 private slots:
     void refreshMarker();
     void refreshSequence(NoteNagaMidiSeq *seq);
+    void refreshStaleTracks();
     void currentTickChanged(int tick);
     void selectFollowMode(MidiEditorFollowMode mode);
     void enableLooping(bool enabled);
@@ -142,6 +156,9 @@ private:
     QPointF m_clickStartPos;
     bool m_hadSelectionBeforeClick = false;
 
+    // --- Tracks whose notes changed outside applyNoteChangeSet() (refreshed once, deferred) ---
+    QSet<NoteNagaTrack *> m_staleTracks;
+
     // --- Active notes tracking ---
     QMap<int, int> m_activeNotes;
     QMap<int, int> m_lastActiveNotes;
@@ -161,6 +178,7 @@ private:
     // --- Graphics scene & items ---
     QGraphicsScene *scene;
     QGraphicsLineItem *marker_line = nullptr;
+    MidiEditorNoteLayer *m_noteLayer = nullptr;
     std::vector<QGraphicsLineItem *> grid_lines;
     std::vector<QGraphicsLineItem *> bar_grid_lines;
     std::vector<QGraphicsSimpleTextItem *> bar_grid_labels;
@@ -188,7 +206,17 @@ private:
     void updateRowHighlights();
     void clearScene();
 
-    void drawNote(const NN_Note_t &note, const NoteNagaTrack *track, bool is_selected,
-                  bool is_drum, int x, int y, int w, int h);
-    QColor getNoteColor(const NN_Note_t &note, const NoteNagaTrack *track) const;
+    /**
+     * @brief Append the notes of a track intersecting the viewport to the note handler.
+     * @param track Track.
+     */
+    void collectVisibleNotes(NoteNagaTrack *track);
+
+    /**
+     * @brief Scene rectangle of a note if it intersects the viewport.
+     * @param note Note (notes without start or length are never shown).
+     * @param rect Receives the rectangle.
+     * @return True if the note is visible.
+     */
+    bool visibleNoteRect(const NN_Note_t &note, QRectF &rect) const;
 };
@@ -14,6 +14,7 @@
 #include <QMenu>
 #include <QInputDialog>
 #include <cmath>
+#include <map>
 #include <set>
 
 NotePropertyEditor::NotePropertyEditor(NoteNagaEngine *engine, MidiEditorWidget *midiEditor, QWidget *parent)
@@ -345,7 +346,7 @@ void NotePropertyEditor::rebuildNoteBars()
     m_hasSelection = !selectedIds.empty();
     
     // Only collect notes from active track
-    std::vector<NN_Note_t> notes = m_activeTrack->getNotes();
+    std::span<const NN_Note_t> notes = m_activeTrack->getNotesView();
     for (size_t i = 0; i < notes.size(); ++i) {
         const NN_Note_t &note = notes[i];
         
@@ -772,29 +773,33 @@ void NotePropertyEditor::mouseMoveEvent(QMouseEvent *event)
         int delta = newValue - m_dragStartValue;
         
         if (m_proportionalEdit && !m_selectedBarsStartValues.empty()) {
-            // Proportional editing: apply delta to all selected notes
+            // Proportional editing: apply delta to all selected notes,
+            // collected into one change set per track
+            std::map<NoteNagaTrack*, NN_NoteChangeSet_t> changes;
             for (const auto& [barIdx, origValue] : m_selectedBarsStartValues) {
                 if (barIdx < 0 || barIdx >= static_cast<int>(m_noteBars.size())) continue;
                 
                 NoteBar &bar = m_noteBars[barIdx];
                 int adjustedValue = std::clamp(origValue + delta, 0, 127);
                 
-                if (adjustedValue != bar.value) {
+                if (adjustedValue != bar.value && bar.track) {
                     bar.value = adjustedValue;
                     
-                    // Update the actual note in the engine
-                    std::vector<NN_Note_t> notes = bar.track->getNotes();
-                    if (bar.noteIndex >= 0 && bar.noteIndex < (int)notes.size()) {
-                        if (m_propertyType == PropertyType::Velocity) {
-                            notes[bar.noteIndex].velocity = adjustedValue;
-                        } else if (m_propertyType == PropertyType::Pan) {
-                            notes[bar.noteIndex].pan = adjustedValue;
-                        }
-                        bar.track->setNotes(notes);
+                    NN_Note_t note = bar.note;
+                    if (m_propertyType == PropertyType::Velocity) {
+                        note.velocity = adjustedValue;
+                    } else if (m_propertyType == PropertyType::Pan) {
+                        note.pan = adjustedValue;
                     }
+                    changes[bar.track].updated.push_back(note);
                 }
             }
             
+            // Update the actual notes in the engine (by note ID, no full note list rewrite)
+            for (auto &[track, changeSet] : changes) {
+                track->applyNoteChanges(changeSet);
+            }
+            
             // Show tooltip for multi-edit
             QString valueText;
             if (m_propertyType == PropertyType::Velocity) {
@@ -815,14 +820,16 @@ void NotePropertyEditor::mouseMoveEvent(QMouseEvent *event)
             m_editingBar->value = newValue;
             
             // Update the actual note in the engine
-            std::vector<NN_Note_t> notes = m_editingBar->track->getNotes();
-            if (m_editingBar->noteIndex >= 0 && m_editingBar->noteIndex < (int)notes.size()) {
+            if (m_editingBar->track) {
+                NN_NoteChangeSet_t changeSet;
+                NN_Note_t note = m_editingBar->note;
                 if (m_propertyType == PropertyType::Velocity) {
-                    notes[m_editingBar->noteIndex].velocity = newValue;
+                    note.velocity = newValue;
                 } else if (m_propertyType == PropertyType::Pan) {
-                    notes[m_editingBar->noteIndex].pan = newValue;
+                    note.pan = newValue;
                 }
-                m_editingBar->track->setNotes(notes);
+                changeSet.updated.push_back(note);
+                m_editingBar->track->applyNoteChanges(changeSet);
                 emit notePropertyChanged(m_editingBar->track, m_editingBar->noteIndex, newValue);
             }
             
@@ -1061,8 +1068,7 @@ int NotePropertyEditor::findNeighborValue(NoteBar *bar, int direction)
     if (!bar || !bar->track) return -1;
     
     // Find the bar's position in the sorted note list
-    std::vector<NN_Note_t> notes = bar->track->getNotes();
-    if (notes.empty()) return -1;
+    if (bar->track->getNotesView().empty()) return -1;
     
     // Sort bars by x position (start time)
     std::vector<NoteBar*> sortedBars;
@@ -1100,7 +1106,7 @@ void NotePropertyEditor::applyValueToContextBar(int value)
     value = qBound(0, value, 127);
     
     // Get the original note for undo
-    std::vector<NN_Note_t> notes = m_contextMenuBar->track->getNotes();
+    std::span<const NN_Note_t> notes = m_contextMenuBar->track->getNotesView();
     if (m_contextMenuBar->noteIndex >= 0 && m_contextMenuBar->noteIndex < (int)notes.size()) {
         NN_Note_t oldNote = notes[m_contextMenuBar->noteIndex];
         NN_Note_t newNote = oldNote;
@@ -28,6 +28,7 @@
 #include "widgets/track_list_widget.h"
 #include "dialogs/project_wizard_dialog.h"
 #include "dialogs/audio_recording_dialog.h"
+#include "dialogs/audio_settings_dialog.h"
 #include "undo/undo_manager.h"
 
 MainWindow::MainWindow(QWidget *parent) : QMainWindow(parent), auto_follow(true), m_currentSection(AppSection::Project) {
@@ -151,6 +152,8 @@ void MainWindow::setup_actions() {
     connect(action_reset_colors, &QAction::triggered, this, &MainWindow::reset_all_colors);
     action_randomize_colors = new QAction("Randomize Track Colors", this);
     connect(action_randomize_colors, &QAction::triggered, this, &MainWindow::randomize_all_colors);
+    action_audio_settings = new QAction("Audio Settings...", this);
+    connect(action_audio_settings, &QAction::triggered, this, &MainWindow::audio_settings_dialog);
 
     action_about = new QAction("About", this);
     connect(action_about, &QAction::triggered, this, &MainWindow::about_dialog);
@@ -432,6 +435,8 @@ void MainWindow::setup_menu_bar() {
     tools_menu->addSeparator();
     tools_menu->addAction(action_reset_colors);
     tools_menu->addAction(action_randomize_colors);
+    tools_menu->addSeparator();
+    tools_menu->addAction(action_audio_settings);
 
     // === Help Menu ===
     QMenu *help_menu = menubar->addMenu(tr("Help"));
@@ -1116,6 +1121,11 @@ void MainWindow::export_midi() {
     }
 }
 
+void MainWindow::audio_settings_dialog() {
+    AudioSettingsDialog dialog(this, engine);
+    dialog.exec();
+}
+
 void MainWindow::reset_all_colors() {
     NoteNagaMidiSeq *active_sequence = this->engine->getRuntimeData()->getActiveSequence();
     if (!active_sequence) {
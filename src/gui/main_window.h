@@ -41,6 +41,7 @@ private slots:
     void export_midi();
     void reset_all_colors();
     void randomize_all_colors();
+    void audio_settings_dialog();
     void about_dialog();
     void reset_layout();
     void show_hide_dock(const QString &name, bool checked);
@@ -129,6 +130,7 @@ private:
     QAction *action_auto_follow;
     QAction *action_reset_colors;
     QAction *action_randomize_colors;
+    QAction *action_audio_settings;
     QAction *action_about;
     QAction *action_homepage;
     QAction *action_toolbar_to_start;
@@ -811,13 +811,10 @@ void ChangeMidiClipFadeCommand::execute()
     
     for (auto *track : arr->getTracks()) {
         if (!track) continue;
-        for (auto &clip : track->getClips()) {
-            if (clip.id == m_clipId) {
-                clip.fadeInTicks = m_newFadeIn;
-                clip.fadeOutTicks = m_newFadeOut;
-                refreshTimeline();
-                return;
-            }
+        // setClipFades emits clipsChanged so the engine picks up the new envelope
+        if (track->setClipFades(m_clipId, m_newFadeIn, m_newFadeOut)) {
+            refreshTimeline();
+            return;
         }
     }
 }
@@ -829,13 +826,10 @@ void ChangeMidiClipFadeCommand::undo()
     
     for (auto *track : arr->getTracks()) {
         if (!track) continue;
-        for (auto &clip : track->getClips()) {
-            if (clip.id == m_clipId) {
-                clip.fadeInTicks = m_oldFadeIn;
-                clip.fadeOutTicks = m_oldFadeOut;
-                refreshTimeline();
-                return;
-            }
+        // setClipFades emits clipsChanged so the engine picks up the new envelope
+        if (track->setClipFades(m_clipId, m_oldFadeIn, m_oldFadeOut)) {
+            refreshTimeline();
+            return;
         }
     }
 }
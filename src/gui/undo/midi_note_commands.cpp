@@ -6,16 +6,9 @@
 // MidiNoteCommandBase - Helper methods
 // ============================================================================
 
-void MidiNoteCommandBase::refreshTracks(const QSet<NoteNagaTrack*> &tracks) {
-    if (!m_editor) return;
-    for (NoteNagaTrack *track : tracks) {
-        m_editor->refreshTrack(track);
-    }
-}
-
-void MidiNoteCommandBase::refreshTracks(NoteNagaTrack *track) {
+void MidiNoteCommandBase::refreshTrack(NoteNagaTrack *track, const NN_NoteChangeSet_t &applied) {
     if (!m_editor || !track) return;
-    m_editor->refreshTrack(track);
+    m_editor->applyNoteChangeSet(track, applied);
 }
 
 void MidiNoteCommandBase::refreshAllTracks() {
@@ -31,6 +24,47 @@ void MidiNoteCommandBase::computeMaxTick() {
     }
 }
 
+NN_NoteChangeSet_t &MidiNoteCommandBase::changesFor(NoteNagaTrack *track) {
+    for (auto &entry : m_changes) {
+        if (entry.first == track) return entry.second;
+    }
+    m_changes.append({track, NN_NoteChangeSet_t()});
+    return m_changes.last().second;
+}
+
+void MidiNoteCommandBase::recordAdd(NoteNagaTrack *track, const NN_Note_t &note) {
+    if (!track) return;
+    changesFor(track).added.push_back(note);
+}
+
+void MidiNoteCommandBase::recordRemove(NoteNagaTrack *track, const NN_Note_t &note) {
+    if (!track) return;
+    changesFor(track).removed.push_back(note);
+}
+
+void MidiNoteCommandBase::recordReplace(NoteNagaTrack *track, const NN_Note_t &oldNote, const NN_Note_t &newNote) {
+    if (!track) return;
+    NN_NoteChangeSet_t &changes = changesFor(track);
+    if (oldNote.id == newNote.id) {
+        changes.updated.push_back(newNote);
+        changes.previous.push_back(oldNote);
+    } else {
+        changes.removed.push_back(oldNote);
+        changes.added.push_back(newNote);
+    }
+}
+
+void MidiNoteCommandBase::applyChanges(bool revert, bool updateMaxTick) {
+    QList<QPair<NoteNagaTrack*, NN_NoteChangeSet_t>> applied;
+    for (const auto &entry : m_changes) {
+        applied.append({entry.first, entry.first->applyNoteChanges(revert ? entry.second.inverted() : entry.second)});
+    }
+    if (updateMaxTick) computeMaxTick();
+    for (const auto &entry : applied) {
+        refreshTrack(entry.first, entry.second);
+    }
+}
+
 // ============================================================================
 // AddNoteCommand
 // ============================================================================
@@ -44,14 +78,18 @@ void AddNoteCommand::execute() {
     if (!m_track) return;
     m_track->addNote(m_note);
     computeMaxTick();
-    refreshTracks(m_track);
+    NN_NoteChangeSet_t applied;
+    applied.added.push_back(m_note);
+    refreshTrack(m_track, applied);
 }
 
 void AddNoteCommand::undo() {
     if (!m_track) return;
     m_track->removeNote(m_note);
     computeMaxTick();
-    refreshTracks(m_track);
+    NN_NoteChangeSet_t applied;
+    applied.removed.push_back(m_note);
+    refreshTrack(m_track, applied);
 }
 
 // ============================================================================
@@ -60,39 +98,26 @@ void AddNoteCommand::undo() {
 
 DeleteNotesCommand::DeleteNotesCommand(MidiEditorWidget *editor,
                                        const QList<QPair<NoteNagaTrack*, NN_Note_t>> &notes)
-    : MidiNoteCommandBase(editor), m_notes(notes)
+    : MidiNoteCommandBase(editor), m_count(notes.size())
 {
+    for (const auto &pair : notes) {
+        recordRemove(pair.first, pair.second);
+    }
 }
 
 void DeleteNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &pair : m_notes) {
-        if (pair.first) {
-            pair.first->removeNote(pair.second);
-            affectedTracks.insert(pair.first);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(false, true);
 }
 
 void DeleteNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &pair : m_notes) {
-        if (pair.first) {
-            pair.first->addNote(pair.second);
-            affectedTracks.insert(pair.first);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(true, true);
 }
 
 QString DeleteNotesCommand::description() const {
-    if (m_notes.size() == 1) {
+    if (m_count == 1) {
         return QObject::tr("Delete Note");
     }
-    return QObject::tr("Delete %1 Notes").arg(m_notes.size());
+    return QObject::tr("Delete %1 Notes").arg(m_count);
 }
 
 // ============================================================================
@@ -101,36 +126,19 @@ QString DeleteNotesCommand::description() const {
 
 MoveNotesCommand::MoveNotesCommand(MidiEditorWidget *editor,
                                    const QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> &noteChanges)
-    : MidiNoteCommandBase(editor), m_noteChanges(noteChanges)
+    : MidiNoteCommandBase(editor)
 {
+    for (const auto &change : noteChanges) {
+        recordReplace(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+    }
 }
 
 void MoveNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<1>(change));  // Remove original
-        track->addNote(std::get<2>(change));     // Add new
-        affectedTracks.insert(track);
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(false, true);
 }
 
 void MoveNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<2>(change));  // Remove new
-        track->addNote(std::get<1>(change));     // Restore original
-        affectedTracks.insert(track);
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(true, true);
 }
 
 // ============================================================================
@@ -139,36 +147,19 @@ void MoveNotesCommand::undo() {
 
 ResizeNotesCommand::ResizeNotesCommand(MidiEditorWidget *editor,
                                        const QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> &noteChanges)
-    : MidiNoteCommandBase(editor), m_noteChanges(noteChanges)
+    : MidiNoteCommandBase(editor)
 {
+    for (const auto &change : noteChanges) {
+        recordReplace(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+    }
 }
 
 void ResizeNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<1>(change));
-        track->addNote(std::get<2>(change));
-        affectedTracks.insert(track);
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(false, true);
 }
 
 void ResizeNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<2>(change));
-        track->addNote(std::get<1>(change));
-        affectedTracks.insert(track);
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(true, true);
 }
 
 // ============================================================================
@@ -177,32 +168,19 @@ void ResizeNotesCommand::undo() {
 
 DuplicateNotesCommand::DuplicateNotesCommand(MidiEditorWidget *editor,
                                              const QList<QPair<NoteNagaTrack*, NN_Note_t>> &duplicatedNotes)
-    : MidiNoteCommandBase(editor), m_duplicatedNotes(duplicatedNotes)
+    : MidiNoteCommandBase(editor)
 {
+    for (const auto &pair : duplicatedNotes) {
+        recordAdd(pair.first, pair.second);
+    }
 }
 
 void DuplicateNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &pair : m_duplicatedNotes) {
-        if (pair.first) {
-            pair.first->addNote(pair.second);
-            affectedTracks.insert(pair.first);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(false, true);
 }
 
 void DuplicateNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &pair : m_duplicatedNotes) {
-        if (pair.first) {
-            pair.first->removeNote(pair.second);
-            affectedTracks.insert(pair.first);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(true, true);
 }
 
 // ============================================================================
@@ -212,34 +190,19 @@ void DuplicateNotesCommand::undo() {
 TransposeNotesCommand::TransposeNotesCommand(MidiEditorWidget *editor,
                                              const QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> &noteChanges,
                                              int semitones)
-    : MidiNoteCommandBase(editor), m_noteChanges(noteChanges), m_semitones(semitones)
+    : MidiNoteCommandBase(editor), m_semitones(semitones)
 {
+    for (const auto &change : noteChanges) {
+        recordReplace(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+    }
 }
 
 void TransposeNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<1>(change));
-        track->addNote(std::get<2>(change));
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(false, false);
 }
 
 void TransposeNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<2>(change));
-        track->addNote(std::get<1>(change));
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(true, false);
 }
 
 QString TransposeNotesCommand::description() const {
@@ -256,34 +219,19 @@ QString TransposeNotesCommand::description() const {
 
 QuantizeNotesCommand::QuantizeNotesCommand(MidiEditorWidget *editor,
                                            const QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> &noteChanges)
-    : MidiNoteCommandBase(editor), m_noteChanges(noteChanges)
+    : MidiNoteCommandBase(editor)
 {
+    for (const auto &change : noteChanges) {
+        recordReplace(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+    }
 }
 
 void QuantizeNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<1>(change));
-        track->addNote(std::get<2>(change));
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(false, false);
 }
 
 void QuantizeNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<2>(change));
-        track->addNote(std::get<1>(change));
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(true, false);
 }
 
 // ============================================================================
@@ -293,34 +241,19 @@ void QuantizeNotesCommand::undo() {
 ChangeVelocityCommand::ChangeVelocityCommand(MidiEditorWidget *editor,
                                              const QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> &noteChanges,
                                              int newVelocity)
-    : MidiNoteCommandBase(editor), m_noteChanges(noteChanges), m_newVelocity(newVelocity)
+    : MidiNoteCommandBase(editor), m_newVelocity(newVelocity)
 {
+    for (const auto &change : noteChanges) {
+        recordReplace(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+    }
 }
 
 void ChangeVelocityCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<1>(change));
-        track->addNote(std::get<2>(change));
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(false, false);
 }
 
 void ChangeVelocityCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<2>(change));
-        track->addNote(std::get<1>(change));
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(true, false);
 }
 
 QString ChangeVelocityCommand::description() const {
@@ -333,32 +266,19 @@ QString ChangeVelocityCommand::description() const {
 
 PasteNotesCommand::PasteNotesCommand(MidiEditorWidget *editor,
                                      const QList<QPair<NoteNagaTrack*, NN_Note_t>> &pastedNotes)
-    : MidiNoteCommandBase(editor), m_pastedNotes(pastedNotes)
+    : MidiNoteCommandBase(editor)
 {
+    for (const auto &pair : pastedNotes) {
+        recordAdd(pair.first, pair.second);
+    }
 }
 
 void PasteNotesCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &pair : m_pastedNotes) {
-        if (pair.first) {
-            pair.first->addNote(pair.second);
-            affectedTracks.insert(pair.first);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(false, true);
 }
 
 void PasteNotesCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &pair : m_pastedNotes) {
-        if (pair.first) {
-            pair.first->removeNote(pair.second);
-            affectedTracks.insert(pair.first);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(true, true);
 }
 
 // ============================================================================
@@ -367,50 +287,20 @@ void PasteNotesCommand::undo() {
 
 MoveNotesToTrackCommand::MoveNotesToTrackCommand(MidiEditorWidget *editor,
                                                  const QList<std::tuple<NoteNagaTrack*, NoteNagaTrack*, NN_Note_t, NN_Note_t>> &moves)
-    : MidiNoteCommandBase(editor), m_moves(moves)
+    : MidiNoteCommandBase(editor)
 {
+    for (const auto &move : moves) {
+        recordRemove(std::get<0>(move), std::get<2>(move));
+        recordAdd(std::get<1>(move), std::get<3>(move));
+    }
 }
 
 void MoveNotesToTrackCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &move : m_moves) {
-        NoteNagaTrack *sourceTrack = std::get<0>(move);
-        NoteNagaTrack *targetTrack = std::get<1>(move);
-        const NN_Note_t &originalNote = std::get<2>(move);
-        const NN_Note_t &newNote = std::get<3>(move);
-        
-        if (sourceTrack) {
-            sourceTrack->removeNote(originalNote);
-            affectedTracks.insert(sourceTrack);
-        }
-        if (targetTrack) {
-            targetTrack->addNote(newNote);
-            affectedTracks.insert(targetTrack);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(false, true);
 }
 
 void MoveNotesToTrackCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &move : m_moves) {
-        NoteNagaTrack *sourceTrack = std::get<0>(move);
-        NoteNagaTrack *targetTrack = std::get<1>(move);
-        const NN_Note_t &originalNote = std::get<2>(move);
-        const NN_Note_t &newNote = std::get<3>(move);
-        
-        if (targetTrack) {
-            targetTrack->removeNote(newNote);
-            affectedTracks.insert(targetTrack);
-        }
-        if (sourceTrack) {
-            sourceTrack->addNote(originalNote);
-            affectedTracks.insert(sourceTrack);
-        }
-    }
-    computeMaxTick();
-    refreshTracks(affectedTracks);
+    applyChanges(true, true);
 }
 // ============================================================================
 // ChangeNotePropertyCommand
@@ -419,40 +309,25 @@ void MoveNotesToTrackCommand::undo() {
 ChangeNotePropertyCommand::ChangeNotePropertyCommand(MidiEditorWidget *editor,
                                                      PropertyType type,
                                                      const QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> &noteChanges)
-    : MidiNoteCommandBase(editor), m_propertyType(type), m_noteChanges(noteChanges)
+    : MidiNoteCommandBase(editor), m_propertyType(type), m_count(noteChanges.size())
 {
+    for (const auto &change : noteChanges) {
+        recordReplace(std::get<0>(change), std::get<1>(change), std::get<2>(change));
+    }
 }
 
 void ChangeNotePropertyCommand::execute() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<1>(change));  // Remove old note
-        track->addNote(std::get<2>(change));     // Add new note
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(false, false);
 }
 
 void ChangeNotePropertyCommand::undo() {
-    QSet<NoteNagaTrack*> affectedTracks;
-    for (const auto &change : m_noteChanges) {
-        NoteNagaTrack *track = std::get<0>(change);
-        if (!track) continue;
-        
-        track->removeNote(std::get<2>(change));  // Remove new note
-        track->addNote(std::get<1>(change));     // Restore old note
-        affectedTracks.insert(track);
-    }
-    refreshTracks(affectedTracks);
+    applyChanges(true, false);
 }
 
 QString ChangeNotePropertyCommand::description() const {
     QString propName = (m_propertyType == PropertyType::Velocity) ? QObject::tr("Velocity") : QObject::tr("Pan");
-    if (m_noteChanges.size() == 1) {
+    if (m_count == 1) {
         return QObject::tr("Change %1").arg(propName);
     }
-    return QObject::tr("Change %1 (%2 notes)").arg(propName).arg(m_noteChanges.size());
+    return QObject::tr("Change %1 (%2 notes)").arg(propName).arg(m_count);
 }
\ No newline at end of file
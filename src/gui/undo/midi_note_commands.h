@@ -17,12 +17,27 @@ class MidiNoteCommandBase : public UndoCommand {
 protected:
     MidiEditorWidget *m_editor;
     
-    // Helper to refresh affected tracks after execute/undo
-    void refreshTracks(const QSet<NoteNagaTrack*> &tracks);
-    void refreshTracks(NoteNagaTrack *track);
+    /// Per-track change sets of the command (only the touched notes are stored)
+    QList<QPair<NoteNagaTrack*, NN_NoteChangeSet_t>> m_changes;
+    
+    // Helper to update the editor after execute/undo (only the notes of the applied change set)
+    void refreshTrack(NoteNagaTrack *track, const NN_NoteChangeSet_t &applied);
     void refreshAllTracks();
     void computeMaxTick();
     
+    // Helpers to build the change sets in the constructor
+    NN_NoteChangeSet_t &changesFor(NoteNagaTrack *track);
+    void recordAdd(NoteNagaTrack *track, const NN_Note_t &note);
+    void recordRemove(NoteNagaTrack *track, const NN_Note_t &note);
+    void recordReplace(NoteNagaTrack *track, const NN_Note_t &oldNote, const NN_Note_t &newNote);
+    
+    /**
+     * @brief Apply (or revert) all change sets, one transaction per track, and refresh the editor.
+     * @param revert True to apply the inverted change sets (undo).
+     * @param updateMaxTick True to recompute the sequence length afterwards.
+     */
+    void applyChanges(bool revert, bool updateMaxTick);
+    
 public:
     explicit MidiNoteCommandBase(MidiEditorWidget *editor) : m_editor(editor) {}
 };
@@ -56,7 +71,7 @@ public:
     QString description() const override;
     
 private:
-    QList<QPair<NoteNagaTrack*, NN_Note_t>> m_notes;
+    int m_count;
 };
 
 /**
@@ -75,9 +90,6 @@ public:
     void undo() override;
     QString description() const override { return QObject::tr("Move Notes"); }
     
-private:
-    // Each entry: track, original note, new note
-    QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_noteChanges;
 };
 
 /**
@@ -91,9 +103,6 @@ public:
     void execute() override;
     void undo() override;
     QString description() const override { return QObject::tr("Resize Notes"); }
-    
-private:
-    QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_noteChanges;
 };
 
 /**
@@ -107,9 +116,6 @@ public:
     void execute() override;
     void undo() override;
     QString description() const override { return QObject::tr("Duplicate Notes"); }
-    
-private:
-    QList<QPair<NoteNagaTrack*, NN_Note_t>> m_duplicatedNotes;
 };
 
 /**
@@ -126,7 +132,6 @@ public:
     QString description() const override;
     
 private:
-    QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_noteChanges;
     int m_semitones;
 };
 
@@ -141,9 +146,6 @@ public:
     void execute() override;
     void undo() override;
     QString description() const override { return QObject::tr("Quantize Notes"); }
-    
-private:
-    QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_noteChanges;
 };
 
 /**
@@ -160,7 +162,6 @@ public:
     QString description() const override;
     
 private:
-    QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_noteChanges;
     int m_newVelocity;
 };
 
@@ -175,9 +176,6 @@ public:
     void execute() override;
     void undo() override;
     QString description() const override { return QObject::tr("Paste Notes"); }
-    
-private:
-    QList<QPair<NoteNagaTrack*, NN_Note_t>> m_pastedNotes;
 };
 
 /**
@@ -195,14 +193,10 @@ public:
     void execute() override;
     void undo() override;
     QString description() const override { return QObject::tr("Move Notes to Track"); }
-    
-private:
-    // sourceTrack, targetTrack, originalNote, newNote
-    QList<std::tuple<NoteNagaTrack*, NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_moves;
 };
 /**
  * @brief Command for changing note properties (velocity, pan, etc.) from property editor.
- *        Stores old and new notes for proper undo/redo.
+ *        Stores the old and new values of the changed notes for proper undo/redo.
  */
 class ChangeNotePropertyCommand : public MidiNoteCommandBase {
 public:
@@ -218,5 +212,5 @@ public:
     
 private:
     PropertyType m_propertyType;
-    QList<std::tuple<NoteNagaTrack*, NN_Note_t, NN_Note_t>> m_noteChanges;  // track, oldNote, newNote
+    int m_count;
 };
\ No newline at end of file
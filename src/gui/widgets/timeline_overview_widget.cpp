@@ -191,7 +191,7 @@ void TimelineOverviewWidget::paintEvent(QPaintEvent *event)
 
     // Draw note blocks for active track
     if (m_activeTrack) {
-        const auto& notes = m_activeTrack->getNotes();
+        std::span<const NN_Note_t> notes = m_activeTrack->getNotesView();
 
         // Group notes into density blocks for visualization
         // We'll divide the timeline into segments and show where notes exist
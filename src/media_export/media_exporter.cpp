@@ -2,6 +2,7 @@
 
 #include "media_renderer.h"
 #include <note_naga_engine/note_naga_engine.h>
+#include <note_naga_engine/module/offline_renderer.h>
 #include <note_naga_engine/nn_utils.h>
 #include <opencv2/opencv.hpp>
 #include <QImage>
@@ -10,82 +11,34 @@
 #include <QFileInfo>
 #include <QtConcurrent>
 #include <QFuture>
-#include <QTextStream> 
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <QDebug>
+#include <atomic>
 #include <numeric>
 #include <memory>
 
-// This guard class ensures that the engine is in manual audio rendering mode
-// during the audio export and switches back automatically when done.
-class ManualModeGuard
-{
-public:
-    ManualModeGuard(NoteNagaEngine *engine, NoteNagaMidiSeq *sequence) 
-        : m_engine(engine), m_sequence(sequence), m_arrangement(nullptr)
-    {
-        if (m_engine)
-        {
-            // Enter manual mode on all track synths
-            if (m_sequence) {
-                for (auto *track : m_sequence->getTracks()) {
-                    if (track && track->getSynth()) {
-                        track->getSynth()->enterManualMode();
-                    }
-                }
-            }
-            m_engine->getAudioWorker()->mute();
-        }
-    }
-    
-    ManualModeGuard(NoteNagaEngine *engine, NoteNagaArrangement *arrangement, NoteNagaRuntimeData *runtimeData)
-        : m_engine(engine), m_sequence(nullptr), m_arrangement(arrangement)
-    {
-        if (m_engine && runtimeData)
-        {
-            // Enter manual mode on all synths from all sequences in clips
-            for (NoteNagaMidiSeq* seq : runtimeData->getSequences()) {
-                if (!seq) continue;
-                for (auto *track : seq->getTracks()) {
-                    if (track && track->getSynth()) {
-                        track->getSynth()->enterManualMode();
-                    }
-                }
-            }
-            m_engine->getAudioWorker()->mute();
-        }
-    }
-    
-    ~ManualModeGuard()
-    {
-        if (m_engine)
-        {
-            NoteNagaRuntimeData* runtimeData = m_engine->getRuntimeData();
-            // Exit manual mode on all track synths
-            if (m_sequence) {
-                for (auto *track : m_sequence->getTracks()) {
-                    if (track && track->getSynth()) {
-                        track->getSynth()->exitManualMode();
-                    }
-                }
-            } else if (m_arrangement && runtimeData) {
-                for (NoteNagaMidiSeq* seq : runtimeData->getSequences()) {
-                    if (!seq) continue;
-                    for (auto *track : seq->getTracks()) {
-                        if (track && track->getSynth()) {
-                            track->getSynth()->exitManualMode();
-                        }
-                    }
-                }
-            }
-            m_engine->getAudioWorker()->unmute();
-        }
-    }
-
-private:
-    NoteNagaEngine *m_engine;
-    NoteNagaMidiSeq *m_sequence;
-    NoteNagaArrangement *m_arrangement;
+namespace {
+
+/**
+ * @brief One slot of the video export window (frame i uses slot i % window size).
+ * A slot goes Free -> Simulated -> Rendering -> Rendered -> Free, the frame data is
+ * only touched by the stage owning the slot.
+ */
+struct VideoFrameSlot {
+    enum Status { Free, Simulated, Rendering, Rendered };
+    Status status = Free;
+    int frame = -1;
+    MediaRenderer::FrameState state; ///< Simulated state of the frame
+    cv::Mat bgr;                     ///< Rendered frame in the encoder format (preallocated, reused)
 };
 
+/// Average milliseconds per frame of an accumulated stage time
+double msPerFrame(qint64 nsecs, int frames) { return frames > 0 ? nsecs / 1e6 / frames : 0.0; }
+
+} // namespace
 
 MediaExporter::MediaExporter(NoteNagaMidiSeq *sequence, QString outputPath,
                              QSize resolution, int fps, NoteNagaEngine *engine,
@@ -102,7 +55,7 @@ MediaExporter::MediaExporter(NoteNagaMidiSeq *sequence, QString outputPath,
       m_exportMode(exportMode), 
       m_audioFormat(audioFormat), 
       m_audioBitrate(audioBitrate), 
-      m_framesRendered(0), m_totalFrames(0)
+      m_totalFrames(0)
 {
     connect(&m_audioWatcher, &QFutureWatcher<bool>::finished, this, &MediaExporter::onTaskFinished);
     connect(&m_videoWatcher, &QFutureWatcher<bool>::finished, this, &MediaExporter::onTaskFinished);
@@ -123,7 +76,7 @@ MediaExporter::MediaExporter(NoteNagaArrangement *arrangement, QString outputPat
       m_exportMode(exportMode), 
       m_audioFormat(audioFormat), 
       m_audioBitrate(audioBitrate), 
-      m_framesRendered(0), m_totalFrames(0)
+      m_totalFrames(0)
 {
     connect(&m_audioWatcher, &QFutureWatcher<bool>::finished, this, &MediaExporter::onTaskFinished);
     connect(&m_videoWatcher, &QFutureWatcher<bool>::finished, this, &MediaExporter::onTaskFinished);
@@ -140,7 +93,7 @@ void MediaExporter::doExport()
 
     if (m_exportMode == Video)
     {
-        // This will be the final temporary video after joining batches
+        // Video without audio, muxed with the audio when both are done
         m_tempVideoPath = m_outputPath + ".tmp.video.mp4"; 
 
         emit statusTextChanged(tr("Rendering in progress..."));
@@ -150,9 +103,8 @@ void MediaExporter::doExport()
         QFuture<bool> audioFuture = QtConcurrent::run([this]()
                                                       { return this->exportAudio(m_tempAudioPath); });
 
-        // Run the new batched method for video
         QFuture<bool> videoFuture = QtConcurrent::run([this]()
-                                                      { return this->exportVideoBatched(m_tempVideoPath); });
+                                                      { return this->exportVideo(m_tempVideoPath); });
 
         m_audioWatcher.setFuture(audioFuture);
         m_videoWatcher.setFuture(videoFuture);
@@ -243,469 +195,246 @@ void MediaExporter::cleanup()
     {
         if (!m_tempVideoPath.isEmpty())
             QFile::remove(m_tempVideoPath);
-            
-        // We must also delete temporary batches
-        QDir dir = QFileInfo(m_outputPath).dir();
-        QString baseName = QFileInfo(m_outputPath).fileName();
-        QStringList filters;
-        filters << baseName + ".tmp.batch.*.mp4";
-        for(const QString& tmpFile : dir.entryList(filters, QDir::Files)) {
-            QFile::remove(dir.filePath(tmpFile));
-        }
-        QFile::remove(dir.filePath("filelist.txt"));
     }
 }
 
 bool MediaExporter::exportAudio(const QString &outputPath)
 {
     NoteNagaRuntimeData *project = m_engine->getRuntimeData();
-    NoteNagaDSPEngine *dspEngine = m_engine->getDSPEngine();
-    
-    const int sampleRate = 44100;
-    const int numChannels = 2;
     
+    // Rendered by a private copy of the synths and DSP chains, the live engine keeps playing
+    NoteNagaOfflineRenderer renderer(project, m_engine->getDSPEngine());
+    bool prepared = false;
     if (m_sourceMode == Arrangement) {
-        return exportAudioArrangement(outputPath);
-    }
-    
-    // Single Sequence mode
-    ManualModeGuard manualMode(this->m_engine, m_sequence);
-
-    NoteNagaMidiSeq *activeSequence = m_sequence ? m_sequence : project->getActiveSequence();
-    if (!activeSequence) return false;
-    
-    const double totalDuration = nn_ticks_to_seconds(activeSequence->getMaxTick(), project->getPPQ(), project->getTempo()) + 2.0;
-    const int totalSamples = static_cast<int>(totalDuration * sampleRate);
-
-    std::vector<float> audioBuffer(totalSamples * numChannels, 0.0f);
-
-    struct MidiEvent
-    {
-        int tick;
-        NN_Note_t note;
-        bool isNoteOn;
-    };
-    std::vector<MidiEvent> allEvents;
-    for (auto *track : activeSequence->getTracks())
-    {
-        if (track->isMuted() || (activeSequence->getSoloTrack() && activeSequence->getSoloTrack() != track))
-            continue;
-        for (const auto &note : track->getNotes())
-        {
-            if (note.start.has_value() && note.length.has_value())
-            {
-                allEvents.push_back({note.start.value(), note, true});
-                allEvents.push_back({note.start.value() + note.length.value(), note, false});
-            }
-        }
-    }
-    std::sort(allEvents.begin(), allEvents.end(), [](const MidiEvent &a, const MidiEvent &b)
-              { return a.tick < b.tick; });
-
-    // Stop all notes on all tracks
-    for (auto *track : activeSequence->getTracks()) {
-        if (track) track->stopAllNotes();
+        prepared = renderer.prepareArrangement();
+    } else {
+        NoteNagaMidiSeq *sequence = m_sequence ? m_sequence : project->getActiveSequence();
+        prepared = renderer.prepareSequence(sequence);
     }
+    if (!prepared) return false;
     
-    int last_tick = 0;
-    int totalSamplesRendered = 0;
-
-    for (const auto &event : allEvents)
-    {
-        int ticksToProcess = event.tick - last_tick;
-        if (ticksToProcess > 0)
-        {
-            double durationToRender = nn_ticks_to_seconds(ticksToProcess, project->getPPQ(), project->getTempo());
-            int samplesToRender = static_cast<int>(durationToRender * sampleRate);
-            if (totalSamplesRendered + samplesToRender > totalSamples)
-            {
-                samplesToRender = totalSamples - totalSamplesRendered;
-            }
-            if (samplesToRender > 0)
-            {
-                dspEngine->render(audioBuffer.data() + totalSamplesRendered * numChannels, samplesToRender, false);
-                totalSamplesRendered += samplesToRender;
-            }
-        }
-        
-        // Play/stop note through track's synth
-        if (event.note.parent) {
-            if (event.isNoteOn) {
-                event.note.parent->playNote(event.note);
-            } else {
-                event.note.parent->stopNote(event.note);
-            }
-            // Process the track's synth queue
-            NoteNagaSynthesizer *synth = event.note.parent->getSynth();
-            if (synth) {
-                synth->processQueue();
-            }
-        }
-        
-        last_tick = event.tick;
-
-        // In audio-only mode, we want this signal to drive the main progress bar
-        emit audioProgressUpdated((int)((double)totalSamplesRendered * 100 / totalSamples));
-    }
-    emit audioProgressUpdated(100);
-
-    int remainingSamples = totalSamples - totalSamplesRendered;
-    if (remainingSamples > 0)
-    {
-        dspEngine->render(audioBuffer.data() + totalSamplesRendered * numChannels, remainingSamples, false);
-    }
+    const int64_t totalFrames = renderer.getTotalFrames();
     std::ofstream file(outputPath.toStdString(), std::ios::binary);
     if (!file.is_open())
         return false;
-    writeWavHeader(file, sampleRate, totalSamples);
-    std::vector<int16_t> intBuffer(audioBuffer.size());
-    for (size_t i = 0; i < audioBuffer.size(); ++i)
+    writeWavHeader(file, renderer.getSampleRate(), static_cast<int>(totalFrames));
+    
+    // Render and write in chunks, the whole mix is never held in memory
+    const int64_t chunkFrames = 65536;
+    std::vector<float> audioBuffer(chunkFrames * 2);
+    std::vector<int16_t> intBuffer(chunkFrames * 2);
+    int lastProgress = -1;
+    while (!renderer.isFinished())
     {
-        intBuffer[i] = static_cast<int16_t>(std::clamp(audioBuffer[i], -1.0f, 1.0f) * 32767.0f);
-    }
-    file.write(reinterpret_cast<const char *>(intBuffer.data()), intBuffer.size() * sizeof(int16_t));
-
-    return true;
-}
-
-bool MediaExporter::exportAudioArrangement(const QString &outputPath)
-{
-    NoteNagaRuntimeData *project = m_engine->getRuntimeData();
-    NoteNagaDSPEngine *dspEngine = m_engine->getDSPEngine();
-    NoteNagaArrangement *arrangement = m_arrangement ? m_arrangement : project->getArrangement();
-    
-    if (!arrangement) return false;
-    
-    ManualModeGuard manualMode(m_engine, arrangement, project);
-    
-    const int sampleRate = 44100;
-    const int numChannels = 2;
-    const int ppq = project->getPPQ();
-    const int tempo = project->getTempo();
-    
-    // Calculate total duration from arrangement
-    arrangement->updateMaxTick();
-    const double totalDuration = nn_ticks_to_seconds(arrangement->getMaxTick(), ppq, tempo) + 2.0;
-    const int totalSamples = static_cast<int>(totalDuration * sampleRate);
-    
-    std::vector<float> audioBuffer(totalSamples * numChannels, 0.0f);
-    
-    // Collect all MIDI events from all clips in arrangement
-    struct ArrangementMidiEvent
-    {
-        int tick;           // Absolute tick in arrangement
-        NN_Note_t note;
-        bool isNoteOn;
-        NoteNagaTrack* track;
-    };
-    std::vector<ArrangementMidiEvent> allEvents;
-    
-    // Process all arrangement tracks
-    for (NoteNagaArrangementTrack* arrTrack : arrangement->getTracks()) {
-        if (!arrTrack || arrTrack->isMuted()) continue;
-        
-        // Process all MIDI clips on this track
-        for (const NN_MidiClip_t& clip : arrTrack->getClips()) {
-            if (clip.muted) continue;
-            
-            NoteNagaMidiSeq* seq = project->getSequenceById(clip.sequenceId);
-            if (!seq) continue;
-            
-            int seqLength = seq->getMaxTick();
-            if (seqLength <= 0) continue;
-            
-            // Process all tracks in the sequence
-            for (NoteNagaTrack* midiTrack : seq->getTracks()) {
-                if (!midiTrack || midiTrack->isMuted() || midiTrack->isTempoTrack()) continue;
-                
-                // Add notes with looping support
-                for (const NN_Note_t& note : midiTrack->getNotes()) {
-                    if (!note.start.has_value() || !note.length.has_value()) continue;
-                    
-                    int noteStart = note.start.value();
-                    int noteEnd = noteStart + note.length.value();
-                    
-                    // Handle looping
-                    int loopCount = (clip.durationTicks + seqLength - 1) / seqLength;
-                    for (int loop = 0; loop < loopCount; ++loop) {
-                        int loopOffset = loop * seqLength;
-                        int absNoteStart = clip.startTick + loopOffset + noteStart;
-                        int absNoteEnd = clip.startTick + loopOffset + noteEnd;
-                        
-                        // Clip to clip boundaries
-                        int clipEndTick = clip.startTick + clip.durationTicks;
-                        if (absNoteEnd <= clip.startTick) continue;
-                        if (absNoteStart >= clipEndTick) continue;
-                        
-                        absNoteStart = std::max(absNoteStart, clip.startTick);
-                        absNoteEnd = std::min(absNoteEnd, clipEndTick);
-                        
-                        if (absNoteEnd > absNoteStart) {
-                            // Create a copy of the note with adjusted timing
-                            NN_Note_t adjustedNote = note;
-                            adjustedNote.start = absNoteStart;
-                            adjustedNote.length = absNoteEnd - absNoteStart;
-                            
-                            allEvents.push_back({absNoteStart, adjustedNote, true, midiTrack});
-                            allEvents.push_back({absNoteEnd, adjustedNote, false, midiTrack});
-                        }
-                    }
-                }
-            }
-        }
-    }
-    
-    // Sort events by tick
-    std::sort(allEvents.begin(), allEvents.end(), [](const ArrangementMidiEvent &a, const ArrangementMidiEvent &b) {
-        return a.tick < b.tick;
-    });
-    
-    // Stop all notes on all sequences
-    for (NoteNagaMidiSeq* seq : project->getSequences()) {
-        if (!seq) continue;
-        for (auto* track : seq->getTracks()) {
-            if (track) track->stopAllNotes();
-        }
-    }
-    
-    int last_tick = 0;
-    int totalSamplesRendered = 0;
-    
-    for (const auto &event : allEvents)
-    {
-        int ticksToProcess = event.tick - last_tick;
-        if (ticksToProcess > 0)
+        int64_t frames = renderer.render(audioBuffer.data(), chunkFrames);
+        for (int64_t i = 0; i < frames * 2; ++i)
         {
-            double durationToRender = nn_ticks_to_seconds(ticksToProcess, ppq, tempo);
-            int samplesToRender = static_cast<int>(durationToRender * sampleRate);
-            if (totalSamplesRendered + samplesToRender > totalSamples)
-            {
-                samplesToRender = totalSamples - totalSamplesRendered;
-            }
-            if (samplesToRender > 0)
-            {
-                dspEngine->render(audioBuffer.data() + totalSamplesRendered * numChannels, samplesToRender, false);
-                totalSamplesRendered += samplesToRender;
-            }
+            intBuffer[i] = static_cast<int16_t>(std::clamp(audioBuffer[i], -1.0f, 1.0f) * 32767.0f);
         }
+        file.write(reinterpret_cast<const char *>(intBuffer.data()), frames * 2 * sizeof(int16_t));
         
-        // Play/stop note through track's synth
-        if (event.track) {
-            if (event.isNoteOn) {
-                event.track->playNote(event.note);
-            } else {
-                event.track->stopNote(event.note);
-            }
-            // Process the track's synth queue
-            NoteNagaSynthesizer *synth = event.track->getSynth();
-            if (synth) {
-                synth->processQueue();
-            }
+        int progress = static_cast<int>(renderer.getRenderedFrames() * 100 / std::max<int64_t>(1, totalFrames));
+        if (progress != lastProgress)
+        {
+            // In audio-only mode, we want this signal to drive the main progress bar
+            emit audioProgressUpdated(progress);
+            lastProgress = progress;
         }
-        
-        last_tick = event.tick;
-        emit audioProgressUpdated((int)((double)totalSamplesRendered * 100 / totalSamples));
     }
     emit audioProgressUpdated(100);
     
-    int remainingSamples = totalSamples - totalSamplesRendered;
-    if (remainingSamples > 0)
-    {
-        dspEngine->render(audioBuffer.data() + totalSamplesRendered * numChannels, remainingSamples, false);
-    }
-    
-    std::ofstream file(outputPath.toStdString(), std::ios::binary);
-    if (!file.is_open())
-        return false;
-    writeWavHeader(file, sampleRate, totalSamples);
-    std::vector<int16_t> intBuffer(audioBuffer.size());
-    for (size_t i = 0; i < audioBuffer.size(); ++i)
-    {
-        intBuffer[i] = static_cast<int16_t>(std::clamp(audioBuffer[i], -1.0f, 1.0f) * 32767.0f);
+    return file.good();
+}
+
+std::unique_ptr<MediaRenderer> MediaExporter::createRenderer() const
+{
+    std::unique_ptr<MediaRenderer> renderer;
+    if (m_sourceMode == Arrangement && m_arrangement) {
+        renderer = std::make_unique<MediaRenderer>(m_arrangement, m_engine->getRuntimeData());
+    } else {
+        renderer = std::make_unique<MediaRenderer>(m_sequence);
     }
-    file.write(reinterpret_cast<const char *>(intBuffer.data()), intBuffer.size() * sizeof(int16_t));
-    
-    return true;
+    renderer->setSecondsVisible(m_secondsVisible);
+    renderer->setRenderSettings(m_settings);
+    return renderer;
 }
 
-bool MediaExporter::exportVideoBatched(const QString &outputPath)
+bool MediaExporter::exportVideo(const QString &outputPath)
 {
-    // === 1. PHASE: Simulation (Single-thread) ===
-    emit statusTextChanged(tr("Simulating effects..."));
+    emit statusTextChanged(tr("Rendering video frames..."));
     
     NoteNagaRuntimeData* runtimeData = m_engine->getRuntimeData();
-    
-    // Create one renderer ONLY for simulation - based on source mode
-    std::unique_ptr<MediaRenderer> simRendererPtr;
     double totalDuration;
-    
     if (m_sourceMode == Arrangement && m_arrangement) {
-        simRendererPtr = std::make_unique<MediaRenderer>(m_arrangement, runtimeData);
         m_arrangement->updateMaxTick();
-        totalDuration = nn_ticks_to_seconds(m_arrangement->getMaxTick(), runtimeData->getPPQ(), runtimeData->getTempo()) + 1.0;
+        totalDuration = runtimeData->getArrangementTempoMap()->ticksToSeconds(m_arrangement->getMaxTick(),
+                                                                              runtimeData->getPPQ()) + 1.0;
     } else {
-        simRendererPtr = std::make_unique<MediaRenderer>(m_sequence);
-        totalDuration = nn_ticks_to_seconds(m_sequence->getMaxTick(), runtimeData->getPPQ(), runtimeData->getTempo()) + 1.0;
+        totalDuration = m_sequence->getTempoMap()->ticksToSeconds(m_sequence->getMaxTick(), m_sequence->getPPQ()) + 1.0;
     }
-    
-    MediaRenderer& simRenderer = *simRendererPtr;
-    simRenderer.setSecondsVisible(m_secondsVisible);
-    simRenderer.setRenderSettings(m_settings);
-    simRenderer.prepareKeyboardLayout(m_resolution); // Important for positions!
-
     m_totalFrames = static_cast<int>(totalDuration * m_fps);
-    m_framesRendered = 0;
-
-    std::vector<MediaRenderer::FrameState> allFrameStates;
-    allFrameStates.reserve(m_totalFrames);
-
-    MediaRenderer::FrameState lastState; // Start with an empty state
-
-    for (int i = 0; i < m_totalFrames; ++i) {
-        double currentTime = static_cast<double>(i) / m_fps;
-        double deltaTime = 1.0 / m_fps;
-        
-        // Calculate the *next* state based on the *last* state
-        MediaRenderer::FrameState nextState = simRenderer.calculateNextState(lastState, currentTime, deltaTime);
-        
-        allFrameStates.push_back(nextState);
-        lastState = nextState; // Update lastState for the next iteration
-        
-        // Progress for simulation (0-10%)
-        emit videoProgressUpdated((i + 1) * 10 / m_totalFrames);
-    }
-    
-    // === 2. PHASE: Parallel Rendering ===
-    emit statusTextChanged(tr("Rendering video frames..."));
-    
-    int numThreads = QThread::idealThreadCount();
-    // We want at least 10 batches, or one per thread
-    int numBatches = std::max(numThreads, 10); 
-    int framesPerBatch = (m_totalFrames + numBatches - 1) / numBatches; // Ceiling division
-
-    QFutureSynchronizer<QString> synchronizer;
-    QStringList tempBatchFiles;
+    if (m_totalFrames <= 0) return false;
     
-    for (int i = 0; i < numBatches; ++i) {
-        int startFrame = i * framesPerBatch;
-        int endFrame = std::min(startFrame + framesPerBatch, m_totalFrames);
-        if (startFrame >= endFrame) continue;
-
-        // Run the batch render in QtConcurrent
-        synchronizer.addFuture(QtConcurrent::run([=]() {
-            // Pass 'allFrameStates' by value (copy) for thread safety
-            return this->renderVideoBatch(startFrame, endFrame, allFrameStates); 
-        }));
-    }
-
-    // Wait for all batches to finish rendering
-    synchronizer.waitForFinished();
-    
-    for(const auto& future : synchronizer.futures()) {
-        tempBatchFiles.append(future.result());
-    }
-    
-    emit videoProgressUpdated(100);
-
-    // === 3. PHASE: Concatenate ===
-    emit statusTextChanged(tr("Joining video files..."));
-    if (!concatenateVideos(tempBatchFiles, outputPath)) {
-        emit error(tr("Failed to join video batches. FFmpeg error."));
-        // Delete temporary batch files
-        for(const QString& f : tempBatchFiles) QFile::remove(f);
+    // Single encoder for the whole video, fed with raw frames in order
+    cv::VideoWriter videoWriter(outputPath.toStdString(), cv::VideoWriter::fourcc('m', 'p', '4', 'v'), m_fps,
+                                cv::Size(m_resolution.width(), m_resolution.height()));
+    if (!videoWriter.isOpened()) {
         return false;
     }
     
-    // Delete temporary batch files
-    for(const QString& f : tempBatchFiles) QFile::remove(f);
-
-    return true;
-}
-
-QString MediaExporter::renderVideoBatch(int startFrame, int endFrame, 
-                                        const std::vector<MediaRenderer::FrameState>& allFrameStates)
-{
-    // Each thread creates its own MediaRenderer - based on source mode
-    std::unique_ptr<MediaRenderer> rendererPtr;
-    if (m_sourceMode == Arrangement && m_arrangement) {
-        rendererPtr = std::make_unique<MediaRenderer>(m_arrangement, m_engine->getRuntimeData());
-    } else {
-        rendererPtr = std::make_unique<MediaRenderer>(m_sequence);
-    }
-    
-    MediaRenderer& renderer = *rendererPtr;
-    renderer.setSecondsVisible(m_secondsVisible);
-    renderer.setRenderSettings(m_settings);
+    // The simulation renderer is used only by this thread
+    std::unique_ptr<MediaRenderer> simRenderer = createRenderer();
+    simRenderer->prepareKeyboardLayout(m_resolution); // Important for positions!
+    
+    // Fixed window of frames in flight: one per worker plus the frame being encoded and the next one.
+    // Every slot owns an encoder buffer (BGR, the format cv::VideoWriter takes), allocated once.
+    const int numWorkers = std::max(1, QThread::idealThreadCount() - 1);
+    const int window = numWorkers + 2;
+    std::vector<VideoFrameSlot> slots(window);
+    for (VideoFrameSlot &slot : slots) {
+        slot.bgr.create(m_resolution.height(), m_resolution.width(), CV_8UC3);
+    }
+    
+    // Per-stage timing (accumulated over all frames, shown in the status text)
+    std::atomic<qint64> renderNsecs{0};
+    std::atomic<qint64> convertNsecs{0};
+    qint64 simulateNsecs = 0;
+    qint64 encodeNsecs = 0;
+    qint64 waitNsecs = 0;
+    QMutex mutex;
+    QWaitCondition simulatedCondition;
+    QWaitCondition renderedCondition;
+    int nextSimulated = 0; // Guarded by mutex
+    int nextClaimed = 0;   // Guarded by mutex
+    bool aborted = false;  // Guarded by mutex, set when a frame can not be rendered or encoded
+    
+    // Stop the workers and the encoder, all waits below give up once this is set
+    auto abortExport = [&]() {
+        aborted = true;
+        simulatedCondition.wakeAll();
+        renderedCondition.wakeAll();
+    };
     
-    // Unique file name for this batch
-    QString tempFile = m_outputPath + QString(".tmp.batch.%1.mp4").arg(startFrame);
+    // Render workers: take the simulated frames in order, each with its own renderer and render target.
+    // The target is opaque RGB32 (B, G, R, 0xff in memory), converted into the slot's buffer in one pass.
+    auto renderWorker = [&]() {
+        std::unique_ptr<MediaRenderer> renderer = createRenderer();
+        QImage target(m_resolution, QImage::Format_RGB32);
+        cv::Mat targetView(target.height(), target.width(), CV_8UC4, target.bits(), target.bytesPerLine());
+        QElapsedTimer timer;
+        QMutexLocker locker(&mutex);
+        while (true) {
+            while (!aborted && nextClaimed >= nextSimulated && nextClaimed < m_totalFrames) {
+                simulatedCondition.wait(&mutex);
+            }
+            if (aborted || nextClaimed >= m_totalFrames) break;
+            VideoFrameSlot &slot = slots[nextClaimed % window];
+            ++nextClaimed;
+            slot.status = VideoFrameSlot::Rendering;
+            locker.unlock();
+            
+            double currentTime = static_cast<double>(slot.frame) / m_fps;
+            timer.start();
+            renderer->renderFrame(currentTime, slot.state, target);
+            const qint64 rendered = timer.nsecsElapsed();
+            try {
+                cv::cvtColor(targetView, slot.bgr, cv::COLOR_BGRA2BGR); // SIMD conversion into the pooled buffer
+            } catch (const std::exception &e) {
+                qWarning() << "Video export: frame" << slot.frame << "conversion failed:" << e.what();
+                locker.relock();
+                abortExport();
+                break;
+            }
+            renderNsecs.fetch_add(rendered, std::memory_order_relaxed);
+            convertNsecs.fetch_add(timer.nsecsElapsed() - rendered, std::memory_order_relaxed);
+            
+            locker.relock();
+            slot.status = VideoFrameSlot::Rendered;
+            renderedCondition.wakeAll();
+        }
+    };
     
-    cv::VideoWriter videoWriter(tempFile.toStdString(), cv::VideoWriter::fourcc('m', 'p', '4', 'v'), m_fps, cv::Size(m_resolution.width(), m_resolution.height()));
-    if (!videoWriter.isOpened()) {
-        // Can't return an error directly, so return an empty string
-        return QString(); 
+    // Own pool, the global one is busy with this task and the audio export
+    QThreadPool workerPool;
+    workerPool.setMaxThreadCount(numWorkers);
+    QFutureSynchronizer<void> workers;
+    for (int w = 0; w < numWorkers; ++w) {
+        workers.addFuture(QtConcurrent::run(&workerPool, renderWorker));
     }
-
-    for (int i = startFrame; i < endFrame; ++i) {
-        double currentTime = static_cast<double>(i) / m_fps;
+    
+    // Simulate ahead as far as the window allows, then encode the next frame once rendered
+    MediaRenderer::FrameState lastState; // Start with an empty state
+    const double deltaTime = 1.0 / m_fps;
+    int lastProgress = -1;
+    QElapsedTimer timer;
+    for (int encoded = 0; encoded < m_totalFrames; ++encoded) {
+        QMutexLocker locker(&mutex);
+        while (nextSimulated < m_totalFrames && nextSimulated < encoded + window) {
+            // The slot was freed by the encoder, no worker touches it until it is published
+            const int i = nextSimulated;
+            VideoFrameSlot &slot = slots[i % window];
+            locker.unlock();
+            timer.start();
+            lastState = simRenderer->calculateNextState(lastState, static_cast<double>(i) / m_fps, deltaTime);
+            slot.state = lastState;
+            simulateNsecs += timer.nsecsElapsed();
+            slot.frame = i;
+            locker.relock();
+            slot.status = VideoFrameSlot::Simulated;
+            ++nextSimulated;
+            simulatedCondition.wakeAll();
+        }
         
-        // Call the stateless renderFrame version
-        QImage frame = renderer.renderFrame(currentTime, m_resolution, allFrameStates[i]);
-
-        cv::Mat cvFrame(frame.height(), frame.width(), CV_8UC4, (void*)frame.constBits(), frame.bytesPerLine());
-        cv::Mat cvFrameBGR;
-        cv::cvtColor(cvFrame, cvFrameBGR, cv::COLOR_BGRA2BGR); // Color correction
-
-        videoWriter.write(cvFrameBGR);
+        VideoFrameSlot &slot = slots[encoded % window];
+        timer.start();
+        while (!aborted && slot.status != VideoFrameSlot::Rendered) {
+            renderedCondition.wait(&mutex);
+        }
+        if (aborted) break;
+        waitNsecs += timer.nsecsElapsed();
+        locker.unlock();
         
-        // Update progress (atomically)
-        int rendered = m_framesRendered.fetchAndAddOrdered(1);
-        // Progress for rendering (10-95%)
-        // Emit only occasionally to avoid flooding the GUI
-        if (rendered % 20 == 0) { 
-             emit videoProgressUpdated(10 + (rendered * 85 / m_totalFrames));
+        // write() has no result, a failing backend throws or closes the writer
+        bool written = true;
+        timer.start();
+        try {
+            videoWriter.write(slot.bgr);
+            written = videoWriter.isOpened();
+        } catch (const std::exception &e) {
+            qWarning() << "Video export: frame" << encoded << "encoding failed:" << e.what();
+            written = false;
+        }
+        encodeNsecs += timer.nsecsElapsed();
+        locker.relock();
+        if (!written) {
+            abortExport();
+            break;
+        }
+        slot.status = VideoFrameSlot::Free;
+        locker.unlock();
+        
+        int progress = (encoded + 1) * 100 / m_totalFrames;
+        if (progress != lastProgress) {
+            emit videoProgressUpdated(progress);
+            lastProgress = progress;
+            
+            // Render and convert times are summed over the workers (CPU time, not wall time)
+            const int frames = encoded + 1;
+            emit statusTextChanged(tr("Rendering video frames... (per frame: simulate %1 ms, render %2 ms, "
+                                      "convert %3 ms, encode %4 ms, encoder waiting %5 ms)")
+                                       .arg(msPerFrame(simulateNsecs, frames), 0, 'f', 2)
+                                       .arg(msPerFrame(renderNsecs.load(std::memory_order_relaxed), frames), 0, 'f', 2)
+                                       .arg(msPerFrame(convertNsecs.load(std::memory_order_relaxed), frames), 0, 'f', 2)
+                                       .arg(msPerFrame(encodeNsecs, frames), 0, 'f', 2)
+                                       .arg(msPerFrame(waitNsecs, frames), 0, 'f', 2));
         }
     }
-
-    videoWriter.release();
-    return tempFile;
-}
-
-bool MediaExporter::concatenateVideos(const QStringList& videoFiles, const QString& finalPath)
-{
-    // 1. Create 'filelist.txt'
-    QString fileListPath = QFileInfo(m_outputPath).dir().filePath("filelist.txt");
-    QFile fileList(fileListPath);
-    if (!fileList.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        return false;
-    }
-    
-    QTextStream out(&fileList);
-    for (const QString& f : videoFiles) {
-        // FFmpeg needs ' and escaped backslashes
-        QString escapedPath = f;
-        escapedPath.replace("\\", "/");
-        out << "file '" << escapedPath << "'\n";
-    }
-    fileList.close();
-
-    // 2. Run FFmpeg
-    QProcess ffmpeg;
-    QStringList arguments;
-    arguments << "-y" << "-f" << "concat" << "-safe" << "0" << "-i" << fileListPath << "-c" << "copy" << finalPath;
-
-    ffmpeg.start("ffmpeg", arguments);
-    if (!ffmpeg.waitForStarted()) {
-        QFile::remove(fileListPath);
-        return false;
-    }
-    ffmpeg.waitForFinished(-1);
     
-    QFile::remove(fileListPath);
-    return ffmpeg.exitCode() == 0;
+    workers.waitForFinished();
+    videoWriter.release();
+    return !aborted;
 }
 
-
 bool MediaExporter::combineAudioVideo(const QString &videoPath, const QString &audioPath, const QString &finalPath)
 {
     QProcess ffmpeg;
@@ -7,6 +7,7 @@
 #include <QFutureWatcher>
 #include <QFutureSynchronizer> 
 #include <QAtomicInt>
+#include <memory>
 #include <note_naga_engine/core/types.h>
 #include <note_naga_engine/note_naga_engine.h>
 #include "media_renderer.h"
@@ -99,26 +100,23 @@ private:
     QString m_tempAudioPath;
     QString m_tempVideoPath;
     
-    // --- Counter for parallel rendering ---
-    QAtomicInt m_framesRendered;
+    // --- Video frame count ---
     int m_totalFrames;
     
     /**
-     * @brief Phase 1: Runs simulation and Phase 2: Parallel rendering.
+     * @brief Creates a renderer for the exported sequence or arrangement with the export settings.
      */
-    bool exportVideoBatched(const QString &outputPath);
-    
-    /**
-     * @brief Renders one batch of frames (runs in its own thread).
-     * @return Path to the temporary .mp4 file for this batch.
-     */
-    QString renderVideoBatch(int startFrame, int endFrame,
-                             const std::vector<MediaRenderer::FrameState>& allFrameStates);
+    std::unique_ptr<MediaRenderer> createRenderer() const;
 
     /**
-     * @brief Joins multiple video files into one using FFmpeg concat.
+     * @brief Exports the video in a single streaming pass.
+     * The calling thread simulates the frame states in order and encodes the finished frames,
+     * a pool of workers renders them in between. Frames travel through a fixed window of
+     * slots (reorder buffer), so memory does not depend on the song length.
+     * @param outputPath Path to the output video file.
+     * @return True if export is successful, false otherwise.
      */
-    bool concatenateVideos(const QStringList& videoFiles, const QString& outputPath);
+    bool exportVideo(const QString &outputPath);
     
     /**
      * @brief Transcodes WAV audio to the desired format using FFmpeg.
@@ -131,18 +129,13 @@ private:
     bool transcodeAudio(const QString &inputWavPath, const QString &finalPath, const QString &format, int bitrate);
     
     /**
-     * @brief Exports audio to a WAV file.
+     * @brief Exports audio of the sequence or the arrangement to a WAV file.
+     * Rendered offline (NoteNagaOfflineRenderer), independently of the live audio engine.
      * @param outputPath Path to the output WAV file.
      * @return True if export is successful, false otherwise.
      */
     bool exportAudio(const QString &outputPath);
     
-    /**
-     * @brief Exports audio from arrangement to a WAV file.
-     * @param outputPath Path to the output WAV file.
-     * @return True if export is successful, false otherwise.
-     */
-    bool exportAudioArrangement(const QString &outputPath);
 
     /**
      * @brief Combines audio and video into a final output file.
@@ -1,5 +1,6 @@
 #include "media_renderer.h"
 
+#include <algorithm>
 #include <cmath>
 #include <QPainter>
 #include <QLinearGradient>
@@ -43,23 +44,26 @@ void MediaRenderer::prepareNoteData()
     if (!m_sequence) return;
     
     m_notes.clear();
+    std::shared_ptr<const NoteNagaTempoMap> tempoMap = m_sequence->getTempoMap();
+    const int ppq = m_sequence->getPPQ();
     for (const auto &track : m_sequence->getTracks())
     {
         // Skip muted tracks and tempo tracks (consistent with arrangement mode)
         if (!track || track->isMuted() || track->isTempoTrack()) continue;
         
         QColor trackColor = track->getColor().toQColor();
-        for (const auto &note : track->getNotes())
+        for (const auto &note : track->getNotesView())
         {
             if (note.start.has_value() && note.length.has_value())
             {
                 m_notes.push_back({note.note,
-                                   nn_ticks_to_seconds(note.start.value(), m_sequence->getPPQ(), m_sequence->getTempo()),
-                                   nn_ticks_to_seconds(note.start.value() + note.length.value(), m_sequence->getPPQ(), m_sequence->getTempo()),
+                                   tempoMap->ticksToSeconds(note.start.value(), ppq),
+                                   tempoMap->ticksToSeconds(note.start.value() + note.length.value(), ppq),
                                    trackColor});
             }
         }
     }
+    buildNoteIndex();
 }
 
 void MediaRenderer::prepareNoteDataFromArrangement()
@@ -70,8 +74,9 @@ void MediaRenderer::prepareNoteDataFromArrangement()
     
     m_notes.clear();
     
+    // Clip positions are arrangement ticks, notes are placed in ticks and then timed by the arrangement tempo map
+    std::shared_ptr<const NoteNagaTempoMap> tempoMap = m_runtimeData->getArrangementTempoMap();
     int ppq = m_runtimeData->getPPQ();
-    int tempo = m_runtimeData->getTempo();
     
     // Iterate through all arrangement tracks
     for (NoteNagaArrangementTrack* arrTrack : m_arrangement->getTracks()) {
@@ -92,10 +97,8 @@ void MediaRenderer::prepareNoteDataFromArrangement()
             int seqLength = seq->getMaxTick();
             if (seqLength <= 0) continue;
             
-            // Calculate clip boundaries in seconds
-            double clipStartSec = nn_ticks_to_seconds(clip.startTick, ppq, tempo);
-            double clipEndSec = nn_ticks_to_seconds(clip.startTick + clip.durationTicks, ppq, tempo);
-            double seqLengthSec = nn_ticks_to_seconds(seqLength, ppq, tempo);
+            int clipStart = clip.startTick;
+            int clipEnd = clip.startTick + clip.durationTicks;
             
             // Get notes from all tracks in the sequence
             for (NoteNagaTrack* midiTrack : seq->getTracks()) {
@@ -104,41 +107,110 @@ void MediaRenderer::prepareNoteDataFromArrangement()
                 // Use arrangement track color for all notes in this clip
                 QColor noteColor = arrTrackColor;
                 
-                for (const NN_Note_t& note : midiTrack->getNotes()) {
+                for (const NN_Note_t& note : midiTrack->getNotesView()) {
                     if (!note.start.has_value() || !note.length.has_value()) continue;
                     
-                    double noteStartInSeq = nn_ticks_to_seconds(note.start.value(), ppq, tempo);
-                    double noteEndInSeq = nn_ticks_to_seconds(note.start.value() + note.length.value(), ppq, tempo);
+                    int noteStartInSeq = note.start.value();
+                    int noteEndInSeq = note.start.value() + note.length.value();
                     
                     // Handle looping - add notes for each loop iteration within the clip
-                    if (seqLengthSec > 0) {
-                        int loopCount = static_cast<int>(ceil((clipEndSec - clipStartSec) / seqLengthSec));
-                        for (int loop = 0; loop < loopCount; ++loop) {
-                            double loopOffset = loop * seqLengthSec;
-                            double absNoteStart = clipStartSec + loopOffset + noteStartInSeq;
-                            double absNoteEnd = clipStartSec + loopOffset + noteEndInSeq;
-                            
-                            // Clip note to clip boundaries
-                            if (absNoteEnd <= clipStartSec) continue;
-                            if (absNoteStart >= clipEndSec) continue;
-                            
-                            absNoteStart = std::max(absNoteStart, clipStartSec);
-                            absNoteEnd = std::min(absNoteEnd, clipEndSec);
-                            
-                            if (absNoteEnd > absNoteStart) {
-                                m_notes.push_back({
-                                    note.note,
-                                    absNoteStart,
-                                    absNoteEnd,
-                                    noteColor
-                                });
-                            }
+                    int loopCount = (clip.durationTicks + seqLength - 1) / seqLength;
+                    for (int loop = 0; loop < loopCount; ++loop) {
+                        int loopOffset = loop * seqLength;
+                        int absNoteStart = clipStart + loopOffset + noteStartInSeq;
+                        int absNoteEnd = clipStart + loopOffset + noteEndInSeq;
+                        
+                        // Clip note to clip boundaries
+                        if (absNoteEnd <= clipStart) continue;
+                        if (absNoteStart >= clipEnd) continue;
+                        
+                        absNoteStart = std::max(absNoteStart, clipStart);
+                        absNoteEnd = std::min(absNoteEnd, clipEnd);
+                        
+                        if (absNoteEnd > absNoteStart) {
+                            m_notes.push_back({
+                                note.note,
+                                tempoMap->ticksToSeconds(absNoteStart, ppq),
+                                tempoMap->ticksToSeconds(absNoteEnd, ppq),
+                                noteColor
+                            });
                         }
                     }
                 }
             }
         }
     }
+    buildNoteIndex();
+}
+
+void MediaRenderer::buildNoteIndex()
+{
+    m_bucketStart.clear();
+    m_bucketNotes.clear();
+    if (m_notes.empty()) return;
+
+    double lastEnd = 0.0;
+    for (const auto &note : m_notes) lastEnd = std::max(lastEnd, note.end_time);
+    const size_t numBuckets = static_cast<size_t>(lastEnd / kNoteBucketSeconds) + 1;
+    auto bucketOf = [numBuckets](double time) {
+        if (time <= 0.0) return size_t(0);
+        return std::min(static_cast<size_t>(time / kNoteBucketSeconds), numBuckets - 1);
+    };
+
+    // Count the notes of every bucket, then fill the buckets in note order
+    m_bucketStart.assign(numBuckets + 1, 0);
+    for (const auto &note : m_notes)
+    {
+        for (size_t b = bucketOf(note.start_time); b <= bucketOf(note.end_time); ++b)
+            ++m_bucketStart[b + 1];
+    }
+    for (size_t b = 0; b < numBuckets; ++b)
+        m_bucketStart[b + 1] += m_bucketStart[b];
+
+    m_bucketNotes.resize(m_bucketStart[numBuckets]);
+    std::vector<uint32_t> cursor(m_bucketStart.begin(), m_bucketStart.end() - 1);
+    for (uint32_t i = 0; i < m_notes.size(); ++i)
+    {
+        for (size_t b = bucketOf(m_notes[i].start_time); b <= bucketOf(m_notes[i].end_time); ++b)
+            m_bucketNotes[cursor[b]++] = i;
+    }
+}
+
+template <typename Fn>
+void MediaRenderer::forEachNoteInRange(double from, double to, Fn &&fn) const
+{
+    if (m_bucketStart.size() < 2 || to < from) return;
+    const size_t numBuckets = m_bucketStart.size() - 1;
+    if (to < 0.0 || from >= numBuckets * kNoteBucketSeconds) return;
+
+    const size_t first = from <= 0.0 ? 0 : static_cast<size_t>(from / kNoteBucketSeconds);
+    const size_t last = std::min(static_cast<size_t>(to / kNoteBucketSeconds), numBuckets - 1);
+    for (size_t b = first; b <= last; ++b)
+    {
+        for (uint32_t k = m_bucketStart[b]; k < m_bucketStart[b + 1]; ++k)
+        {
+            const uint32_t index = m_bucketNotes[k];
+            // A note spanning several buckets is reported by the first visited one only
+            const double start = m_notes[index].start_time;
+            const size_t noteFirst = start <= 0.0 ? 0 : static_cast<size_t>(start / kNoteBucketSeconds);
+            if (b == std::max(noteFirst, first))
+                fn(index);
+        }
+    }
+}
+
+std::array<int, 128> MediaRenderer::findSoundingNotes(double time) const
+{
+    std::array<int, 128> sounding;
+    sounding.fill(-1);
+    forEachNoteInRange(time, time, [&](uint32_t index) {
+        const NoteInfo &note = m_notes[index];
+        if (note.note_val < 0 || note.note_val > 127) return;
+        if (time < note.start_time || time >= note.end_time) return;
+        int &slot = sounding[note.note_val];
+        if (slot < 0 || static_cast<int>(index) < slot) slot = static_cast<int>(index);
+    });
+    return sounding;
 }
 
 void MediaRenderer::prepareKeyboardLayout(const QSize &size)
@@ -227,42 +299,44 @@ MediaRenderer::FrameState MediaRenderer::calculateNextState(const FrameState &pr
 
     std::map<int, bool> currentActiveNotes;
 
-    // 1. Find active notes (for keyboard and particles)
-    for (const auto &note : m_notes)
-    {
+    // 1. Find active notes (for keyboard and particles), only the current bucket is visited
+    forEachNoteInRange(currentTime, currentTime, [&](uint32_t index) {
+        const NoteInfo &note = m_notes[index];
         if (currentTime >= note.start_time && currentTime < note.end_time)
         {
             currentActiveNotes[note.note_val] = true;
         }
-    }
+    });
 
     // 2. Spawn new particles (if enabled)
     if (m_settings.renderParticles)
     {
         double resolutionScale = (double)m_lastLayoutSize.height() / 720.0;
 
+        // Notes which really start now (first one per note value), searched only around the current time
+        const double startTolerance = deltaTime + 0.01;
+        std::array<int, 128> startingNotes;
+        startingNotes.fill(-1);
+        forEachNoteInRange(currentTime - startTolerance, currentTime + startTolerance, [&](uint32_t index) {
+            const NoteInfo &noteInfo = m_notes[index];
+            if (noteInfo.note_val < 0 || noteInfo.note_val > 127) return;
+            if (std::abs(noteInfo.start_time - currentTime) >= startTolerance) return;
+            int &slot = startingNotes[noteInfo.note_val];
+            if (slot < 0 || static_cast<int>(index) < slot) slot = static_cast<int>(index);
+        });
+
         for (const auto &pair : currentActiveNotes)
         {
             // Was this note active in the previous state?
             bool wasActive = previousState.activeNotes.find(pair.first) != previousState.activeNotes.end();
-            if (!wasActive)
+            if (!wasActive && pair.first >= 0 && pair.first <= 127 && startingNotes[pair.first] >= 0)
             {
-                // Note just started playing, find its data
-                for (const auto &noteInfo : m_notes)
+                // Note just started playing
+                const NoteInfo &noteInfo = m_notes[startingNotes[pair.first]];
+                if (m_keyboardLayout.find(noteInfo.note_val) != m_keyboardLayout.end())
                 {
-                    if (noteInfo.note_val == pair.first)
-                    {
-                        // Check if it's the "real" start of the note
-                        if (std::abs(noteInfo.start_time - currentTime) < (deltaTime + 0.01))
-                        {
-                            if (m_keyboardLayout.find(noteInfo.note_val) != m_keyboardLayout.end())
-                            {
-                                // Add particles to the *new* state
-                                spawnParticles(noteInfo, resolutionScale, newState.particles);
-                            }
-                            break;
-                        }
-                    }
+                    // Add particles to the *new* state
+                    spawnParticles(noteInfo, resolutionScale, newState.particles);
                 }
             }
         }
@@ -285,13 +359,21 @@ MediaRenderer::FrameState MediaRenderer::calculateNextState(const FrameState &pr
 
 QImage MediaRenderer::renderFrame(double currentTime, const QSize &size, const FrameState &state)
 {
+    QImage frame(size, QImage::Format_ARGB32);
+    renderFrame(currentTime, state, frame);
+    return frame;
+}
 
+void MediaRenderer::renderFrame(double currentTime, const FrameState &state, QImage &frame)
+{
+    const QSize size = frame.size();
     prepareKeyboardLayout(size);
-    QImage frame(size, QImage::Format_ARGB32);
 
     // 1. Draw background
     if (!m_settings.backgroundImage.isNull())
     {
+        // The image may not cover every pixel (transparency, shake), the reused target keeps old content
+        frame.fill(m_settings.backgroundColor);
         QPainter bgPainter(&frame);
 
         QRectF targetRect = frame.rect();
@@ -338,7 +420,6 @@ QImage MediaRenderer::renderFrame(double currentTime, const QSize &size, const F
     }
 
     painter.end();
-    return frame;
 }
 
 // =========================================================================
@@ -410,8 +491,15 @@ void MediaRenderer::drawNotesAndKeyboard(QPainter &painter, double currentTime,
     // --- Draw falling notes ---
     if (m_settings.renderNotes)
     {
-        for (const auto &note : m_notes)
+        // Visible notes from the buckets of the window, drawn in note order (same overlap as before)
+        m_visibleNotes.clear();
+        forEachNoteInRange(currentTime - 1.0, currentTime + m_secondsVisible,
+                           [this](uint32_t index) { m_visibleNotes.push_back(index); });
+        std::sort(m_visibleNotes.begin(), m_visibleNotes.end());
+
+        for (uint32_t index : m_visibleNotes)
         {
+            const NoteInfo &note = m_notes[index];
             if (note.end_time < currentTime - 1.0 || note.start_time > currentTime + m_secondsVisible)
                 continue;
 
@@ -474,6 +562,9 @@ void MediaRenderer::drawNotesAndKeyboard(QPainter &painter, double currentTime,
     // --- Draw Keyboard ---
     if (m_settings.renderKeyboard)
     {
+        // Color of every sounding key (first sounding note wins)
+        const std::array<int, 128> soundingNotes = findSoundingNotes(currentTime);
+
         // Draw white keys
         for (const auto &pair : m_keyboardLayout)
         {
@@ -483,14 +574,8 @@ void MediaRenderer::drawNotesAndKeyboard(QPainter &painter, double currentTime,
                 if (isActive)
                 {
                     QColor activeColor = QColor(150, 150, 255);
-                    for (const auto &note : m_notes)
-                    {
-                        if (note.note_val == pair.first && currentTime >= note.start_time && currentTime < note.end_time)
-                        {
-                            activeColor = note.color;
-                            break;
-                        }
-                    }
+                    if (pair.first >= 0 && pair.first <= 127 && soundingNotes[pair.first] >= 0)
+                        activeColor = m_notes[soundingNotes[pair.first]].color;
                     painter.setBrush(activeColor.lighter(120));
                     painter.setPen(activeColor);
                 }
@@ -511,14 +596,8 @@ void MediaRenderer::drawNotesAndKeyboard(QPainter &painter, double currentTime,
                 if (isActive)
                 {
                     QColor activeColor = QColor(150, 150, 255);
-                    for (const auto &note : m_notes)
-                    {
-                        if (note.note_val == pair.first && currentTime >= note.start_time && currentTime < note.end_time)
-                        {
-                            activeColor = note.color;
-                            break;
-                        }
-                    }
+                    if (pair.first >= 0 && pair.first <= 127 && soundingNotes[pair.first] >= 0)
+                        activeColor = m_notes[soundingNotes[pair.first]].color;
                     painter.setBrush(activeColor.lighter(120));
                     painter.setPen(activeColor);
                 }
@@ -3,6 +3,8 @@
 #include <QImage>
 #include <QColor>
 #include <QPixmap>
+#include <array>
+#include <cstdint>
 #include <map>
 #include <vector>
 #include <note_naga_engine/core/types.h>
@@ -90,6 +92,16 @@ public:
      */
     QImage renderFrame(double currentTime, const QSize& size, const FrameState& state);
 
+    /**
+     * @brief Renders a frame into an existing image (Stateless version for export).
+     * The target is reused between frames, nothing is allocated for it. Every pixel is
+     * overwritten, opaque formats (QImage::Format_RGB32) are the fastest to paint into.
+     * @param currentTime The current absolute time.
+     * @param state The pre-calculated state of the frame.
+     * @param target Image to draw into (its size is the frame size).
+     */
+    void renderFrame(double currentTime, const FrameState& state, QImage& target);
+
     /**
      * @brief Calculates the state for the next frame based on the previous one. (Stateless)
      * @param previousState The state of the previous frame.
@@ -124,6 +136,24 @@ private:
 
     void prepareNoteData();
     void prepareNoteDataFromArrangement();
+
+    /**
+     * @brief Builds the time bucket index over m_notes (called after the notes are prepared).
+     */
+    void buildNoteIndex();
+
+    /**
+     * @brief Calls fn(index) once for every note that may overlap [from, to].
+     * Only the buckets of the range are visited, the caller checks the exact note times.
+     */
+    template <typename Fn>
+    void forEachNoteInRange(double from, double to, Fn &&fn) const;
+
+    /**
+     * @brief Finds the first note (lowest index) sounding at the given time for every MIDI note value.
+     * @return Note index per MIDI note value, -1 for silent keys.
+     */
+    std::array<int, 128> findSoundingNotes(double time) const;
     
     // Simulation methods
     void updateParticles(double deltaTime, std::vector<Particle>& particles);
@@ -139,6 +169,13 @@ private:
     NoteNagaRuntimeData* m_runtimeData;
 
     std::vector<NoteInfo> m_notes;
+
+    // Time bucket index over m_notes: bucket b lists (in index order) every note overlapping
+    // [b * kNoteBucketSeconds, (b + 1) * kNoteBucketSeconds)
+    static constexpr double kNoteBucketSeconds = 0.5;
+    std::vector<uint32_t> m_bucketStart; // Offsets into m_bucketNotes, one extra at the end
+    std::vector<uint32_t> m_bucketNotes;
+    std::vector<uint32_t> m_visibleNotes; // Scratch list of the notes drawn in a frame
     std::map<int, KeyInfo> m_keyboardLayout;
     QSize m_lastLayoutSize;
     double m_secondsVisible = 5.0;